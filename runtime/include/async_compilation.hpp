@@ -0,0 +1,365 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "background_queue.hpp"
+#include "pipeline_cache.hpp"
+#include "render_backend.hpp"
+
+namespace se {
+
+// Handle to a shader or pipeline that may still be compiling. Copies share
+// state; readiness may be polled from any thread.
+template <typename Id>
+class AsyncHandle {
+public:
+    AsyncHandle() = default;
+
+    static AsyncHandle resolved(Id id)
+    {
+        AsyncHandle handle(std::make_shared<State>());
+        handle.state_->publish(id);
+        return handle;
+    }
+
+    bool valid() const
+    {
+        return state_ != nullptr;
+    }
+
+    bool ready() const
+    {
+        return state_ && state_->ready.load(std::memory_order_acquire);
+    }
+
+    // Only meaningful once ready() returned true.
+    Id get() const
+    {
+        return state_->id;
+    }
+
+private:
+    friend class AsyncCompilation;
+
+    struct State {
+        void publish(Id value)
+        {
+            id = value;
+            ready.store(true, std::memory_order_release);
+        }
+
+        Id id {};
+        std::atomic<bool> ready { false };
+    };
+
+    explicit AsyncHandle(std::shared_ptr<State> state)
+        : state_(std::move(state))
+    {
+    }
+
+    std::shared_ptr<State> state_;
+};
+
+using AsyncShader = AsyncHandle<ShaderId>;
+using AsyncPipeline = AsyncHandle<PipelineId>;
+
+struct AsyncCompilationStats {
+    uint64_t shadersCompiled { 0 };
+    uint64_t pipelinesCompiled { 0 };
+    // Spent compiling on worker threads.
+    std::chrono::nanoseconds compileTime { 0 };
+    // Spent on the frame thread registering finished objects in pump().
+    std::chrono::nanoseconds registerTime { 0 };
+};
+
+// Compiles shaders and pipelines on background threads. Requests return a
+// handle immediately; finished objects are registered with the backend and
+// the caches by pump(), which runs on the frame thread, so backend resource
+// tables are never written concurrently with command execution.
+class AsyncCompilation {
+public:
+    AsyncCompilation(RenderBackend& backend, ShaderCache& shaders, PipelineCache& pipelines, size_t threads = 1)
+        : backend_(backend)
+        , shader_cache_(shaders)
+        , pipeline_cache_(pipelines)
+        , queue_(threads)
+    {
+    }
+
+    AsyncShader loadShader(GameLibraryId libraryId, const char* name)
+    {
+        if (std::optional<ShaderId> shader = shader_cache_.find(libraryId, name))
+            return AsyncShader::resolved(*shader);
+
+        auto [iter, inserted] = shaders_in_flight_.try_emplace({ libraryId, name });
+        if (!inserted)
+            return AsyncShader(iter->second);
+
+        auto job = std::make_shared<ShaderJob>();
+        job->state = std::make_shared<AsyncShader::State>();
+        job->library = libraryId;
+        job->name = name;
+        iter->second = job->state;
+
+        queue_.submit([this, job]() {
+            auto start = std::chrono::steady_clock::now();
+            job->result = backend_.compileShader(job->library, job->name.c_str());
+            job->time = std::chrono::steady_clock::now() - start;
+
+            {
+                std::unique_lock lock(mutex_);
+                finished_shaders_.push_back(job);
+            }
+            job_finished_.notify_all();
+        });
+
+        return AsyncShader(job->state);
+    }
+
+    // `desc` must reference shaders that are already loaded.
+    AsyncPipeline createPipeline(const PipelineDesc& desc)
+    {
+        if (std::optional<PipelineId> pipeline = pipeline_cache_.find(desc))
+            return AsyncPipeline::resolved(*pipeline);
+
+        auto state = std::make_shared<AsyncPipeline::State>();
+        startPipeline(desc, state);
+        return AsyncPipeline(state);
+    }
+
+    // Starts compiling once both shaders are ready. The shader ids in `desc`
+    // are ignored and replaced by those of `vertexShader` and `fragmentShader`.
+    AsyncPipeline createPipeline(AsyncShader vertexShader, AsyncShader fragmentShader, PipelineDesc desc)
+    {
+        if (vertexShader.ready() && fragmentShader.ready()) {
+            desc.vertexShader = vertexShader.get();
+            desc.fragmentShader = fragmentShader.get();
+            return createPipeline(desc);
+        }
+
+        auto state = std::make_shared<AsyncPipeline::State>();
+        waiting_.push_back({ std::move(vertexShader), std::move(fragmentShader), desc, state });
+        return AsyncPipeline(state);
+    }
+
+    // Blocking counterparts of loadShader and createPipeline. A request that
+    // is still compiling in the background is waited for instead of being
+    // compiled a second time. Frame thread only.
+    ShaderId loadShaderNow(GameLibraryId libraryId, const char* name)
+    {
+        if (shaders_in_flight_.contains({ libraryId, name })) {
+            waitUntilFinished([&]() {
+                return std::any_of(finished_shaders_.begin(), finished_shaders_.end(), [&](const auto& job) {
+                    return job->library == libraryId && job->name == name;
+                });
+            });
+        }
+
+        if (std::optional<ShaderId> shader = shader_cache_.find(libraryId, name))
+            return *shader;
+
+        ShaderId shader = backend_.loadShaderFromLibrary(libraryId, name);
+        shader_cache_.insert(libraryId, name, shader);
+        return shader;
+    }
+
+    // Waits for the shaders of `libraryId` still compiling, so none is
+    // compiled from a library that is about to be destroyed. Frame thread
+    // only.
+    void finishLibrary(GameLibraryId libraryId)
+    {
+        size_t in_flight = std::count_if(shaders_in_flight_.begin(), shaders_in_flight_.end(), [libraryId](const auto& entry) {
+            return entry.first.first == libraryId;
+        });
+        if (in_flight == 0)
+            return;
+
+        waitUntilFinished([&]() {
+            return size_t(std::count_if(finished_shaders_.begin(), finished_shaders_.end(), [libraryId](const auto& job) {
+                return job->library == libraryId;
+            })) == in_flight;
+        });
+    }
+
+    PipelineId createPipelineNow(const PipelineDesc& desc)
+    {
+        if (pipelines_in_flight_.contains(desc)) {
+            waitUntilFinished([&]() {
+                return std::any_of(finished_pipelines_.begin(), finished_pipelines_.end(), [&](const auto& job) {
+                    return job->desc == desc;
+                });
+            });
+        }
+
+        return pipeline_cache_.getOrCreate(desc, [this](const PipelineDesc& desc) {
+            return backend_.createPipeline(desc);
+        });
+    }
+
+    // Registers everything that finished since the last call and starts
+    // pipelines whose shaders have become ready. Frame thread only.
+    void pump()
+    {
+        std::vector<std::shared_ptr<ShaderJob>> shaders;
+        std::vector<std::shared_ptr<PipelineJob>> pipelines;
+        {
+            std::unique_lock lock(mutex_);
+            shaders.swap(finished_shaders_);
+            pipelines.swap(finished_pipelines_);
+        }
+
+        if (shaders.empty() && pipelines.empty() && waiting_.empty())
+            return;
+
+        auto start = std::chrono::steady_clock::now();
+
+        for (const std::shared_ptr<ShaderJob>& job : shaders) {
+            ShaderId shader = backend_.addShader(std::move(job->result));
+            shader_cache_.insert(job->library, job->name, shader);
+            shaders_in_flight_.erase({ job->library, job->name });
+            job->state->publish(shader);
+
+            ++stats_.shadersCompiled;
+            stats_.compileTime += job->time;
+        }
+
+        for (const std::shared_ptr<PipelineJob>& job : pipelines) {
+            PipelineId pipeline = backend_.addPipeline(std::move(job->result));
+            pipeline_cache_.insert(job->desc, pipeline, job->time);
+
+            auto iter = pipelines_in_flight_.find(job->desc);
+            for (const std::shared_ptr<AsyncPipeline::State>& state : iter->second)
+                state->publish(pipeline);
+            pipelines_in_flight_.erase(iter);
+
+            ++stats_.pipelinesCompiled;
+            stats_.compileTime += job->time;
+        }
+
+        for (size_t i = 0; i < waiting_.size();) {
+            WaitingPipeline& waiting = waiting_[i];
+            if (!waiting.vertexShader.ready() || !waiting.fragmentShader.ready()) {
+                ++i;
+                continue;
+            }
+
+            waiting.desc.vertexShader = waiting.vertexShader.get();
+            waiting.desc.fragmentShader = waiting.fragmentShader.get();
+
+            if (std::optional<PipelineId> pipeline = pipeline_cache_.find(waiting.desc))
+                waiting.state->publish(*pipeline);
+            else
+                startPipeline(waiting.desc, waiting.state);
+
+            waiting_[i] = std::move(waiting_.back());
+            waiting_.pop_back();
+        }
+
+        stats_.registerTime += std::chrono::steady_clock::now() - start;
+    }
+
+    // Blocks until every request made so far is ready. Frame thread only.
+    void finish()
+    {
+        while (inFlight() > 0) {
+            queue_.wait();
+            pump();
+        }
+    }
+
+    size_t inFlight() const
+    {
+        return shaders_in_flight_.size() + pipelines_in_flight_.size() + waiting_.size();
+    }
+
+    const AsyncCompilationStats& stats() const
+    {
+        return stats_;
+    }
+
+private:
+    struct ShaderJob {
+        std::shared_ptr<AsyncShader::State> state;
+        GameLibraryId library;
+        std::string name;
+        std::unique_ptr<CompiledObject> result;
+        std::chrono::nanoseconds time;
+    };
+
+    struct PipelineJob {
+        PipelineDesc desc;
+        std::unique_ptr<CompiledObject> result;
+        std::chrono::nanoseconds time;
+    };
+
+    struct WaitingPipeline {
+        AsyncShader vertexShader;
+        AsyncShader fragmentShader;
+        PipelineDesc desc;
+        std::shared_ptr<AsyncPipeline::State> state;
+    };
+
+    void startPipeline(const PipelineDesc& desc, std::shared_ptr<AsyncPipeline::State> state)
+    {
+        auto [iter, inserted] = pipelines_in_flight_.try_emplace(desc);
+        iter->second.push_back(std::move(state));
+        if (!inserted)
+            return;
+
+        auto job = std::make_shared<PipelineJob>();
+        job->desc = desc;
+
+        queue_.submit([this, job]() {
+            auto start = std::chrono::steady_clock::now();
+            job->result = backend_.compilePipeline(job->desc);
+            job->time = std::chrono::steady_clock::now() - start;
+
+            {
+                std::unique_lock lock(mutex_);
+                finished_pipelines_.push_back(job);
+            }
+            job_finished_.notify_all();
+        });
+    }
+
+    // Waits until `finished` holds for the finished jobs, then registers
+    // them.
+    template <typename Finished>
+    void waitUntilFinished(Finished&& finished)
+    {
+        {
+            std::unique_lock lock(mutex_);
+            job_finished_.wait(lock, finished);
+        }
+        pump();
+    }
+
+    RenderBackend& backend_;
+    ShaderCache& shader_cache_;
+    PipelineCache& pipeline_cache_;
+
+    // Frame thread only.
+    std::map<std::pair<GameLibraryId, std::string>, std::shared_ptr<AsyncShader::State>> shaders_in_flight_;
+    std::unordered_map<PipelineDesc, std::vector<std::shared_ptr<AsyncPipeline::State>>, PipelineDescHash> pipelines_in_flight_;
+    std::vector<WaitingPipeline> waiting_;
+    AsyncCompilationStats stats_;
+
+    std::mutex mutex_;
+    std::condition_variable job_finished_;
+    std::vector<std::shared_ptr<ShaderJob>> finished_shaders_;
+    std::vector<std::shared_ptr<PipelineJob>> finished_pipelines_;
+
+    // Declared last so workers are joined before the state they use is gone.
+    BackgroundQueue queue_;
+};
+
+} // namespace se
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace se {
+
+// First-in first-out queue of jobs executed by long-lived worker threads.
+// Unlike ThreadPool, submitting never blocks the caller.
+class BackgroundQueue {
+public:
+    explicit BackgroundQueue(size_t threads = 1)
+    {
+        for (size_t i = 0; i < threads; ++i)
+            workers_.emplace_back([this]() { work(); });
+    }
+
+    // Jobs that have not started yet are discarded.
+    ~BackgroundQueue()
+    {
+        {
+            std::unique_lock lock(mutex_);
+            stop_ = true;
+            jobs_.clear();
+        }
+        wake_.notify_all();
+
+        for (std::thread& worker : workers_)
+            worker.join();
+    }
+
+    BackgroundQueue(const BackgroundQueue&) = delete;
+    BackgroundQueue& operator=(const BackgroundQueue&) = delete;
+
+    void submit(std::function<void()> job)
+    {
+        {
+            std::unique_lock lock(mutex_);
+            jobs_.push_back(std::move(job));
+        }
+        wake_.notify_one();
+    }
+
+    // Blocks until the queue is empty and no job is running.
+    void wait()
+    {
+        std::unique_lock lock(mutex_);
+        idle_.wait(lock, [this]() { return jobs_.empty() && running_ == 0; });
+    }
+
+private:
+    void work()
+    {
+        for (;;) {
+            std::function<void()> job;
+            {
+                std::unique_lock lock(mutex_);
+                wake_.wait(lock, [this]() { return stop_ || !jobs_.empty(); });
+                if (stop_)
+                    return;
+
+                job = std::move(jobs_.front());
+                jobs_.pop_front();
+                ++running_;
+            }
+
+            job();
+
+            {
+                std::unique_lock lock(mutex_);
+                --running_;
+            }
+            idle_.notify_all();
+        }
+    }
+
+    std::vector<std::thread> workers_;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable idle_;
+    std::deque<std::function<void()>> jobs_;
+    size_t running_ { 0 };
+    bool stop_ { false };
+};
+
+} // namespace se
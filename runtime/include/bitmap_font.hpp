@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdint>
+
+namespace se {
+
+// Built-in 8x8 monospace font covering printable ASCII.
+constexpr uint32_t kBitmapFontSize = 8;
+constexpr uint32_t kBitmapFontFirst = 0x20;
+constexpr uint32_t kBitmapFontLast = 0x7e;
+
+// Returns kBitmapFontSize rows for `codepoint`, or nullptr when the font has
+// no glyph for it. Bit 0 of each row is the leftmost pixel.
+const uint8_t* bitmapFontGlyph(uint32_t codepoint);
+
+} // namespace se
@@ -0,0 +1,326 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <vector>
+
+#include "generics.h"
+#include "logging.hpp"
+#include "render_types.hpp"
+
+namespace se {
+
+enum class RenderCommandType : uint8_t {
+    BindPipeline,
+    BindTexture,
+    SetVertexBytes,
+    BindVertexBuffer,
+    Draw,
+    DrawIndexed
+};
+
+// Every command starts with this header. `size` covers the header, the
+// command fields and any inline payload, rounded up to kCommandAlignment.
+struct RenderCommand {
+    RenderCommandType type;
+    uint32_t size;
+};
+
+struct BindPipelineCommand : RenderCommand {
+    PipelineId pipeline;
+};
+
+struct BindTextureCommand : RenderCommand {
+    uint32_t index;
+    TextureId texture;
+};
+
+struct SetVertexBytesCommand : RenderCommand {
+    uint32_t index;
+    uint32_t length;
+
+    const void* bytes() const
+    {
+        return this + 1;
+    }
+};
+
+struct BindVertexBufferCommand : RenderCommand {
+    uint32_t index;
+    uint32_t offset;
+    BufferId buffer;
+};
+
+struct DrawCommand : RenderCommand {
+    uint32_t vertexStart;
+    uint32_t vertexCount;
+};
+
+// Indices are read from `indexBuffer` starting at element `indexStart`.
+struct DrawIndexedCommand : RenderCommand {
+    IndexType indexType;
+    uint32_t indexStart;
+    uint32_t indexCount;
+    BufferId indexBuffer;
+};
+
+// Backend-agnostic draw work recorded into one linear buffer. Each worker
+// owns one list for the duration of a frame, so recording needs no
+// synchronization. Lists are executed by a RenderBackend in index order.
+class CommandList {
+public:
+    static constexpr size_t kCommandAlignment = 16;
+    // Quad index buffers hold the 16-bit indices of this many quads; see
+    // quadIndices() in mesh_builder.hpp.
+    static constexpr uint32_t kMaxQuadsPerDraw = 16384;
+    // Largest payload of one setVertexBytes: the command, its payload and
+    // the padding must fit the 32-bit size field.
+    static constexpr size_t kMaxVertexBytes = (UINT32_MAX & ~(kCommandAlignment - 1)) - sizeof(SetVertexBytesCommand);
+
+    void bindPipeline(PipelineId pipeline)
+    {
+        BindPipelineCommand* command = emplace<BindPipelineCommand>(RenderCommandType::BindPipeline, 0);
+        command->pipeline = pipeline;
+    }
+
+    void bindTexture(uint32_t index, TextureId texture)
+    {
+        BindTextureCommand* command = emplace<BindTextureCommand>(RenderCommandType::BindTexture, 0);
+        command->index = index;
+        command->texture = texture;
+    }
+
+    // Copies `bytes` into the list. Returns false and records nothing when
+    // `length` is above kMaxVertexBytes.
+    bool setVertexBytes(uint32_t index, const void* bytes, size_t length)
+    {
+        // The payload follows the command and must stay aligned.
+        static_assert(sizeof(SetVertexBytesCommand) % kCommandAlignment == 0);
+
+        if (length > kMaxVertexBytes) {
+            ERROR("Vertex bytes too large for one command");
+            return false;
+        }
+
+        SetVertexBytesCommand* command = emplace<SetVertexBytesCommand>(RenderCommandType::SetVertexBytes, length);
+        command->index = index;
+        command->length = uint32_t(length);
+        std::memcpy(command + 1, bytes, length);
+        return true;
+    }
+
+    void bindVertexBuffer(uint32_t index, BufferId buffer, uint32_t offset = 0)
+    {
+        BindVertexBufferCommand* command = emplace<BindVertexBufferCommand>(RenderCommandType::BindVertexBuffer, 0);
+        command->index = index;
+        command->offset = offset;
+        command->buffer = buffer;
+    }
+
+    void draw(uint32_t vertexStart, uint32_t vertexCount)
+    {
+        DrawCommand* command = emplace<DrawCommand>(RenderCommandType::Draw, 0);
+        command->vertexStart = vertexStart;
+        command->vertexCount = vertexCount;
+    }
+
+    void drawIndexed(BufferId indexBuffer, IndexType indexType, uint32_t indexStart, uint32_t indexCount)
+    {
+        DrawIndexedCommand* command = emplace<DrawIndexedCommand>(RenderCommandType::DrawIndexed, 0);
+        command->indexType = indexType;
+        command->indexStart = indexStart;
+        command->indexCount = indexCount;
+        command->indexBuffer = indexBuffer;
+    }
+
+    void drawVertices(const AAPLVertex* vertices, uint64_t length, PipelineId pipeline)
+    {
+        bindPipeline(pipeline);
+        if (setVertexBytes(AAPLVertexInputIndexVertices, vertices, sizeof(AAPLVertex) * length))
+            draw(0, length);
+    }
+
+    void drawVertices(const AAPLPackedVertex* vertices, uint64_t length, PipelineId pipeline)
+    {
+        bindPipeline(pipeline);
+        if (setVertexBytes(AAPLVertexInputIndexVertices, vertices, sizeof(AAPLPackedVertex) * length))
+            draw(0, length);
+    }
+
+    void drawSprites(const AAPLSpriteVertex* vertices, uint64_t length, PipelineId pipeline, TextureId texture)
+    {
+        drawSpriteBytes(vertices, sizeof(AAPLSpriteVertex) * length, length, pipeline, texture);
+    }
+
+    void drawSprites(const AAPLPackedSpriteVertex* vertices, uint64_t length, PipelineId pipeline, TextureId texture)
+    {
+        drawSpriteBytes(vertices, sizeof(AAPLPackedSpriteVertex) * length, length, pipeline, texture);
+    }
+
+    void drawSprites(const AAPLHalfSpriteVertex* vertices, uint64_t length, PipelineId pipeline, TextureId texture)
+    {
+        drawSpriteBytes(vertices, sizeof(AAPLHalfSpriteVertex) * length, length, pipeline, texture);
+    }
+
+    // Draws `quadCount` quads of four vertices each, ordered top left, top
+    // right, bottom left, bottom right, with the shared `quadIndices` buffer.
+    // Saves a third of the vertex bytes over two triangles per quad. `Vertex`
+    // is one of the layouts in generics.h and must match the pipeline.
+    template <typename Vertex>
+    void drawQuads(const Vertex* vertices, uint64_t quadCount, PipelineId pipeline, BufferId quadIndices)
+    {
+        bindPipeline(pipeline);
+        for (uint64_t first = 0; first < quadCount; first += kMaxQuadsPerDraw) {
+            uint32_t count = uint32_t(std::min<uint64_t>(quadCount - first, kMaxQuadsPerDraw));
+            setVertexBytes(AAPLVertexInputIndexVertices, vertices + first * 4, sizeof(Vertex) * 4 * count);
+            drawIndexed(quadIndices, IndexType::UInt16, 0, count * 6);
+        }
+    }
+
+    template <typename Vertex>
+    void drawSpriteQuads(const Vertex* vertices, uint64_t quadCount, PipelineId pipeline, TextureId texture, BufferId quadIndices)
+    {
+        bindTexture(AAPLTextureIndexAtlas, texture);
+        drawQuads(vertices, quadCount, pipeline, quadIndices);
+    }
+
+    void drawMesh(const Mesh& mesh, PipelineId pipeline)
+    {
+        bindPipeline(pipeline);
+        bindVertexBuffer(AAPLVertexInputIndexVertices, mesh.vertexBuffer);
+        drawIndexed(mesh.indexBuffer, mesh.indexType, 0, mesh.indexCount);
+    }
+
+    // Calls `visitor` with each command, downcast to its concrete type, in
+    // recording order.
+    template <typename Visitor>
+    void visit(Visitor&& visitor) const
+    {
+        size_t offset = 0;
+        while (offset < data_.size()) {
+            const RenderCommand* command = reinterpret_cast<const RenderCommand*>(data_.data() + offset);
+
+            switch (command->type) {
+            case RenderCommandType::BindPipeline:
+                visitor(*static_cast<const BindPipelineCommand*>(command));
+                break;
+            case RenderCommandType::BindTexture:
+                visitor(*static_cast<const BindTextureCommand*>(command));
+                break;
+            case RenderCommandType::SetVertexBytes:
+                visitor(*static_cast<const SetVertexBytesCommand*>(command));
+                break;
+            case RenderCommandType::BindVertexBuffer:
+                visitor(*static_cast<const BindVertexBufferCommand*>(command));
+                break;
+            case RenderCommandType::Draw:
+                visitor(*static_cast<const DrawCommand*>(command));
+                break;
+            case RenderCommandType::DrawIndexed:
+                visitor(*static_cast<const DrawIndexedCommand*>(command));
+                break;
+            }
+
+            offset += command->size;
+        }
+    }
+
+    bool empty() const
+    {
+        return data_.empty();
+    }
+
+    size_t commandCount() const
+    {
+        return command_count_;
+    }
+
+    size_t sizeInBytes() const
+    {
+        return data_.size();
+    }
+
+    void reset()
+    {
+        data_.clear();
+        command_count_ = 0;
+    }
+
+private:
+    void drawSpriteBytes(const void* bytes, size_t length, uint64_t vertexCount, PipelineId pipeline, TextureId texture)
+    {
+        bindPipeline(pipeline);
+        bindTexture(AAPLTextureIndexAtlas, texture);
+        if (setVertexBytes(AAPLVertexInputIndexVertices, bytes, length))
+            draw(0, vertexCount);
+    }
+
+    template <typename Command>
+    Command* emplace(RenderCommandType type, size_t payload)
+    {
+        static_assert(alignof(Command) <= kCommandAlignment);
+
+        size_t size = (sizeof(Command) + payload + kCommandAlignment - 1) & ~(kCommandAlignment - 1);
+        size_t offset = data_.size();
+        data_.resize(offset + size);
+
+        Command* command = new (data_.data() + offset) Command();
+        command->type = type;
+        command->size = size;
+
+        ++command_count_;
+        return command;
+    }
+
+    struct alignas(kCommandAlignment) Block {
+        std::byte bytes[kCommandAlignment];
+    };
+
+    // Stored as blocks so the buffer itself is kCommandAlignment aligned.
+    class Buffer {
+    public:
+        std::byte* data()
+        {
+            return reinterpret_cast<std::byte*>(blocks_.data());
+        }
+
+        const std::byte* data() const
+        {
+            return reinterpret_cast<const std::byte*>(blocks_.data());
+        }
+
+        size_t size() const
+        {
+            return size_;
+        }
+
+        bool empty() const
+        {
+            return size_ == 0;
+        }
+
+        void resize(size_t size)
+        {
+            if (size > blocks_.size() * kCommandAlignment)
+                blocks_.resize(std::max(blocks_.size() * 2, size / kCommandAlignment));
+            size_ = size;
+        }
+
+        void clear()
+        {
+            size_ = 0;
+        }
+
+    private:
+        std::vector<Block> blocks_;
+        size_t size_ { 0 };
+    };
+
+    Buffer data_;
+    size_t command_count_ { 0 };
+};
+
+} // namespace se
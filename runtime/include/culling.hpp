@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "generics.h"
+#include "thread_pool.hpp"
+
+namespace se {
+
+// Axis-aligned rectangle in the pixel space of the vertex shaders: origin at
+// the viewport center, y up.
+struct CullRect {
+    float minX;
+    float minY;
+    float maxX;
+    float maxY;
+};
+
+// The part of that space a viewport of `viewport` pixels shows when centered
+// on `center`, grown by `margin` pixels on every side.
+inline CullRect viewportRect(vector_uint2 viewport, vector_float2 center = vector_float2 { 0, 0 }, float margin = 0)
+{
+    float half_width = float(viewport[0]) * 0.5f + margin;
+    float half_height = float(viewport[1]) * 0.5f + margin;
+    return { center[0] - half_width, center[1] - half_height, center[0] + half_width, center[1] + half_height };
+}
+
+// Bounds of many objects kept as structure of arrays, so the viewport test
+// runs on four objects per vector compare. Objects are identified by their
+// index, which callers map back to whatever they draw.
+class BoundsCuller {
+public:
+    uint32_t add(const CullRect& bounds);
+    void set(uint32_t index, const CullRect& bounds);
+    // New objects start out never visible.
+    void resize(size_t count);
+    void clear();
+
+    size_t size() const
+    {
+        return count_;
+    }
+
+    // Replaces `visible` with the indices of objects overlapping `view`, in
+    // ascending order, so draws built from it keep their submission order.
+    // Touching edges count as overlapping.
+    void cull(const CullRect& view, std::vector<uint32_t>& visible) const;
+
+    // Same result, with the objects split into chunks tested across `pool`.
+    void cull(const CullRect& view, std::vector<uint32_t>& visible, ThreadPool& pool) const;
+
+private:
+    static constexpr size_t kLanes = 4;
+    static constexpr size_t kChunk = 16384;
+
+    // Writes the visible indices of [begin, end) to `out`, returns how many.
+    size_t cullRange(const CullRect& view, size_t begin, size_t end, uint32_t* out) const;
+
+    // Padded to a multiple of kLanes with empty bounds that never pass.
+    std::vector<float> min_x_;
+    std::vector<float> min_y_;
+    std::vector<float> max_x_;
+    std::vector<float> max_y_;
+    size_t count_ { 0 };
+};
+
+} // namespace se
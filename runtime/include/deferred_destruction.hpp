@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <vector>
+
+namespace se {
+
+// Holds on to resources that command buffers may still be reading until the
+// frame that last used them has completed. Frames are numbered by the
+// backend in submission order; releases are batched per frame and run on the
+// thread that calls retire, which is the frame thread in every backend.
+class DeferredDestructionQueue {
+public:
+    DeferredDestructionQueue() = default;
+
+    // Runs the remaining releases; the owner must have waited for the GPU.
+    ~DeferredDestructionQueue()
+    {
+        retireAll();
+    }
+
+    DeferredDestructionQueue(const DeferredDestructionQueue&) = delete;
+    DeferredDestructionQueue& operator=(const DeferredDestructionQueue&) = delete;
+
+    // Runs `release` once `frame` has completed. Frames must not decrease
+    // between calls.
+    void enqueue(uint64_t frame, std::function<void()> release)
+    {
+        if (batches_.empty() || batches_.back().frame != frame)
+            batches_.push_back({ frame, {} });
+        batches_.back().releases.push_back(std::move(release));
+        ++pending_;
+    }
+
+    // Runs the releases of every frame up to and including `completedFrame`.
+    // Returns how many ran.
+    size_t retire(uint64_t completedFrame)
+    {
+        size_t retired = 0;
+        while (!batches_.empty() && batches_.front().frame <= completedFrame) {
+            // Popped first so releases may enqueue more work.
+            Batch batch = std::move(batches_.front());
+            batches_.pop_front();
+
+            for (std::function<void()>& release : batch.releases)
+                release();
+            retired += batch.releases.size();
+        }
+
+        pending_ -= retired;
+        return retired;
+    }
+
+    size_t retireAll()
+    {
+        return retire(UINT64_MAX);
+    }
+
+    size_t pending() const
+    {
+        return pending_;
+    }
+
+private:
+    struct Batch {
+        uint64_t frame;
+        std::vector<std::function<void()>> releases;
+    };
+
+    std::deque<Batch> batches_;
+    size_t pending_ { 0 };
+};
+
+// Turns per-frame completion callbacks, which may arrive late, twice or out
+// of order, into the newest frame whose predecessors have all completed.
+// That frame is what DeferredDestructionQueue::retire expects: a high-water
+// mark would release frame N's resources when frame N + 1 finishes first.
+// complete may be called from any thread. Frames are numbered from 1.
+class FrameCompletion {
+public:
+    void complete(uint64_t frame)
+    {
+        std::lock_guard lock(mutex_);
+        if (frame <= completed_through_)
+            return;
+        completed_.insert(frame);
+        while (!completed_.empty() && *completed_.begin() == completed_through_ + 1) {
+            completed_.erase(completed_.begin());
+            ++completed_through_;
+        }
+    }
+
+    uint64_t completedThrough() const
+    {
+        std::lock_guard lock(mutex_);
+        return completed_through_;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::set<uint64_t> completed_;
+    uint64_t completed_through_ { 0 };
+};
+
+} // namespace se
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+namespace se {
+
+struct DynamicResolutionSettings {
+    // Milliseconds per frame to stay within.
+    double targetFrameTime { 1000.0 / 60.0 };
+    float minScale { 0.5f };
+    float maxScale { 1.0f };
+    // Scales are multiples of `step`, so the intermediate target is only
+    // reallocated when the scale really changes.
+    float step { 0.05f };
+    // The scale is raised only after `raiseDelay` frames in a row came in
+    // under `raiseThreshold` of the target.
+    double raiseThreshold { 0.8 };
+    uint32_t raiseDelay { 60 };
+};
+
+// Chooses the render scale from recent frame times. Lowering is immediate
+// and sized from the measured overshoot, assuming cost grows with the pixel
+// count, i.e. the square of the scale. Raising goes one step at a time after
+// a stable stretch of cheap frames, so the scale does not oscillate around
+// the target. After every change the history restarts, since frames at the
+// old scale say little about the new one.
+//
+// Pure logic over the samples it is fed, so it can be driven by recorded or
+// synthetic frame-time traces.
+class DynamicResolutionController {
+public:
+    static constexpr size_t kHistory = 8;
+
+    explicit DynamicResolutionController(const DynamicResolutionSettings& settings = {})
+        : settings_(settings)
+        , scale_(settings.maxScale)
+    {
+    }
+
+    // Feeds the time of one frame in milliseconds and returns the scale for
+    // the next one.
+    float update(double frameTime)
+    {
+        history_[next_] = frameTime;
+        next_ = (next_ + 1) % kHistory;
+        count_ = std::min(count_ + 1, kHistory);
+
+        if (frameTime < settings_.targetFrameTime * settings_.raiseThreshold)
+            ++cheap_frames_;
+        else
+            cheap_frames_ = 0;
+
+        if (count_ < kHistory)
+            return scale_;
+
+        double average = 0;
+        for (double sample : history_)
+            average += sample;
+        average /= double(kHistory);
+
+        if (average > settings_.targetFrameTime) {
+            float ideal = scale_ * float(std::sqrt(settings_.targetFrameTime / average));
+            // At least one step down, or small overshoots would never resolve.
+            setScale(std::min(quantizeDown(ideal), scale_ - settings_.step));
+        } else if (cheap_frames_ >= settings_.raiseDelay) {
+            setScale(scale_ + settings_.step);
+        }
+
+        return scale_;
+    }
+
+    float scale() const
+    {
+        return scale_;
+    }
+
+    const DynamicResolutionSettings& settings() const
+    {
+        return settings_;
+    }
+
+    void reset()
+    {
+        scale_ = settings_.maxScale;
+        restart();
+    }
+
+private:
+    float quantizeDown(float scale) const
+    {
+        // The epsilon keeps exact multiples from dropping a step.
+        return std::floor(scale / settings_.step + 1e-3f) * settings_.step;
+    }
+
+    // Snaps to the nearest multiple of the step, so stepping from an
+    // unsnapped maxScale, or by a step float cannot represent exactly, does
+    // not drift off the grid.
+    void setScale(float scale)
+    {
+        scale = std::round(scale / settings_.step) * settings_.step;
+        scale = std::clamp(scale, settings_.minScale, settings_.maxScale);
+        if (scale == scale_)
+            return;
+
+        scale_ = scale;
+        restart();
+    }
+
+    void restart()
+    {
+        next_ = 0;
+        count_ = 0;
+        cheap_frames_ = 0;
+    }
+
+    DynamicResolutionSettings settings_;
+    float scale_;
+
+    std::array<double, kHistory> history_ {};
+    size_t next_ { 0 };
+    size_t count_ { 0 };
+    uint32_t cheap_frames_ { 0 };
+};
+
+} // namespace se
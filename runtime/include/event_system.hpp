@@ -6,6 +6,8 @@
 #include <unordered_map>
 #include <vector>
 
+#include "memory_tracker.hpp"
+
 namespace se {
 
 using Event = SDL_Event;
@@ -23,20 +25,30 @@ public:
 
 class EventSystem {
 public:
-    void processEvents()
+    // Returns the number of events polled.
+    size_t processEvents()
     {
+        MemoryScope scope(MemoryTag::Events);
         Event event;
+        size_t count = 0;
 
         while (SDL_PollEvent(&event) != 0) {
-            auto type = Events(event.type);
-
-            for (auto listner : listners_[type])
+            ++count;
+            // Looked up without inserting, so event types nobody listens to
+            // do not allocate.
+            auto listners = listners_.find(Events(event.type));
+            if (listners == listners_.end())
+                continue;
+
+            for (const auto& listner : listners->second)
                 listner->listen(event);
         }
+        return count;
     }
 
     void addListner(std::shared_ptr<EventListner> listner, Events event_type)
     {
+        MemoryScope scope(MemoryTag::Events);
         listners_[event_type].push_back(listner);
     }
 
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <mutex>
+#include <vector>
+
+namespace se {
+
+// Linear allocator for data that lives until the end of the frame. Every
+// thread bumps a pointer through a block of its own, so allocating takes
+// no lock and no heap call once the blocks of a frame have been handed out
+// before. reset() reclaims everything at once and keeps the blocks for the
+// next frame.
+//
+// reset() must not run concurrently with allocations. In DEBUG builds freed
+// memory is overwritten with 0xdd, resources made by resource() refuse to
+// allocate in a later frame, and under AddressSanitizer every access to
+// memory of a past frame is reported.
+class FrameArena {
+public:
+    static constexpr size_t kDefaultBlockSize = 256 * 1024;
+
+    explicit FrameArena(size_t blockSize = kDefaultBlockSize);
+    ~FrameArena();
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    template <typename T>
+    T* allocate(size_t count)
+    {
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    void reset();
+
+    // Counts resets; memory handed out belongs to the frame it was
+    // allocated in.
+    uint64_t frame() const
+    {
+        return frame_.load(std::memory_order_relaxed);
+    }
+
+    // Bytes of the blocks held, used or not.
+    size_t capacity() const;
+
+    // Heap allocations made for blocks since construction. Stays constant
+    // once frames stop growing.
+    uint64_t blockAllocations() const
+    {
+        return block_allocations_.load(std::memory_order_relaxed);
+    }
+
+private:
+    friend class FrameResource;
+
+    struct Block {
+        char* data;
+        size_t size;
+    };
+
+    Block acquire(size_t minimum);
+
+    const uint64_t id_;
+    const size_t block_size_;
+    std::atomic<uint64_t> frame_ { 0 };
+    std::atomic<uint64_t> block_allocations_ { 0 };
+
+    mutable std::mutex mutex_;
+    std::vector<Block> used_;
+    std::vector<Block> free_;
+    // Allocations bigger than a block, returned to the heap on reset.
+    std::vector<Block> large_;
+};
+
+// Lets std::pmr containers allocate from a FrameArena for the current frame.
+// Deallocation is a no-op; the memory comes back on the arena's reset.
+//
+//     FrameResource resource(arena);
+//     std::pmr::vector<Draw> draws(&resource);
+class FrameResource : public std::pmr::memory_resource {
+public:
+    explicit FrameResource(FrameArena& arena)
+        : arena_(arena)
+        , frame_(arena.frame())
+    {
+    }
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* pointer, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+
+    FrameArena& arena_;
+    uint64_t frame_;
+};
+
+} // namespace se
@@ -0,0 +1,201 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "image_writer.hpp"
+#include "logging.hpp"
+
+namespace se {
+
+enum class CaptureFormat {
+    Raw,
+    Png
+};
+
+struct CapturedFrame {
+    uint64_t frame { 0 };
+    uint32_t width { 0 };
+    uint32_t height { 0 };
+    // Set by backends whose read-back is in BGRA order; swizzled on the
+    // writer thread.
+    bool bgra { false };
+    // Tightly packed RGBA8 pixels, top row first.
+    std::vector<uint32_t> pixels;
+};
+
+// Writes captured frames to disk on a worker thread. Frames are read back
+// into a fixed pool of reusable buffers; when every buffer is still queued
+// the frame is dropped instead of stalling the frame loop.
+//
+// Backends hold on to the capture until the GPU has finished the frames
+// read back into it, so destruction first waits for every acquired buffer
+// to be submitted or released.
+class FrameCapture {
+public:
+    FrameCapture(std::string directory, CaptureFormat format, size_t buffers = 3)
+        : directory_(std::move(directory))
+        , format_(format)
+    {
+        for (size_t i = 0; i < buffers; ++i) {
+            frames_.push_back(std::make_unique<CapturedFrame>());
+            free_.push_back(frames_.back().get());
+        }
+
+        worker_ = std::thread([this]() { work(); });
+    }
+
+    ~FrameCapture()
+    {
+        flush();
+        {
+            std::unique_lock lock(mutex_);
+            stop_ = true;
+        }
+        queued_.notify_all();
+        worker_.join();
+    }
+
+    FrameCapture(const FrameCapture&) = delete;
+    FrameCapture& operator=(const FrameCapture&) = delete;
+
+    // Called by the backend on the frame thread. Returns nullptr and counts a
+    // dropped frame when no buffer is free.
+    CapturedFrame* acquire()
+    {
+        std::unique_lock lock(mutex_);
+
+        uint64_t frame = next_frame_++;
+        if (free_.empty()) {
+            ++dropped_;
+            return nullptr;
+        }
+
+        CapturedFrame* captured = free_.back();
+        free_.pop_back();
+        captured->frame = frame;
+        captured->bgra = false;
+        return captured;
+    }
+
+    // Queues a filled buffer for writing. May be called from any thread,
+    // including GPU completion handlers. Notifies under the lock: once the
+    // buffer is written the capture may be destroyed, and this call must
+    // not touch it after that.
+    void submit(CapturedFrame* captured)
+    {
+        std::unique_lock lock(mutex_);
+        pending_.push_back(captured);
+        queued_.notify_one();
+    }
+
+    // Returns a buffer without writing it, e.g. when read-back failed.
+    void release(CapturedFrame* captured)
+    {
+        std::unique_lock lock(mutex_);
+        free_.push_back(captured);
+        drained_.notify_all();
+    }
+
+    // Blocks until every acquired buffer has been written or released.
+    void flush()
+    {
+        std::unique_lock lock(mutex_);
+        drained_.wait(lock, [this]() { return free_.size() == frames_.size(); });
+    }
+
+    uint64_t framesWritten() const
+    {
+        std::unique_lock lock(mutex_);
+        return written_;
+    }
+
+    uint64_t framesDropped() const
+    {
+        std::unique_lock lock(mutex_);
+        return dropped_;
+    }
+
+private:
+    void work()
+    {
+        for (;;) {
+            CapturedFrame* captured = nullptr;
+            {
+                std::unique_lock lock(mutex_);
+                queued_.wait(lock, [this]() { return stop_ || !pending_.empty(); });
+                if (pending_.empty())
+                    return;
+
+                captured = pending_.front();
+                pending_.pop_front();
+            }
+
+            bool ok = write(*captured);
+
+            {
+                std::unique_lock lock(mutex_);
+                free_.push_back(captured);
+                if (ok)
+                    ++written_;
+            }
+            drained_.notify_all();
+        }
+    }
+
+    bool write(CapturedFrame& captured)
+    {
+        if (captured.bgra) {
+            for (uint32_t& pixel : captured.pixels)
+                pixel = (pixel & 0xff00ff00u) | ((pixel >> 16) & 0xffu) | ((pixel & 0xffu) << 16);
+            captured.bgra = false;
+        }
+
+        char name[64];
+        bool ok;
+
+        if (format_ == CaptureFormat::Png) {
+            std::snprintf(name, sizeof(name), "/frame_%06llu.png", (unsigned long long)captured.frame);
+            png_ = encodePng(captured.width, captured.height, captured.pixels.data(), captured.width);
+            ok = !png_.empty() && writeFile(directory_ + name, png_.data(), png_.size());
+        } else {
+            std::snprintf(name, sizeof(name), "/frame_%06llu_%ux%u.rgba",
+                (unsigned long long)captured.frame, captured.width, captured.height);
+            ok = writeFile(directory_ + name, captured.pixels.data(), captured.pixels.size() * sizeof(uint32_t));
+        }
+
+        if (!ok) {
+            ERROR("Failed to write captured frame");
+            return false;
+        }
+
+        return true;
+    }
+
+    std::string directory_;
+    CaptureFormat format_;
+
+    // Owned by the writer thread.
+    std::vector<uint8_t> png_;
+
+    std::vector<std::unique_ptr<CapturedFrame>> frames_;
+    std::vector<CapturedFrame*> free_;
+    std::deque<CapturedFrame*> pending_;
+    uint64_t next_frame_ { 0 };
+    uint64_t written_ { 0 };
+    uint64_t dropped_ { 0 };
+
+    mutable std::mutex mutex_;
+    std::condition_variable queued_;
+    std::condition_variable drained_;
+    bool stop_ { false };
+    std::thread worker_;
+};
+
+} // namespace se
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace se {
+
+// Runs the render stage of frame N on its own thread while the caller
+// simulates frame N + 1. The stages share nothing but two snapshots: the
+// caller extracts into back() what rendering needs from game state, and
+// present() hands it to the render stage, which reads it as const while
+// the caller fills the other one.
+//
+//     while (running) {
+//         simulate(world);
+//         extract(world, pipeline.back());
+//         pipeline.present();
+//     }
+//
+// Everything the render stage touches, the renderer included, must be used
+// from the render stage only while the pipeline runs.
+template <typename Snapshot>
+class FramePipeline {
+public:
+    using RenderStage = std::function<void(const Snapshot&)>;
+
+    explicit FramePipeline(RenderStage render)
+        : render_(std::move(render))
+        , thread_([this]() { work(); })
+    {
+    }
+
+    // Renders the frame in flight, if any, before returning.
+    ~FramePipeline()
+    {
+        {
+            std::unique_lock lock(mutex_);
+            idle_.wait(lock, [this]() { return !pending_; });
+            stop_ = true;
+        }
+        wake_.notify_one();
+        thread_.join();
+    }
+
+    FramePipeline(const FramePipeline&) = delete;
+    FramePipeline& operator=(const FramePipeline&) = delete;
+
+    // The snapshot for the next present(). Not read by the render stage, and
+    // still holding what was extracted into it two frames ago.
+    Snapshot& back()
+    {
+        return snapshots_[back_];
+    }
+
+    // Waits until the previous frame is rendered, then starts rendering
+    // back() and swaps the snapshots.
+    void present()
+    {
+        {
+            std::unique_lock lock(mutex_);
+            idle_.wait(lock, [this]() { return !pending_; });
+            front_ = back_;
+            back_ ^= 1;
+            pending_ = true;
+        }
+        wake_.notify_one();
+    }
+
+    // Waits until the frame in flight is rendered.
+    void finish()
+    {
+        std::unique_lock lock(mutex_);
+        idle_.wait(lock, [this]() { return !pending_; });
+    }
+
+private:
+    void work()
+    {
+        for (;;) {
+            size_t front;
+            {
+                std::unique_lock lock(mutex_);
+                wake_.wait(lock, [this]() { return stop_ || pending_; });
+                if (stop_)
+                    return;
+                front = front_;
+            }
+
+            render_(snapshots_[front]);
+
+            {
+                std::unique_lock lock(mutex_);
+                pending_ = false;
+            }
+            idle_.notify_all();
+        }
+    }
+
+    RenderStage render_;
+    std::array<Snapshot, 2> snapshots_ {};
+    size_t back_ { 0 };
+    size_t front_ { 1 };
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable idle_;
+    bool pending_ { false };
+    bool stop_ { false };
+
+    // Last, so it starts after everything it uses is constructed.
+    std::thread thread_;
+};
+
+} // namespace se
@@ -1,152 +1,417 @@
 #pragma once
 
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string_view>
 #include <vector>
 
-#include "game_window.hpp"
-
-#include <Foundation/Foundation.hpp>
-#include <Metal/Metal.hpp>
-#include <Metal/shared_ptr.hpp>
-#include <QuartzCore/QuartzCore.hpp>
+#include "async_compilation.hpp"
+#include "command_list.hpp"
+#include "culling.hpp"
+#include "dynamic_resolution.hpp"
+#include "frame_arena.hpp"
+#include "memory_tracker.hpp"
+#include "mesh_builder.hpp"
+#include "pipeline_cache.hpp"
+#include "render_backend.hpp"
+#include "render_types.hpp"
+#include "text_renderer.hpp"
+
+#ifdef __APPLE__
+#include "metal_render_backend.hpp"
+#endif
 
 namespace se {
-using GameLibraryId = uint64_t;
-using ShaderId = uint64_t;
-using PipelineId = uint64_t;
+
+class Scene;
+class Tilemap;
 
 class GameRenderer {
 public:
+    explicit GameRenderer(std::unique_ptr<RenderBackend> backend)
+        : backend_(std::move(backend))
+        , compilation_(*backend_, shader_cache_, pipeline_cache_)
+    {
+        MemoryScope scope(MemoryTag::Renderer);
+        viewport_ = backend_->viewport();
+        quad_indices_ = createQuadIndexBuffer(*backend_);
+    }
+
+#ifdef __APPLE__
     GameRenderer(GameWindow& window)
-        : window_(window)
+        : GameRenderer(std::make_unique<MetalRenderBackend>(window))
     {
-        renderer_ = SDL_CreateRenderer(window_.window, nullptr, SDL_RENDERER_PRESENTVSYNC);
-        if (!renderer_) {
-            FATAL("Failed to create renderer");
-        }
+    }
+#endif
 
-        swapchain_ = (CA::MetalLayer*)SDL_GetRenderMetalLayer(renderer_);
-        device_ = swapchain_->device();
-        command_queue_ = MTL::make_owned(device_->newCommandQueue());
+    GameLibraryId addLibrary(const void* library_data, size_t length)
+    {
+        MemoryScope scope(MemoryTag::Renderer);
+        return backend_->addLibrary(library_data, length);
+    }
 
-        viewport_ = window_.getViewport();
+    // Loading the same function twice returns the same shader, which keeps
+    // pipeline descriptions comparable. This holds across synchronous and
+    // asynchronous loads.
+    ShaderId loadShaderFromLibrary(GameLibraryId libraryId, const char* name)
+    {
+        MemoryScope scope(MemoryTag::Renderer);
+        return compilation_.loadShaderNow(libraryId, name);
     }
 
-    ~GameRenderer()
+    // Compiles on a background thread; the shader becomes ready during a
+    // later beginFrame.
+    AsyncShader loadShaderFromLibraryAsync(GameLibraryId libraryId, const char* name)
     {
-        SDL_DestroyRenderer(renderer_);
-        renderer_ = nullptr;
+        return compilation_.loadShader(libraryId, name);
     }
 
-    GameLibraryId addLibrary(dispatch_data_s* library_data)
+    PipelineId createPipeline(ShaderId vertexShader, ShaderId fragmentShader)
     {
-        NS::Error* err { nullptr };
+        return createPipeline(PipelineDesc { vertexShader, fragmentShader });
+    }
 
-        MTL::shared_ptr<MTL::Library> library = MTL::make_owned(device_->newLibrary(library_data, &err));
-        if (!library)
-            FATAL("Failed to load library");
+    // Waits for an asynchronous compile of the same description instead of
+    // creating a duplicate.
+    PipelineId createPipeline(const PipelineDesc& desc)
+    {
+        MemoryScope scope(MemoryTag::Renderer);
+        return compilation_.createPipelineNow(desc);
+    }
 
-        libraryes_.push_back({ library });
-        return libraryes_.size() - 1;
+    AsyncPipeline createPipelineAsync(AsyncShader vertexShader, AsyncShader fragmentShader, const PipelineDesc& desc = {})
+    {
+        return compilation_.createPipeline(std::move(vertexShader), std::move(fragmentShader), desc);
     }
 
-    ShaderId loadShaderFromLibrary(GameLibraryId libraryId, const char* name)
+    AsyncPipeline createPipelineAsync(const PipelineDesc& desc)
     {
-        NS::String* function_name = NS::String::string(name, NS::ASCIIStringEncoding);
-        MTL::shared_ptr<MTL::Function> function = MTL::make_owned(libraryes_[libraryId].library->newFunction(function_name));
+        return compilation_.createPipeline(desc);
+    }
 
-        shaders_.push_back({ function });
-        return shaders_.size() - 1;
+    // Used in place of pipelines that are still compiling. Without a fallback
+    // their draws are skipped.
+    void setFallbackPipeline(std::optional<PipelineId> pipeline)
+    {
+        fallback_pipeline_ = pipeline;
     }
 
-    PipelineId createPipeline(ShaderId vertexShader, ShaderId fragmentShader)
+    std::optional<PipelineId> resolve(const AsyncPipeline& pipeline) const
     {
-        NS::Error* err { nullptr };
+        if (pipeline.ready())
+            return pipeline.get();
+        return fallback_pipeline_;
+    }
 
-        MTL::shared_ptr<MTL::RenderPipelineDescriptor> pipeline_descriptor = MTL::make_owned(MTL::RenderPipelineDescriptor::alloc()->init());
-        pipeline_descriptor->setVertexFunction(shaders_[vertexShader].function.get());
-        pipeline_descriptor->setFragmentFunction(shaders_[fragmentShader].function.get());
+    // Blocks until all asynchronous compiles have been registered.
+    void finishCompilation()
+    {
+        compilation_.finish();
+    }
 
-        MTL::RenderPipelineColorAttachmentDescriptor* color_attachment_descriptor = pipeline_descriptor->colorAttachments()->object(0);
-        color_attachment_descriptor->setPixelFormat(swapchain_->pixelFormat());
+    const AsyncCompilationStats& compilationStats() const
+    {
+        return compilation_.stats();
+    }
 
-        MTL::shared_ptr<MTL::RenderPipelineState> pipeline = MTL::make_owned(device_->newRenderPipelineState(pipeline_descriptor.get(), &err));
+    // Ids of destroyed resources stop resolving: loading or creating the same
+    // thing again yields a new id, and draws with a stale pipeline are
+    // rejected by the backend.
+    // Shaders already loaded from the library stay usable, but are no
+    // longer returned for it by loadShaderFromLibrary.
+    void destroyLibrary(GameLibraryId libraryId)
+    {
+        compilation_.finishLibrary(libraryId);
+        shader_cache_.eraseLibrary(libraryId);
+        backend_->destroyLibrary(libraryId);
+    }
 
-        if (!pipeline)
-            FATAL("Failed to create pipeline");
+    void destroyShader(ShaderId shader)
+    {
+        shader_cache_.erase(shader);
+        backend_->destroyShader(shader);
+    }
 
-        pipelines_.push_back({ pipeline_descriptor, pipeline });
-        return pipelines_.size() - 1;
+    void destroyPipeline(PipelineId pipeline)
+    {
+        pipeline_cache_.erase(pipeline);
+        backend_->destroyPipeline(pipeline);
     }
 
-    void beginFrame()
+    TextureId createTexture(uint32_t width, uint32_t height)
     {
-        drawable_ = swapchain_->nextDrawable();
+        MemoryScope scope(MemoryTag::Renderer);
+        return backend_->createTexture(width, height);
+    }
+
+    void updateTexture(TextureId texture, uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+        const uint32_t* pixels, uint32_t stride)
+    {
+        backend_->updateTexture(texture, x, y, width, height, pixels, stride);
+    }
 
-        render_pass_ = MTL::make_owned(MTL::RenderPassDescriptor::renderPassDescriptor());
+    void destroyTexture(TextureId texture)
+    {
+        backend_->destroyTexture(texture);
+    }
+
+    BufferId createBuffer(const void* data, size_t length)
+    {
+        MemoryScope scope(MemoryTag::Renderer);
+        return backend_->createBuffer(data, length);
+    }
 
-        MTL::RenderPassColorAttachmentDescriptor* color_attachment = render_pass_->colorAttachments()->object(0);
-        color_attachment->setLoadAction(MTL::LoadAction::LoadActionClear);
-        color_attachment->setStoreAction(MTL::StoreAction::StoreActionStore);
-        color_attachment->setTexture(drawable_->texture());
+    void destroyBuffer(BufferId buffer)
+    {
+        backend_->destroyBuffer(buffer);
+    }
 
-        command_buffer_ = MTL::make_owned(command_queue_->commandBuffer());
+    template <typename Vertex>
+    Mesh createMesh(const MeshBuilder<Vertex>& builder)
+    {
+        MemoryScope scope(MemoryTag::Renderer);
+        return builder.upload(*backend_);
+    }
 
-        encoder_ = MTL::make_owned(command_buffer_->renderCommandEncoder(render_pass_.get()));
-        encoder_->setViewport(MTL::Viewport {
-            0.0, 0.0,
-            (double)viewport_[0], (double)viewport_[1],
-            0.0, 1.0 });
+    void destroyMesh(const Mesh& mesh)
+    {
+        backend_->destroyBuffer(mesh.vertexBuffer);
+        backend_->destroyBuffer(mesh.indexBuffer);
+    }
+
+    // Shared 16-bit indices for CommandList::drawQuads on worker lists.
+    BufferId quadIndexBuffer() const
+    {
+        return quad_indices_;
+    }
+
+    const PipelineCacheStats& pipelineCacheStats() const
+    {
+        return pipeline_cache_.stats();
+    }
+
+    size_t cachedShaders() const
+    {
+        return shader_cache_.size();
+    }
+
+    void beginFrame()
+    {
+        MemoryScope scope(MemoryTag::Renderer);
+        compilation_.pump();
+        backend_->beginFrame();
+        frame_arena_.reset();
+
+        immediate_.reset();
+        for (CommandList& list : command_lists_)
+            list.reset();
+        active_command_lists_ = 0;
+    }
+
+    // Scratch memory for the frame being recorded, reclaimed by the next
+    // beginFrame. Worker threads may allocate from it concurrently.
+    FrameArena& frameArena()
+    {
+        return frame_arena_;
+    }
+
+    // Returns `count` lists that worker threads may record into concurrently,
+    // one list per thread. Must be called from the frame thread between
+    // beginFrame and endFrame. Lists execute after the immediate draws, in
+    // index order, regardless of which thread finishes recording first.
+    std::span<CommandList> commandLists(size_t count)
+    {
+        if (command_lists_.size() < count)
+            command_lists_.resize(count);
+
+        active_command_lists_ = count;
+        return { command_lists_.data(), count };
     }
 
     void drawVertices(AAPLVertex* vertices, uint64_t length, PipelineId pipeline)
     {
-        encoder_->setRenderPipelineState(pipelines_[pipeline].pipeline.get());
+        immediate_.drawVertices(vertices, length, pipeline);
+    }
+
+    // `pipeline` must use VertexLayout::AAPLPackedVertex.
+    void drawVertices(const AAPLPackedVertex* vertices, uint64_t length, PipelineId pipeline)
+    {
+        immediate_.drawVertices(vertices, length, pipeline);
+    }
+
+    // Four vertices per quad; see CommandList::drawQuads.
+    template <typename Vertex>
+    void drawQuads(const Vertex* vertices, uint64_t quadCount, PipelineId pipeline)
+    {
+        immediate_.drawQuads(vertices, quadCount, pipeline, quad_indices_);
+    }
 
-        encoder_->setVertexBytes(&vertices[0], sizeof(AAPLVertex) * length, AAPLVertexInputIndexVertices);
-        encoder_->setVertexBytes(&viewport_, sizeof(viewport_), AAPLVertexInputIndexViewportSize);
+    template <typename Vertex>
+    void drawSpriteQuads(const Vertex* vertices, uint64_t quadCount, PipelineId pipeline, TextureId texture)
+    {
+        immediate_.drawSpriteQuads(vertices, quadCount, pipeline, texture, quad_indices_);
+    }
 
-        NS::UInteger vertex_start = 0, vertex_count = length;
-        encoder_->drawPrimitives(MTL::PrimitiveType::PrimitiveTypeTriangle, vertex_start, vertex_count);
+    void drawMesh(const Mesh& mesh, PipelineId pipeline)
+    {
+        immediate_.drawMesh(mesh, pipeline);
+    }
+
+    // Draws the part of `tilemap` the viewport shows when centered on
+    // `camera`; see Tilemap::draw. Defined in game_renderer.cpp, so only
+    // callers that draw tilemaps include tilemap.hpp.
+    void drawTilemap(Tilemap& tilemap, vector_float2 camera, PipelineId pipeline, TextureId tileset);
+
+    // Draws the sprites of `scene` the viewport shows when centered on
+    // `camera`; see Scene::draw. Out of line too, so only callers that draw
+    // scenes depend on EnTT.
+    void drawScene(Scene& scene, vector_float2 camera, PipelineId pipeline);
+
+    // Enables drawText. `pipeline` must be an alpha-blended sprite pipeline;
+    // see TextRenderer.
+    void enableText(PipelineId pipeline)
+    {
+        MemoryScope scope(MemoryTag::Renderer);
+        text_ = std::make_unique<TextRenderer>(*backend_, pipeline, quad_indices_, viewport_);
+    }
+
+    // Text is drawn after all other work of the frame, in call order.
+    void drawText(std::string_view text, float x, float y, vector_float4 color = vector_float4 { 1, 1, 1, 1 }, uint32_t scale = 1)
+    {
+        if (text_)
+            text_->drawText(text, x, y, color, scale);
+    }
+
+    void drawSprites(const AAPLSpriteVertex* vertices, uint64_t length, PipelineId pipeline, TextureId texture)
+    {
+        immediate_.drawSprites(vertices, length, pipeline, texture);
+    }
+
+    // The pipeline's vertex layout must match the vertex type.
+    void drawSprites(const AAPLPackedSpriteVertex* vertices, uint64_t length, PipelineId pipeline, TextureId texture)
+    {
+        immediate_.drawSprites(vertices, length, pipeline, texture);
+    }
+
+    void drawSprites(const AAPLHalfSpriteVertex* vertices, uint64_t length, PipelineId pipeline, TextureId texture)
+    {
+        immediate_.drawSprites(vertices, length, pipeline, texture);
+    }
+
+    void drawVertices(AAPLVertex* vertices, uint64_t length, const AsyncPipeline& pipeline)
+    {
+        if (std::optional<PipelineId> resolved = resolve(pipeline))
+            immediate_.drawVertices(vertices, length, *resolved);
     }
 
     void endFrame()
     {
-        encoder_->endEncoding();
+        MemoryScope scope(MemoryTag::Renderer);
+        submitted_.clear();
+        submitted_.push_back(&immediate_);
+        for (size_t i = 0; i < active_command_lists_; ++i)
+            submitted_.push_back(&command_lists_[i]);
+
+        if (text_) {
+            overlay_.reset();
+            text_->submit(overlay_);
+            submitted_.push_back(&overlay_);
+        }
 
-        command_buffer_->presentDrawable(drawable_);
-        command_buffer_->commit();
+        backend_->execute(submitted_);
+        backend_->endFrame();
 
-        drawable_->release();
+        if (resolution_)
+            updateRenderScale();
     }
 
-private:
-    struct GameLibrary {
-        MTL::shared_ptr<MTL::Library> library;
-    };
+    // Adjusts the render scale every frame to hold the target frame time;
+    // see DynamicResolutionController. Returns false when the backend cannot
+    // render at a reduced scale.
+    bool enableDynamicResolution(const DynamicResolutionSettings& settings = {})
+    {
+        if (!backend_->setRenderScale(settings.maxScale))
+            return false;
+
+        resolution_.emplace(settings);
+        last_frame_end_.reset();
+        return true;
+    }
+
+    void disableDynamicResolution()
+    {
+        if (resolution_)
+            backend_->setRenderScale(1.0f);
+        resolution_.reset();
+    }
+
+    float renderScale() const
+    {
+        return resolution_ ? resolution_->scale() : 1.0f;
+    }
+
+    // Captures the frame being recorded; see RenderBackend::requestCapture.
+    bool captureFrame(FrameCapture& capture)
+    {
+        return backend_->requestCapture(capture);
+    }
+
+    vector_uint2 viewport() const
+    {
+        return viewport_;
+    }
 
-    struct Shader {
-        MTL::shared_ptr<MTL::Function> function;
-    };
+    // What the viewport shows, for BoundsCuller; see viewportRect.
+    CullRect viewRect(vector_float2 center = vector_float2 { 0, 0 }, float margin = 0) const
+    {
+        return viewportRect(viewport_, center, margin);
+    }
 
-    struct Pipline {
-        MTL::shared_ptr<MTL::RenderPipelineDescriptor> descriptor;
-        MTL::shared_ptr<MTL::RenderPipelineState> pipeline;
-    };
+    RenderBackend& backend()
+    {
+        return *backend_;
+    }
 
-    GameWindow& window_;
+private:
+    // GPU time drives the controller when the backend reports it. Otherwise
+    // the time between frames is used, which also includes CPU work.
+    void updateRenderScale()
+    {
+        auto now = std::chrono::steady_clock::now();
+        std::optional<double> frame_time = backend_->gpuFrameTime();
+        if (!frame_time && last_frame_end_)
+            frame_time = std::chrono::duration<double, std::milli>(now - *last_frame_end_).count();
+        last_frame_end_ = now;
+
+        if (!frame_time)
+            return;
+
+        float scale = resolution_->scale();
+        if (resolution_->update(*frame_time) != scale)
+            backend_->setRenderScale(resolution_->scale());
+    }
+
+    std::unique_ptr<RenderBackend> backend_;
     vector_uint2 viewport_;
+    BufferId quad_indices_;
+
+    ShaderCache shader_cache_;
+    PipelineCache pipeline_cache_;
+    std::optional<PipelineId> fallback_pipeline_;
+    AsyncCompilation compilation_;
+
+    CommandList immediate_;
+    std::vector<CommandList> command_lists_;
+    size_t active_command_lists_ { 0 };
+    std::vector<const CommandList*> submitted_;
+    FrameArena frame_arena_;
+
+    std::unique_ptr<TextRenderer> text_;
+    CommandList overlay_;
 
-    SDL_Renderer* renderer_ { nullptr };
-    CA::MetalLayer* swapchain_ { nullptr };
-    MTL::Device* device_ { nullptr };
-    MTL::shared_ptr<MTL::CommandQueue> command_queue_;
-    MTL::shared_ptr<MTL::CommandBuffer> command_buffer_;
-    MTL::shared_ptr<MTL::RenderPassDescriptor> render_pass_;
-    MTL::shared_ptr<MTL::RenderCommandEncoder> encoder_;
-    CA::MetalDrawable* drawable_;
-
-    std::vector<GameLibrary> libraryes_;
-    std::vector<Shader> shaders_;
-    std::vector<Pipline> pipelines_;
+    std::optional<DynamicResolutionController> resolution_;
+    std::optional<std::chrono::steady_clock::time_point> last_frame_end_;
 };
 } // namespace se
@@ -4,17 +4,12 @@
 
 #include "generics.h"
 
-#include <Foundation/Foundation.hpp>
-#include <Metal/Metal.hpp>
-#include <Metal/shared_ptr.hpp>
-#include <QuartzCore/QuartzCore.hpp>
-
 #include <SDL3/SDL.h>
 #include <fmt/format.h>
 
 namespace se {
 
-class GameRenderer;
+class MetalRenderBackend;
 
 class GameWindow {
 public:
@@ -69,7 +64,7 @@ public:
         return { (uint32_t)x, (uint32_t)y };
     }
 
-    friend class GameRenderer;
+    friend class MetalRenderBackend;
 
 private:
     SDL_Window* window { nullptr };
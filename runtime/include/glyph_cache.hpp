@@ -0,0 +1,188 @@
+#pragma once
+
+#include <array>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include "bitmap_font.hpp"
+#include "texture_atlas.hpp"
+
+namespace se {
+
+struct Glyph {
+    // Normalized (u0, v0, u1, v1) in the cache's atlas page.
+    vector_float4 uv;
+    uint32_t width;
+    uint32_t height;
+};
+
+struct GlyphCacheStats {
+    uint64_t hits { 0 };
+    uint64_t misses { 0 };
+    uint64_t evictions { 0 };
+};
+
+// Rasterizes glyphs of the built-in font into a single atlas page on first
+// use, so all text can be drawn with one texture. When the page is full the
+// glyph used least recently is evicted; glyphs used in the current frame
+// are never evicted, since quads referencing them are already recorded.
+class GlyphCache {
+public:
+    static constexpr uint32_t kMaxScale = 8;
+
+    explicit GlyphCache(RenderBackend& backend, uint32_t pageSize = 512)
+        : atlas_(backend, pageSize, 1)
+    {
+        fast_.fill({});
+    }
+
+    GlyphCache(const GlyphCache&) = delete;
+    GlyphCache& operator=(const GlyphCache&) = delete;
+
+    // Returns nullptr when the glyph cannot be cached because every cached
+    // glyph is in use this frame. Characters missing from the font map to '?'.
+    // `scale` is clamped to [1, kMaxScale].
+    const Glyph* glyph(uint32_t codepoint, uint32_t scale)
+    {
+        if (codepoint < kFastCodepoints && scale - 1 < kMaxScale) {
+            if (Entry* entry = fast_[scale - 1][codepoint]) {
+                touch(*entry);
+                return &entry->glyph;
+            }
+        }
+        return lookup(codepoint, scale);
+    }
+
+    // Starts a new frame for the purpose of eviction.
+    void nextFrame()
+    {
+        ++frame_;
+    }
+
+    // Uploads glyphs rasterized since the last call.
+    void upload()
+    {
+        atlas_.upload();
+    }
+
+    // Invalid until the first glyph has been cached.
+    TextureId texture() const
+    {
+        return atlas_.pageCount() > 0 ? atlas_.pageTexture(0) : TextureId {};
+    }
+
+    size_t size() const
+    {
+        return entries_.size();
+    }
+
+    const GlyphCacheStats& stats() const
+    {
+        return stats_;
+    }
+
+private:
+    static constexpr uint32_t kFastCodepoints = 128;
+
+    struct Entry {
+        Glyph glyph;
+        uint64_t key;
+        AtlasEntryId atlasEntry;
+        uint64_t lastUsedFrame;
+        std::list<Entry*>::iterator lru;
+    };
+
+    static uint64_t makeKey(uint32_t codepoint, uint32_t scale)
+    {
+        return (uint64_t(scale) << 32) | codepoint;
+    }
+
+    // Moves the entry to the front of the LRU list once per frame.
+    void touch(Entry& entry)
+    {
+        ++stats_.hits;
+        if (entry.lastUsedFrame == frame_)
+            return;
+
+        entry.lastUsedFrame = frame_;
+        lru_.splice(lru_.begin(), lru_, entry.lru);
+    }
+
+    const Glyph* lookup(uint32_t codepoint, uint32_t scale)
+    {
+        scale = std::clamp(scale, 1u, kMaxScale);
+        if (!bitmapFontGlyph(codepoint))
+            codepoint = '?';
+
+        auto iter = entries_.find(makeKey(codepoint, scale));
+        if (iter != entries_.end()) {
+            touch(iter->second);
+            return &iter->second.glyph;
+        }
+
+        ++stats_.misses;
+        Entry* entry = rasterize(codepoint, scale);
+        if (entry && codepoint < kFastCodepoints)
+            fast_[scale - 1][codepoint] = entry;
+        return entry ? &entry->glyph : nullptr;
+    }
+
+    Entry* rasterize(uint32_t codepoint, uint32_t scale)
+    {
+        const uint8_t* rows = bitmapFontGlyph(codepoint);
+        uint32_t size = kBitmapFontSize * scale;
+
+        pixels_.assign(size_t(size) * size, 0);
+        for (uint32_t y = 0; y < size; ++y) {
+            uint8_t row = rows[y / scale];
+            for (uint32_t x = 0; x < size; ++x) {
+                if (row & (1u << (x / scale)))
+                    pixels_[size_t(y) * size + x] = 0xffffffff;
+            }
+        }
+
+        AtlasEntryId atlas_entry;
+        while (!(atlas_entry = atlas_.insert(size, size, pixels_.data(), size)).valid()) {
+            if (lru_.empty() || lru_.back()->lastUsedFrame == frame_)
+                return nullptr;
+            evict(*lru_.back());
+        }
+
+        uint64_t key = makeKey(codepoint, scale);
+        Entry& entry = entries_[key];
+        const AtlasRegion* region = atlas_.region(atlas_entry);
+        entry.glyph = { region->uv, region->width, region->height };
+        entry.key = key;
+        entry.atlasEntry = atlas_entry;
+        entry.lastUsedFrame = frame_;
+        lru_.push_front(&entry);
+        entry.lru = lru_.begin();
+        return &entry;
+    }
+
+    void evict(Entry& entry)
+    {
+        uint32_t codepoint = uint32_t(entry.key);
+        uint32_t scale = uint32_t(entry.key >> 32);
+        if (codepoint < kFastCodepoints)
+            fast_[scale - 1][codepoint] = nullptr;
+
+        atlas_.remove(entry.atlasEntry);
+        lru_.erase(entry.lru);
+        entries_.erase(entry.key);
+        ++stats_.evictions;
+    }
+
+    TextureAtlas atlas_;
+    // Node-based, so entries keep their address while the map grows.
+    std::unordered_map<uint64_t, Entry> entries_;
+    // Most recently used first.
+    std::list<Entry*> lru_;
+    std::array<std::array<Entry*, kFastCodepoints>, kMaxScale> fast_;
+    std::vector<uint32_t> pixels_;
+    uint64_t frame_ { 0 };
+    GlyphCacheStats stats_;
+};
+
+} // namespace se
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace se {
+
+// Encodes RGBA8 pixels as a PNG. Rows are `stride` pixels apart. The image
+// data is stored without compression, which keeps encoding cheap enough for
+// capturing every frame. Returns nothing when either size is 0.
+std::vector<uint8_t> encodePng(uint32_t width, uint32_t height, const uint32_t* pixels, uint32_t stride);
+
+bool writeFile(const std::string& path, const void* data, size_t length);
+
+} // namespace se
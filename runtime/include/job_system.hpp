@@ -0,0 +1,210 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "work_stealing_deque.hpp"
+
+namespace se {
+
+// A unit of work with a counter of itself plus its unfinished children. A
+// job is finished once its function returned and all its children are
+// finished. Jobs stay valid until JobSystem::kJobsPerThread more jobs were
+// created on the same thread.
+class alignas(64) Job {
+public:
+    bool finished() const
+    {
+        return unfinished_.load(std::memory_order_acquire) == 0;
+    }
+
+private:
+    friend class JobSystem;
+
+    static constexpr size_t kDataSize = 96;
+
+    void (*function_)(Job&) { nullptr };
+    Job* parent_ { nullptr };
+    std::atomic<int32_t> unfinished_ { 0 };
+    alignas(16) unsigned char data_[kDataSize];
+};
+
+static_assert(sizeof(Job) == 128);
+
+struct JobSystemStats {
+    uint64_t spawned { 0 };
+    uint64_t executed { 0 };
+    uint64_t steals { 0 };
+    uint64_t failedSteals { 0 };
+    // Jobs taken from the heap because the ring slot was still in use.
+    uint64_t overflowJobs { 0 };
+};
+
+// Work-stealing scheduler. Every thread has its own Chase-Lev deque: it
+// runs its newest jobs first, while idle threads steal the oldest jobs of
+// others, which in divide-and-conquer work are the biggest ones. Waiting
+// for a job runs other jobs meanwhile instead of blocking the thread.
+//
+// The thread that constructs the system takes part as thread 0; jobs may
+// be created, run and waited for on it and inside jobs only.
+//
+// Each thread creates its jobs in a ring of kJobsPerThread slots and queues
+// at most that many. Up to kJobsPerThread unfinished jobs per thread cost no
+// allocation. Past that, e.g. when a loop spawns more children than that
+// before waiting for their parent, creating a job first runs queued jobs
+// the way wait() does, and if its slot is still taken, allocates the job
+// on the heap. Queuing a job while the queue is full runs it right away.
+class JobSystem {
+public:
+    static constexpr size_t kJobsPerThread = 4096;
+
+    explicit JobSystem(size_t threads = std::thread::hardware_concurrency());
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // `fn` is stored in the job, so it must be small and trivially
+    // copyable: capture pointers and references rather than containers.
+    template <typename Fn>
+    Job* create(Fn&& fn)
+    {
+        return createChild(nullptr, std::forward<Fn>(fn));
+    }
+
+    // `parent`, unless null, is finished only after the new job is.
+    template <typename Fn>
+    Job* createChild(Job* parent, Fn&& fn)
+    {
+        using Function = std::decay_t<Fn>;
+        static_assert(sizeof(Function) <= Job::kDataSize, "Job function too large");
+        static_assert(alignof(Function) <= 16, "Job function overaligned");
+        static_assert(std::is_trivially_copyable_v<Function>, "Job function must be trivially copyable");
+
+        Job* job = allocate(parent);
+        new (job->data_) Function(std::forward<Fn>(fn));
+        job->function_ = [](Job& job) {
+            (*std::launder(reinterpret_cast<Function*>(job.data_)))();
+        };
+        return job;
+    }
+
+    // Queues `job` on the calling thread.
+    void run(Job* job);
+
+    // Runs jobs until `job` is finished.
+    void wait(const Job* job);
+
+    // Calls `fn(first, last)` over disjoint chunks covering [begin, end) and
+    // returns once all calls have finished. Ranges are split in halves, and
+    // a half is only split off while the splitting thread has no queued work
+    // of its own, i.e. while other threads are out of work to steal. So
+    // balanced loops run in few large chunks and unbalanced ones subdivide
+    // down to `grain` items. A `grain` of 0 picks one from the range size.
+    template <typename Fn>
+    void parallelFor(size_t begin, size_t end, Fn&& fn, size_t grain = 0)
+    {
+        if (begin >= end)
+            return;
+
+        if (threadCount() == 1) {
+            fn(begin, end);
+            return;
+        }
+
+        if (grain == 0)
+            grain = std::max<size_t>(1, (end - begin) / (threadCount() * kChunksPerThread));
+
+        // Every chunk is a child of `root`, which does nothing itself.
+        Job* root = create([]() {});
+        run(createRange(root, begin, end, grain, &fn));
+        run(root);
+        wait(root);
+    }
+
+    size_t threadCount() const
+    {
+        return workers_.size();
+    }
+
+    // Totals over all threads; approximate while jobs are running.
+    JobSystemStats stats() const;
+    void resetStats();
+
+private:
+    struct Worker {
+        explicit Worker(size_t index);
+
+        size_t index;
+        WorkStealingDeque<Job> queue;
+        std::unique_ptr<Job[]> jobs;
+        size_t next_job { 0 };
+        uint64_t random;
+
+        std::atomic<uint64_t> spawned { 0 };
+        std::atomic<uint64_t> executed { 0 };
+        std::atomic<uint64_t> steals { 0 };
+        std::atomic<uint64_t> failed_steals { 0 };
+        std::atomic<uint64_t> overflow_jobs { 0 };
+
+        // Jobs created so far, and the heap jobs created when the ring slot
+        // was taken, oldest first, with the value of `created` at the time.
+        uint64_t created { 0 };
+        std::deque<std::pair<uint64_t, std::unique_ptr<Job>>> overflow;
+    };
+
+    static constexpr size_t kChunksPerThread = 16;
+
+    template <typename Fn>
+    Job* createRange(Job* parent, size_t begin, size_t end, size_t grain, Fn* fn)
+    {
+        return createChild(parent, [this, parent, begin, end, grain, fn]() {
+            size_t first = begin;
+            size_t last = end;
+            while (first < last) {
+                if (last - first > grain && queueEmpty()) {
+                    size_t middle = first + (last - first) / 2;
+                    run(createRange(parent, middle, last, grain, fn));
+                    last = middle;
+                    continue;
+                }
+
+                size_t stop = std::min(last, first + grain);
+                (*fn)(first, stop);
+                first = stop;
+            }
+        });
+    }
+
+    Job* allocate(Job* parent);
+    Job* allocateOverflow(Worker& worker);
+    Worker& worker();
+    bool queueEmpty();
+
+    Job* find(Worker& worker);
+    void execute(Worker& worker, Job& job);
+    void finish(Job* job);
+    void work(Worker& worker);
+    void sleep();
+    bool hasQueuedJobs() const;
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::vector<std::thread> threads_;
+
+    std::atomic<bool> stop_ { false };
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+    std::atomic<uint32_t> sleeping_ { 0 };
+};
+
+} // namespace se
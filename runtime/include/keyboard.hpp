@@ -3,6 +3,7 @@
 #include <unordered_set>
 
 #include "event_system.hpp"
+#include "object_pool.hpp"
 
 #include <SDL3/SDL.h>
 
@@ -14,7 +15,7 @@ class Keyboard {
 public:
     explicit Keyboard(EventSystem& eventSystem)
     {
-        auto listner = std::make_shared<KeyboardListner>(*this);
+        auto listner = makePooled<KeyboardListner>(*this);
         eventSystem.addListner(listner, Events::KeyDown);
         eventSystem.addListner(listner, Events::KeyUp);
     }
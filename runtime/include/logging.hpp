@@ -20,7 +20,7 @@ public:
 private:
     std::mutex mutex;
 
-    std::string prefix(Severity severity);
+    std::string_view prefix(Severity severity);
     void log(Severity severity, std::string_view msg);
 };
 
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace se {
+
+// Subsystems heap allocations are attributed to.
+enum class MemoryTag : uint8_t {
+    Untagged,
+    Renderer,
+    Events,
+    Scene,
+    Jobs,
+    Game,
+    Count
+};
+
+std::string_view memoryTagName(MemoryTag tag);
+
+struct MemoryTagStats {
+    uint64_t liveBytes { 0 };
+    uint64_t peakBytes { 0 };
+    uint64_t liveAllocations { 0 };
+    uint64_t totalAllocations { 0 };
+    // Since the last MemoryTracker::endFrame.
+    uint64_t frameAllocations { 0 };
+    uint64_t frameBytes { 0 };
+    // 0 when the tag has no budget.
+    uint64_t budget { 0 };
+    // Allocations that left the tag above its budget.
+    uint64_t overruns { 0 };
+};
+
+struct FrameMemoryStats {
+    uint64_t allocations { 0 };
+    uint64_t bytes { 0 };
+};
+
+// Attributes the heap allocations of the calling thread to `tag` until the
+// scope ends. Scopes nest.
+class MemoryScope {
+public:
+    explicit MemoryScope(MemoryTag tag);
+    ~MemoryScope();
+
+    MemoryScope(const MemoryScope&) = delete;
+    MemoryScope& operator=(const MemoryScope&) = delete;
+
+private:
+    MemoryTag previous_;
+};
+
+// Counts heap allocations per tag through replacements of the global
+// operator new and delete. Opt-in: the replacements and counters exist only
+// when the runtime is built with SE_TRACK_ALLOCATIONS (the CMake option of
+// the same name); otherwise every stat stays zero and scopes cost a
+// thread-local store.
+//
+// Each allocation carries a 16-byte header with its size and tag and costs
+// three relaxed atomic adds on the counters of its tag, a free two.
+class MemoryTracker {
+public:
+    static constexpr bool enabled()
+    {
+#ifdef SE_TRACK_ALLOCATIONS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    static MemoryTagStats stats(MemoryTag tag);
+
+    // Live bytes above which allocations of `tag` count as overruns; 0
+    // removes the budget.
+    static void setBudget(MemoryTag tag, uint64_t bytes);
+
+    // Returns what all tags allocated since the last call and starts a new
+    // frame. Tags that went over budget during the frame are reported.
+    static FrameMemoryStats endFrame();
+
+    static MemoryTag currentTag();
+};
+
+} // namespace se
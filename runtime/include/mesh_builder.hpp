@@ -0,0 +1,216 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <tuple>
+#include <vector>
+
+#include "command_list.hpp"
+#include "generics.h"
+#include "render_backend.hpp"
+
+namespace se {
+
+// Fields that identify a vertex when welding. Padding is left out, so equal
+// vertices weld regardless of what their padding bytes hold.
+inline auto weldFields(const AAPLVertex& vertex)
+{
+    return std::tie(vertex.position, vertex.color);
+}
+
+inline auto weldFields(const AAPLSpriteVertex& vertex)
+{
+    return std::tie(vertex.position, vertex.uv, vertex.color);
+}
+
+inline auto weldFields(const AAPLPackedVertex& vertex)
+{
+    return std::tie(vertex.position, vertex.color);
+}
+
+inline auto weldFields(const AAPLPackedSpriteVertex& vertex)
+{
+    return std::tie(vertex.position, vertex.uv, vertex.color);
+}
+
+inline auto weldFields(const AAPLHalfSpriteVertex& vertex)
+{
+    return std::tie(vertex.position, vertex.uv, vertex.color);
+}
+
+// Indices of `quadCount` quads in the corner order CommandList::drawQuads
+// expects. At most 16384 quads fit 16-bit indices.
+inline std::vector<uint16_t> quadIndices(uint32_t quadCount)
+{
+    std::vector<uint16_t> indices(size_t(quadCount) * 6);
+    for (uint32_t quad = 0; quad < quadCount; ++quad) {
+        uint16_t first = uint16_t(quad * 4);
+        uint16_t* out = &indices[size_t(quad) * 6];
+        out[0] = first;
+        out[1] = first + 1;
+        out[2] = first + 2;
+        out[3] = first + 2;
+        out[4] = first + 1;
+        out[5] = first + 3;
+    }
+    return indices;
+}
+
+inline BufferId createQuadIndexBuffer(RenderBackend& backend)
+{
+    std::vector<uint16_t> indices = quadIndices(CommandList::kMaxQuadsPerDraw);
+    return backend.createBuffer(indices.data(), indices.size() * sizeof(uint16_t));
+}
+
+// Builds indexed triangle lists, welding vertices whose fields are bitwise
+// equal into one. Vertices are found through an open-addressing hash table
+// of indices into the vertex array, so each add costs one hash and usually
+// one comparison.
+template <typename Vertex>
+class MeshBuilder {
+public:
+    // Returns the index of an equal vertex added before, or of the new one.
+    uint32_t addVertex(const Vertex& vertex)
+    {
+        if ((vertices_.size() + 1) * 2 > table_.size())
+            rehash(std::max<size_t>(table_.size() * 2, 64));
+
+        size_t mask = table_.size() - 1;
+        for (size_t slot = hashVertex(vertex) & mask;; slot = (slot + 1) & mask) {
+            uint32_t index = table_[slot];
+            if (index == kEmpty) {
+                index = uint32_t(vertices_.size());
+                table_[slot] = index;
+                vertices_.push_back(vertex);
+                return index;
+            }
+            if (equal(vertices_[index], vertex)) {
+                ++welded_;
+                return index;
+            }
+        }
+    }
+
+    void addTriangle(const Vertex& a, const Vertex& b, const Vertex& c)
+    {
+        indices_.push_back(addVertex(a));
+        indices_.push_back(addVertex(b));
+        indices_.push_back(addVertex(c));
+    }
+
+    void addQuad(const Vertex& topLeft, const Vertex& topRight, const Vertex& bottomLeft, const Vertex& bottomRight)
+    {
+        addTriangle(topLeft, topRight, bottomLeft);
+        addTriangle(bottomLeft, topRight, bottomRight);
+    }
+
+    const std::vector<Vertex>& vertices() const
+    {
+        return vertices_;
+    }
+
+    const std::vector<uint32_t>& indices() const
+    {
+        return indices_;
+    }
+
+    // Vertices that were merged into an earlier one.
+    size_t weldedCount() const
+    {
+        return welded_;
+    }
+
+    IndexType indexType() const
+    {
+        return vertices_.size() <= 0x10000 ? IndexType::UInt16 : IndexType::UInt32;
+    }
+
+    // Indices encoded as indexType().
+    std::vector<uint8_t> indexBytes() const
+    {
+        std::vector<uint8_t> bytes(indices_.size() * indexSize(indexType()));
+        if (indexType() == IndexType::UInt32) {
+            std::memcpy(bytes.data(), indices_.data(), bytes.size());
+            return bytes;
+        }
+
+        for (size_t i = 0; i < indices_.size(); ++i) {
+            uint16_t index = uint16_t(indices_[i]);
+            std::memcpy(&bytes[i * sizeof(uint16_t)], &index, sizeof(index));
+        }
+        return bytes;
+    }
+
+    // Uploads the mesh into new backend buffers, which the caller destroys.
+    // An empty mesh gets invalid buffers and an index count of 0.
+    Mesh upload(RenderBackend& backend) const
+    {
+        std::vector<uint8_t> index_bytes = indexBytes();
+
+        Mesh mesh;
+        mesh.vertexBuffer = backend.createBuffer(vertices_.data(), vertices_.size() * sizeof(Vertex));
+        mesh.indexBuffer = backend.createBuffer(index_bytes.data(), index_bytes.size());
+        mesh.indexType = indexType();
+        mesh.indexCount = uint32_t(indices_.size());
+        return mesh;
+    }
+
+    void clear()
+    {
+        vertices_.clear();
+        indices_.clear();
+        std::fill(table_.begin(), table_.end(), kEmpty);
+        welded_ = 0;
+    }
+
+private:
+    static constexpr uint32_t kEmpty = ~0u;
+
+    static uint64_t hashVertex(const Vertex& vertex)
+    {
+        // FNV-1a over the field bytes.
+        uint64_t hash = 0xcbf29ce484222325ull;
+        std::apply([&](const auto&... field) {
+            (hashBytes(hash, &field, sizeof(field)), ...);
+        },
+            weldFields(vertex));
+        return hash ^ (hash >> 32);
+    }
+
+    static void hashBytes(uint64_t& hash, const void* data, size_t length)
+    {
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < length; ++i)
+            hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+    }
+
+    static bool equal(const Vertex& a, const Vertex& b)
+    {
+        return std::apply([&](const auto&... a_fields) {
+            return std::apply([&](const auto&... b_fields) {
+                return ((std::memcmp(&a_fields, &b_fields, sizeof(a_fields)) == 0) && ...);
+            },
+                weldFields(b));
+        },
+            weldFields(a));
+    }
+
+    void rehash(size_t size)
+    {
+        table_.assign(size, kEmpty);
+        size_t mask = size - 1;
+        for (uint32_t index = 0; index < vertices_.size(); ++index) {
+            size_t slot = hashVertex(vertices_[index]) & mask;
+            while (table_[slot] != kEmpty)
+                slot = (slot + 1) & mask;
+            table_[slot] = index;
+        }
+    }
+
+    std::vector<Vertex> vertices_;
+    std::vector<uint32_t> indices_;
+    std::vector<uint32_t> table_;
+    size_t welded_ { 0 };
+};
+
+} // namespace se
@@ -0,0 +1,743 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "deferred_destruction.hpp"
+#include "game_window.hpp"
+#include "render_backend.hpp"
+#include "thread_pool.hpp"
+
+#include <Foundation/Foundation.hpp>
+#include <Metal/Metal.hpp>
+#include <Metal/shared_ptr.hpp>
+#include <QuartzCore/QuartzCore.hpp>
+
+namespace se {
+
+namespace detail {
+
+    // Built at runtime, since the backend cannot rely on the game's library.
+    // Draws one triangle covering the target and samples the scaled frame.
+    constexpr const char* kUpscaleShaderSource = R"(
+#include <metal_stdlib>
+using namespace metal;
+
+struct UpscaleRasterizerData
+{
+    float4 position [[position]];
+    float2 uv;
+};
+
+vertex UpscaleRasterizerData upscaleVertexShader(uint vertexID [[vertex_id]])
+{
+    UpscaleRasterizerData out;
+    out.uv = float2((vertexID << 1) & 2, vertexID & 2);
+    out.position = float4(out.uv * float2(2.0, -2.0) + float2(-1.0, 1.0), 0.0, 1.0);
+    return out;
+}
+
+fragment float4 upscaleFragmentShader(UpscaleRasterizerData in [[stage_in]],
+                                      texture2d<float> source [[texture(0)]])
+{
+    constexpr sampler linearSampler(mag_filter::linear, min_filter::linear);
+    return source.sample(linearSampler, in.uv);
+}
+)";
+
+} // namespace detail
+
+class MetalRenderBackend : public RenderBackend {
+public:
+    MetalRenderBackend(GameWindow& window)
+    {
+        renderer_ = SDL_CreateRenderer(window.window, nullptr, SDL_RENDERER_PRESENTVSYNC);
+        if (!renderer_) {
+            FATAL("Failed to create renderer");
+        }
+
+        swapchain_ = (CA::MetalLayer*)SDL_GetRenderMetalLayer(renderer_);
+        device_ = swapchain_->device();
+        command_queue_ = MTL::make_owned(device_->newCommandQueue());
+
+        pixel_format_ = swapchain_->pixelFormat();
+        viewport_ = window.getViewport();
+    }
+
+    // Offscreen mode: renders into a private texture of `size` pixels on the
+    // default device, without a window or swapchain.
+    explicit MetalRenderBackend(vector_uint2 size)
+    {
+        device_ = MTL::CreateSystemDefaultDevice();
+        if (!device_) {
+            FATAL("No Metal device available");
+        }
+        owned_device_ = MTL::make_owned(device_);
+        command_queue_ = MTL::make_owned(device_->newCommandQueue());
+
+        pixel_format_ = MTL::PixelFormat::PixelFormatBGRA8Unorm;
+        viewport_ = size;
+
+        MTL::TextureDescriptor* descriptor = MTL::TextureDescriptor::texture2DDescriptor(
+            pixel_format_, viewport_[0], viewport_[1], false);
+        descriptor->setUsage(MTL::TextureUsageRenderTarget | MTL::TextureUsageShaderRead);
+        descriptor->setStorageMode(MTL::StorageModePrivate);
+        offscreen_target_ = MTL::make_owned(device_->newTexture(descriptor));
+    }
+
+    ~MetalRenderBackend()
+    {
+        // Read-back completion handlers reference this backend's buffers.
+        if (command_buffer_)
+            command_buffer_->waitUntilCompleted();
+        deferred_.retireAll();
+
+        if (renderer_)
+            SDL_DestroyRenderer(renderer_);
+        renderer_ = nullptr;
+    }
+
+    GameLibraryId addLibrary(const void* data, size_t length) override
+    {
+        NS::Error* err { nullptr };
+
+        dispatch_data_t library_data = dispatch_data_create(data, length,
+            dispatch_get_main_queue(), DISPATCH_DATA_DESTRUCTOR_DEFAULT);
+        MTL::shared_ptr<MTL::Library> library = MTL::make_owned(device_->newLibrary(library_data, &err));
+        dispatch_release(library_data);
+
+        if (!library)
+            FATAL("Failed to load library");
+
+        std::unique_lock lock(resources_mutex_);
+        return libraryes_.insert({ library });
+    }
+
+    void destroyLibrary(GameLibraryId libraryId) override
+    {
+        destroyDeferred(libraryes_, libraryId);
+    }
+
+    std::unique_ptr<CompiledObject> compileShader(GameLibraryId libraryId, const char* name) override
+    {
+        MTL::shared_ptr<MTL::Library> library;
+        {
+            std::shared_lock lock(resources_mutex_);
+            if (const GameLibrary* game_library = libraryes_.get(libraryId))
+                library = game_library->library;
+        }
+
+        if (!library)
+            FATAL("Unknown library");
+
+        // Worker threads have no autorelease pool of their own.
+        NS::AutoreleasePool* autorelease_pool = NS::AutoreleasePool::alloc()->init();
+
+        NS::String* function_name = NS::String::string(name, NS::ASCIIStringEncoding);
+        auto shader = std::make_unique<Shader>();
+        shader->function = MTL::make_owned(library->newFunction(function_name));
+
+        autorelease_pool->release();
+
+        if (!shader->function)
+            FATAL("Failed to load shader");
+
+        return shader;
+    }
+
+    ShaderId addShader(std::unique_ptr<CompiledObject> shader) override
+    {
+        std::unique_lock lock(resources_mutex_);
+        return shaders_.insert(std::move(static_cast<Shader&>(*shader)));
+    }
+
+    void destroyShader(ShaderId shader) override
+    {
+        destroyDeferred(shaders_, shader);
+    }
+
+    std::unique_ptr<CompiledObject> compilePipeline(const PipelineDesc& desc) override
+    {
+        NS::Error* err { nullptr };
+
+        MTL::shared_ptr<MTL::Function> vertex_function, fragment_function;
+        {
+            std::shared_lock lock(resources_mutex_);
+            const Shader* vertex_shader = shaders_.get(desc.vertexShader);
+            const Shader* fragment_shader = shaders_.get(desc.fragmentShader);
+            if (!vertex_shader || !fragment_shader)
+                FATAL("Unknown shader");
+
+            vertex_function = vertex_shader->function;
+            fragment_function = fragment_shader->function;
+        }
+
+        NS::AutoreleasePool* autorelease_pool = NS::AutoreleasePool::alloc()->init();
+
+        MTL::shared_ptr<MTL::RenderPipelineDescriptor> pipeline_descriptor = MTL::make_owned(MTL::RenderPipelineDescriptor::alloc()->init());
+        pipeline_descriptor->setVertexFunction(vertex_function.get());
+        pipeline_descriptor->setFragmentFunction(fragment_function.get());
+
+        MTL::RenderPipelineColorAttachmentDescriptor* color_attachment_descriptor = pipeline_descriptor->colorAttachments()->object(0);
+        color_attachment_descriptor->setPixelFormat(toMetal(desc.pixelFormat));
+
+        if (desc.blend != BlendMode::Opaque) {
+            MTL::BlendFactor destination = desc.blend == BlendMode::Alpha
+                ? MTL::BlendFactorOneMinusSourceAlpha
+                : MTL::BlendFactorOne;
+
+            color_attachment_descriptor->setBlendingEnabled(true);
+            color_attachment_descriptor->setSourceRGBBlendFactor(MTL::BlendFactorSourceAlpha);
+            color_attachment_descriptor->setDestinationRGBBlendFactor(destination);
+            color_attachment_descriptor->setSourceAlphaBlendFactor(MTL::BlendFactorOne);
+            color_attachment_descriptor->setDestinationAlphaBlendFactor(destination);
+        }
+
+        auto pipeline = std::make_unique<Pipline>();
+        pipeline->descriptor = pipeline_descriptor;
+        pipeline->pipeline = MTL::make_owned(device_->newRenderPipelineState(pipeline_descriptor.get(), &err));
+
+        autorelease_pool->release();
+
+        if (!pipeline->pipeline)
+            FATAL("Failed to create pipeline");
+
+        return pipeline;
+    }
+
+    PipelineId addPipeline(std::unique_ptr<CompiledObject> pipeline) override
+    {
+        std::unique_lock lock(resources_mutex_);
+        return pipelines_.insert(std::move(static_cast<Pipline&>(*pipeline)));
+    }
+
+    void destroyPipeline(PipelineId pipeline) override
+    {
+        destroyDeferred(pipelines_, pipeline);
+    }
+
+    TextureId createTexture(uint32_t width, uint32_t height) override
+    {
+        MTL::TextureDescriptor* descriptor = MTL::TextureDescriptor::texture2DDescriptor(
+            MTL::PixelFormat::PixelFormatRGBA8Unorm, width, height, false);
+        descriptor->setUsage(MTL::TextureUsageShaderRead);
+        descriptor->setStorageMode(MTL::StorageModePrivate);
+
+        Texture texture { MTL::make_owned(device_->newTexture(descriptor)) };
+        if (!texture.texture)
+            FATAL("Failed to create texture");
+
+        std::unique_lock lock(resources_mutex_);
+        return textures_.insert(std::move(texture));
+    }
+
+    // Staged through a shared buffer and blitted at the start of the next
+    // execute, so the write is ordered after earlier frames' reads.
+    void updateTexture(TextureId texture, uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+        const uint32_t* pixels, uint32_t stride) override
+    {
+        const Texture* target = textures_.get(texture);
+        if (!target) {
+            ERROR("Update of unknown or destroyed texture");
+            return;
+        }
+
+        NS::UInteger row_bytes = NS::UInteger(width) * sizeof(uint32_t);
+        MTL::shared_ptr<MTL::Buffer> staging = MTL::make_owned(
+            device_->newBuffer(row_bytes * height, MTL::ResourceStorageModeShared));
+
+        auto* destination = static_cast<uint8_t*>(staging->contents());
+        for (uint32_t row = 0; row < height; ++row)
+            std::memcpy(destination + row * row_bytes, pixels + size_t(row) * stride, row_bytes);
+
+        pending_uploads_.push_back({ target->texture, staging, x, y, width, height });
+    }
+
+    void destroyTexture(TextureId texture) override
+    {
+        destroyDeferred(textures_, texture);
+    }
+
+    BufferId createBuffer(const void* data, size_t length) override
+    {
+        // Metal has no zero-length buffers.
+        if (length == 0)
+            return {};
+
+        // Apple GPUs share memory with the CPU, so a shared buffer is read
+        // as fast as a private one and needs no blit.
+        Buffer buffer { MTL::make_owned(device_->newBuffer(data, length, MTL::ResourceStorageModeShared)) };
+        if (!buffer.buffer)
+            FATAL("Failed to create buffer");
+
+        std::unique_lock lock(resources_mutex_);
+        return buffers_.insert(std::move(buffer));
+    }
+
+    void destroyBuffer(BufferId buffer) override
+    {
+        destroyDeferred(buffers_, buffer);
+    }
+
+    vector_uint2 viewport() const override
+    {
+        return viewport_;
+    }
+
+    // Takes effect with the next beginFrame.
+    bool setRenderScale(float scale) override
+    {
+        render_scale_ = std::clamp(scale, 0.1f, 1.0f);
+        return true;
+    }
+
+    std::optional<double> gpuFrameTime() override
+    {
+        double time = gpu_frame_time_->exchange(-1.0, std::memory_order_acquire);
+        if (time < 0)
+            return std::nullopt;
+        return time;
+    }
+
+    void beginFrame() override
+    {
+        deferred_.retire(completed_frames_->completedThrough());
+        ++frame_index_;
+
+        // Drained in endFrame, so autoreleased per-frame objects do not pile
+        // up when the caller has no pool of its own.
+        frame_pool_ = NS::AutoreleasePool::alloc()->init();
+
+        if (swapchain_) {
+            drawable_ = MTL::shared_ptr<CA::MetalDrawable>(swapchain_->nextDrawable());
+            target_ = drawable_->texture();
+        } else {
+            target_ = offscreen_target_.get();
+        }
+
+        render_pass_ = MTL::shared_ptr<MTL::RenderPassDescriptor>(MTL::RenderPassDescriptor::renderPassDescriptor());
+
+        MTL::RenderPassColorAttachmentDescriptor* color_attachment = render_pass_->colorAttachments()->object(0);
+        color_attachment->setLoadAction(MTL::LoadAction::LoadActionClear);
+        color_attachment->setStoreAction(MTL::StoreAction::StoreActionStore);
+        scaled_frame_ = render_scale_ < 1.0f;
+        color_attachment->setTexture(scaled_frame_ ? scaledTarget() : target_);
+        if (!scaled_frame_)
+            render_size_ = viewport_;
+
+        command_buffer_ = MTL::shared_ptr<MTL::CommandBuffer>(command_queue_->commandBuffer());
+    }
+
+    void execute(std::span<const CommandList* const> lists) override
+    {
+        if (!pending_uploads_.empty())
+            encodeUploads();
+        stageLargeVertexBytes(lists);
+
+        MTL::shared_ptr<MTL::ParallelRenderCommandEncoder> parallel_encoder(
+            command_buffer_->parallelRenderCommandEncoder(render_pass_.get()));
+
+        // Sub-encoders execute in creation order, so they are created here on
+        // the frame thread and only the encoding itself is spread across threads.
+        std::vector<MTL::shared_ptr<MTL::RenderCommandEncoder>> encoders(lists.size());
+        for (size_t i = 0; i < lists.size(); ++i) {
+            if (!lists[i]->empty())
+                encoders[i] = MTL::shared_ptr<MTL::RenderCommandEncoder>(parallel_encoder->renderCommandEncoder());
+        }
+
+        // Pool threads outlive the frame, so each list drains its own
+        // autorelease pool.
+        encode_pool_.parallelFor(lists.size(), [this, &encoders, &lists](size_t i) {
+            if (!encoders[i])
+                return;
+            NS::AutoreleasePool* autorelease_pool = NS::AutoreleasePool::alloc()->init();
+            encodeCommandList(encoders[i].get(), *lists[i]);
+            autorelease_pool->release();
+        });
+
+        parallel_encoder->endEncoding();
+    }
+
+    void endFrame() override
+    {
+        if (scaled_frame_)
+            encodeUpscale();
+        if (capture_)
+            encodeReadback();
+
+        std::shared_ptr<FrameCompletion> completed_frames = completed_frames_;
+        std::shared_ptr<std::atomic<double>> gpu_frame_time = gpu_frame_time_;
+        uint64_t frame = frame_index_;
+        command_buffer_->addCompletedHandler([completed_frames, gpu_frame_time, frame](MTL::CommandBuffer* command_buffer) {
+            gpu_frame_time->store((command_buffer->GPUEndTime() - command_buffer->GPUStartTime()) * 1000.0,
+                std::memory_order_release);
+            completed_frames->complete(frame);
+        });
+
+        if (drawable_) {
+            command_buffer_->presentDrawable(drawable_.get());
+            deferred_.enqueue(frame_index_, [drawable = std::move(drawable_)]() {});
+        }
+        command_buffer_->commit();
+
+        frame_pool_->release();
+        frame_pool_ = nullptr;
+    }
+
+    bool requestCapture(FrameCapture& capture) override
+    {
+        // Drawables of a framebuffer-only layer cannot be blitted from; the
+        // layer is switched so captures start with the next frame.
+        if (target_->framebufferOnly()) {
+            swapchain_->setFramebufferOnly(false);
+            return false;
+        }
+
+        capture_ = &capture;
+        return true;
+    }
+
+private:
+    // Unregisters the resource now, so its id goes stale immediately, and
+    // releases it once the frame being recorded has completed on the GPU.
+    template <typename Resource, typename Tag>
+    void destroyDeferred(SlotMap<Resource, Tag>& resources, Handle<Tag> handle)
+    {
+        std::unique_lock lock(resources_mutex_);
+        Resource* resource = resources.get(handle);
+        if (!resource)
+            return;
+
+        deferred_.enqueue(frame_index_, [retired = std::move(*resource)]() {});
+        resources.erase(handle);
+    }
+
+    // setVertexBytes only takes up to 4 KB. Larger payloads are copied into
+    // one shared buffer per execute and bound with setVertexBuffer instead.
+    void stageLargeVertexBytes(std::span<const CommandList* const> lists)
+    {
+        staged_offsets_.clear();
+
+        NS::UInteger length = 0;
+        for (const CommandList* list : lists) {
+            list->visit([&](const auto& command) {
+                using Command = std::decay_t<decltype(command)>;
+
+                if constexpr (std::is_same_v<Command, SetVertexBytesCommand>) {
+                    if (command.length > kMaxVertexBytes) {
+                        staged_offsets_.emplace(&command, length);
+                        length += (command.length + kStagingAlignment - 1) & ~(kStagingAlignment - 1);
+                    }
+                }
+            });
+        }
+
+        if (staged_offsets_.empty())
+            return;
+
+        staged_vertices_ = MTL::make_owned(device_->newBuffer(length, MTL::ResourceStorageModeShared));
+        auto* contents = static_cast<uint8_t*>(staged_vertices_->contents());
+        for (const auto& [command, offset] : staged_offsets_)
+            std::memcpy(contents + offset, command->bytes(), command->length);
+
+        deferred_.enqueue(frame_index_, [buffer = staged_vertices_]() {});
+    }
+
+    // The intermediate target for the current render scale. Resizing hands
+    // the old texture to the deferred queue, as earlier frames may still
+    // render into it.
+    MTL::Texture* scaledTarget()
+    {
+        uint32_t width = std::max(1u, uint32_t(std::lround(float(viewport_[0]) * render_scale_)));
+        uint32_t height = std::max(1u, uint32_t(std::lround(float(viewport_[1]) * render_scale_)));
+        render_size_ = vector_uint2 { width, height };
+
+        if (scaled_target_ && scaled_target_->width() == width && scaled_target_->height() == height)
+            return scaled_target_.get();
+
+        if (scaled_target_)
+            deferred_.enqueue(frame_index_, [retired = std::move(scaled_target_)]() {});
+
+        MTL::TextureDescriptor* descriptor = MTL::TextureDescriptor::texture2DDescriptor(
+            pixel_format_, width, height, false);
+        descriptor->setUsage(MTL::TextureUsageRenderTarget | MTL::TextureUsageShaderRead);
+        descriptor->setStorageMode(MTL::StorageModePrivate);
+        scaled_target_ = MTL::make_owned(device_->newTexture(descriptor));
+        if (!scaled_target_)
+            FATAL("Failed to create scaled render target");
+
+        return scaled_target_.get();
+    }
+
+    void encodeUpscale()
+    {
+        if (!upscale_pipeline_)
+            createUpscalePipeline();
+
+        MTL::RenderPassDescriptor* pass = MTL::RenderPassDescriptor::renderPassDescriptor();
+        MTL::RenderPassColorAttachmentDescriptor* color_attachment = pass->colorAttachments()->object(0);
+        color_attachment->setLoadAction(MTL::LoadAction::LoadActionDontCare);
+        color_attachment->setStoreAction(MTL::StoreAction::StoreActionStore);
+        color_attachment->setTexture(target_);
+
+        MTL::RenderCommandEncoder* encoder = command_buffer_->renderCommandEncoder(pass);
+        encoder->setRenderPipelineState(upscale_pipeline_.get());
+        encoder->setFragmentTexture(scaled_target_.get(), 0);
+        encoder->drawPrimitives(MTL::PrimitiveType::PrimitiveTypeTriangle, NS::UInteger(0), NS::UInteger(3));
+        encoder->endEncoding();
+    }
+
+    void createUpscalePipeline()
+    {
+        NS::Error* err = nullptr;
+        MTL::shared_ptr<MTL::Library> library = MTL::make_owned(device_->newLibrary(
+            NS::String::string(detail::kUpscaleShaderSource, NS::UTF8StringEncoding), nullptr, &err));
+        if (!library)
+            FATAL("Failed to build upscale shaders");
+
+        MTL::shared_ptr<MTL::Function> vertex_function = MTL::make_owned(
+            library->newFunction(NS::String::string("upscaleVertexShader", NS::UTF8StringEncoding)));
+        MTL::shared_ptr<MTL::Function> fragment_function = MTL::make_owned(
+            library->newFunction(NS::String::string("upscaleFragmentShader", NS::UTF8StringEncoding)));
+
+        MTL::shared_ptr<MTL::RenderPipelineDescriptor> descriptor = MTL::make_owned(MTL::RenderPipelineDescriptor::alloc()->init());
+        descriptor->setVertexFunction(vertex_function.get());
+        descriptor->setFragmentFunction(fragment_function.get());
+        descriptor->colorAttachments()->object(0)->setPixelFormat(pixel_format_);
+
+        upscale_pipeline_ = MTL::make_owned(device_->newRenderPipelineState(descriptor.get(), &err));
+        if (!upscale_pipeline_)
+            FATAL("Failed to create upscale pipeline");
+    }
+
+    void encodeUploads()
+    {
+        MTL::BlitCommandEncoder* blit = command_buffer_->blitCommandEncoder();
+        for (const TextureUpload& upload : pending_uploads_) {
+            blit->copyFromBuffer(upload.staging.get(), 0, NS::UInteger(upload.width) * sizeof(uint32_t),
+                NS::UInteger(upload.width) * upload.height * sizeof(uint32_t), MTL::Size(upload.width, upload.height, 1),
+                upload.texture.get(), 0, 0, MTL::Origin(upload.x, upload.y, 0));
+        }
+        blit->endEncoding();
+
+        // Staging buffers are released once this frame has completed.
+        deferred_.enqueue(frame_index_, [uploads = std::move(pending_uploads_)]() {});
+        pending_uploads_.clear();
+    }
+
+    MTL::PixelFormat toMetal(PixelFormat format) const
+    {
+        switch (format) {
+        case PixelFormat::BGRA8Unorm:
+            return MTL::PixelFormat::PixelFormatBGRA8Unorm;
+        case PixelFormat::RGBA8Unorm:
+            return MTL::PixelFormat::PixelFormatRGBA8Unorm;
+        case PixelFormat::Target:
+            break;
+        }
+        return pixel_format_;
+    }
+
+    // Copies the target into a shared buffer owned by the capture slot and
+    // hands it to the capture thread once the GPU has finished the frame.
+    void encodeReadback()
+    {
+        FrameCapture* capture = capture_;
+        capture_ = nullptr;
+
+        CapturedFrame* captured = capture->acquire();
+        if (!captured)
+            return;
+
+        uint32_t width = target_->width();
+        uint32_t height = target_->height();
+        NS::UInteger row_bytes = NS::UInteger(width) * 4;
+        NS::UInteger length = row_bytes * height;
+
+        MTL::shared_ptr<MTL::Buffer>& buffer = readback_buffers_[captured];
+        if (!buffer || buffer->length() < length)
+            buffer = MTL::make_owned(device_->newBuffer(length, MTL::ResourceStorageModeShared));
+
+        MTL::BlitCommandEncoder* blit = command_buffer_->blitCommandEncoder();
+        blit->copyFromTexture(target_, 0, 0, MTL::Origin(0, 0, 0), MTL::Size(width, height, 1),
+            buffer.get(), 0, row_bytes, length);
+        blit->endEncoding();
+
+        // `capture` is only used until the buffer is submitted or released,
+        // which its destructor waits for; the read-back buffer is retained
+        // in case the backend goes first.
+        command_buffer_->addCompletedHandler([capture, captured, source = buffer, width, height](MTL::CommandBuffer* command_buffer) {
+            if (command_buffer->status() != MTL::CommandBufferStatusCompleted) {
+                capture->release(captured);
+                return;
+            }
+
+            captured->width = width;
+            captured->height = height;
+            captured->bgra = true;
+            captured->pixels.resize(size_t(width) * height);
+            std::memcpy(captured->pixels.data(), source->contents(), captured->pixels.size() * sizeof(uint32_t));
+
+            capture->submit(captured);
+        });
+    }
+
+    void encodeCommandList(MTL::RenderCommandEncoder* encoder, const CommandList& list)
+    {
+        // The scaled target when dynamic resolution is on; shaders still map
+        // positions with the unscaled viewport.
+        encoder->setViewport(MTL::Viewport {
+            0.0, 0.0,
+            (double)render_size_[0], (double)render_size_[1],
+            0.0, 1.0 });
+        encoder->setVertexBytes(&viewport_, sizeof(viewport_), AAPLVertexInputIndexViewportSize);
+
+        MTL::RenderPipelineState* bound_pipeline = nullptr;
+
+        list.visit([&](const auto& command) {
+            using Command = std::decay_t<decltype(command)>;
+
+            if constexpr (std::is_same_v<Command, BindPipelineCommand>) {
+                const Pipline* pipeline = pipelines_.get(command.pipeline);
+                if (!pipeline) {
+                    ERROR("Bind of unknown or destroyed pipeline");
+                    bound_pipeline = nullptr;
+                    return;
+                }
+                if (pipeline->pipeline.get() != bound_pipeline) {
+                    encoder->setRenderPipelineState(pipeline->pipeline.get());
+                    bound_pipeline = pipeline->pipeline.get();
+                }
+            } else if constexpr (std::is_same_v<Command, BindTextureCommand>) {
+                const Texture* texture = textures_.get(command.texture);
+                if (!texture) {
+                    ERROR("Bind of unknown or destroyed texture");
+                    return;
+                }
+                encoder->setFragmentTexture(texture->texture.get(), command.index);
+            } else if constexpr (std::is_same_v<Command, SetVertexBytesCommand>) {
+                if (command.length > kMaxVertexBytes)
+                    encoder->setVertexBuffer(staged_vertices_.get(), staged_offsets_.at(&command), command.index);
+                else
+                    encoder->setVertexBytes(command.bytes(), command.length, command.index);
+            } else if constexpr (std::is_same_v<Command, BindVertexBufferCommand>) {
+                const Buffer* buffer = buffers_.get(command.buffer);
+                if (!buffer) {
+                    ERROR("Bind of unknown or destroyed buffer");
+                    return;
+                }
+                encoder->setVertexBuffer(buffer->buffer.get(), command.offset, command.index);
+            } else if constexpr (std::is_same_v<Command, DrawCommand>) {
+                if (!bound_pipeline)
+                    return;
+                encoder->drawPrimitives(MTL::PrimitiveType::PrimitiveTypeTriangle,
+                    NS::UInteger(command.vertexStart), NS::UInteger(command.vertexCount));
+            } else if constexpr (std::is_same_v<Command, DrawIndexedCommand>) {
+                if (!bound_pipeline)
+                    return;
+                const Buffer* indices = buffers_.get(command.indexBuffer);
+                if (!indices) {
+                    ERROR("Draw with unknown or destroyed index buffer");
+                    return;
+                }
+                MTL::IndexType index_type = command.indexType == IndexType::UInt16
+                    ? MTL::IndexType::IndexTypeUInt16
+                    : MTL::IndexType::IndexTypeUInt32;
+                encoder->drawIndexedPrimitives(MTL::PrimitiveType::PrimitiveTypeTriangle,
+                    NS::UInteger(command.indexCount), index_type, indices->buffer.get(),
+                    NS::UInteger(command.indexStart) * indexSize(command.indexType));
+            }
+        });
+
+        encoder->endEncoding();
+    }
+
+    struct GameLibrary {
+        MTL::shared_ptr<MTL::Library> library;
+    };
+
+    struct Shader : CompiledObject {
+        MTL::shared_ptr<MTL::Function> function;
+    };
+
+    struct Pipline : CompiledObject {
+        MTL::shared_ptr<MTL::RenderPipelineDescriptor> descriptor;
+        MTL::shared_ptr<MTL::RenderPipelineState> pipeline;
+    };
+
+    struct Texture {
+        MTL::shared_ptr<MTL::Texture> texture;
+    };
+
+    struct Buffer {
+        MTL::shared_ptr<MTL::Buffer> buffer;
+    };
+
+    struct TextureUpload {
+        MTL::shared_ptr<MTL::Texture> texture;
+        MTL::shared_ptr<MTL::Buffer> staging;
+        uint32_t x, y, width, height;
+    };
+
+    vector_uint2 viewport_;
+    MTL::PixelFormat pixel_format_;
+
+    SDL_Renderer* renderer_ { nullptr };
+    CA::MetalLayer* swapchain_ { nullptr };
+    MTL::Device* device_ { nullptr };
+    MTL::shared_ptr<MTL::Device> owned_device_;
+    MTL::shared_ptr<MTL::Texture> offscreen_target_;
+    MTL::shared_ptr<MTL::CommandQueue> command_queue_;
+    MTL::shared_ptr<MTL::CommandBuffer> command_buffer_;
+    MTL::shared_ptr<MTL::RenderPassDescriptor> render_pass_;
+    MTL::shared_ptr<CA::MetalDrawable> drawable_;
+    MTL::Texture* target_ { nullptr };
+    NS::AutoreleasePool* frame_pool_ { nullptr };
+    // Encodes command lists in parallel; started once with the backend.
+    ThreadPool encode_pool_;
+
+    // Dynamic resolution. render_size_ is the size of the texture the
+    // current frame renders into.
+    float render_scale_ { 1 };
+    bool scaled_frame_ { false };
+    vector_uint2 render_size_;
+    MTL::shared_ptr<MTL::Texture> scaled_target_;
+    MTL::shared_ptr<MTL::RenderPipelineState> upscale_pipeline_;
+    std::shared_ptr<std::atomic<double>> gpu_frame_time_ { std::make_shared<std::atomic<double>>(-1.0) };
+
+    // Frames are numbered from 1 in beginFrame; completion handlers publish
+    // the last finished one.
+    uint64_t frame_index_ { 0 };
+    std::shared_ptr<FrameCompletion> completed_frames_ { std::make_shared<FrameCompletion>() };
+    DeferredDestructionQueue deferred_;
+
+    FrameCapture* capture_ { nullptr };
+    std::unordered_map<CapturedFrame*, MTL::shared_ptr<MTL::Buffer>> readback_buffers_;
+
+    // Written on the frame thread only; compiles on worker threads read it.
+    std::shared_mutex resources_mutex_;
+    SlotMap<GameLibrary, GameLibraryTag> libraryes_;
+    SlotMap<Shader, ShaderTag> shaders_;
+    SlotMap<Pipline, PipelineTag> pipelines_;
+    SlotMap<Texture, TextureTag> textures_;
+    SlotMap<Buffer, BufferTag> buffers_;
+
+    // Frame thread only.
+    std::vector<TextureUpload> pending_uploads_;
+
+    static constexpr uint32_t kMaxVertexBytes = 4096;
+    static constexpr NS::UInteger kStagingAlignment = 256;
+    // Written before encoding starts; encoder threads only read them.
+    MTL::shared_ptr<MTL::Buffer> staged_vertices_;
+    std::unordered_map<const SetVertexBytesCommand*, NS::UInteger> staged_offsets_;
+};
+
+} // namespace se
@@ -0,0 +1,385 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "logging.hpp"
+#include "render_backend.hpp"
+
+namespace se {
+
+struct RenderStats {
+    uint64_t commands { 0 };
+    uint64_t commandBytes { 0 };
+    uint64_t draws { 0 };
+    uint64_t vertices { 0 };
+    uint64_t indices { 0 };
+    uint64_t vertexBytes { 0 };
+    uint64_t pipelineBinds { 0 };
+    uint64_t redundantPipelineBinds { 0 };
+    uint64_t textureBinds { 0 };
+    uint64_t textureUploads { 0 };
+    uint64_t textureUploadBytes { 0 };
+    uint64_t invalidCommands { 0 };
+
+    RenderStats& operator+=(const RenderStats& other)
+    {
+        commands += other.commands;
+        commandBytes += other.commandBytes;
+        draws += other.draws;
+        vertices += other.vertices;
+        indices += other.indices;
+        vertexBytes += other.vertexBytes;
+        pipelineBinds += other.pipelineBinds;
+        redundantPipelineBinds += other.redundantPipelineBinds;
+        textureBinds += other.textureBinds;
+        textureUploads += other.textureUploads;
+        textureUploadBytes += other.textureUploadBytes;
+        invalidCommands += other.invalidCommands;
+        return *this;
+    }
+};
+
+// Backend that submits nothing to a GPU. It checks every command against the
+// resources it has handed out and counts what a real backend would have had
+// to do, which makes CPU submission overhead measurable on any machine.
+class NullRenderBackend : public RenderBackend {
+public:
+    explicit NullRenderBackend(vector_uint2 viewport)
+        : viewport_(viewport)
+    {
+    }
+
+    // Makes every compile block for `delay`, standing in for a real shader
+    // compiler when exercising asynchronous compilation.
+    void setCompileDelay(std::chrono::microseconds delay)
+    {
+        compile_delay_ = delay;
+    }
+
+    GameLibraryId addLibrary(const void*, size_t) override
+    {
+        std::unique_lock lock(mutex_);
+        return libraries_.insert({});
+    }
+
+    void destroyLibrary(GameLibraryId libraryId) override
+    {
+        std::unique_lock lock(mutex_);
+        libraries_.erase(libraryId);
+    }
+
+    std::unique_ptr<CompiledObject> compileShader(GameLibraryId libraryId, const char* name) override
+    {
+        {
+            std::shared_lock lock(mutex_);
+            if (!libraries_.contains(libraryId))
+                FATAL("Unknown library");
+        }
+
+        simulateCompile();
+        return std::make_unique<Shader>(name);
+    }
+
+    ShaderId addShader(std::unique_ptr<CompiledObject> shader) override
+    {
+        std::unique_lock lock(mutex_);
+        return shaders_.insert(std::move(static_cast<Shader&>(*shader).name));
+    }
+
+    void destroyShader(ShaderId shader) override
+    {
+        std::unique_lock lock(mutex_);
+        shaders_.erase(shader);
+    }
+
+    std::unique_ptr<CompiledObject> compilePipeline(const PipelineDesc& desc) override
+    {
+        {
+            std::shared_lock lock(mutex_);
+            if (!shaders_.contains(desc.vertexShader) || !shaders_.contains(desc.fragmentShader))
+                FATAL("Unknown shader");
+        }
+
+        simulateCompile();
+        return std::make_unique<Pipeline>(desc.vertexLayout);
+    }
+
+    PipelineId addPipeline(std::unique_ptr<CompiledObject> pipeline) override
+    {
+        std::unique_lock lock(mutex_);
+        return pipelines_.insert(std::move(static_cast<Pipeline&>(*pipeline)));
+    }
+
+    void destroyPipeline(PipelineId pipeline) override
+    {
+        std::unique_lock lock(mutex_);
+        pipelines_.erase(pipeline);
+    }
+
+    TextureId createTexture(uint32_t width, uint32_t height) override
+    {
+        return textures_.insert({ width, height });
+    }
+
+    // Uploads are counted in the stats of the frame that executes them.
+    void updateTexture(TextureId texture, uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+        const uint32_t*, uint32_t stride) override
+    {
+        const Texture* target = textures_.get(texture);
+        if (!target) {
+            ++upload_stats_.invalidCommands;
+            ERROR("Update of unknown or destroyed texture");
+            return;
+        }
+        if (uint64_t(x) + width > target->width || uint64_t(y) + height > target->height || stride < width) {
+            ++upload_stats_.invalidCommands;
+            ERROR("Texture update out of bounds");
+            return;
+        }
+
+        ++upload_stats_.textureUploads;
+        upload_stats_.textureUploadBytes += uint64_t(width) * height * sizeof(uint32_t);
+    }
+
+    void destroyTexture(TextureId texture) override
+    {
+        textures_.erase(texture);
+    }
+
+    // Contents are kept so indexed draws can be checked against them.
+    BufferId createBuffer(const void* data, size_t length) override
+    {
+        if (length == 0)
+            return {};
+
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        return buffers_.insert(std::vector<uint8_t>(bytes, bytes + length));
+    }
+
+    void destroyBuffer(BufferId buffer) override
+    {
+        buffers_.erase(buffer);
+    }
+
+    vector_uint2 viewport() const override
+    {
+        return viewport_;
+    }
+
+    // Only recorded, so callers driving the scale can be observed.
+    bool setRenderScale(float scale) override
+    {
+        render_scale_ = scale;
+        return true;
+    }
+
+    float renderScale() const
+    {
+        return render_scale_;
+    }
+
+    void beginFrame() override
+    {
+        frame_stats_ = {};
+    }
+
+    void execute(std::span<const CommandList* const> lists) override
+    {
+        frame_stats_ += upload_stats_;
+        upload_stats_ = {};
+
+        for (const CommandList* list : lists)
+            validate(*list);
+    }
+
+    void endFrame() override
+    {
+        total_stats_ += frame_stats_;
+        ++frames_;
+    }
+
+    const RenderStats& frameStats() const
+    {
+        return frame_stats_;
+    }
+
+    const RenderStats& totalStats() const
+    {
+        return total_stats_;
+    }
+
+    uint64_t frames() const
+    {
+        return frames_;
+    }
+
+private:
+    struct Library {
+    };
+
+    struct Pipeline : CompiledObject {
+        explicit Pipeline(VertexLayout vertexLayout)
+            : vertexLayout(vertexLayout)
+        {
+        }
+
+        VertexLayout vertexLayout;
+    };
+
+    struct Texture {
+        uint32_t width;
+        uint32_t height;
+    };
+
+    struct Shader : CompiledObject {
+        explicit Shader(std::string name)
+            : name(std::move(name))
+        {
+        }
+
+        std::string name;
+    };
+
+    void simulateCompile()
+    {
+        if (compile_delay_.count() > 0)
+            std::this_thread::sleep_for(compile_delay_);
+    }
+
+    void validate(const CommandList& list)
+    {
+        // State does not carry over between lists, matching separate encoders.
+        bool has_pipeline = false;
+        PipelineId bound_pipeline;
+        uint32_t vertex_stride = 0;
+        uint32_t vertex_bytes = 0;
+
+        frame_stats_.commands += list.commandCount();
+        frame_stats_.commandBytes += list.sizeInBytes();
+
+        list.visit([&](const auto& command) {
+            using Command = std::decay_t<decltype(command)>;
+
+            if constexpr (std::is_same_v<Command, BindPipelineCommand>) {
+                const Pipeline* pipeline = pipelines_.get(command.pipeline);
+                if (!pipeline) {
+                    // Like Metal, draws after a failed bind have no pipeline.
+                    has_pipeline = false;
+                    invalid("Bind of unknown or destroyed pipeline");
+                    return;
+                }
+                vertex_stride = vertexStride(pipeline->vertexLayout);
+                ++frame_stats_.pipelineBinds;
+                if (has_pipeline && bound_pipeline == command.pipeline)
+                    ++frame_stats_.redundantPipelineBinds;
+                has_pipeline = true;
+                bound_pipeline = command.pipeline;
+            } else if constexpr (std::is_same_v<Command, BindTextureCommand>) {
+                if (!textures_.contains(command.texture)) {
+                    invalid("Bind of unknown or destroyed texture");
+                    return;
+                }
+                ++frame_stats_.textureBinds;
+            } else if constexpr (std::is_same_v<Command, SetVertexBytesCommand>) {
+                if (command.index == AAPLVertexInputIndexViewportSize) {
+                    invalid("Viewport buffer index is reserved for the backend");
+                    return;
+                }
+                frame_stats_.vertexBytes += command.length;
+                if (command.index == AAPLVertexInputIndexVertices)
+                    vertex_bytes = command.length;
+            } else if constexpr (std::is_same_v<Command, BindVertexBufferCommand>) {
+                const std::vector<uint8_t>* buffer = buffers_.get(command.buffer);
+                if (!buffer || command.offset > buffer->size()) {
+                    invalid("Bind of unknown or destroyed buffer");
+                    return;
+                }
+                if (command.index == AAPLVertexInputIndexVertices)
+                    vertex_bytes = uint32_t(buffer->size() - command.offset);
+            } else if constexpr (std::is_same_v<Command, DrawCommand>) {
+                if (!has_pipeline) {
+                    invalid("Draw without a bound pipeline");
+                    return;
+                }
+                uint64_t end = uint64_t(command.vertexStart) + command.vertexCount;
+                if (end * vertex_stride > vertex_bytes) {
+                    invalid("Draw reads past the bound vertex bytes");
+                    return;
+                }
+                ++frame_stats_.draws;
+                frame_stats_.vertices += command.vertexCount;
+            } else if constexpr (std::is_same_v<Command, DrawIndexedCommand>) {
+                if (!has_pipeline) {
+                    invalid("Draw without a bound pipeline");
+                    return;
+                }
+                const std::vector<uint8_t>* indices = buffers_.get(command.indexBuffer);
+                uint32_t index_size = indexSize(command.indexType);
+                if (!indices || (uint64_t(command.indexStart) + command.indexCount) * index_size > indices->size()) {
+                    invalid("Draw reads past the index buffer");
+                    return;
+                }
+                uint64_t max_index = maxIndex(indices->data() + size_t(command.indexStart) * index_size,
+                    command.indexCount, command.indexType);
+                if (command.indexCount > 0 && (max_index + 1) * vertex_stride > vertex_bytes) {
+                    invalid("Draw reads past the bound vertex bytes");
+                    return;
+                }
+                ++frame_stats_.draws;
+                frame_stats_.vertices += command.indexCount;
+                frame_stats_.indices += command.indexCount;
+            }
+        });
+    }
+
+    static uint32_t maxIndex(const uint8_t* data, uint32_t count, IndexType type)
+    {
+        uint32_t result = 0;
+        for (uint32_t i = 0; i < count; ++i) {
+            uint32_t index;
+            if (type == IndexType::UInt16) {
+                uint16_t narrow;
+                std::memcpy(&narrow, data + size_t(i) * sizeof(narrow), sizeof(narrow));
+                index = narrow;
+            } else {
+                std::memcpy(&index, data + size_t(i) * sizeof(index), sizeof(index));
+            }
+            result = std::max(result, index);
+        }
+        return result;
+    }
+
+    void invalid(const char* message)
+    {
+        ++frame_stats_.invalidCommands;
+        ERROR(message);
+    }
+
+    vector_uint2 viewport_;
+    float render_scale_ { 1 };
+    std::chrono::microseconds compile_delay_ { 0 };
+
+    // Guards the resource tables against compiles on worker threads.
+    std::shared_mutex mutex_;
+    SlotMap<Library, GameLibraryTag> libraries_;
+    SlotMap<std::string, ShaderTag> shaders_;
+    SlotMap<Pipeline, PipelineTag> pipelines_;
+    // Frame thread only.
+    SlotMap<Texture, TextureTag> textures_;
+    SlotMap<std::vector<uint8_t>, BufferTag> buffers_;
+
+    RenderStats upload_stats_;
+    RenderStats frame_stats_;
+    RenderStats total_stats_;
+    uint64_t frames_ { 0 };
+};
+
+} // namespace se
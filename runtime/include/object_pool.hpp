@@ -0,0 +1,281 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+
+namespace se {
+
+// Thread-safe allocator for objects of one size. Memory comes in 64 KiB
+// chunks carved into slots; free slots move between threads in batches
+// through a lock-free global list, and every thread keeps up to two batches
+// of its own, so most allocations and frees are a few loads and stores on
+// memory no other thread touches.
+//
+// Chunks are returned to the heap only when the pool is destroyed, which
+// must happen after all its objects were deallocated. In DEBUG builds freed
+// slots are overwritten with 0xdd.
+//
+// The chunk table grows a segment at a time, up to kMaxChunks chunks (64
+// GiB) or 2^32 - 1 slots, whichever is fewer; past that, allocate throws
+// std::bad_alloc like operator new.
+class FixedPool {
+public:
+    static constexpr size_t kChunkSize = 64 * 1024;
+    static constexpr uint32_t kBatchSize = 32;
+    static constexpr uint32_t kMaxThreads = 64;
+    static constexpr uint32_t kChunksPerSegment = 1024;
+    static constexpr uint32_t kMaxSegments = 1024;
+    static constexpr uint32_t kMaxChunks = kChunksPerSegment * kMaxSegments;
+
+    explicit FixedPool(size_t objectSize, size_t alignment = alignof(std::max_align_t));
+    ~FixedPool();
+
+    FixedPool(const FixedPool&) = delete;
+    FixedPool& operator=(const FixedPool&) = delete;
+
+    void* allocate();
+    void deallocate(void* object);
+
+    size_t objectSize() const
+    {
+        return object_size_;
+    }
+
+    // Slots in all chunks, used or not.
+    size_t capacity() const
+    {
+        return size_t(chunk_count_.load(std::memory_order_relaxed)) * objects_per_chunk_;
+    }
+
+    uint64_t chunkAllocations() const
+    {
+        return chunk_count_.load(std::memory_order_relaxed);
+    }
+
+private:
+    // Written into free slots. The first slot of a batch holds its length.
+    struct Node {
+        Node* next;
+        uint32_t count;
+    };
+
+    // Free slots of one thread.
+    struct alignas(64) Cache {
+        Node* head { nullptr };
+        uint32_t count { 0 };
+    };
+
+    static constexpr uint32_t kEmpty = UINT32_MAX;
+
+    void* allocateFrom(Cache& cache);
+    void deallocateTo(Cache& cache, Node* node);
+
+    Node* popBatch();
+    void pushBatch(Node* batch);
+    void grow();
+
+    char* chunk(uint32_t chunkIndex) const;
+    Node* node(uint32_t index) const;
+    uint32_t indexOf(const void* object) const;
+    // Next batch on the global list after the batch starting at `index`.
+    // Kept outside the slots so the racy read in popBatch never touches
+    // memory handed out to users.
+    std::atomic<uint32_t>& link(uint32_t index) const;
+
+    size_t object_size_;
+    size_t stride_;
+    size_t objects_offset_;
+    uint32_t objects_per_chunk_;
+    uint32_t max_chunks_;
+
+    // Index of the first slot of the first batch, tagged with a counter
+    // in the upper half against ABA.
+    std::atomic<uint64_t> head_ { kEmpty };
+    // Segments of kChunksPerSegment chunk pointers, allocated as the pool
+    // grows and never moved, so readers need no lock.
+    std::atomic<std::atomic<char*>*> segments_[kMaxSegments] {};
+    std::atomic<uint32_t> chunk_count_ { 0 };
+
+    Cache caches_[kMaxThreads];
+
+    std::mutex grow_mutex_;
+    // Shared by the threads beyond kMaxThreads.
+    std::mutex overflow_mutex_;
+    Cache overflow_;
+};
+
+// Owning pointer to an object of an ObjectPool; destroys the object and
+// returns its slot when reset or destroyed.
+template <typename T>
+class PoolPtr {
+public:
+    PoolPtr() = default;
+
+    PoolPtr(T* object, FixedPool* pool)
+        : object_(object)
+        , pool_(pool)
+    {
+    }
+
+    PoolPtr(PoolPtr&& other)
+        : object_(std::exchange(other.object_, nullptr))
+        , pool_(other.pool_)
+    {
+    }
+
+    PoolPtr& operator=(PoolPtr&& other)
+    {
+        if (this != &other) {
+            reset();
+            object_ = std::exchange(other.object_, nullptr);
+            pool_ = other.pool_;
+        }
+        return *this;
+    }
+
+    ~PoolPtr()
+    {
+        reset();
+    }
+
+    void reset()
+    {
+        if (object_) {
+            object_->~T();
+            pool_->deallocate(object_);
+            object_ = nullptr;
+        }
+    }
+
+    T* get() const
+    {
+        return object_;
+    }
+
+    T& operator*() const
+    {
+        return *object_;
+    }
+
+    T* operator->() const
+    {
+        return object_;
+    }
+
+    explicit operator bool() const
+    {
+        return object_ != nullptr;
+    }
+
+private:
+    T* object_ { nullptr };
+    FixedPool* pool_ { nullptr };
+};
+
+// FixedPool sized for T, constructing objects in place.
+template <typename T>
+class ObjectPool {
+public:
+    ObjectPool()
+        : pool_(sizeof(T), alignof(T))
+    {
+    }
+
+    template <typename... Args>
+    PoolPtr<T> make(Args&&... args)
+    {
+        return PoolPtr<T>(create(std::forward<Args>(args)...), &pool_);
+    }
+
+    // Unowned object; pair with destroy().
+    template <typename... Args>
+    T* create(Args&&... args)
+    {
+        void* memory = pool_.allocate();
+        try {
+            return new (memory) T(std::forward<Args>(args)...);
+        } catch (...) {
+            pool_.deallocate(memory);
+            throw;
+        }
+    }
+
+    void destroy(T* object)
+    {
+        object->~T();
+        pool_.deallocate(object);
+    }
+
+    size_t capacity() const
+    {
+        return pool_.capacity();
+    }
+
+private:
+    FixedPool pool_;
+};
+
+// Process-wide pool for objects of `Size` bytes. Never destroyed, so
+// objects may outlive static destruction.
+template <size_t Size, size_t Alignment>
+FixedPool& sizeClassPool()
+{
+    static FixedPool* pool = new FixedPool(Size, Alignment);
+    return *pool;
+}
+
+// Allocator handing out single objects from the size class pools, for
+// std::allocate_shared and node-based containers. Arrays go to the heap.
+template <typename T>
+class PoolAllocator {
+public:
+    using value_type = T;
+
+    PoolAllocator() = default;
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>&)
+    {
+    }
+
+    T* allocate(size_t count)
+    {
+        if (count != 1)
+            return std::allocator<T>().allocate(count);
+        return static_cast<T*>(pool().allocate());
+    }
+
+    void deallocate(T* object, size_t count)
+    {
+        if (count != 1)
+            return std::allocator<T>().deallocate(object, count);
+        pool().deallocate(object);
+    }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U>&) const
+    {
+        return true;
+    }
+
+private:
+    // Sizes are rounded up to 16 bytes so similar types share a pool.
+    static FixedPool& pool()
+    {
+        return sizeClassPool<(sizeof(T) + 15) & ~size_t(15), alignof(T)>();
+    }
+};
+
+// std::make_shared with the object and its control block in a pool slot.
+template <typename T, typename... Args>
+std::shared_ptr<T> makePooled(Args&&... args)
+{
+    return std::allocate_shared<T>(PoolAllocator<T>(), std::forward<Args>(args)...);
+}
+
+} // namespace se
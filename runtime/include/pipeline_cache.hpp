@@ -0,0 +1,141 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include "render_types.hpp"
+
+namespace se {
+
+struct PipelineDescHash {
+    size_t operator()(const PipelineDesc& desc) const
+    {
+        // FNV-1a over every field of the description.
+        uint64_t hash = 14695981039346656037ull;
+        auto mix = [&hash](uint64_t value) {
+            for (int i = 0; i < 8; ++i) {
+                hash ^= (value >> (i * 8)) & 0xff;
+                hash *= 1099511628211ull;
+            }
+        };
+
+        mix(desc.vertexShader.value());
+        mix(desc.fragmentShader.value());
+        mix(uint64_t(desc.pixelFormat));
+        mix(uint64_t(desc.blend));
+        mix(uint64_t(desc.vertexLayout));
+        return size_t(hash);
+    }
+};
+
+struct PipelineCacheStats {
+    uint64_t hits { 0 };
+    uint64_t misses { 0 };
+    // Time spent in the backend creating pipelines on a miss.
+    std::chrono::nanoseconds creationTime { 0 };
+    std::chrono::nanoseconds slowestCreation { 0 };
+};
+
+// Maps full pipeline descriptions to pipelines that were already created, so
+// identical requests share one backend pipeline state.
+class PipelineCache {
+public:
+    template <typename Create>
+    PipelineId getOrCreate(const PipelineDesc& desc, Create&& create)
+    {
+        if (std::optional<PipelineId> pipeline = find(desc))
+            return *pipeline;
+
+        auto start = std::chrono::steady_clock::now();
+        PipelineId pipeline = create(desc);
+        insert(desc, pipeline, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start));
+
+        return pipeline;
+    }
+
+    // Counts a hit when the description is cached.
+    std::optional<PipelineId> find(const PipelineDesc& desc)
+    {
+        auto iter = pipelines_.find(desc);
+        if (iter == pipelines_.end())
+            return std::nullopt;
+
+        ++stats_.hits;
+        return iter->second;
+    }
+
+    // Records a pipeline created after a miss, along with its creation time.
+    void insert(const PipelineDesc& desc, PipelineId pipeline, std::chrono::nanoseconds creationTime)
+    {
+        ++stats_.misses;
+        stats_.creationTime += creationTime;
+        if (creationTime > stats_.slowestCreation)
+            stats_.slowestCreation = creationTime;
+
+        pipelines_.emplace(desc, pipeline);
+    }
+
+    // Forgets a pipeline that is being destroyed. Linear in the cache size.
+    void erase(PipelineId pipeline)
+    {
+        std::erase_if(pipelines_, [pipeline](const auto& entry) { return entry.second == pipeline; });
+    }
+
+    const PipelineCacheStats& stats() const
+    {
+        return stats_;
+    }
+
+    size_t size() const
+    {
+        return pipelines_.size();
+    }
+
+private:
+    std::unordered_map<PipelineDesc, PipelineId, PipelineDescHash> pipelines_;
+    PipelineCacheStats stats_;
+};
+
+// Shaders by library and function name.
+class ShaderCache {
+public:
+    std::optional<ShaderId> find(GameLibraryId libraryId, const std::string& name) const
+    {
+        auto iter = shaders_.find({ libraryId, name });
+        if (iter == shaders_.end())
+            return std::nullopt;
+        return iter->second;
+    }
+
+    void insert(GameLibraryId libraryId, std::string name, ShaderId shader)
+    {
+        shaders_.emplace(std::make_pair(libraryId, std::move(name)), shader);
+    }
+
+    // Forgets a shader that is being destroyed. Linear in the cache size.
+    void erase(ShaderId shader)
+    {
+        std::erase_if(shaders_, [shader](const auto& entry) { return entry.second == shader; });
+    }
+
+    // Forgets the shaders of a library that is being destroyed; the shaders
+    // themselves stay usable. A library loaded later gets fresh entries.
+    void eraseLibrary(GameLibraryId libraryId)
+    {
+        std::erase_if(shaders_, [libraryId](const auto& entry) { return entry.first.first == libraryId; });
+    }
+
+    size_t size() const
+    {
+        return shaders_.size();
+    }
+
+private:
+    std::map<std::pair<GameLibraryId, std::string>, ShaderId> shaders_;
+};
+
+} // namespace se
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace se {
+
+struct PackedRect {
+    uint32_t x { 0 };
+    uint32_t y { 0 };
+    uint32_t width { 0 };
+    uint32_t height { 0 };
+
+    bool operator==(const PackedRect&) const = default;
+};
+
+// MaxRects bin packer (best short side fit) over a fixed-size page. Every
+// free region is tracked as a maximal rectangle, so rectangles can be
+// inserted one at a time without knowing what comes next, and removed again
+// to make room for new ones.
+class RectPacker {
+public:
+    RectPacker(uint32_t width, uint32_t height);
+
+    std::optional<PackedRect> insert(uint32_t width, uint32_t height);
+
+    // `rect` must have been returned by insert and not removed since.
+    void remove(const PackedRect& rect);
+
+    void reset();
+
+    uint32_t width() const
+    {
+        return width_;
+    }
+
+    uint32_t height() const
+    {
+        return height_;
+    }
+
+    uint64_t usedArea() const
+    {
+        return used_area_;
+    }
+
+    // Fraction of the page covered by inserted rectangles.
+    double occupancy() const
+    {
+        return double(used_area_) / (double(width_) * height_);
+    }
+
+    size_t freeRectCount() const
+    {
+        return free_.size();
+    }
+
+private:
+    void place(const PackedRect& rect);
+    bool split(const PackedRect& free, const PackedRect& used);
+    size_t merge(size_t index);
+    void prune(size_t index);
+
+    uint32_t width_;
+    uint32_t height_;
+    uint64_t used_area_ { 0 };
+    std::vector<PackedRect> free_;
+    std::vector<PackedRect> scratch_;
+};
+
+} // namespace se
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+
+#include "command_list.hpp"
+#include "frame_capture.hpp"
+#include "generics.h"
+#include "render_types.hpp"
+
+namespace se {
+
+// A shader or pipeline built by a backend but not registered yet.
+struct CompiledObject {
+    virtual ~CompiledObject() = default;
+};
+
+// Executes recorded command lists on a concrete graphics API. All methods are
+// called from the frame thread, except compileShader and compilePipeline,
+// which may also run on worker threads.
+class RenderBackend {
+public:
+    virtual ~RenderBackend() = default;
+
+    virtual GameLibraryId addLibrary(const void* data, size_t length) = 0;
+    virtual void destroyLibrary(GameLibraryId libraryId) = 0;
+
+    // Compilation is split from registration so the slow half can run off the
+    // frame thread. A pipeline may only reference shaders that were added.
+    virtual std::unique_ptr<CompiledObject> compileShader(GameLibraryId libraryId, const char* name) = 0;
+    virtual ShaderId addShader(std::unique_ptr<CompiledObject> shader) = 0;
+    virtual std::unique_ptr<CompiledObject> compilePipeline(const PipelineDesc& desc) = 0;
+    virtual PipelineId addPipeline(std::unique_ptr<CompiledObject> pipeline) = 0;
+
+    // Stale ids are ignored. Ids go stale immediately, but backends keep the
+    // underlying objects alive until frames in flight that used them have
+    // completed. Shaders and pipelines already created from a destroyed
+    // library, or pipelines from a destroyed shader, stay usable.
+    virtual void destroyShader(ShaderId shader) = 0;
+    virtual void destroyPipeline(PipelineId pipeline) = 0;
+
+    ShaderId loadShaderFromLibrary(GameLibraryId libraryId, const char* name)
+    {
+        return addShader(compileShader(libraryId, name));
+    }
+
+    PipelineId createPipeline(const PipelineDesc& desc)
+    {
+        return addPipeline(compilePipeline(desc));
+    }
+
+    // RGBA8 textures for the sprite shaders. Updates take effect from the
+    // next execute on and may target textures that frames in flight still
+    // sample. `stride` is in pixels.
+    virtual TextureId createTexture(uint32_t width, uint32_t height) = 0;
+    virtual void updateTexture(TextureId texture, uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+        const uint32_t* pixels, uint32_t stride)
+        = 0;
+    virtual void destroyTexture(TextureId texture) = 0;
+
+    // Immutable buffers of vertex or index data, for geometry that outlives
+    // a frame. An empty buffer is never created: `length` 0 returns an
+    // invalid id, which draws reject and destroyBuffer ignores.
+    virtual BufferId createBuffer(const void* data, size_t length) = 0;
+    virtual void destroyBuffer(BufferId buffer) = 0;
+
+    virtual vector_uint2 viewport() const = 0;
+
+    // Renders the following frames at `scale` times the viewport size per
+    // axis into an intermediate target, then upscales to the real one.
+    // Vertex positions stay in viewport pixels. Returns false when the
+    // backend cannot scale.
+    virtual bool setRenderScale(float)
+    {
+        return false;
+    }
+
+    // Milliseconds the GPU spent on the most recently completed frame,
+    // reported once per completion; nullopt when nothing completed since the
+    // last call or the backend cannot time the GPU.
+    virtual std::optional<double> gpuFrameTime()
+    {
+        return std::nullopt;
+    }
+
+    virtual void beginFrame() = 0;
+    // Lists are executed in span order; empty lists are allowed.
+    virtual void execute(std::span<const CommandList* const> lists) = 0;
+    virtual void endFrame() = 0;
+
+    // Reads back the frame being recorded into `capture` once it has been
+    // rendered. Called between beginFrame and endFrame; returns false when
+    // the backend has nothing to read back. `capture` must stay alive until
+    // endFrame; reads the GPU finishes later are waited for by its
+    // destructor.
+    virtual bool requestCapture(FrameCapture&)
+    {
+        return false;
+    }
+};
+
+inline uint32_t vertexStride(VertexLayout layout)
+{
+    switch (layout) {
+    case VertexLayout::AAPLVertex:
+        return sizeof(AAPLVertex);
+    case VertexLayout::AAPLSpriteVertex:
+        return sizeof(AAPLSpriteVertex);
+    case VertexLayout::AAPLPackedVertex:
+        return sizeof(AAPLPackedVertex);
+    case VertexLayout::AAPLPackedSpriteVertex:
+        return sizeof(AAPLPackedSpriteVertex);
+    case VertexLayout::AAPLHalfSpriteVertex:
+        return sizeof(AAPLHalfSpriteVertex);
+    }
+    return 0;
+}
+
+} // namespace se
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+
+#include "slot_map.hpp"
+
+namespace se {
+using GameLibraryId = Handle<struct GameLibraryTag>;
+using ShaderId = Handle<struct ShaderTag>;
+using PipelineId = Handle<struct PipelineTag>;
+using TextureId = Handle<struct TextureTag>;
+using BufferId = Handle<struct BufferTag>;
+
+enum class PixelFormat : uint8_t {
+    // Whatever the backend renders into.
+    Target,
+    BGRA8Unorm,
+    RGBA8Unorm
+};
+
+enum class BlendMode : uint8_t {
+    Opaque,
+    Alpha,
+    Additive
+};
+
+enum class VertexLayout : uint8_t {
+    AAPLVertex,
+    AAPLSpriteVertex,
+    AAPLPackedVertex,
+    AAPLPackedSpriteVertex,
+    AAPLHalfSpriteVertex
+};
+
+enum class IndexType : uint8_t {
+    UInt16,
+    UInt32
+};
+
+inline uint32_t indexSize(IndexType type)
+{
+    return type == IndexType::UInt16 ? sizeof(uint16_t) : sizeof(uint32_t);
+}
+
+// Indexed triangles stored in backend buffers, for geometry that is drawn
+// over many frames without being re-recorded.
+struct Mesh {
+    BufferId vertexBuffer;
+    BufferId indexBuffer;
+    IndexType indexType { IndexType::UInt16 };
+    uint32_t indexCount { 0 };
+};
+
+struct PipelineDesc {
+    ShaderId vertexShader;
+    ShaderId fragmentShader;
+    PixelFormat pixelFormat { PixelFormat::Target };
+    BlendMode blend { BlendMode::Opaque };
+    VertexLayout vertexLayout { VertexLayout::AAPLVertex };
+
+    bool operator==(const PipelineDesc&) const = default;
+};
+} // namespace se
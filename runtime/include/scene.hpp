@@ -0,0 +1,187 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include <entt/entt.hpp>
+
+#include "command_list.hpp"
+#include "culling.hpp"
+#include "generics.h"
+#include "memory_tracker.hpp"
+#include "render_types.hpp"
+
+namespace se {
+
+// Written for the EnTT 3 API: views iterated with each(entity, components...),
+// view<T>() creating missing storage (see SystemAccess), and registry::clear()
+// with no arguments destroying every entity.
+static_assert(ENTT_VERSION_MAJOR == 3, "scene.hpp is written against the EnTT 3 API");
+
+using Entity = entt::entity;
+
+// Components are plain data. The registry keeps each type in its own packed
+// array, so the systems below walk contiguous memory instead of chasing
+// pointers to objects with virtual update methods.
+
+struct Transform {
+    vector_float2 position { 0, 0 };
+    // Radians, counterclockwise.
+    float rotation { 0 };
+    vector_float2 scale { 1, 1 };
+};
+
+struct Velocity {
+    // Pixels per second.
+    vector_float2 linear { 0, 0 };
+    // Radians per second.
+    float angular { 0 };
+};
+
+// A textured quad centered on the entity's position.
+struct Sprite {
+    TextureId texture;
+    // Pixels, before the transform's scale.
+    vector_float2 size { 0, 0 };
+    // Normalized (u0, v0, u1, v1) in the texture.
+    vector_float4 uv { 0, 0, 1, 1 };
+    vector_float4 color { 1, 1, 1, 1 };
+};
+
+// What drawing a sprite needs, copied out of the registry so a render
+// thread can build quads while the registry moves on; see FramePipeline.
+struct SpriteInstance {
+    Transform transform;
+    Sprite sprite;
+};
+
+// Sprite quads of one frame, one batch per texture. Batches keep their
+// storage across frames.
+class SpriteBatches {
+public:
+    struct Batch {
+        TextureId texture;
+        // Four vertices per quad, in the order CommandList::drawQuads expects.
+        std::vector<AAPLSpriteVertex> vertices;
+    };
+
+    void clear();
+    std::vector<AAPLSpriteVertex>& vertices(TextureId texture);
+
+    // Records one draw per batch, in the order their textures first appeared.
+    void draw(CommandList& list, PipelineId pipeline, BufferId quadIndices) const;
+
+    size_t quadCount() const;
+
+    const Batch* begin() const
+    {
+        return batches_.data();
+    }
+
+    const Batch* end() const
+    {
+        return batches_.data() + active_;
+    }
+
+private:
+    std::vector<Batch> batches_;
+    size_t active_ { 0 };
+    size_t last_ { 0 };
+};
+
+// Systems, each one pass over the packed storage of the components it reads.
+
+// Integrates velocities over `dt` seconds.
+void movementSystem(entt::registry& registry, float dt);
+
+// Replaces the contents of `batches` with the quads of the sprites that
+// overlap `view`. Vertex positions are relative to the center of `view`, so
+// it lands in the middle of the viewport.
+void spriteSystem(entt::registry& registry, const CullRect& view, SpriteBatches& batches);
+void spriteSystem(std::span<const SpriteInstance> sprites, const CullRect& view, SpriteBatches& batches);
+
+// Replaces the contents of `sprites` with every sprite in the registry.
+void extractSprites(entt::registry& registry, std::vector<SpriteInstance>& sprites);
+
+// Entities with engine components, updated and drawn by the systems above.
+// The registry is exposed for game-specific components and systems.
+class Scene {
+public:
+    Entity create()
+    {
+        return registry_.create();
+    }
+
+    Entity createSprite(const Transform& transform, const Sprite& sprite)
+    {
+        MemoryScope scope(MemoryTag::Scene);
+        Entity entity = registry_.create();
+        registry_.emplace<Transform>(entity, transform);
+        registry_.emplace<Sprite>(entity, sprite);
+        return entity;
+    }
+
+    void destroy(Entity entity)
+    {
+        registry_.destroy(entity);
+    }
+
+    bool valid(Entity entity) const
+    {
+        return registry_.valid(entity);
+    }
+
+    template <typename Component, typename... Args>
+    Component& emplace(Entity entity, Args&&... args)
+    {
+        return registry_.emplace<Component>(entity, std::forward<Args>(args)...);
+    }
+
+    template <typename Component>
+    Component& get(Entity entity)
+    {
+        return registry_.get<Component>(entity);
+    }
+
+    void clear()
+    {
+        registry_.clear();
+    }
+
+    void update(float dt)
+    {
+        MemoryScope scope(MemoryTag::Scene);
+        movementSystem(registry_, dt);
+    }
+
+    // Records the sprites that overlap `view`, one draw per texture, with
+    // its center in the middle of the viewport. `pipeline` pairs
+    // spriteVertexShader with a sprite fragment shader; `quadIndices` is a
+    // buffer made by createQuadIndexBuffer. Sprites sharing a texture keep
+    // their storage order, so overlapping sprites should share a texture or
+    // be drawn by a pass of their own.
+    void draw(CommandList& list, const CullRect& view, PipelineId pipeline, BufferId quadIndices)
+    {
+        MemoryScope scope(MemoryTag::Scene);
+        spriteSystem(registry_, view, batches_);
+        batches_.draw(list, pipeline, quadIndices);
+    }
+
+    // Sprites recorded by the last draw.
+    size_t drawnSprites() const
+    {
+        return batches_.quadCount();
+    }
+
+    entt::registry& registry()
+    {
+        return registry_;
+    }
+
+private:
+    entt::registry registry_;
+    SpriteBatches batches_;
+};
+
+} // namespace se
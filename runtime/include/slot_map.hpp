@@ -0,0 +1,182 @@
+#pragma once
+
+#include <compare>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace se {
+
+// Reference to an element of a SlotMap. The generation changes every time a
+// slot is freed, so handles to destroyed elements stop resolving instead of
+// aliasing whatever reuses the slot. `Tag` keeps handles of different
+// resource kinds from being mixed up.
+template <typename Tag>
+struct Handle {
+    static constexpr uint32_t kInvalidIndex = std::numeric_limits<uint32_t>::max();
+
+    uint32_t index { kInvalidIndex };
+    uint32_t generation { 0 };
+
+    bool valid() const
+    {
+        return index != kInvalidIndex;
+    }
+
+    // Index and generation packed into one word, for hashing and logging.
+    uint64_t value() const
+    {
+        return (uint64_t(generation) << 32) | index;
+    }
+
+    auto operator<=>(const Handle&) const = default;
+};
+
+// Unordered container with stable handles. Elements are stored densely so
+// iteration touches only live elements; lookup, insertion and erasure are
+// O(1). Erasing moves the last element into the hole, so pointers and
+// iteration order are not stable across erase.
+template <typename T, typename Tag>
+class SlotMap {
+public:
+    using Key = Handle<Tag>;
+
+    // Generation a slot moves to when its element is erased. Generation 0 is
+    // skipped on wrap-around, so a zero-initialized handle never resolves.
+    static constexpr uint32_t nextGeneration(uint32_t generation)
+    {
+        return generation == std::numeric_limits<uint32_t>::max() ? 1 : generation + 1;
+    }
+
+    Key insert(T value)
+    {
+        uint32_t index;
+        if (free_head_ != kNoSlot) {
+            index = free_head_;
+            free_head_ = slots_[index].dense;
+        } else {
+            if (slots_.size() == Key::kInvalidIndex)
+                return {};
+            index = uint32_t(slots_.size());
+            slots_.push_back({ 0, 1 });
+        }
+
+        slots_[index].dense = uint32_t(values_.size());
+        values_.push_back(std::move(value));
+        keys_.push_back(index);
+
+        return { index, slots_[index].generation };
+    }
+
+    // Returns false for handles that are stale or were never valid.
+    bool erase(Key key)
+    {
+        if (!contains(key))
+            return false;
+
+        Slot& slot = slots_[key.index];
+        uint32_t last = uint32_t(values_.size() - 1);
+        if (slot.dense != last) {
+            values_[slot.dense] = std::move(values_[last]);
+            keys_[slot.dense] = keys_[last];
+            slots_[keys_[last]].dense = slot.dense;
+        }
+        values_.pop_back();
+        keys_.pop_back();
+
+        slot.generation = nextGeneration(slot.generation);
+        slot.dense = free_head_;
+        free_head_ = key.index;
+        return true;
+    }
+
+    bool contains(Key key) const
+    {
+        return key.index < slots_.size()
+            && slots_[key.index].generation == key.generation
+            && slots_[key.index].dense < keys_.size()
+            && keys_[slots_[key.index].dense] == key.index;
+    }
+
+    // Returns nullptr for stale handles.
+    T* get(Key key)
+    {
+        return contains(key) ? &values_[slots_[key.index].dense] : nullptr;
+    }
+
+    const T* get(Key key) const
+    {
+        return contains(key) ? &values_[slots_[key.index].dense] : nullptr;
+    }
+
+    // Handle of the element at dense position `position`, for iteration.
+    Key keyAt(size_t position) const
+    {
+        uint32_t index = keys_[position];
+        return { index, slots_[index].generation };
+    }
+
+    size_t size() const
+    {
+        return values_.size();
+    }
+
+    bool empty() const
+    {
+        return values_.empty();
+    }
+
+    void clear()
+    {
+        while (!empty())
+            erase(keyAt(size() - 1));
+    }
+
+    // Live elements in dense order.
+    auto begin()
+    {
+        return values_.begin();
+    }
+
+    auto end()
+    {
+        return values_.end();
+    }
+
+    auto begin() const
+    {
+        return values_.begin();
+    }
+
+    auto end() const
+    {
+        return values_.end();
+    }
+
+private:
+    static constexpr uint32_t kNoSlot = std::numeric_limits<uint32_t>::max();
+
+    struct Slot {
+        // Position in values_ while live; next free slot while free.
+        uint32_t dense;
+        uint32_t generation;
+    };
+
+    std::vector<Slot> slots_;
+    std::vector<T> values_;
+    // Slot index of each dense element.
+    std::vector<uint32_t> keys_;
+    uint32_t free_head_ { kNoSlot };
+};
+
+} // namespace se
+
+template <typename Tag>
+struct std::hash<se::Handle<Tag>> {
+    size_t operator()(const se::Handle<Tag>& handle) const
+    {
+        return std::hash<uint64_t> {}(handle.value());
+    }
+};
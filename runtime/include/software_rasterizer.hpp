@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "generics.h"
+#include "thread_pool.hpp"
+
+namespace se {
+
+struct Framebuffer {
+    uint32_t width { 0 };
+    uint32_t height { 0 };
+    // Row pitch in pixels, padded to a whole number of tiles.
+    uint32_t stride { 0 };
+    // RGBA8 pixels, top row first.
+    std::vector<uint32_t> pixels;
+
+    uint32_t pixel(uint32_t x, uint32_t y) const
+    {
+        return pixels[y * stride + x];
+    }
+};
+
+// CPU implementation of triangle.metal. Triangles are binned into square
+// tiles, tiles are rasterized in parallel and every tile draws its triangles
+// in submission order, so the output does not depend on the thread count.
+class SoftwareRasterizer {
+public:
+    static constexpr uint32_t kTileSize = 64;
+
+    explicit SoftwareRasterizer(ThreadPool& pool)
+        : pool_(pool)
+    {
+    }
+
+    void resize(uint32_t width, uint32_t height);
+    void clear(uint32_t color);
+
+    // Runs the vertex stage on `count` vertices, three per triangle, using
+    // the same pixel-space to clip-space transform as vertexShader.
+    void addTriangles(const AAPLVertex* vertices, uint32_t count, vector_uint2 viewport);
+
+    // Rasterizes every queued triangle and empties the queue.
+    void flush();
+
+    const Framebuffer& framebuffer() const
+    {
+        return framebuffer_;
+    }
+
+    uint64_t trianglesRasterized() const
+    {
+        return triangles_rasterized_;
+    }
+
+    uint64_t pixelsShaded() const
+    {
+        return pixels_shaded_;
+    }
+
+    // Name of the instruction set the span loop was compiled for.
+    static const char* simdName();
+
+private:
+    struct Triangle {
+        float x[3];
+        float y[3];
+        float color[3][4];
+    };
+
+    // E(x, y) = a * (x - baseX) + b * (y - baseY). The base is the smaller of
+    // the two edge vertices so an edge shared by two triangles evaluates to
+    // exactly opposite values in both.
+    struct Edge {
+        float a;
+        float b;
+        float baseX;
+        float baseY;
+        bool topLeft;
+    };
+
+    // channel(x, y) = value + dx * (x - originX) + dy * (y - originY)
+    struct Gradient {
+        float value;
+        float dx;
+        float dy;
+    };
+
+    struct Setup {
+        Edge edges[3];
+        Gradient color[4];
+        float originX;
+        float originY;
+        int32_t minX;
+        int32_t minY;
+        int32_t maxX;
+        int32_t maxY;
+    };
+
+    bool setup(const Triangle& triangle, Setup& result) const;
+    void bin(size_t chunk, size_t chunks);
+    void rasterizeTile(size_t tile);
+
+    ThreadPool& pool_;
+    Framebuffer framebuffer_;
+    uint32_t tiles_x_ { 0 };
+    uint32_t tiles_y_ { 0 };
+
+    std::vector<Triangle> triangles_;
+    std::vector<Setup> setups_;
+    // One bin list per (chunk, tile); chunks hold consecutive triangle ranges.
+    std::vector<std::vector<uint32_t>> bins_;
+    size_t chunks_ { 0 };
+    std::vector<uint64_t> tile_pixels_;
+
+    uint64_t triangles_rasterized_ { 0 };
+    uint64_t pixels_shaded_ { 0 };
+};
+
+} // namespace se
@@ -0,0 +1,313 @@
+#pragma once
+
+#include <cstring>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "logging.hpp"
+#include "render_backend.hpp"
+#include "software_rasterizer.hpp"
+#include "thread_pool.hpp"
+
+namespace se {
+
+// Headless backend that draws into an in-memory framebuffer. It implements
+// the vertexShader/fragmentShader pair from triangle.metal; other pipelines
+// are created with an error logged and draw nothing.
+class SoftwareRenderBackend : public RenderBackend {
+public:
+    explicit SoftwareRenderBackend(vector_uint2 viewport, size_t threads = std::thread::hardware_concurrency())
+        : viewport_(viewport)
+        , pool_(threads)
+        , rasterizer_(pool_)
+    {
+        rasterizer_.resize(viewport_[0], viewport_[1]);
+    }
+
+    GameLibraryId addLibrary(const void*, size_t) override
+    {
+        std::unique_lock lock(mutex_);
+        return libraries_.insert({});
+    }
+
+    void destroyLibrary(GameLibraryId libraryId) override
+    {
+        std::unique_lock lock(mutex_);
+        libraries_.erase(libraryId);
+    }
+
+    std::unique_ptr<CompiledObject> compileShader(GameLibraryId libraryId, const char* name) override
+    {
+        std::shared_lock lock(mutex_);
+        if (!libraries_.contains(libraryId))
+            FATAL("Unknown library");
+
+        return std::make_unique<Shader>(name);
+    }
+
+    ShaderId addShader(std::unique_ptr<CompiledObject> shader) override
+    {
+        std::unique_lock lock(mutex_);
+        return shaders_.insert(std::move(static_cast<Shader&>(*shader).name));
+    }
+
+    void destroyShader(ShaderId shader) override
+    {
+        std::unique_lock lock(mutex_);
+        shaders_.erase(shader);
+    }
+
+    std::unique_ptr<CompiledObject> compilePipeline(const PipelineDesc& desc) override
+    {
+        std::shared_lock lock(mutex_);
+        const std::string* vertex_shader = shaders_.get(desc.vertexShader);
+        const std::string* fragment_shader = shaders_.get(desc.fragmentShader);
+        if (!vertex_shader || !fragment_shader)
+            FATAL("Unknown shader");
+
+        const char* unsupported = nullptr;
+        if (*vertex_shader != "vertexShader" || *fragment_shader != "fragmentShader")
+            unsupported = "Software backend has no implementation for this shader pair";
+        else if (desc.pixelFormat != PixelFormat::Target && desc.pixelFormat != PixelFormat::RGBA8Unorm)
+            unsupported = "Software backend only renders RGBA8";
+        else if (desc.blend != BlendMode::Opaque)
+            unsupported = "Software backend only supports opaque pipelines";
+        else if (desc.vertexLayout != VertexLayout::AAPLVertex)
+            unsupported = "Software backend only supports AAPLVertex input";
+
+        if (unsupported)
+            ERROR(unsupported);
+        return std::make_unique<Pipeline>(!unsupported);
+    }
+
+    PipelineId addPipeline(std::unique_ptr<CompiledObject> pipeline) override
+    {
+        std::unique_lock lock(mutex_);
+        return pipelines_.insert(Pipeline(static_cast<Pipeline&>(*pipeline).supported));
+    }
+
+    void destroyPipeline(PipelineId pipeline) override
+    {
+        std::unique_lock lock(mutex_);
+        pipelines_.erase(pipeline);
+    }
+
+    // Textures are stored so uploads can be checked and read back, but no
+    // supported pipeline samples them.
+    TextureId createTexture(uint32_t width, uint32_t height) override
+    {
+        return textures_.insert({ width, height, std::vector<uint32_t>(size_t(width) * height) });
+    }
+
+    void updateTexture(TextureId texture, uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+        const uint32_t* pixels, uint32_t stride) override
+    {
+        Texture* target = textures_.get(texture);
+        if (!target || uint64_t(x) + width > target->width || uint64_t(y) + height > target->height) {
+            ERROR("Invalid texture update skipped by software backend");
+            return;
+        }
+
+        for (uint32_t row = 0; row < height; ++row)
+            std::memcpy(&target->pixels[size_t(y + row) * target->width + x], &pixels[size_t(row) * stride],
+                width * sizeof(uint32_t));
+    }
+
+    void destroyTexture(TextureId texture) override
+    {
+        textures_.erase(texture);
+    }
+
+    BufferId createBuffer(const void* data, size_t length) override
+    {
+        if (length == 0)
+            return {};
+
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        return buffers_.insert(std::vector<uint8_t>(bytes, bytes + length));
+    }
+
+    void destroyBuffer(BufferId buffer) override
+    {
+        buffers_.erase(buffer);
+    }
+
+    vector_uint2 viewport() const override
+    {
+        return viewport_;
+    }
+
+    void beginFrame() override
+    {
+        // Opaque black, the Metal default clear color.
+        rasterizer_.clear(0xff000000);
+    }
+
+    void execute(std::span<const CommandList* const> lists) override
+    {
+        for (const CommandList* list : lists) {
+            bool has_pipeline = false;
+            bool supported = false;
+            const AAPLVertex* vertices = nullptr;
+            uint32_t vertex_count = 0;
+
+            list->visit([&](const auto& command) {
+                using Command = std::decay_t<decltype(command)>;
+
+                if constexpr (std::is_same_v<Command, BindPipelineCommand>) {
+                    const Pipeline* pipeline = pipelines_.get(command.pipeline);
+                    has_pipeline = pipeline != nullptr;
+                    supported = pipeline && pipeline->supported;
+                } else if constexpr (std::is_same_v<Command, SetVertexBytesCommand>) {
+                    if (command.index == AAPLVertexInputIndexVertices) {
+                        vertices = static_cast<const AAPLVertex*>(command.bytes());
+                        vertex_count = command.length / sizeof(AAPLVertex);
+                    }
+                } else if constexpr (std::is_same_v<Command, BindVertexBufferCommand>) {
+                    const std::vector<uint8_t>* buffer = buffers_.get(command.buffer);
+                    if (command.index == AAPLVertexInputIndexVertices && buffer && command.offset <= buffer->size()) {
+                        vertices = reinterpret_cast<const AAPLVertex*>(buffer->data() + command.offset);
+                        vertex_count = uint32_t((buffer->size() - command.offset) / sizeof(AAPLVertex));
+                    }
+                } else if constexpr (std::is_same_v<Command, DrawCommand>) {
+                    if (has_pipeline && !supported)
+                        return;
+                    if (!has_pipeline || uint64_t(command.vertexStart) + command.vertexCount > vertex_count) {
+                        ERROR("Invalid draw skipped by software backend");
+                        return;
+                    }
+                    rasterizer_.addTriangles(vertices + command.vertexStart, command.vertexCount, viewport_);
+                } else if constexpr (std::is_same_v<Command, DrawIndexedCommand>) {
+                    if (has_pipeline && !supported)
+                        return;
+                    if (!has_pipeline || !gatherIndexed(command, vertices, vertex_count)) {
+                        ERROR("Invalid draw skipped by software backend");
+                        return;
+                    }
+                    rasterizer_.addTriangles(gathered_.data(), uint32_t(gathered_.size()), viewport_);
+                }
+            });
+        }
+
+        rasterizer_.flush();
+    }
+
+    void endFrame() override
+    {
+        if (!capture_)
+            return;
+
+        if (CapturedFrame* captured = capture_->acquire()) {
+            const Framebuffer& framebuffer = rasterizer_.framebuffer();
+
+            captured->width = framebuffer.width;
+            captured->height = framebuffer.height;
+            captured->pixels.resize(size_t(framebuffer.width) * framebuffer.height);
+
+            for (uint32_t y = 0; y < framebuffer.height; ++y)
+                std::memcpy(&captured->pixels[size_t(y) * framebuffer.width],
+                    &framebuffer.pixels[size_t(y) * framebuffer.stride],
+                    framebuffer.width * sizeof(uint32_t));
+
+            capture_->submit(captured);
+        }
+
+        capture_ = nullptr;
+    }
+
+    bool requestCapture(FrameCapture& capture) override
+    {
+        capture_ = &capture;
+        return true;
+    }
+
+    const Framebuffer& framebuffer() const
+    {
+        return rasterizer_.framebuffer();
+    }
+
+    const SoftwareRasterizer& rasterizer() const
+    {
+        return rasterizer_;
+    }
+
+private:
+    // The rasterizer takes plain triangle lists, so indexed vertices are
+    // expanded into gathered_.
+    bool gatherIndexed(const DrawIndexedCommand& command, const AAPLVertex* vertices, uint32_t vertex_count)
+    {
+        const std::vector<uint8_t>* indices = buffers_.get(command.indexBuffer);
+        uint32_t index_size = indexSize(command.indexType);
+        if (!indices || (uint64_t(command.indexStart) + command.indexCount) * index_size > indices->size())
+            return false;
+
+        gathered_.resize(command.indexCount);
+        const uint8_t* data = indices->data() + size_t(command.indexStart) * index_size;
+        for (uint32_t i = 0; i < command.indexCount; ++i) {
+            uint32_t index;
+            if (command.indexType == IndexType::UInt16) {
+                uint16_t narrow;
+                std::memcpy(&narrow, data + size_t(i) * sizeof(narrow), sizeof(narrow));
+                index = narrow;
+            } else {
+                std::memcpy(&index, data + size_t(i) * sizeof(index), sizeof(index));
+            }
+            if (index >= vertex_count)
+                return false;
+            gathered_[i] = vertices[index];
+        }
+        return true;
+    }
+
+    struct Library {
+    };
+
+    // Unsupported pipelines stay valid ids so draws with them are skipped
+    // quietly; the error is logged once when they are compiled.
+    struct Pipeline : CompiledObject {
+        explicit Pipeline(bool supported)
+            : supported(supported)
+        {
+        }
+
+        bool supported;
+    };
+
+    struct Texture {
+        uint32_t width;
+        uint32_t height;
+        std::vector<uint32_t> pixels;
+    };
+
+    struct Shader : CompiledObject {
+        explicit Shader(std::string name)
+            : name(std::move(name))
+        {
+        }
+
+        std::string name;
+    };
+
+    vector_uint2 viewport_;
+
+    ThreadPool pool_;
+    SoftwareRasterizer rasterizer_;
+
+    // Guards the resource tables against compiles on worker threads.
+    std::shared_mutex mutex_;
+    SlotMap<Library, GameLibraryTag> libraries_;
+    SlotMap<std::string, ShaderTag> shaders_;
+    SlotMap<Pipeline, PipelineTag> pipelines_;
+    // Frame thread only.
+    SlotMap<Texture, TextureTag> textures_;
+    SlotMap<std::vector<uint8_t>, BufferTag> buffers_;
+    std::vector<AAPLVertex> gathered_;
+
+    FrameCapture* capture_ { nullptr };
+};
+
+} // namespace se
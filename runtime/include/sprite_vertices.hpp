@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+
+#include "generics.h"
+
+namespace se {
+
+// Many sprites as structure of arrays, element i of every array describing
+// sprite i. Kept apart so the kernel below loads eight sprites' worth of one
+// property with a single instruction.
+struct SpriteStreams {
+    const float* x { nullptr };
+    const float* y { nullptr };
+    // Radians, counterclockwise.
+    const float* rotation { nullptr };
+    // Quad size in pixels: the sprite's size times its scale.
+    const float* width { nullptr };
+    const float* height { nullptr };
+    // Normalized (u0, v0, u1, v1) in the texture.
+    const vector_float4* uv { nullptr };
+    const vector_float4* color { nullptr };
+};
+
+// Writes the quads of `count` sprites to `out`, four vertices per sprite in
+// the order SpriteBatches keeps them, without culling. Sines and cosines
+// come from a polynomial accurate to about 2e-7 for rotations within
+// +-8192 pi. Larger rotations are first reduced by a float 2 pi, which
+// loses precision as they grow; infinite and NaN ones give NaN positions.
+// The AVX2 and scalar kernels give bit-identical results.
+//
+// Runs eight sprites at a time with AVX2 or four with NEON; which one is
+// picked once at run time from the CPU. Defining
+// SE_SPRITE_VERTICES_SCALAR compiles only the portable version.
+void generateSpriteVertices(const SpriteStreams& sprites, size_t count, AAPLSpriteVertex* out);
+
+// "avx2", "neon" or "scalar".
+const char* spriteVerticesKernelName();
+
+} // namespace se
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <entt/entt.hpp>
+
+#include "thread_pool.hpp"
+
+namespace se {
+
+namespace detail {
+    inline uint32_t nextComponentId()
+    {
+        static std::atomic<uint32_t> next { 0 };
+        return next.fetch_add(1, std::memory_order_relaxed);
+    }
+} // namespace detail
+
+// Process-wide id of a component type, assigned on first use.
+template <typename Component>
+uint32_t componentId()
+{
+    static const uint32_t id = detail::nextComponentId();
+    return id;
+}
+
+// The components a system touches. Two systems conflict when one writes a
+// component the other reads or writes, or when either is exclusive.
+// Systems that create or destroy entities, or add or remove components,
+// change the registry itself and must be exclusive.
+class SystemAccess {
+public:
+    template <typename... Components>
+    SystemAccess& reads()
+    {
+        (add<Components>(reads_), ...);
+        return *this;
+    }
+
+    template <typename... Components>
+    SystemAccess& writes()
+    {
+        (add<Components>(writes_), ...);
+        return *this;
+    }
+
+    SystemAccess& exclusive()
+    {
+        exclusive_ = true;
+        return *this;
+    }
+
+    bool conflicts(const SystemAccess& other) const;
+
+private:
+    friend class SystemScheduler;
+
+    using Prepare = void (*)(entt::registry&);
+
+    template <typename Component>
+    void add(std::vector<uint32_t>& ids)
+    {
+        using Type = std::remove_const_t<Component>;
+        ids.push_back(componentId<Type>());
+        prepare_.push_back([](entt::registry& registry) {
+            static_cast<void>(registry.view<Type>());
+        });
+    }
+
+    static bool overlaps(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b);
+
+    std::vector<uint32_t> reads_;
+    std::vector<uint32_t> writes_;
+    // Creates the storage of every declared component, since creating
+    // storage concurrently would race on the registry.
+    std::vector<Prepare> prepare_;
+    bool exclusive_ { false };
+};
+
+// Runs systems over a registry with the result of running them one after
+// another in the order they were added. A system waits only for earlier
+// systems it conflicts with, so non-conflicting systems run in parallel on
+// the threads of a ThreadPool. Systems must touch only the components they
+// declare. A system may run its own loops on that pool, e.g. through
+// BoundsCuller::cull; they run inline on the thread running the system.
+//
+//     scheduler.add("movement", SystemAccess().writes<Transform>().reads<Velocity>(), movementSystem);
+class SystemScheduler {
+public:
+    using System = std::function<void(entt::registry&, float)>;
+
+    void add(std::string name, const SystemAccess& access, System system);
+    void clear();
+
+    // One after another on the calling thread.
+    void run(entt::registry& registry, float dt);
+    void run(entt::registry& registry, float dt, ThreadPool& pool);
+
+    size_t size() const
+    {
+        return systems_.size();
+    }
+
+    const std::string& name(size_t index) const
+    {
+        return systems_[index].name;
+    }
+
+    // Indices of the earlier systems `index` waits for.
+    std::vector<size_t> dependencies(size_t index);
+
+private:
+    struct Node {
+        std::string name;
+        SystemAccess access;
+        System system;
+        std::vector<size_t> successors;
+        size_t dependencies { 0 };
+    };
+
+    void buildGraph();
+    void prepare(entt::registry& registry);
+    void drain(entt::registry& registry, float dt);
+
+    std::vector<Node> systems_;
+    bool dirty_ { false };
+
+    std::mutex mutex_;
+    std::condition_variable ready_changed_;
+    std::vector<size_t> ready_;
+    std::vector<size_t> pending_;
+    size_t remaining_ { 0 };
+};
+
+} // namespace se
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+namespace se {
+
+template <typename T = void>
+class Task;
+
+namespace detail {
+
+    struct TaskPromiseBase {
+        // Resumed when the task finishes, if another task awaits it.
+        std::coroutine_handle<> continuation;
+
+        struct FinalAwaiter {
+            bool await_ready() noexcept
+            {
+                return false;
+            }
+
+            template <typename Promise>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+            {
+                std::coroutine_handle<> continuation = handle.promise().continuation;
+                return continuation ? continuation : std::noop_coroutine();
+            }
+
+            void await_resume() noexcept
+            {
+            }
+        };
+
+        std::suspend_always initial_suspend() noexcept
+        {
+            return {};
+        }
+
+        FinalAwaiter final_suspend() noexcept
+        {
+            return {};
+        }
+
+        void unhandled_exception()
+        {
+            std::terminate();
+        }
+    };
+
+    template <typename T>
+    struct TaskPromise : TaskPromiseBase {
+        std::optional<T> value;
+
+        Task<T> get_return_object();
+
+        void return_value(T result)
+        {
+            value.emplace(std::move(result));
+        }
+    };
+
+    template <>
+    struct TaskPromise<void> : TaskPromiseBase {
+        Task<void> get_return_object();
+
+        void return_void()
+        {
+        }
+    };
+
+} // namespace detail
+
+// Coroutine that starts suspended and runs when first resumed: by a task
+// awaiting it, which continues once it finishes, or by a TaskScheduler it
+// was spawned on. Owns its frame, which is destroyed with the task.
+template <typename T>
+class [[nodiscard]] Task {
+public:
+    using promise_type = detail::TaskPromise<T>;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    Task() = default;
+
+    explicit Task(Handle handle)
+        : handle_(handle)
+    {
+    }
+
+    Task(Task&& other) noexcept
+        : handle_(std::exchange(other.handle_, {}))
+    {
+    }
+
+    Task& operator=(Task&& other) noexcept
+    {
+        if (this != &other) {
+            if (handle_)
+                handle_.destroy();
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+
+    ~Task()
+    {
+        if (handle_)
+            handle_.destroy();
+    }
+
+    bool done() const
+    {
+        return !handle_ || handle_.done();
+    }
+
+    // Starts the awaited task right away on the awaiting thread.
+    auto operator co_await() const noexcept
+    {
+        struct Awaiter {
+            Handle handle;
+
+            bool await_ready() const noexcept
+            {
+                return !handle || handle.done();
+            }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+            {
+                handle.promise().continuation = awaiting;
+                return handle;
+            }
+
+            T await_resume()
+            {
+                if constexpr (!std::is_void_v<T>)
+                    return std::move(*handle.promise().value);
+            }
+        };
+        return Awaiter { handle_ };
+    }
+
+    Handle handle() const
+    {
+        return handle_;
+    }
+
+private:
+    Handle handle_;
+};
+
+namespace detail {
+
+    template <typename T>
+    Task<T> TaskPromise<T>::get_return_object()
+    {
+        return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+    }
+
+    inline Task<void> TaskPromise<void>::get_return_object()
+    {
+        return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+    }
+
+} // namespace detail
+
+} // namespace se
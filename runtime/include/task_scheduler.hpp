@@ -0,0 +1,194 @@
+#pragma once
+
+#include <coroutine>
+#include <cstdint>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "background_queue.hpp"
+#include "task.hpp"
+
+namespace se {
+
+// Resumes tasks that wait for a frame, for time to pass or for the main
+// thread, from pump(), which the frame loop calls once per frame on the
+// main thread. Tasks that move to a worker run on a BackgroundQueue owned
+// by the scheduler until they come back.
+//
+//     Task<> load(TaskScheduler& tasks)
+//     {
+//         co_await tasks.onWorker();
+//         decode();
+//         co_await tasks.onMainThread();
+//         upload();
+//         co_await tasks.delay(500);
+//         fadeIn();
+//     }
+//
+// The thread that constructs the scheduler is its main thread. Tasks are
+// spawned there; awaiting the scheduler is allowed from any thread.
+class TaskScheduler {
+public:
+    struct NextFrameAwaiter {
+        TaskScheduler& scheduler;
+
+        bool await_ready() const noexcept
+        {
+            return false;
+        }
+
+        void await_suspend(std::coroutine_handle<> handle)
+        {
+            scheduler.resumeNextFrame(handle);
+        }
+
+        void await_resume() const noexcept
+        {
+        }
+    };
+
+    struct DelayAwaiter {
+        TaskScheduler& scheduler;
+        double milliseconds;
+
+        bool await_ready() const noexcept
+        {
+            return milliseconds <= 0;
+        }
+
+        void await_suspend(std::coroutine_handle<> handle)
+        {
+            scheduler.resumeAfter(handle, milliseconds);
+        }
+
+        void await_resume() const noexcept
+        {
+        }
+    };
+
+    struct WorkerAwaiter {
+        TaskScheduler& scheduler;
+
+        bool await_ready() const noexcept
+        {
+            return false;
+        }
+
+        void await_suspend(std::coroutine_handle<> handle)
+        {
+            scheduler.workers_.submit([handle]() { handle.resume(); });
+        }
+
+        void await_resume() const noexcept
+        {
+        }
+    };
+
+    struct MainThreadAwaiter {
+        TaskScheduler& scheduler;
+
+        bool await_ready() const noexcept
+        {
+            return std::this_thread::get_id() == scheduler.main_thread_;
+        }
+
+        void await_suspend(std::coroutine_handle<> handle)
+        {
+            scheduler.resumeNextFrame(handle);
+        }
+
+        void await_resume() const noexcept
+        {
+        }
+    };
+
+    explicit TaskScheduler(size_t workerThreads = 1);
+    ~TaskScheduler();
+
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    // Takes ownership of `task`, which starts at the next pump.
+    void spawn(Task<> task);
+
+    // Resumes the tasks that became ready. `deltaTime` is the frame time in
+    // milliseconds, as given by Clock::delta, and advances the time delay()
+    // counts in.
+    void pump(double deltaTime);
+
+    // Resumes at the next pump.
+    NextFrameAwaiter nextFrame()
+    {
+        return { *this };
+    }
+
+    // Resumes at the first pump after `milliseconds` of pumped time.
+    DelayAwaiter delay(double milliseconds)
+    {
+        return { *this, milliseconds };
+    }
+
+    // Resumes on a worker thread.
+    WorkerAwaiter onWorker()
+    {
+        return { *this };
+    }
+
+    // Resumes on the main thread at the next pump; continues right away when
+    // already there.
+    MainThreadAwaiter onMainThread()
+    {
+        return { *this };
+    }
+
+    // Spawned tasks that have not finished.
+    size_t activeTasks() const
+    {
+        return tasks_.size();
+    }
+
+    // Milliseconds pumped so far.
+    double time() const
+    {
+        return time_;
+    }
+
+private:
+    struct Timer {
+        double deadline;
+        uint64_t sequence;
+        std::coroutine_handle<> handle;
+
+        // Earliest first, then in the order they were set.
+        bool operator>(const Timer& other) const
+        {
+            return deadline != other.deadline ? deadline > other.deadline : sequence > other.sequence;
+        }
+    };
+
+    Task<> run(Task<> task, uint64_t id);
+    void resumeNextFrame(std::coroutine_handle<> handle);
+    void resumeAfter(std::coroutine_handle<> handle, double milliseconds);
+
+    std::thread::id main_thread_;
+
+    std::mutex mutex_;
+    std::vector<std::coroutine_handle<>> next_frame_;
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> timers_;
+    uint64_t timer_sequence_ { 0 };
+    double time_ { 0 };
+
+    // Touched by the main thread only.
+    std::vector<std::coroutine_handle<>> resuming_;
+    std::unordered_map<uint64_t, Task<>> tasks_;
+    std::vector<uint64_t> finished_;
+    uint64_t next_task_ { 0 };
+
+    // Last, so it is joined before the tasks it may be running are destroyed.
+    BackgroundQueue workers_;
+};
+
+} // namespace se
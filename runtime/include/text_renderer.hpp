@@ -0,0 +1,121 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+
+#include "command_list.hpp"
+#include "glyph_cache.hpp"
+
+namespace se {
+
+// Lays out strings of the built-in font into sprite quads and records all
+// text of a frame as a single indexed draw. Positions are in pixels from the
+// top left of the viewport. `pipeline` must be an alpha-blended pipeline of
+// the sprite shaders with the AAPLSpriteVertex layout.
+class TextRenderer {
+public:
+    // `quadIndices` is a buffer made by createQuadIndexBuffer.
+    TextRenderer(RenderBackend& backend, PipelineId pipeline, BufferId quadIndices, vector_uint2 viewport, uint32_t atlasSize = 512)
+        : glyphs_(backend, atlasSize)
+        , pipeline_(pipeline)
+        , quad_indices_(quadIndices)
+    {
+        setViewport(viewport);
+    }
+
+    void setViewport(vector_uint2 viewport)
+    {
+        half_width_ = float(viewport[0]) * 0.5f;
+        half_height_ = float(viewport[1]) * 0.5f;
+    }
+
+    // '\n' starts a new line. Glyphs are kBitmapFontSize * scale pixels.
+    void drawText(std::string_view text, float x, float y, vector_float4 color = vector_float4 { 1, 1, 1, 1 }, uint32_t scale = 1)
+    {
+        float advance = float(kBitmapFontSize * scale);
+
+        // The vertex shader maps pixels around the viewport center, y up.
+        float left = x - half_width_;
+        float pen_x = left;
+        float pen_y = half_height_ - y;
+
+        size_t count = vertices_.size();
+        vertices_.resize(count + text.size() * 4);
+        AAPLSpriteVertex* out = vertices_.data() + count;
+
+        for (char character : text) {
+            if (character == '\n') {
+                pen_x = left;
+                pen_y -= advance;
+                continue;
+            }
+            if (character == ' ') {
+                pen_x += advance;
+                continue;
+            }
+
+            const Glyph* glyph = glyphs_.glyph(uint8_t(character), scale);
+            if (!glyph) {
+                pen_x += advance;
+                continue;
+            }
+
+            float x0 = pen_x;
+            float x1 = pen_x + float(glyph->width);
+            float y0 = pen_y;
+            float y1 = pen_y - float(glyph->height);
+            vector_float4 uv = glyph->uv;
+
+            out[0] = spriteVertex(x0, y0, uv[0], uv[1], color);
+            out[1] = spriteVertex(x1, y0, uv[2], uv[1], color);
+            out[2] = spriteVertex(x0, y1, uv[0], uv[3], color);
+            out[3] = spriteVertex(x1, y1, uv[2], uv[3], color);
+            out += 4;
+
+            pen_x += advance;
+        }
+
+        vertices_.resize(out - vertices_.data());
+    }
+
+    // Records everything drawn since the last call into `list` and starts a
+    // new frame. Glyphs first used this frame are uploaded beforehand.
+    void submit(CommandList& list)
+    {
+        glyphs_.upload();
+        if (!vertices_.empty())
+            list.drawSpriteQuads(vertices_.data(), vertices_.size() / 4, pipeline_, glyphs_.texture(), quad_indices_);
+
+        vertices_.clear();
+        glyphs_.nextFrame();
+    }
+
+    size_t glyphCount() const
+    {
+        return vertices_.size() / 4;
+    }
+
+    const GlyphCache& glyphCache() const
+    {
+        return glyphs_;
+    }
+
+private:
+    static AAPLSpriteVertex spriteVertex(float x, float y, float u, float v, vector_float4 color)
+    {
+        AAPLSpriteVertex vertex;
+        vertex.position = vector_float2 { x, y };
+        vertex.uv = vector_float2 { u, v };
+        vertex.color = color;
+        return vertex;
+    }
+
+    GlyphCache glyphs_;
+    PipelineId pipeline_;
+    BufferId quad_indices_;
+    float half_width_;
+    float half_height_;
+    std::vector<AAPLSpriteVertex> vertices_;
+};
+
+} // namespace se
@@ -0,0 +1,246 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "generics.h"
+#include "rect_packer.hpp"
+#include "render_backend.hpp"
+#include "slot_map.hpp"
+
+namespace se {
+
+using AtlasEntryId = Handle<struct AtlasEntryTag>;
+
+struct AtlasRegion {
+    TextureId texture;
+    uint32_t page { 0 };
+    uint32_t x { 0 };
+    uint32_t y { 0 };
+    uint32_t width { 0 };
+    uint32_t height { 0 };
+    // Normalized (u0, v0, u1, v1) of the region for AAPLSpriteVertex::uv.
+    vector_float4 uv;
+};
+
+struct TextureAtlasStats {
+    uint64_t inserts { 0 };
+    uint64_t failedInserts { 0 };
+    uint64_t removes { 0 };
+    uint64_t uploads { 0 };
+    uint64_t uploadedBytes { 0 };
+};
+
+// Packs many small RGBA8 images into a few large texture pages so sprites
+// can share one texture binding. Images are added and evicted one at a time;
+// pixels are kept on the CPU and only the regions written since the last
+// upload() are sent to the backend.
+class TextureAtlas {
+public:
+    // Entries are separated by `padding` transparent pixels so sampling at a
+    // region's edge never picks up its neighbour.
+    TextureAtlas(RenderBackend& backend, uint32_t pageSize = 2048, uint32_t maxPages = 4, uint32_t padding = 1)
+        : backend_(backend)
+        , page_size_(pageSize)
+        , max_pages_(maxPages)
+        , padding_(padding)
+    {
+    }
+
+    ~TextureAtlas()
+    {
+        for (const std::unique_ptr<Page>& page : pages_)
+            backend_.destroyTexture(page->texture);
+    }
+
+    TextureAtlas(const TextureAtlas&) = delete;
+    TextureAtlas& operator=(const TextureAtlas&) = delete;
+
+    // Returns an invalid id when no page has room and no page may be added;
+    // the caller is expected to evict entries and try again. `stride` is in
+    // pixels.
+    AtlasEntryId insert(uint32_t width, uint32_t height, const uint32_t* pixels, uint32_t stride)
+    {
+        uint32_t padded_width = width + 2 * padding_;
+        uint32_t padded_height = height + 2 * padding_;
+
+        for (uint32_t i = 0; i < pages_.size(); ++i) {
+            if (std::optional<PackedRect> rect = pages_[i]->packer.insert(padded_width, padded_height))
+                return add(i, *rect, pixels, stride);
+        }
+
+        if (pages_.size() < max_pages_ && padded_width <= page_size_ && padded_height <= page_size_) {
+            addPage();
+            if (std::optional<PackedRect> rect = pages_.back()->packer.insert(padded_width, padded_height))
+                return add(uint32_t(pages_.size() - 1), *rect, pixels, stride);
+        }
+
+        ++stats_.failedInserts;
+        return {};
+    }
+
+    // Frees the entry's space for later inserts. Pixels are not cleared, so
+    // draws that still use the old region keep working until it is reused.
+    void remove(AtlasEntryId entry)
+    {
+        const Entry* found = entries_.get(entry);
+        if (!found)
+            return;
+
+        pages_[found->region.page]->packer.remove(found->packed);
+        entries_.erase(entry);
+        ++stats_.removes;
+    }
+
+    // Returns nullptr for removed entries.
+    const AtlasRegion* region(AtlasEntryId entry) const
+    {
+        const Entry* found = entries_.get(entry);
+        return found ? &found->region : nullptr;
+    }
+
+    // Sends every region written since the last call to the backend. Called
+    // once per frame before the draws that use new entries are executed.
+    void upload()
+    {
+        for (const std::unique_ptr<Page>& page : pages_) {
+            if (page->dirty.empty())
+                continue;
+
+            // Many small writes are cheaper as one larger copy.
+            if (page->dirty.size() > kMaxDirtyRects) {
+                PackedRect bounds = page->dirty.front();
+                for (const PackedRect& rect : page->dirty)
+                    bounds = unite(bounds, rect);
+                page->dirty.assign(1, bounds);
+            }
+
+            for (const PackedRect& rect : page->dirty) {
+                backend_.updateTexture(page->texture, rect.x, rect.y, rect.width, rect.height,
+                    &page->pixels[size_t(rect.y) * page_size_ + rect.x], page_size_);
+                ++stats_.uploads;
+                stats_.uploadedBytes += uint64_t(rect.width) * rect.height * sizeof(uint32_t);
+            }
+            page->dirty.clear();
+        }
+    }
+
+    size_t entryCount() const
+    {
+        return entries_.size();
+    }
+
+    size_t pageCount() const
+    {
+        return pages_.size();
+    }
+
+    uint32_t pageSize() const
+    {
+        return page_size_;
+    }
+
+    TextureId pageTexture(uint32_t page) const
+    {
+        return pages_[page]->texture;
+    }
+
+    // Fraction of the page covered by entries, padding included.
+    double occupancy(uint32_t page) const
+    {
+        return pages_[page]->packer.occupancy();
+    }
+
+    const TextureAtlasStats& stats() const
+    {
+        return stats_;
+    }
+
+private:
+    static constexpr size_t kMaxDirtyRects = 64;
+
+    struct Page {
+        explicit Page(uint32_t size)
+            : packer(size, size)
+            , pixels(size_t(size) * size)
+        {
+        }
+
+        TextureId texture;
+        RectPacker packer;
+        std::vector<uint32_t> pixels;
+        std::vector<PackedRect> dirty;
+    };
+
+    struct Entry {
+        AtlasRegion region;
+        PackedRect packed;
+    };
+
+    static PackedRect unite(const PackedRect& a, const PackedRect& b)
+    {
+        uint32_t x = std::min(a.x, b.x);
+        uint32_t y = std::min(a.y, b.y);
+        return { x, y,
+            std::max(a.x + a.width, b.x + b.width) - x,
+            std::max(a.y + a.height, b.y + b.height) - y };
+    }
+
+    void addPage()
+    {
+        auto page = std::make_unique<Page>(page_size_);
+        page->texture = backend_.createTexture(page_size_, page_size_);
+        // The whole page once, so padding starts out transparent.
+        page->dirty.push_back({ 0, 0, page_size_, page_size_ });
+        pages_.push_back(std::move(page));
+    }
+
+    AtlasEntryId add(uint32_t page_index, const PackedRect& packed, const uint32_t* pixels, uint32_t stride)
+    {
+        Page& page = *pages_[page_index];
+
+        Entry entry;
+        entry.packed = packed;
+        entry.region.texture = page.texture;
+        entry.region.page = page_index;
+        entry.region.x = packed.x + padding_;
+        entry.region.y = packed.y + padding_;
+        entry.region.width = packed.width - 2 * padding_;
+        entry.region.height = packed.height - 2 * padding_;
+
+        float scale = 1.0f / float(page_size_);
+        entry.region.uv = vector_float4 {
+            float(entry.region.x) * scale,
+            float(entry.region.y) * scale,
+            float(entry.region.x + entry.region.width) * scale,
+            float(entry.region.y + entry.region.height) * scale
+        };
+
+        // Clears the padding as well, since a reused region may hold old pixels.
+        for (uint32_t row = 0; row < packed.height; ++row)
+            std::memset(&page.pixels[size_t(packed.y + row) * page_size_ + packed.x], 0, packed.width * sizeof(uint32_t));
+        for (uint32_t row = 0; row < entry.region.height; ++row)
+            std::memcpy(&page.pixels[size_t(entry.region.y + row) * page_size_ + entry.region.x],
+                &pixels[size_t(row) * stride], entry.region.width * sizeof(uint32_t));
+
+        bool whole_page_dirty = !page.dirty.empty() && page.dirty.front() == PackedRect { 0, 0, page_size_, page_size_ };
+        if (!whole_page_dirty)
+            page.dirty.push_back(packed);
+
+        ++stats_.inserts;
+        return entries_.insert(entry);
+    }
+
+    RenderBackend& backend_;
+    uint32_t page_size_;
+    uint32_t max_pages_;
+    uint32_t padding_;
+
+    std::vector<std::unique_ptr<Page>> pages_;
+    SlotMap<Entry, AtlasEntryTag> entries_;
+    TextureAtlasStats stats_;
+};
+
+} // namespace se
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace se {
+
+// Fixed set of worker threads for fork-join loops. The calling thread takes
+// part in every loop, so a pool of N threads starts N - 1 workers.
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t threads = std::thread::hardware_concurrency())
+    {
+        for (size_t i = 1; i < threads; ++i)
+            workers_.emplace_back([this]() { work(); });
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::unique_lock lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+
+        for (std::thread& worker : workers_)
+            worker.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t threadCount() const
+    {
+        return workers_.size() + 1;
+    }
+
+    // Calls `fn(i)` for every i in [0, count) and returns once all calls have
+    // finished. Calls may run in any order and on any pool thread.
+    //
+    // A loop started from inside a loop of the same pool runs inline on the
+    // calling thread: the other threads are busy with the outer loop, and
+    // waiting for them would deadlock.
+    template <typename Fn>
+    void parallelFor(size_t count, Fn&& fn)
+    {
+        if (workers_.empty() || count <= 1 || running_ == this) {
+            for (size_t i = 0; i < count; ++i)
+                fn(i);
+            return;
+        }
+
+        std::unique_lock submit_lock(submit_mutex_);
+        {
+            std::unique_lock lock(mutex_);
+            // A worker that woke up late for the previous loop may still be
+            // leaving it; wait so it cannot pick up indices of this one.
+            idle_.wait(lock, [this]() { return active_ == 0; });
+
+            task_ = [&fn](size_t i) { fn(i); };
+            count_ = count;
+            next_ = 0;
+            done_ = 0;
+            ++generation_;
+        }
+        wake_.notify_all();
+
+        const ThreadPool* outer = std::exchange(running_, this);
+        runTasks();
+        running_ = outer;
+
+        std::unique_lock lock(mutex_);
+        idle_.wait(lock, [this]() { return active_ == 0 && done_ == count_; });
+        task_ = nullptr;
+    }
+
+private:
+    void work()
+    {
+        running_ = this;
+        uint64_t seen = 0;
+
+        for (;;) {
+            {
+                std::unique_lock lock(mutex_);
+                wake_.wait(lock, [&]() { return stop_ || generation_ != seen; });
+                if (stop_)
+                    return;
+
+                seen = generation_;
+                ++active_;
+            }
+
+            runTasks();
+
+            {
+                std::unique_lock lock(mutex_);
+                --active_;
+            }
+            idle_.notify_all();
+        }
+    }
+
+    void runTasks()
+    {
+        for (;;) {
+            size_t i = next_.fetch_add(1, std::memory_order_relaxed);
+            if (i >= count_)
+                break;
+
+            task_(i);
+            done_.fetch_add(1, std::memory_order_release);
+        }
+    }
+
+    // The pool whose loop the current thread is running, if any.
+    static inline thread_local const ThreadPool* running_ { nullptr };
+
+    std::vector<std::thread> workers_;
+
+    std::mutex submit_mutex_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable idle_;
+    bool stop_ { false };
+    uint64_t generation_ { 0 };
+    size_t active_ { 0 };
+
+    std::function<void(size_t)> task_;
+    size_t count_ { 0 };
+    std::atomic<size_t> next_ { 0 };
+    std::atomic<size_t> done_ { 0 };
+};
+
+} // namespace se
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "command_list.hpp"
+#include "culling.hpp"
+#include "generics.h"
+#include "render_backend.hpp"
+
+namespace se {
+
+struct TilemapStats {
+    uint64_t chunkBuilds { 0 };
+    uint64_t chunkEvictions { 0 };
+    // Of the last draw.
+    uint32_t drawnChunks { 0 };
+    uint32_t drawnTiles { 0 };
+};
+
+// Grid of tiles drawn from cached geometry. The map is split into chunks of
+// kChunkTiles x kChunkTiles tiles whose quads are built into a backend
+// buffer the first time the chunk is visible and rebuilt only after one of
+// its tiles changed, so a frame costs one draw per visible chunk no matter
+// how large the map is. Buffers of the chunks seen least recently are
+// released once more than `maxResidentChunks` are built.
+//
+// Tile (0, 0) is the top left one, with its top left corner at the origin
+// of the vertex shaders' pixel space; rows extend downwards.
+class Tilemap {
+public:
+    static constexpr uint32_t kChunkTiles = 32;
+    static constexpr uint16_t kEmptyTile = 0;
+
+    // `quadIndices` is a buffer made by createQuadIndexBuffer.
+    Tilemap(RenderBackend& backend, BufferId quadIndices, uint32_t width, uint32_t height, uint32_t tileSize,
+        size_t maxResidentChunks = 1024);
+    ~Tilemap();
+
+    Tilemap(const Tilemap&) = delete;
+    Tilemap& operator=(const Tilemap&) = delete;
+
+    // Where `tile` is found in the tileset texture, as normalized
+    // (u0, v0, u1, v1). Changing a region does not rebuild built chunks.
+    void setTileRegion(uint16_t tile, vector_float4 uv);
+
+    void setTile(uint32_t x, uint32_t y, uint16_t tile);
+    uint16_t tile(uint32_t x, uint32_t y) const
+    {
+        return tiles_[size_t(y) * width_ + x];
+    }
+
+    // Records the chunks overlapping `view`, building those that are new or
+    // changed first. `pipeline` pairs tileVertexShader with
+    // spriteFragmentShader and uses VertexLayout::AAPLPackedSpriteVertex.
+    void draw(CommandList& list, const CullRect& view, PipelineId pipeline, TextureId tileset);
+
+    uint32_t width() const
+    {
+        return width_;
+    }
+
+    uint32_t height() const
+    {
+        return height_;
+    }
+
+    uint32_t tileSize() const
+    {
+        return tile_size_;
+    }
+
+    size_t residentChunks() const
+    {
+        return resident_.size();
+    }
+
+    const TilemapStats& stats() const
+    {
+        return stats_;
+    }
+
+private:
+    struct TileRegion {
+        vector_ushort2 uv0;
+        vector_ushort2 uv1;
+    };
+
+    struct Chunk {
+        BufferId buffer;
+        uint32_t quadCount { 0 };
+        uint64_t lastDrawn { 0 };
+        bool dirty { true };
+    };
+
+    Chunk& chunkAt(uint32_t x, uint32_t y)
+    {
+        return chunks_[size_t(y) * chunks_x_ + x];
+    }
+
+    void build(uint32_t chunk_x, uint32_t chunk_y);
+    void evict();
+
+    RenderBackend& backend_;
+    BufferId quad_indices_;
+    uint32_t width_;
+    uint32_t height_;
+    uint32_t tile_size_;
+    uint32_t chunks_x_;
+    uint32_t chunks_y_;
+    size_t max_resident_;
+
+    std::vector<uint16_t> tiles_;
+    // Indexed by tile id, in the packed unorm16 form of the vertices.
+    std::vector<TileRegion> regions_;
+    std::vector<Chunk> chunks_;
+    // Indices into chunks_ of chunks that hold a buffer.
+    std::vector<uint32_t> resident_;
+    std::vector<AAPLPackedSpriteVertex> scratch_;
+
+    uint64_t frame_ { 0 };
+    TilemapStats stats_;
+};
+
+} // namespace se
@@ -0,0 +1,1037 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+
+#include "generics.h"
+
+#if defined(SE_VECTOR_MATH_SCALAR)
+#define SE_MATH_SCALAR
+#elif defined(__SSE2__)
+#define SE_MATH_SSE
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define SE_MATH_NEON
+#include <arm_neon.h>
+#else
+#define SE_MATH_SCALAR
+#endif
+
+namespace se {
+
+// Four-float register the vector, matrix and quaternion operations below are
+// written in. Defining SE_VECTOR_MATH_SCALAR forces the portable version,
+// which is also the reference the SIMD versions are checked against.
+namespace detail {
+
+#if defined(SE_MATH_SSE)
+    using Float4 = __m128;
+
+    inline Float4 load4(const float* p)
+    {
+        return _mm_load_ps(p);
+    }
+
+    inline void store4(float* p, Float4 v)
+    {
+        _mm_store_ps(p, v);
+    }
+
+    inline Float4 splat(float s)
+    {
+        return _mm_set1_ps(s);
+    }
+
+    inline Float4 add(Float4 a, Float4 b)
+    {
+        return _mm_add_ps(a, b);
+    }
+
+    inline Float4 sub(Float4 a, Float4 b)
+    {
+        return _mm_sub_ps(a, b);
+    }
+
+    inline Float4 mul(Float4 a, Float4 b)
+    {
+        return _mm_mul_ps(a, b);
+    }
+
+    inline Float4 div(Float4 a, Float4 b)
+    {
+        return _mm_div_ps(a, b);
+    }
+
+    inline Float4 min(Float4 a, Float4 b)
+    {
+        return _mm_min_ps(a, b);
+    }
+
+    inline Float4 max(Float4 a, Float4 b)
+    {
+        return _mm_max_ps(a, b);
+    }
+
+    // a * b + c
+    inline Float4 madd(Float4 a, Float4 b, Float4 c)
+    {
+        return _mm_add_ps(_mm_mul_ps(a, b), c);
+    }
+
+    template <int Lane>
+    inline Float4 lane(Float4 v)
+    {
+        return _mm_shuffle_ps(v, v, _MM_SHUFFLE(Lane, Lane, Lane, Lane));
+    }
+
+    inline float sum(Float4 v)
+    {
+        Float4 pairs = _mm_add_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_movehl_ps(pairs, pairs)));
+    }
+#elif defined(SE_MATH_NEON)
+    using Float4 = float32x4_t;
+
+    inline Float4 load4(const float* p)
+    {
+        return vld1q_f32(p);
+    }
+
+    inline void store4(float* p, Float4 v)
+    {
+        vst1q_f32(p, v);
+    }
+
+    inline Float4 splat(float s)
+    {
+        return vdupq_n_f32(s);
+    }
+
+    inline Float4 add(Float4 a, Float4 b)
+    {
+        return vaddq_f32(a, b);
+    }
+
+    inline Float4 sub(Float4 a, Float4 b)
+    {
+        return vsubq_f32(a, b);
+    }
+
+    inline Float4 mul(Float4 a, Float4 b)
+    {
+        return vmulq_f32(a, b);
+    }
+
+    inline Float4 div(Float4 a, Float4 b)
+    {
+        return vdivq_f32(a, b);
+    }
+
+    inline Float4 min(Float4 a, Float4 b)
+    {
+        return vminq_f32(a, b);
+    }
+
+    inline Float4 max(Float4 a, Float4 b)
+    {
+        return vmaxq_f32(a, b);
+    }
+
+    inline Float4 madd(Float4 a, Float4 b, Float4 c)
+    {
+        return vfmaq_f32(c, a, b);
+    }
+
+    template <int Lane>
+    inline Float4 lane(Float4 v)
+    {
+        return vdupq_laneq_f32(v, Lane);
+    }
+
+    inline float sum(Float4 v)
+    {
+        return vaddvq_f32(v);
+    }
+#else
+    struct Float4 {
+        float v[4];
+    };
+
+    inline Float4 load4(const float* p)
+    {
+        return { { p[0], p[1], p[2], p[3] } };
+    }
+
+    inline void store4(float* p, Float4 v)
+    {
+        p[0] = v.v[0];
+        p[1] = v.v[1];
+        p[2] = v.v[2];
+        p[3] = v.v[3];
+    }
+
+    inline Float4 splat(float s)
+    {
+        return { { s, s, s, s } };
+    }
+
+    inline Float4 add(Float4 a, Float4 b)
+    {
+        return { { a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3] } };
+    }
+
+    inline Float4 sub(Float4 a, Float4 b)
+    {
+        return { { a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3] } };
+    }
+
+    inline Float4 mul(Float4 a, Float4 b)
+    {
+        return { { a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3] } };
+    }
+
+    inline Float4 div(Float4 a, Float4 b)
+    {
+        return { { a.v[0] / b.v[0], a.v[1] / b.v[1], a.v[2] / b.v[2], a.v[3] / b.v[3] } };
+    }
+
+    // Same operand order as minps/maxps, so NaNs come out the same way.
+    inline Float4 min(Float4 a, Float4 b)
+    {
+        Float4 r;
+        for (int i = 0; i < 4; ++i)
+            r.v[i] = a.v[i] < b.v[i] ? a.v[i] : b.v[i];
+        return r;
+    }
+
+    inline Float4 max(Float4 a, Float4 b)
+    {
+        Float4 r;
+        for (int i = 0; i < 4; ++i)
+            r.v[i] = a.v[i] > b.v[i] ? a.v[i] : b.v[i];
+        return r;
+    }
+
+    inline Float4 madd(Float4 a, Float4 b, Float4 c)
+    {
+        return add(mul(a, b), c);
+    }
+
+    template <int Lane>
+    inline Float4 lane(Float4 v)
+    {
+        return splat(v.v[Lane]);
+    }
+
+    inline float sum(Float4 v)
+    {
+        return (v.v[0] + v.v[1]) + (v.v[2] + v.v[3]);
+    }
+#endif
+
+} // namespace detail
+
+// Vector, matrix and quaternion types with the sizes, alignments and
+// column-major layouts of the Metal types, so they can be copied into
+// shader buffers as they are: Vec2 is float2, Vec3 is float3 (16 bytes, the
+// last one unused), Mat3 is float3x3 and Mat4 is float4x4. Angles are in
+// radians.
+
+struct alignas(8) Vec2 {
+    float x { 0 };
+    float y { 0 };
+
+    constexpr Vec2() = default;
+    constexpr Vec2(float x, float y)
+        : x(x)
+        , y(y)
+    {
+    }
+
+    constexpr explicit Vec2(float s)
+        : x(s)
+        , y(s)
+    {
+    }
+
+    Vec2(vector_float2 v)
+        : x(v[0])
+        , y(v[1])
+    {
+    }
+
+    operator vector_float2() const
+    {
+        return vector_float2 { x, y };
+    }
+
+    float& operator[](size_t i)
+    {
+        return (&x)[i];
+    }
+
+    float operator[](size_t i) const
+    {
+        return (&x)[i];
+    }
+};
+
+struct alignas(16) Vec3 {
+    float x { 0 };
+    float y { 0 };
+    float z { 0 };
+    float unused { 0 };
+
+    constexpr Vec3() = default;
+    constexpr Vec3(float x, float y, float z)
+        : x(x)
+        , y(y)
+        , z(z)
+    {
+    }
+
+    constexpr explicit Vec3(float s)
+        : x(s)
+        , y(s)
+        , z(s)
+    {
+    }
+
+    constexpr Vec3(Vec2 xy, float z)
+        : x(xy.x)
+        , y(xy.y)
+        , z(z)
+    {
+    }
+
+    Vec2 xy() const
+    {
+        return { x, y };
+    }
+
+    float& operator[](size_t i)
+    {
+        return (&x)[i];
+    }
+
+    float operator[](size_t i) const
+    {
+        return (&x)[i];
+    }
+};
+
+struct alignas(16) Vec4 {
+    float x { 0 };
+    float y { 0 };
+    float z { 0 };
+    float w { 0 };
+
+    constexpr Vec4() = default;
+    constexpr Vec4(float x, float y, float z, float w)
+        : x(x)
+        , y(y)
+        , z(z)
+        , w(w)
+    {
+    }
+
+    constexpr explicit Vec4(float s)
+        : x(s)
+        , y(s)
+        , z(s)
+        , w(s)
+    {
+    }
+
+    constexpr Vec4(Vec3 xyz, float w)
+        : x(xyz.x)
+        , y(xyz.y)
+        , z(xyz.z)
+        , w(w)
+    {
+    }
+
+    Vec4(vector_float4 v)
+        : x(v[0])
+        , y(v[1])
+        , z(v[2])
+        , w(v[3])
+    {
+    }
+
+    operator vector_float4() const
+    {
+        return vector_float4 { x, y, z, w };
+    }
+
+    Vec2 xy() const
+    {
+        return { x, y };
+    }
+
+    Vec3 xyz() const
+    {
+        return { x, y, z };
+    }
+
+    float& operator[](size_t i)
+    {
+        return (&x)[i];
+    }
+
+    float operator[](size_t i) const
+    {
+        return (&x)[i];
+    }
+};
+
+static_assert(sizeof(Vec2) == sizeof(vector_float2) && alignof(Vec2) == alignof(vector_float2));
+static_assert(sizeof(Vec3) == 16 && alignof(Vec3) == 16);
+static_assert(sizeof(Vec4) == sizeof(vector_float4) && alignof(Vec4) == alignof(vector_float4));
+
+namespace detail {
+
+    inline Float4 load(const Vec3& v)
+    {
+        return load4(&v.x);
+    }
+
+    inline Float4 load(const Vec4& v)
+    {
+        return load4(&v.x);
+    }
+
+    template <typename V>
+    inline V store(Float4 value)
+    {
+        V v;
+        store4(&v.x, value);
+        return v;
+    }
+
+    // Keeps the unused lane of a Vec3 at zero, so it never holds NaNs or
+    // denormals that slow down later operations.
+    inline Vec3 store3(Float4 value)
+    {
+        Vec3 v = store<Vec3>(value);
+        v.unused = 0;
+        return v;
+    }
+
+} // namespace detail
+
+// Vec2 is too narrow for SIMD to pay off; it stays scalar.
+
+inline Vec2 operator+(Vec2 a, Vec2 b)
+{
+    return { a.x + b.x, a.y + b.y };
+}
+
+inline Vec2 operator-(Vec2 a, Vec2 b)
+{
+    return { a.x - b.x, a.y - b.y };
+}
+
+inline Vec2 operator*(Vec2 a, Vec2 b)
+{
+    return { a.x * b.x, a.y * b.y };
+}
+
+inline Vec2 operator/(Vec2 a, Vec2 b)
+{
+    return { a.x / b.x, a.y / b.y };
+}
+
+inline Vec2 operator*(Vec2 a, float s)
+{
+    return { a.x * s, a.y * s };
+}
+
+inline Vec2 operator*(float s, Vec2 a)
+{
+    return a * s;
+}
+
+inline Vec2 operator/(Vec2 a, float s)
+{
+    return { a.x / s, a.y / s };
+}
+
+inline Vec2 operator-(Vec2 a)
+{
+    return { -a.x, -a.y };
+}
+
+inline Vec2& operator+=(Vec2& a, Vec2 b)
+{
+    return a = a + b;
+}
+
+inline Vec2& operator-=(Vec2& a, Vec2 b)
+{
+    return a = a - b;
+}
+
+inline Vec2& operator*=(Vec2& a, float s)
+{
+    return a = a * s;
+}
+
+inline bool operator==(Vec2 a, Vec2 b)
+{
+    return a.x == b.x && a.y == b.y;
+}
+
+inline float dot(Vec2 a, Vec2 b)
+{
+    return a.x * b.x + a.y * b.y;
+}
+
+inline float length(Vec2 a)
+{
+    return std::sqrt(dot(a, a));
+}
+
+inline Vec2 normalize(Vec2 a)
+{
+    return a / length(a);
+}
+
+inline Vec2 min(Vec2 a, Vec2 b)
+{
+    return { b.x < a.x ? b.x : a.x, b.y < a.y ? b.y : a.y };
+}
+
+inline Vec2 max(Vec2 a, Vec2 b)
+{
+    return { a.x < b.x ? b.x : a.x, a.y < b.y ? b.y : a.y };
+}
+
+inline Vec2 lerp(Vec2 a, Vec2 b, float t)
+{
+    return a + (b - a) * t;
+}
+
+inline Vec3 operator+(Vec3 a, Vec3 b)
+{
+    return detail::store3(detail::add(detail::load(a), detail::load(b)));
+}
+
+inline Vec3 operator-(Vec3 a, Vec3 b)
+{
+    return detail::store3(detail::sub(detail::load(a), detail::load(b)));
+}
+
+inline Vec3 operator*(Vec3 a, Vec3 b)
+{
+    return detail::store3(detail::mul(detail::load(a), detail::load(b)));
+}
+
+inline Vec3 operator/(Vec3 a, Vec3 b)
+{
+    return { a.x / b.x, a.y / b.y, a.z / b.z };
+}
+
+inline Vec3 operator*(Vec3 a, float s)
+{
+    return detail::store3(detail::mul(detail::load(a), detail::splat(s)));
+}
+
+inline Vec3 operator*(float s, Vec3 a)
+{
+    return a * s;
+}
+
+inline Vec3 operator/(Vec3 a, float s)
+{
+    return a * (1.0f / s);
+}
+
+inline Vec3 operator-(Vec3 a)
+{
+    return { -a.x, -a.y, -a.z };
+}
+
+inline Vec3& operator+=(Vec3& a, Vec3 b)
+{
+    return a = a + b;
+}
+
+inline Vec3& operator-=(Vec3& a, Vec3 b)
+{
+    return a = a - b;
+}
+
+inline Vec3& operator*=(Vec3& a, float s)
+{
+    return a = a * s;
+}
+
+inline bool operator==(Vec3 a, Vec3 b)
+{
+    return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+inline float dot(Vec3 a, Vec3 b)
+{
+    return detail::sum(detail::mul(detail::load(a), detail::load(b)));
+}
+
+inline Vec3 cross(Vec3 a, Vec3 b)
+{
+    return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+}
+
+inline float length(Vec3 a)
+{
+    return std::sqrt(dot(a, a));
+}
+
+inline Vec3 normalize(Vec3 a)
+{
+    return a / length(a);
+}
+
+inline Vec3 min(Vec3 a, Vec3 b)
+{
+    return detail::store3(detail::min(detail::load(a), detail::load(b)));
+}
+
+inline Vec3 max(Vec3 a, Vec3 b)
+{
+    return detail::store3(detail::max(detail::load(a), detail::load(b)));
+}
+
+inline Vec3 lerp(Vec3 a, Vec3 b, float t)
+{
+    return a + (b - a) * t;
+}
+
+inline Vec4 operator+(Vec4 a, Vec4 b)
+{
+    return detail::store<Vec4>(detail::add(detail::load(a), detail::load(b)));
+}
+
+inline Vec4 operator-(Vec4 a, Vec4 b)
+{
+    return detail::store<Vec4>(detail::sub(detail::load(a), detail::load(b)));
+}
+
+inline Vec4 operator*(Vec4 a, Vec4 b)
+{
+    return detail::store<Vec4>(detail::mul(detail::load(a), detail::load(b)));
+}
+
+inline Vec4 operator/(Vec4 a, Vec4 b)
+{
+    return detail::store<Vec4>(detail::div(detail::load(a), detail::load(b)));
+}
+
+inline Vec4 operator*(Vec4 a, float s)
+{
+    return detail::store<Vec4>(detail::mul(detail::load(a), detail::splat(s)));
+}
+
+inline Vec4 operator*(float s, Vec4 a)
+{
+    return a * s;
+}
+
+inline Vec4 operator/(Vec4 a, float s)
+{
+    return a * (1.0f / s);
+}
+
+inline Vec4 operator-(Vec4 a)
+{
+    return { -a.x, -a.y, -a.z, -a.w };
+}
+
+inline Vec4& operator+=(Vec4& a, Vec4 b)
+{
+    return a = a + b;
+}
+
+inline Vec4& operator-=(Vec4& a, Vec4 b)
+{
+    return a = a - b;
+}
+
+inline Vec4& operator*=(Vec4& a, float s)
+{
+    return a = a * s;
+}
+
+inline bool operator==(Vec4 a, Vec4 b)
+{
+    return a.x == b.x && a.y == b.y && a.z == b.z && a.w == b.w;
+}
+
+inline float dot(Vec4 a, Vec4 b)
+{
+    return detail::sum(detail::mul(detail::load(a), detail::load(b)));
+}
+
+inline float length(Vec4 a)
+{
+    return std::sqrt(dot(a, a));
+}
+
+inline Vec4 normalize(Vec4 a)
+{
+    return a / length(a);
+}
+
+inline Vec4 min(Vec4 a, Vec4 b)
+{
+    return detail::store<Vec4>(detail::min(detail::load(a), detail::load(b)));
+}
+
+inline Vec4 max(Vec4 a, Vec4 b)
+{
+    return detail::store<Vec4>(detail::max(detail::load(a), detail::load(b)));
+}
+
+inline Vec4 lerp(Vec4 a, Vec4 b, float t)
+{
+    return a + (b - a) * t;
+}
+
+// Rotation as a unit quaternion, (x, y, z) the vector part.
+struct alignas(16) Quat {
+    float x { 0 };
+    float y { 0 };
+    float z { 0 };
+    float w { 1 };
+
+    constexpr Quat() = default;
+    constexpr Quat(float x, float y, float z, float w)
+        : x(x)
+        , y(y)
+        , z(z)
+        , w(w)
+    {
+    }
+
+    // `axis` must be normalized.
+    static Quat axisAngle(Vec3 axis, float angle)
+    {
+        float s = std::sin(angle * 0.5f);
+        return { axis.x * s, axis.y * s, axis.z * s, std::cos(angle * 0.5f) };
+    }
+};
+
+// Applies `b` first, then `a`.
+inline Quat operator*(Quat a, Quat b)
+{
+    return {
+        a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+        a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+        a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+        a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z,
+    };
+}
+
+inline float dot(Quat a, Quat b)
+{
+    return detail::sum(detail::mul(detail::load4(&a.x), detail::load4(&b.x)));
+}
+
+inline Quat conjugate(Quat q)
+{
+    return { -q.x, -q.y, -q.z, q.w };
+}
+
+inline Quat normalize(Quat q)
+{
+    float inverse = 1.0f / std::sqrt(dot(q, q));
+    return detail::store<Quat>(detail::mul(detail::load4(&q.x), detail::splat(inverse)));
+}
+
+inline Vec3 rotate(Quat q, Vec3 v)
+{
+    Vec3 axis(q.x, q.y, q.z);
+    Vec3 t = cross(axis, v) * 2.0f;
+    return v + t * q.w + cross(axis, t);
+}
+
+// Shortest-path spherical interpolation; falls back to normalized linear
+// interpolation for nearly equal rotations.
+inline Quat slerp(Quat a, Quat b, float t)
+{
+    float cosine = dot(a, b);
+    if (cosine < 0) {
+        b = { -b.x, -b.y, -b.z, -b.w };
+        cosine = -cosine;
+    }
+
+    float wa = 1.0f - t;
+    float wb = t;
+    if (cosine < 0.9995f) {
+        float angle = std::acos(cosine);
+        float inverse_sine = 1.0f / std::sin(angle);
+        wa = std::sin(wa * angle) * inverse_sine;
+        wb = std::sin(wb * angle) * inverse_sine;
+    }
+
+    Quat q = detail::store<Quat>(detail::madd(detail::load4(&a.x), detail::splat(wa), detail::mul(detail::load4(&b.x), detail::splat(wb))));
+    return cosine < 0.9995f ? q : normalize(q);
+}
+
+// Column-major; `columns[2]` holds the translation of 2D affine transforms.
+struct Mat3 {
+    Vec3 columns[3] { { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } };
+
+    static Mat3 identity()
+    {
+        return {};
+    }
+
+    static Mat3 translation(Vec2 offset)
+    {
+        Mat3 m;
+        m.columns[2] = { offset, 1 };
+        return m;
+    }
+
+    static Mat3 rotation(float angle)
+    {
+        float c = std::cos(angle);
+        float s = std::sin(angle);
+        Mat3 m;
+        m.columns[0] = { c, s, 0 };
+        m.columns[1] = { -s, c, 0 };
+        return m;
+    }
+
+    static Mat3 scale(Vec2 factors)
+    {
+        Mat3 m;
+        m.columns[0].x = factors.x;
+        m.columns[1].y = factors.y;
+        return m;
+    }
+
+    static Mat3 rotation(Quat q);
+
+    Vec3& operator[](size_t i)
+    {
+        return columns[i];
+    }
+
+    const Vec3& operator[](size_t i) const
+    {
+        return columns[i];
+    }
+};
+
+// Column-major, for column vectors: `m * v`.
+struct Mat4 {
+    Vec4 columns[4] { { 1, 0, 0, 0 }, { 0, 1, 0, 0 }, { 0, 0, 1, 0 }, { 0, 0, 0, 1 } };
+
+    static Mat4 identity()
+    {
+        return {};
+    }
+
+    static Mat4 translation(Vec3 offset)
+    {
+        Mat4 m;
+        m.columns[3] = { offset, 1 };
+        return m;
+    }
+
+    static Mat4 scale(Vec3 factors)
+    {
+        Mat4 m;
+        m.columns[0].x = factors.x;
+        m.columns[1].y = factors.y;
+        m.columns[2].z = factors.z;
+        return m;
+    }
+
+    static Mat4 rotation(Quat q)
+    {
+        float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+        float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+        float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+        Mat4 m;
+        m.columns[0] = { 1 - 2 * (yy + zz), 2 * (xy + wz), 2 * (xz - wy), 0 };
+        m.columns[1] = { 2 * (xy - wz), 1 - 2 * (xx + zz), 2 * (yz + wx), 0 };
+        m.columns[2] = { 2 * (xz + wy), 2 * (yz - wx), 1 - 2 * (xx + yy), 0 };
+        return m;
+    }
+
+    // Maps the box to Metal clip space, with depth from 0 at `near` to 1 at
+    // `far`.
+    static Mat4 orthographic(float left, float right, float bottom, float top, float near, float far)
+    {
+        Mat4 m;
+        m.columns[0].x = 2 / (right - left);
+        m.columns[1].y = 2 / (top - bottom);
+        m.columns[2].z = 1 / (far - near);
+        m.columns[3] = { (left + right) / (left - right), (bottom + top) / (bottom - top), near / (near - far), 1 };
+        return m;
+    }
+
+    Vec4& operator[](size_t i)
+    {
+        return columns[i];
+    }
+
+    const Vec4& operator[](size_t i) const
+    {
+        return columns[i];
+    }
+};
+
+static_assert(sizeof(Mat3) == 48 && alignof(Mat3) == 16);
+static_assert(sizeof(Mat4) == 64 && alignof(Mat4) == 16);
+
+inline Mat3 Mat3::rotation(Quat q)
+{
+    Mat4 m = Mat4::rotation(q);
+    Mat3 r;
+    for (int i = 0; i < 3; ++i)
+        r.columns[i] = m.columns[i].xyz();
+    return r;
+}
+
+inline Vec3 operator*(const Mat3& m, Vec3 v)
+{
+    using namespace detail;
+    Float4 r = mul(load(m.columns[0]), splat(v.x));
+    r = madd(load(m.columns[1]), splat(v.y), r);
+    r = madd(load(m.columns[2]), splat(v.z), r);
+    return store3(r);
+}
+
+inline Mat3 operator*(const Mat3& a, const Mat3& b)
+{
+    Mat3 m;
+    for (int i = 0; i < 3; ++i)
+        m.columns[i] = a * b.columns[i];
+    return m;
+}
+
+// Treats `p` as a point of the plane: applies the translation too.
+inline Vec2 transformPoint(const Mat3& m, Vec2 p)
+{
+    return {
+        m.columns[0].x * p.x + m.columns[1].x * p.y + m.columns[2].x,
+        m.columns[0].y * p.x + m.columns[1].y * p.y + m.columns[2].y,
+    };
+}
+
+inline Vec4 operator*(const Mat4& m, Vec4 v)
+{
+    using namespace detail;
+    Float4 vector = load(v);
+    Float4 r = mul(load(m.columns[0]), lane<0>(vector));
+    r = madd(load(m.columns[1]), lane<1>(vector), r);
+    r = madd(load(m.columns[2]), lane<2>(vector), r);
+    r = madd(load(m.columns[3]), lane<3>(vector), r);
+    return store<Vec4>(r);
+}
+
+inline Mat4 operator*(const Mat4& a, const Mat4& b)
+{
+    Mat4 m;
+    for (int i = 0; i < 4; ++i)
+        m.columns[i] = a * b.columns[i];
+    return m;
+}
+
+inline Vec3 transformPoint(const Mat4& m, Vec3 p)
+{
+    return (m * Vec4(p, 1)).xyz();
+}
+
+inline Mat3 transpose(const Mat3& m)
+{
+    Mat3 t;
+    for (int c = 0; c < 3; ++c)
+        for (int r = 0; r < 3; ++r)
+            t.columns[c][r] = m.columns[r][c];
+    return t;
+}
+
+inline Mat4 transpose(const Mat4& m)
+{
+    Mat4 t;
+    for (int c = 0; c < 4; ++c)
+        for (int r = 0; r < 4; ++r)
+            t.columns[c][r] = m.columns[r][c];
+    return t;
+}
+
+// Singular matrices give infinities.
+Mat3 inverse(const Mat3& m);
+Mat4 inverse(const Mat4& m);
+
+// Axis-aligned bounding box. The default one is empty: it contains
+// nothing and merging anything into it gives that thing's bounds.
+struct AABB {
+    Vec3 min { INFINITY };
+    Vec3 max { -INFINITY };
+
+    bool empty() const
+    {
+        return max.x < min.x || max.y < min.y || max.z < min.z;
+    }
+
+    Vec3 center() const
+    {
+        return (min + max) * 0.5f;
+    }
+
+    Vec3 extent() const
+    {
+        return (max - min) * 0.5f;
+    }
+
+    void merge(Vec3 point)
+    {
+        min = se::min(min, point);
+        max = se::max(max, point);
+    }
+
+    void merge(const AABB& other)
+    {
+        min = se::min(min, other.min);
+        max = se::max(max, other.max);
+    }
+
+    bool contains(Vec3 point) const
+    {
+        return point.x >= min.x && point.y >= min.y && point.z >= min.z
+            && point.x <= max.x && point.y <= max.y && point.z <= max.z;
+    }
+
+    // Touching boxes intersect.
+    bool intersects(const AABB& other) const
+    {
+        return min.x <= other.max.x && other.min.x <= max.x
+            && min.y <= other.max.y && other.min.y <= max.y
+            && min.z <= other.max.z && other.min.z <= max.z;
+    }
+};
+
+// Bounds of the transformed box, without transforming its eight corners.
+AABB transform(const Mat4& m, const AABB& box);
+
+// Batched kernels. Input and output may be the same array but must not
+// otherwise overlap.
+
+// out[i] = m * in[i].
+void transformPoints(const Mat4& m, const Vec4* in, Vec4* out, size_t count);
+// out[i] = transformPoint(m, in[i]).
+void transformPoints(const Mat3& m, const Vec2* in, Vec2* out, size_t count);
+// out[i] = a[i] * b[i].
+void multiplyMatrices(const Mat4* a, const Mat4* b, Mat4* out, size_t count);
+
+// Instruction set the batched kernels were compiled for.
+const char* vectorMathSimdName();
+
+} // namespace se
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "generics.h"
+
+namespace se {
+
+// Converts full-precision vertices to the compact layouts in generics.h.
+// Positions and uvs are rounded to the nearest representable value and
+// clamped to its range, colors are clamped to [0, 1]. `out` may not overlap
+// `vertices`.
+void packVertices(const AAPLVertex* vertices, size_t count, AAPLPackedVertex* out);
+void packVertices(const AAPLSpriteVertex* vertices, size_t count, AAPLPackedSpriteVertex* out);
+void packVertices(const AAPLSpriteVertex* vertices, size_t count, AAPLHalfSpriteVertex* out);
+
+// Single values, for callers that build packed vertices directly.
+uint16_t floatToHalf(float value);
+float halfToFloat(uint16_t value);
+
+} // namespace se
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace se {
+
+// Chase-Lev deque of pointers with a fixed power-of-two capacity, after "Correct
+// and Efficient Work-Stealing for Weak Memory Models" (Lê et al., 2013). The
+// owning thread pushes and pops at the bottom; any thread may steal from
+// the top. Lock-free; a steal fails instead of retrying when it races
+// another one.
+template <typename T>
+class WorkStealingDeque {
+public:
+    explicit WorkStealingDeque(size_t capacity)
+        : mask_(capacity - 1)
+        , buffer_(std::make_unique<std::atomic<T*>[]>(capacity))
+    {
+    }
+
+    // Owner only. Returns false when the deque is full.
+    bool push(T* item)
+    {
+        int64_t bottom = bottom_.load(std::memory_order_relaxed);
+        int64_t top = top_.load(std::memory_order_acquire);
+        if (bottom - top > int64_t(mask_))
+            return false;
+
+        buffer_[size_t(bottom) & mask_].store(item, std::memory_order_relaxed);
+        bottom_.store(bottom + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Owner only. Takes the most recently pushed item.
+    T* pop()
+    {
+        int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+        bottom_.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t top = top_.load(std::memory_order_relaxed);
+
+        if (top > bottom) {
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        T* item = buffer_[size_t(bottom) & mask_].load(std::memory_order_relaxed);
+        if (top == bottom) {
+            // Last item; a thief may be taking it at the same time.
+            if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                item = nullptr;
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    // Any thread. Takes the least recently pushed item.
+    T* steal()
+    {
+        int64_t top = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t bottom = bottom_.load(std::memory_order_acquire);
+        if (top >= bottom)
+            return nullptr;
+
+        T* item = buffer_[size_t(top) & mask_].load(std::memory_order_relaxed);
+        if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return nullptr;
+        return item;
+    }
+
+    // A snapshot; only exact on the owning thread while nobody steals.
+    bool empty() const
+    {
+        return bottom_.load(std::memory_order_relaxed) <= top_.load(std::memory_order_relaxed);
+    }
+
+private:
+    // Written by different threads, so kept on separate cache lines.
+    alignas(64) std::atomic<int64_t> top_ { 0 };
+    alignas(64) std::atomic<int64_t> bottom_ { 0 };
+    size_t mask_;
+    std::unique_ptr<std::atomic<T*>[]> buffer_;
+};
+
+} // namespace se
@@ -8,15 +8,32 @@ Header containing types and enum constants shared between Metal shaders and C/Ob
 #ifndef GENERICS_H
 #define GENERICS_H
 
-#include <simd/simd.h>
+#ifdef __METAL_VERSION__
+#include <metal_stdlib>
+
+typedef metal::float2 vector_float2;
+typedef metal::float4 vector_float4;
+typedef metal::uint2 vector_uint2;
+typedef metal::short2 vector_short2;
+typedef metal::ushort2 vector_ushort2;
+typedef metal::uchar4 vector_uchar4;
+#else
+#include "vector_types.h"
+#endif
 
 // Buffer index values shared between shader and C code to ensure Metal shader buffer inputs
 // match Metal API buffer set calls.
 typedef enum AAPLVertexInputIndex {
     AAPLVertexInputIndexVertices = 0,
     AAPLVertexInputIndexViewportSize = 1,
+    AAPLVertexInputIndexTranslation = 2,
 } AAPLVertexInputIndex;
 
+// Texture index values shared between shader and C code.
+typedef enum AAPLTextureIndex {
+    AAPLTextureIndexAtlas = 0,
+} AAPLTextureIndex;
+
 //  This structure defines the layout of vertices sent to the vertex
 //  shader. This header is shared between the .metal shader and C code, to guarantee that
 //  the layout of the vertex array in the C code matches the layout that the .metal
@@ -27,4 +44,39 @@ typedef struct
     vector_float4 color;
 } AAPLVertex;
 
+//  Vertex layout of the sprite shaders. `uv` addresses the bound atlas page
+//  in normalized coordinates with the origin at the top left.
+typedef struct
+{
+    vector_float2 position;
+    vector_float2 uv;
+    vector_float4 color;
+} AAPLSpriteVertex;
+
+//  Compact variants of the layouts above, selected per pipeline through
+//  se::VertexLayout and filled by the routines in vertex_packing.hpp.
+//  Positions are whole pixels, uvs are normalized to 0..65535 and colors
+//  are RGBA8, so a vertex takes 8 or 12 bytes instead of 32.
+typedef struct
+{
+    vector_short2 position;
+    vector_uchar4 color;
+} AAPLPackedVertex;
+
+typedef struct
+{
+    vector_short2 position;
+    vector_ushort2 uv;
+    vector_uchar4 color;
+} AAPLPackedSpriteVertex;
+
+//  Keeps sub-pixel positions and exact texel uvs as IEEE half floats. They
+//  are stored as raw bits, since C has no portable half type.
+typedef struct
+{
+    vector_ushort2 position;
+    vector_ushort2 uv;
+    vector_uchar4 color;
+} AAPLHalfSpriteVertex;
+
 #endif /* GENERICS_H */
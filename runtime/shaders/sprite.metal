@@ -0,0 +1,109 @@
+/*
+Abstract:
+Metal shaders for textured sprites sampled from an atlas page
+*/
+
+#include <metal_stdlib>
+
+using namespace metal;
+
+#include "generics.h"
+
+struct SpriteRasterizerData
+{
+    float4 position [[position]];
+    float2 uv;
+    float4 color;
+};
+
+vertex SpriteRasterizerData
+spriteVertexShader(uint vertexID [[vertex_id]],
+                   constant AAPLSpriteVertex *vertices [[buffer(AAPLVertexInputIndexVertices)]],
+                   constant vector_uint2 *viewportSizePointer [[buffer(AAPLVertexInputIndexViewportSize)]])
+{
+    SpriteRasterizerData out;
+
+    // Same pixel-space to clip-space mapping as vertexShader in triangle.metal.
+    float2 pixelSpacePosition = vertices[vertexID].position.xy;
+    vector_float2 viewportSize = vector_float2(*viewportSizePointer);
+
+    out.position = vector_float4(0.0, 0.0, 0.0, 1.0);
+    out.position.xy = pixelSpacePosition / (viewportSize / 2.0);
+
+    out.uv = vertices[vertexID].uv;
+    out.color = vertices[vertexID].color;
+
+    return out;
+}
+
+// Variants of spriteVertexShader for the packed layouts. Both pair with
+// spriteFragmentShader.
+vertex SpriteRasterizerData
+packedSpriteVertexShader(uint vertexID [[vertex_id]],
+                         constant AAPLPackedSpriteVertex *vertices [[buffer(AAPLVertexInputIndexVertices)]],
+                         constant vector_uint2 *viewportSizePointer [[buffer(AAPLVertexInputIndexViewportSize)]])
+{
+    SpriteRasterizerData out;
+
+    float2 pixelSpacePosition = float2(vertices[vertexID].position);
+    vector_float2 viewportSize = vector_float2(*viewportSizePointer);
+
+    out.position = vector_float4(0.0, 0.0, 0.0, 1.0);
+    out.position.xy = pixelSpacePosition / (viewportSize / 2.0);
+
+    out.uv = float2(vertices[vertexID].uv) / 65535.0;
+    out.color = float4(vertices[vertexID].color) / 255.0;
+
+    return out;
+}
+
+vertex SpriteRasterizerData
+halfSpriteVertexShader(uint vertexID [[vertex_id]],
+                       constant AAPLHalfSpriteVertex *vertices [[buffer(AAPLVertexInputIndexVertices)]],
+                       constant vector_uint2 *viewportSizePointer [[buffer(AAPLVertexInputIndexViewportSize)]])
+{
+    SpriteRasterizerData out;
+
+    float2 pixelSpacePosition = float2(as_type<half2>(vertices[vertexID].position));
+    vector_float2 viewportSize = vector_float2(*viewportSizePointer);
+
+    out.position = vector_float4(0.0, 0.0, 0.0, 1.0);
+    out.position.xy = pixelSpacePosition / (viewportSize / 2.0);
+
+    out.uv = float2(as_type<half2>(vertices[vertexID].uv));
+    out.color = float4(vertices[vertexID].color) / 255.0;
+
+    return out;
+}
+
+// Variant of packedSpriteVertexShader for cached geometry: positions are
+// relative to an origin that is moved by `translation` at draw time.
+vertex SpriteRasterizerData
+tileVertexShader(uint vertexID [[vertex_id]],
+                 constant AAPLPackedSpriteVertex *vertices [[buffer(AAPLVertexInputIndexVertices)]],
+                 constant vector_uint2 *viewportSizePointer [[buffer(AAPLVertexInputIndexViewportSize)]],
+                 constant vector_float2 *translation [[buffer(AAPLVertexInputIndexTranslation)]])
+{
+    SpriteRasterizerData out;
+
+    float2 pixelSpacePosition = float2(vertices[vertexID].position) + *translation;
+    vector_float2 viewportSize = vector_float2(*viewportSizePointer);
+
+    out.position = vector_float4(0.0, 0.0, 0.0, 1.0);
+    out.position.xy = pixelSpacePosition / (viewportSize / 2.0);
+
+    out.uv = float2(vertices[vertexID].uv) / 65535.0;
+    out.color = float4(vertices[vertexID].color) / 255.0;
+
+    return out;
+}
+
+fragment float4 spriteFragmentShader(SpriteRasterizerData in [[stage_in]],
+                                     texture2d<float> atlas [[texture(AAPLTextureIndexAtlas)]])
+{
+    // Atlas entries are padded, so nearest sampling never reads a neighbour.
+    constexpr sampler atlasSampler(mag_filter::nearest, min_filter::nearest);
+
+    // Tinted by the vertex color.
+    return atlas.sample(atlasSampler, in.uv) * in.color;
+}
@@ -54,6 +54,25 @@ vertexShader(uint vertexID [[vertex_id]],
     return out;
 }
 
+// Variant of vertexShader for AAPLPackedVertex.
+vertex RasterizerData
+packedVertexShader(uint vertexID [[vertex_id]],
+                   constant AAPLPackedVertex *vertices [[buffer(AAPLVertexInputIndexVertices)]],
+                   constant vector_uint2 *viewportSizePointer [[buffer(AAPLVertexInputIndexViewportSize)]])
+{
+    RasterizerData out;
+
+    float2 pixelSpacePosition = float2(vertices[vertexID].position);
+    vector_float2 viewportSize = vector_float2(*viewportSizePointer);
+
+    out.position = vector_float4(0.0, 0.0, 0.0, 1.0);
+    out.position.xy = pixelSpacePosition / (viewportSize / 2.0);
+
+    out.color = float4(vertices[vertexID].color) / 255.0;
+
+    return out;
+}
+
 fragment float4 fragmentShader(RasterizerData in [[stage_in]])
 {
     // Return the interpolated color.
@@ -0,0 +1,31 @@
+/*
+Abstract:
+Vector types of the shader interface for C and C++ code. Names, sizes and
+alignments match both Apple's <simd/simd.h> and the Metal types, so structures
+in generics.h have one layout everywhere.
+*/
+
+#ifndef VECTOR_TYPES_H
+#define VECTOR_TYPES_H
+
+#include <stdint.h>
+
+#if defined(__clang__)
+// The same types <simd/simd.h> declares, so both headers can be included.
+#define SE_VECTOR_TYPE(scalar, count) __attribute__((__ext_vector_type__(count))) scalar
+#elif defined(__GNUC__)
+#define SE_VECTOR_TYPE(scalar, count) scalar __attribute__((__vector_size__(count * sizeof(scalar))))
+#else
+#error "The shader vector types need Clang or GCC vector extensions"
+#endif
+
+typedef SE_VECTOR_TYPE(float, 2) vector_float2;
+typedef SE_VECTOR_TYPE(float, 4) vector_float4;
+typedef SE_VECTOR_TYPE(uint32_t, 2) vector_uint2;
+typedef SE_VECTOR_TYPE(int16_t, 2) vector_short2;
+typedef SE_VECTOR_TYPE(uint16_t, 2) vector_ushort2;
+typedef SE_VECTOR_TYPE(uint8_t, 4) vector_uchar4;
+
+#undef SE_VECTOR_TYPE
+
+#endif /* VECTOR_TYPES_H */
@@ -0,0 +1,125 @@
+#include "culling.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace se {
+
+namespace {
+
+    typedef float Float4 __attribute__((vector_size(16)));
+    typedef int32_t Int4 __attribute__((vector_size(16)));
+
+    Float4 load(const float* source)
+    {
+        Float4 value;
+        std::memcpy(&value, source, sizeof(value));
+        return value;
+    }
+
+    constexpr CullRect kNeverVisible {
+        std::numeric_limits<float>::infinity(),
+        std::numeric_limits<float>::infinity(),
+        -std::numeric_limits<float>::infinity(),
+        -std::numeric_limits<float>::infinity()
+    };
+
+} // namespace
+
+uint32_t BoundsCuller::add(const CullRect& bounds)
+{
+    uint32_t index = uint32_t(count_);
+    resize(count_ + 1);
+    set(index, bounds);
+    return index;
+}
+
+void BoundsCuller::set(uint32_t index, const CullRect& bounds)
+{
+    min_x_[index] = bounds.minX;
+    min_y_[index] = bounds.minY;
+    max_x_[index] = bounds.maxX;
+    max_y_[index] = bounds.maxY;
+}
+
+void BoundsCuller::resize(size_t count)
+{
+    size_t padded = (count + kLanes - 1) & ~(kLanes - 1);
+    min_x_.resize(padded, kNeverVisible.minX);
+    min_y_.resize(padded, kNeverVisible.minY);
+    max_x_.resize(padded, kNeverVisible.maxX);
+    max_y_.resize(padded, kNeverVisible.maxY);
+
+    // Shrinking leaves stale bounds in the padding.
+    for (size_t i = count; i < std::min(count_, padded); ++i)
+        set(uint32_t(i), kNeverVisible);
+    count_ = count;
+}
+
+void BoundsCuller::clear()
+{
+    min_x_.clear();
+    min_y_.clear();
+    max_x_.clear();
+    max_y_.clear();
+    count_ = 0;
+}
+
+void BoundsCuller::cull(const CullRect& view, std::vector<uint32_t>& visible) const
+{
+    // Room for the padding lanes, which are written but never counted.
+    visible.resize(min_x_.size());
+    visible.resize(cullRange(view, 0, count_, visible.data()));
+}
+
+void BoundsCuller::cull(const CullRect& view, std::vector<uint32_t>& visible, ThreadPool& pool) const
+{
+    size_t chunks = (count_ + kChunk - 1) / kChunk;
+    if (chunks <= 1 || pool.threadCount() <= 1) {
+        cull(view, visible);
+        return;
+    }
+
+    // Each chunk writes its results at its own first index, which is past
+    // everything the previous chunk can write; the gaps are closed after.
+    std::vector<size_t> counts(chunks);
+    visible.resize(min_x_.size());
+    pool.parallelFor(chunks, [&](size_t chunk) {
+        size_t begin = chunk * kChunk;
+        counts[chunk] = cullRange(view, begin, std::min(begin + kChunk, count_), visible.data() + begin);
+    });
+
+    size_t total = counts[0];
+    for (size_t chunk = 1; chunk < chunks; ++chunk) {
+        std::memmove(visible.data() + total, visible.data() + chunk * kChunk, counts[chunk] * sizeof(uint32_t));
+        total += counts[chunk];
+    }
+    visible.resize(total);
+}
+
+size_t BoundsCuller::cullRange(const CullRect& view, size_t begin, size_t end, uint32_t* out) const
+{
+    const Float4 view_min_x = Float4 {} + view.minX;
+    const Float4 view_min_y = Float4 {} + view.minY;
+    const Float4 view_max_x = Float4 {} + view.maxX;
+    const Float4 view_max_y = Float4 {} + view.maxY;
+
+    // `begin` is a multiple of kLanes; the padding lanes never pass, so the
+    // last group needs no special case.
+    size_t count = 0;
+    for (size_t i = begin; i < end; i += kLanes) {
+        Int4 inside = (load(&max_x_[i]) >= view_min_x) & (load(&min_x_[i]) <= view_max_x)
+            & (load(&max_y_[i]) >= view_min_y) & (load(&min_y_[i]) <= view_max_y);
+
+        // Branchless compaction: every lane is written, but the count only
+        // advances past visible ones.
+        for (size_t lane = 0; lane < kLanes; ++lane) {
+            out[count] = uint32_t(i + lane);
+            count += inside[lane] & 1;
+        }
+    }
+    return count;
+}
+
+} // namespace se
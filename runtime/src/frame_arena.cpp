@@ -0,0 +1,188 @@
+#include "frame_arena.hpp"
+
+#include <cstring>
+#include <new>
+
+#include "logging.hpp"
+
+#if defined(__SANITIZE_ADDRESS__)
+#define SE_ASAN 1
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define SE_ASAN 1
+#endif
+#endif
+
+#ifdef SE_ASAN
+#include <sanitizer/asan_interface.h>
+#define POISON(data, size) ASAN_POISON_MEMORY_REGION(data, size)
+#define UNPOISON(data, size) ASAN_UNPOISON_MEMORY_REGION(data, size)
+#else
+#define POISON(data, size)
+#define UNPOISON(data, size)
+#endif
+
+namespace se {
+
+namespace {
+
+    constexpr std::align_val_t kBlockAlignment { 64 };
+
+    std::atomic<uint64_t> next_arena_id { 1 };
+
+    // A thread's position in the block it allocates from, for the few
+    // arenas it used last.
+    struct Cursor {
+        uint64_t arena { 0 };
+        uint64_t frame { 0 };
+        char* next { nullptr };
+        char* end { nullptr };
+    };
+
+    constexpr size_t kCursors = 4;
+    thread_local Cursor cursors[kCursors];
+    thread_local size_t next_cursor = 0;
+
+    char* alignUp(char* pointer, size_t alignment)
+    {
+        uintptr_t value = reinterpret_cast<uintptr_t>(pointer);
+        return reinterpret_cast<char*>((value + alignment - 1) & ~uintptr_t(alignment - 1));
+    }
+
+} // namespace
+
+FrameArena::FrameArena(size_t blockSize)
+    : id_(next_arena_id.fetch_add(1, std::memory_order_relaxed))
+    , block_size_(blockSize)
+{
+}
+
+FrameArena::~FrameArena()
+{
+    reset();
+    for (Block& block : free_) {
+        UNPOISON(block.data, block.size);
+        ::operator delete(block.data, kBlockAlignment);
+    }
+
+    // Forget the cursors of this thread; the id is never reused.
+    for (Cursor& cursor : cursors) {
+        if (cursor.arena == id_)
+            cursor = {};
+    }
+}
+
+void* FrameArena::allocate(size_t size, size_t alignment)
+{
+    uint64_t frame = frame_.load(std::memory_order_relaxed);
+
+    Cursor* cursor = nullptr;
+    for (Cursor& candidate : cursors) {
+        if (candidate.arena == id_) {
+            cursor = &candidate;
+            break;
+        }
+    }
+    if (!cursor) {
+        cursor = &cursors[next_cursor];
+        next_cursor = (next_cursor + 1) % kCursors;
+        *cursor = { id_, frame, nullptr, nullptr };
+    }
+
+    // The block of a past frame went back to the arena on reset.
+    if (cursor->frame != frame)
+        *cursor = { id_, frame, nullptr, nullptr };
+
+    char* start = alignUp(cursor->next, alignment);
+    if (!cursor->next || start + size > cursor->end) {
+        if (size + alignment > block_size_ / 4) {
+            Block block = acquire(size + alignment);
+            start = alignUp(block.data, alignment);
+            UNPOISON(start, size);
+            return start;
+        }
+
+        Block block = acquire(block_size_);
+        cursor->next = block.data;
+        cursor->end = block.data + block.size;
+        start = alignUp(cursor->next, alignment);
+    }
+
+    cursor->next = start + size;
+    UNPOISON(start, size);
+    return start;
+}
+
+void FrameArena::reset()
+{
+    std::unique_lock lock(mutex_);
+    for (Block& block : used_) {
+#ifdef DEBUG
+        UNPOISON(block.data, block.size);
+        std::memset(block.data, 0xdd, block.size);
+#endif
+        POISON(block.data, block.size);
+        free_.push_back(block);
+    }
+    used_.clear();
+
+    for (Block& block : large_) {
+        UNPOISON(block.data, block.size);
+        ::operator delete(block.data, kBlockAlignment);
+    }
+    large_.clear();
+
+    frame_.fetch_add(1, std::memory_order_relaxed);
+}
+
+size_t FrameArena::capacity() const
+{
+    std::unique_lock lock(mutex_);
+    size_t total = 0;
+    for (const Block& block : used_)
+        total += block.size;
+    for (const Block& block : free_)
+        total += block.size;
+    for (const Block& block : large_)
+        total += block.size;
+    return total;
+}
+
+FrameArena::Block FrameArena::acquire(size_t minimum)
+{
+    std::unique_lock lock(mutex_);
+    if (minimum == block_size_ && !free_.empty()) {
+        Block block = free_.back();
+        free_.pop_back();
+        used_.push_back(block);
+        return block;
+    }
+
+    Block block { static_cast<char*>(::operator new(minimum, kBlockAlignment)), minimum };
+    block_allocations_.fetch_add(1, std::memory_order_relaxed);
+    POISON(block.data, block.size);
+    if (minimum == block_size_)
+        used_.push_back(block);
+    else
+        large_.push_back(block);
+    return block;
+}
+
+void* FrameResource::do_allocate(size_t bytes, size_t alignment)
+{
+#ifdef DEBUG
+    if (frame_ != arena_.frame())
+        FATAL("Frame memory used after its frame ended");
+#endif
+    return arena_.allocate(bytes, alignment);
+}
+
+void FrameResource::do_deallocate(void*, size_t, size_t)
+{
+#ifdef DEBUG
+    if (frame_ != arena_.frame())
+        FATAL("Frame memory used after its frame ended");
+#endif
+}
+
+} // namespace se
@@ -0,0 +1,18 @@
+#include "game_renderer.hpp"
+
+#include "scene.hpp"
+#include "tilemap.hpp"
+
+namespace se {
+
+void GameRenderer::drawTilemap(Tilemap& tilemap, vector_float2 camera, PipelineId pipeline, TextureId tileset)
+{
+    tilemap.draw(immediate_, viewRect(camera), pipeline, tileset);
+}
+
+void GameRenderer::drawScene(Scene& scene, vector_float2 camera, PipelineId pipeline)
+{
+    scene.draw(immediate_, viewRect(camera), pipeline, quad_indices_);
+}
+
+} // namespace se
@@ -0,0 +1,156 @@
+#include "image_writer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+
+namespace se {
+
+namespace {
+
+    std::array<uint32_t, 256> makeCrcTable()
+    {
+        std::array<uint32_t, 256> table;
+
+        for (uint32_t n = 0; n < 256; ++n) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; ++k)
+                c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+            table[n] = c;
+        }
+
+        return table;
+    }
+
+    uint32_t crc32(const uint8_t* data, size_t length, uint32_t crc = 0)
+    {
+        static const std::array<uint32_t, 256> table = makeCrcTable();
+
+        crc = ~crc;
+        for (size_t i = 0; i < length; ++i)
+            crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+        return ~crc;
+    }
+
+    void adler32(const uint8_t* data, size_t length, uint32_t& a, uint32_t& b)
+    {
+        // 5552 is the largest run for which the sums cannot overflow.
+        while (length > 0) {
+            size_t run = std::min<size_t>(length, 5552);
+            for (size_t i = 0; i < run; ++i) {
+                a += data[i];
+                b += a;
+            }
+            a %= 65521;
+            b %= 65521;
+
+            data += run;
+            length -= run;
+        }
+    }
+
+    void putBigEndian(std::vector<uint8_t>& out, uint32_t value)
+    {
+        out.push_back(uint8_t(value >> 24));
+        out.push_back(uint8_t(value >> 16));
+        out.push_back(uint8_t(value >> 8));
+        out.push_back(uint8_t(value));
+    }
+
+    void putChunk(std::vector<uint8_t>& out, const char* type, const std::vector<uint8_t>& data)
+    {
+        putBigEndian(out, uint32_t(data.size()));
+
+        size_t start = out.size();
+        out.insert(out.end(), type, type + 4);
+        out.insert(out.end(), data.begin(), data.end());
+
+        putBigEndian(out, crc32(&out[start], out.size() - start));
+    }
+
+} // namespace
+
+std::vector<uint8_t> encodePng(uint32_t width, uint32_t height, const uint32_t* pixels, uint32_t stride)
+{
+    static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+
+    // PNG has no empty images, and the stream below needs at least one row
+    // to emit its final block.
+    if (width == 0 || height == 0)
+        return {};
+
+    std::vector<uint8_t> png(signature, signature + 8);
+
+    std::vector<uint8_t> header;
+    putBigEndian(header, width);
+    putBigEndian(header, height);
+    header.push_back(8); // bit depth
+    header.push_back(6); // RGBA
+    header.push_back(0); // deflate
+    header.push_back(0); // adaptive filtering
+    header.push_back(0); // no interlace
+    putChunk(png, "IHDR", header);
+
+    // Scanlines prefixed with filter type 0, packed into stored deflate
+    // blocks inside a zlib stream.
+    size_t row_bytes = size_t(width) * 4 + 1;
+    size_t raw_size = row_bytes * height;
+
+    std::vector<uint8_t> zlib;
+    zlib.reserve(raw_size + raw_size / 65535 * 5 + 16);
+    zlib.push_back(0x78);
+    zlib.push_back(0x01);
+
+    uint32_t adler_a = 1, adler_b = 0;
+    size_t written = 0;
+    size_t block_left = 0;
+
+    auto put = [&](const uint8_t* data, size_t length) {
+        while (length > 0) {
+            if (block_left == 0) {
+                block_left = std::min<size_t>(65535, raw_size - written);
+                bool last = written + block_left == raw_size;
+                zlib.push_back(last ? 1 : 0);
+                zlib.push_back(uint8_t(block_left));
+                zlib.push_back(uint8_t(block_left >> 8));
+                zlib.push_back(uint8_t(~block_left));
+                zlib.push_back(uint8_t(~block_left >> 8));
+            }
+
+            size_t count = std::min(length, block_left);
+            zlib.insert(zlib.end(), data, data + count);
+
+            adler32(data, count, adler_a, adler_b);
+
+            data += count;
+            length -= count;
+            written += count;
+            block_left -= count;
+        }
+    };
+
+    const uint8_t filter = 0;
+    for (uint32_t y = 0; y < height; ++y) {
+        put(&filter, 1);
+        put(reinterpret_cast<const uint8_t*>(pixels + size_t(y) * stride), size_t(width) * 4);
+    }
+
+    putBigEndian(zlib, (adler_b << 16) | adler_a);
+    putChunk(png, "IDAT", zlib);
+    putChunk(png, "IEND", {});
+
+    return png;
+}
+
+bool writeFile(const std::string& path, const void* data, size_t length)
+{
+    std::ofstream file(path, std::ios::binary);
+    if (!file)
+        return false;
+
+    file.write(static_cast<const char*>(data), length);
+    return bool(file);
+}
+
+} // namespace se
@@ -0,0 +1,251 @@
+#include "job_system.hpp"
+
+#include "logging.hpp"
+
+namespace se {
+
+namespace {
+
+    struct ThreadState {
+        const JobSystem* system { nullptr };
+        void* worker { nullptr };
+    };
+
+    thread_local ThreadState current_thread;
+
+    // Idle attempts to find a job before a worker goes to sleep.
+    constexpr uint32_t kSpinsBeforeSleep = 256;
+
+} // namespace
+
+JobSystem::Worker::Worker(size_t index)
+    : index(index)
+    , queue(kJobsPerThread)
+    , jobs(std::make_unique<Job[]>(kJobsPerThread))
+    , random(0x9e3779b97f4a7c15ull * (index + 1))
+{
+}
+
+JobSystem::JobSystem(size_t threads)
+{
+    threads = std::max<size_t>(threads, 1);
+    for (size_t i = 0; i < threads; ++i)
+        workers_.push_back(std::make_unique<Worker>(i));
+
+    current_thread = { this, workers_[0].get() };
+    for (size_t i = 1; i < threads; ++i)
+        threads_.emplace_back([this, i]() { work(*workers_[i]); });
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::unique_lock lock(sleep_mutex_);
+        stop_.store(true, std::memory_order_relaxed);
+    }
+    wake_.notify_all();
+
+    for (std::thread& thread : threads_)
+        thread.join();
+
+    if (current_thread.system == this)
+        current_thread = {};
+}
+
+void JobSystem::run(Job* job)
+{
+    if (!worker().queue.push(job)) {
+        // Full; running it right away keeps the program correct.
+        execute(worker(), *job);
+        return;
+    }
+
+    // Pairs with the fence in sleep(): either the sleeper sees the job or
+    // this sees the sleeper.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping_.load(std::memory_order_relaxed) > 0) {
+        std::unique_lock lock(sleep_mutex_);
+        wake_.notify_one();
+    }
+}
+
+void JobSystem::wait(const Job* job)
+{
+    Worker& self = worker();
+    while (!job->finished()) {
+        if (Job* next = find(self))
+            execute(self, *next);
+        else
+            std::this_thread::yield();
+    }
+}
+
+JobSystemStats JobSystem::stats() const
+{
+    JobSystemStats stats;
+    for (const std::unique_ptr<Worker>& worker : workers_) {
+        stats.spawned += worker->spawned.load(std::memory_order_relaxed);
+        stats.executed += worker->executed.load(std::memory_order_relaxed);
+        stats.steals += worker->steals.load(std::memory_order_relaxed);
+        stats.failedSteals += worker->failed_steals.load(std::memory_order_relaxed);
+        stats.overflowJobs += worker->overflow_jobs.load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+void JobSystem::resetStats()
+{
+    for (std::unique_ptr<Worker>& worker : workers_) {
+        worker->spawned.store(0, std::memory_order_relaxed);
+        worker->executed.store(0, std::memory_order_relaxed);
+        worker->steals.store(0, std::memory_order_relaxed);
+        worker->failed_steals.store(0, std::memory_order_relaxed);
+        worker->overflow_jobs.store(0, std::memory_order_relaxed);
+    }
+}
+
+Job* JobSystem::allocate(Job* parent)
+{
+    Worker& self = worker();
+
+    // The job created kJobsPerThread jobs ago is still unfinished. Queued
+    // jobs may be what holds it up, so run those first; one that was created
+    // but not queued yet, like a parent spawning many children, only its
+    // creator can finish, so then this job comes from the heap. The slot is
+    // read again after every job run here, since those may create jobs too.
+    Job* job = nullptr;
+    while (!job) {
+        Job* slot = &self.jobs[self.next_job];
+        if (slot->finished())
+            job = slot;
+        else if (Job* next = find(self))
+            execute(self, *next);
+        else
+            job = allocateOverflow(self);
+    }
+    // Skips a taken slot too, so every slot is reused exactly
+    // kJobsPerThread jobs after it was last handed out.
+    self.next_job = (self.next_job + 1) % kJobsPerThread;
+    ++self.created;
+    self.spawned.fetch_add(1, std::memory_order_relaxed);
+
+    job->parent_ = parent;
+    job->unfinished_.store(1, std::memory_order_relaxed);
+    if (parent)
+        parent->unfinished_.fetch_add(1, std::memory_order_relaxed);
+    return job;
+}
+
+Job* JobSystem::allocateOverflow(Worker& self)
+{
+    // Heap jobs keep the lifetime of ring jobs: they are freed once finished
+    // and kJobsPerThread more jobs were created after them.
+    while (!self.overflow.empty() && self.created - self.overflow.front().first >= kJobsPerThread
+        && self.overflow.front().second->finished())
+        self.overflow.pop_front();
+
+    self.overflow_jobs.fetch_add(1, std::memory_order_relaxed);
+    self.overflow.emplace_back(self.created, std::make_unique<Job>());
+    return self.overflow.back().second.get();
+}
+
+JobSystem::Worker& JobSystem::worker()
+{
+    if (current_thread.system != this)
+        FATAL("Jobs used outside of their job system's threads");
+    return *static_cast<Worker*>(current_thread.worker);
+}
+
+bool JobSystem::queueEmpty()
+{
+    return worker().queue.empty();
+}
+
+Job* JobSystem::find(Worker& self)
+{
+    if (Job* job = self.queue.pop())
+        return job;
+
+    size_t count = workers_.size();
+    if (count == 1)
+        return nullptr;
+
+    // xorshift64, to spread thieves over victims.
+    self.random ^= self.random << 13;
+    self.random ^= self.random >> 7;
+    self.random ^= self.random << 17;
+
+    size_t start = size_t(self.random % count);
+    for (size_t i = 0; i < count; ++i) {
+        Worker& victim = *workers_[(start + i) % count];
+        if (&victim == &self || victim.queue.empty())
+            continue;
+
+        if (Job* job = victim.queue.steal()) {
+            self.steals.fetch_add(1, std::memory_order_relaxed);
+            return job;
+        }
+        self.failed_steals.fetch_add(1, std::memory_order_relaxed);
+    }
+    return nullptr;
+}
+
+void JobSystem::execute(Worker& self, Job& job)
+{
+    job.function_(job);
+    self.executed.fetch_add(1, std::memory_order_relaxed);
+    finish(&job);
+}
+
+void JobSystem::finish(Job* job)
+{
+    while (job) {
+        Job* parent = job->parent_;
+        if (job->unfinished_.fetch_sub(1, std::memory_order_acq_rel) != 1)
+            return;
+        job = parent;
+    }
+}
+
+void JobSystem::work(Worker& self)
+{
+    current_thread = { this, &self };
+
+    uint32_t idle = 0;
+    while (!stop_.load(std::memory_order_relaxed)) {
+        if (Job* job = find(self)) {
+            execute(self, *job);
+            idle = 0;
+            continue;
+        }
+
+        if (++idle < kSpinsBeforeSleep) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        sleep();
+        idle = 0;
+    }
+}
+
+void JobSystem::sleep()
+{
+    std::unique_lock lock(sleep_mutex_);
+    sleeping_.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!stop_.load(std::memory_order_relaxed) && !hasQueuedJobs())
+        wake_.wait(lock);
+    sleeping_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+bool JobSystem::hasQueuedJobs() const
+{
+    for (const std::unique_ptr<Worker>& worker : workers_) {
+        if (!worker->queue.empty())
+            return true;
+    }
+    return false;
+}
+
+} // namespace se
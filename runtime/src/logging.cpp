@@ -22,14 +22,10 @@ void Logger::fatal(std::string_view msg)
     log(FATAL, msg);
 }
 
-std::string Logger::prefix(Severity severity)
+std::string_view Logger::prefix(Severity severity)
 {
-    std::string res;
-
-    static const char* labels[4] = { "[INFO]   ", "[WARNING]", "[ERROR]  ", "[FATAL]  " };
-    res += labels[severity];
-
-    return res;
+    static constexpr std::string_view labels[4] = { "[INFO]   ", "[WARNING]", "[ERROR]  ", "[FATAL]  " };
+    return labels[severity];
 }
 
 void Logger::log(Severity severity, std::string_view msg)
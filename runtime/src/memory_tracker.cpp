@@ -0,0 +1,297 @@
+#include "memory_tracker.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+#include "logging.hpp"
+
+namespace se {
+
+namespace {
+
+    thread_local MemoryTag current_tag = MemoryTag::Untagged;
+
+    constexpr size_t kTags = size_t(MemoryTag::Count);
+
+    // One cache line per tag, so threads working for different subsystems
+    // do not contend. Only running totals change per allocation; frame and
+    // live counts are derived from them.
+    struct alignas(64) Counters {
+        std::atomic<uint64_t> live_bytes { 0 };
+        std::atomic<uint64_t> peak_bytes { 0 };
+        std::atomic<uint64_t> allocations { 0 };
+        std::atomic<uint64_t> allocated_bytes { 0 };
+        std::atomic<uint64_t> frees { 0 };
+        std::atomic<uint64_t> budget { 0 };
+        std::atomic<uint64_t> overruns { 0 };
+    };
+
+    Counters counters[kTags];
+
+    // Totals at the last endFrame, and overruns it already reported.
+    struct FrameStart {
+        uint64_t allocations;
+        uint64_t allocated_bytes;
+        uint64_t overruns;
+    };
+
+    FrameStart frame_start[kTags];
+
+} // namespace
+
+std::string_view memoryTagName(MemoryTag tag)
+{
+    static constexpr std::string_view names[kTags] = { "Untagged", "Renderer", "Events", "Scene", "Jobs", "Game" };
+    return names[size_t(tag)];
+}
+
+MemoryScope::MemoryScope(MemoryTag tag)
+    : previous_(current_tag)
+{
+    current_tag = tag;
+}
+
+MemoryScope::~MemoryScope()
+{
+    current_tag = previous_;
+}
+
+MemoryTagStats MemoryTracker::stats(MemoryTag tag)
+{
+    const Counters& tag_counters = counters[size_t(tag)];
+
+    uint64_t frees = tag_counters.frees.load(std::memory_order_relaxed);
+
+    MemoryTagStats stats;
+    stats.liveBytes = tag_counters.live_bytes.load(std::memory_order_relaxed);
+    stats.peakBytes = tag_counters.peak_bytes.load(std::memory_order_relaxed);
+    stats.totalAllocations = tag_counters.allocations.load(std::memory_order_relaxed);
+    stats.liveAllocations = stats.totalAllocations - frees;
+    stats.frameAllocations = stats.totalAllocations - frame_start[size_t(tag)].allocations;
+    stats.frameBytes = tag_counters.allocated_bytes.load(std::memory_order_relaxed) - frame_start[size_t(tag)].allocated_bytes;
+    stats.budget = tag_counters.budget.load(std::memory_order_relaxed);
+    stats.overruns = tag_counters.overruns.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void MemoryTracker::setBudget(MemoryTag tag, uint64_t bytes)
+{
+    counters[size_t(tag)].budget.store(bytes, std::memory_order_relaxed);
+}
+
+FrameMemoryStats MemoryTracker::endFrame()
+{
+    FrameMemoryStats frame;
+    for (size_t tag = 0; tag < kTags; ++tag) {
+        Counters& tag_counters = counters[tag];
+        FrameStart& start = frame_start[tag];
+
+        uint64_t allocations = tag_counters.allocations.load(std::memory_order_relaxed);
+        uint64_t allocated_bytes = tag_counters.allocated_bytes.load(std::memory_order_relaxed);
+        frame.allocations += allocations - start.allocations;
+        frame.bytes += allocated_bytes - start.allocated_bytes;
+        start.allocations = allocations;
+        start.allocated_bytes = allocated_bytes;
+
+        uint64_t overruns = tag_counters.overruns.load(std::memory_order_relaxed);
+        if (overruns != start.overruns) {
+            start.overruns = overruns;
+            std::string message = "Memory budget exceeded: ";
+            message += memoryTagName(MemoryTag(tag));
+            message += " holds ";
+            message += std::to_string(tag_counters.live_bytes.load(std::memory_order_relaxed));
+            message += " of ";
+            message += std::to_string(tag_counters.budget.load(std::memory_order_relaxed));
+            message += " bytes";
+            ERROR(message);
+        }
+    }
+    return frame;
+}
+
+MemoryTag MemoryTracker::currentTag()
+{
+    return current_tag;
+}
+
+} // namespace se
+
+#ifdef SE_TRACK_ALLOCATIONS
+
+namespace {
+
+// Placed right before every tracked allocation. 16 bytes keep the default
+// new alignment.
+struct alignas(16) Header {
+    uint64_t size;
+    se::MemoryTag tag;
+};
+
+static_assert(sizeof(Header) == 16);
+
+void record(const Header& header)
+{
+    se::Counters& tag_counters = se::counters[size_t(header.tag)];
+    uint64_t live = tag_counters.live_bytes.fetch_add(header.size, std::memory_order_relaxed) + header.size;
+    tag_counters.allocations.fetch_add(1, std::memory_order_relaxed);
+    tag_counters.allocated_bytes.fetch_add(header.size, std::memory_order_relaxed);
+
+    uint64_t peak = tag_counters.peak_bytes.load(std::memory_order_relaxed);
+    while (live > peak && !tag_counters.peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+
+    uint64_t budget = tag_counters.budget.load(std::memory_order_relaxed);
+    if (budget != 0 && live > budget)
+        tag_counters.overruns.fetch_add(1, std::memory_order_relaxed);
+}
+
+void forget(const Header& header)
+{
+    se::Counters& tag_counters = se::counters[size_t(header.tag)];
+    tag_counters.live_bytes.fetch_sub(header.size, std::memory_order_relaxed);
+    tag_counters.frees.fetch_add(1, std::memory_order_relaxed);
+}
+
+// `offset` bytes precede the returned pointer: the header, padded up to
+// the requested alignment.
+void* allocate(size_t size, size_t offset, size_t alignment)
+{
+    void* block = alignment > alignof(Header)
+        ? std::aligned_alloc(alignment, (offset + size + alignment - 1) & ~(alignment - 1))
+        : std::malloc(offset + size);
+    if (!block)
+        return nullptr;
+
+    char* pointer = static_cast<char*>(block) + offset;
+    Header* header = reinterpret_cast<Header*>(pointer) - 1;
+    header->size = size;
+    header->tag = se::current_tag;
+    record(*header);
+    return pointer;
+}
+
+void release(void* pointer, size_t offset)
+{
+    if (!pointer)
+        return;
+
+    Header* header = static_cast<Header*>(pointer) - 1;
+    forget(*header);
+    std::free(static_cast<char*>(pointer) - offset);
+}
+
+size_t alignedOffset(std::align_val_t alignment)
+{
+    return std::max(sizeof(Header), size_t(alignment));
+}
+
+} // namespace
+
+void* operator new(size_t size)
+{
+    if (void* pointer = allocate(size, sizeof(Header), alignof(Header)))
+        return pointer;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size, sizeof(Header), alignof(Header));
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size, sizeof(Header), alignof(Header));
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+    if (void* pointer = allocate(size, alignedOffset(alignment), size_t(alignment)))
+        return pointer;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+    return operator new(size, alignment);
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return allocate(size, alignedOffset(alignment), size_t(alignment));
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return allocate(size, alignedOffset(alignment), size_t(alignment));
+}
+
+void operator delete(void* pointer) noexcept
+{
+    release(pointer, sizeof(Header));
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    release(pointer, sizeof(Header));
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+    release(pointer, sizeof(Header));
+}
+
+void operator delete[](void* pointer, size_t) noexcept
+{
+    release(pointer, sizeof(Header));
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept
+{
+    release(pointer, sizeof(Header));
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept
+{
+    release(pointer, sizeof(Header));
+}
+
+void operator delete(void* pointer, std::align_val_t alignment) noexcept
+{
+    release(pointer, alignedOffset(alignment));
+}
+
+void operator delete[](void* pointer, std::align_val_t alignment) noexcept
+{
+    release(pointer, alignedOffset(alignment));
+}
+
+void operator delete(void* pointer, size_t, std::align_val_t alignment) noexcept
+{
+    release(pointer, alignedOffset(alignment));
+}
+
+void operator delete[](void* pointer, size_t, std::align_val_t alignment) noexcept
+{
+    release(pointer, alignedOffset(alignment));
+}
+
+void operator delete(void* pointer, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    release(pointer, alignedOffset(alignment));
+}
+
+void operator delete[](void* pointer, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    release(pointer, alignedOffset(alignment));
+}
+
+#endif
@@ -0,0 +1,242 @@
+#include "object_pool.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "logging.hpp"
+
+namespace se {
+
+namespace {
+
+    constexpr uint32_t kNoSlot = UINT32_MAX;
+
+    // Threads are numbered from 0 while alive; a number is reused once its
+    // thread exits, together with the caches it left in every pool.
+    std::mutex slot_mutex;
+    std::vector<uint32_t> free_slots;
+    uint32_t next_slot = 0;
+
+    struct ThreadSlot {
+        uint32_t index;
+
+        ThreadSlot()
+        {
+            std::unique_lock lock(slot_mutex);
+            if (!free_slots.empty()) {
+                index = free_slots.back();
+                free_slots.pop_back();
+            } else {
+                index = next_slot < FixedPool::kMaxThreads ? next_slot++ : kNoSlot;
+            }
+        }
+
+        ~ThreadSlot()
+        {
+            if (index == kNoSlot)
+                return;
+            std::unique_lock lock(slot_mutex);
+            free_slots.push_back(index);
+            // Pools used by later thread-local destructors fall back to
+            // the shared cache.
+            index = kNoSlot;
+        }
+    };
+
+    thread_local ThreadSlot thread_slot;
+
+    struct ChunkHeader {
+        uint32_t index;
+    };
+
+    uint64_t tagged(uint32_t index, uint64_t previous)
+    {
+        return (((previous >> 32) + 1) << 32) | index;
+    }
+
+    uint32_t untagged(uint64_t head)
+    {
+        return uint32_t(head);
+    }
+
+    size_t alignUp(size_t value, size_t alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+} // namespace
+
+FixedPool::FixedPool(size_t objectSize, size_t alignment)
+    : object_size_(objectSize)
+{
+    alignment = std::max(alignment, alignof(Node));
+    stride_ = alignUp(std::max(objectSize, sizeof(Node)), alignment);
+
+    // Header, one link per slot, then the slots.
+    size_t available = kChunkSize - sizeof(ChunkHeader) - alignment;
+    objects_per_chunk_ = uint32_t(available / (stride_ + sizeof(std::atomic<uint32_t>)));
+    objects_offset_ = alignUp(sizeof(ChunkHeader) + objects_per_chunk_ * sizeof(std::atomic<uint32_t>), alignment);
+
+    if (alignment > kChunkSize / 16 || objects_per_chunk_ < kBatchSize)
+        FATAL("Objects too large for a pool");
+
+    // Slot indices stay below kEmpty.
+    max_chunks_ = std::min(kMaxChunks, uint32_t(kEmpty / objects_per_chunk_));
+}
+
+FixedPool::~FixedPool()
+{
+    uint32_t count = chunk_count_.load(std::memory_order_relaxed);
+    for (uint32_t i = 0; i < count; ++i)
+        ::operator delete(chunk(i), std::align_val_t(kChunkSize));
+    for (std::atomic<std::atomic<char*>*>& segment : segments_)
+        delete[] segment.load(std::memory_order_relaxed);
+}
+
+void* FixedPool::allocate()
+{
+    uint32_t slot = thread_slot.index;
+    if (slot != kNoSlot)
+        return allocateFrom(caches_[slot]);
+
+    std::unique_lock lock(overflow_mutex_);
+    return allocateFrom(overflow_);
+}
+
+void FixedPool::deallocate(void* object)
+{
+#ifdef DEBUG
+    std::memset(object, 0xdd, stride_);
+#endif
+    Node* freed = static_cast<Node*>(object);
+
+    uint32_t slot = thread_slot.index;
+    if (slot != kNoSlot)
+        return deallocateTo(caches_[slot], freed);
+
+    std::unique_lock lock(overflow_mutex_);
+    deallocateTo(overflow_, freed);
+}
+
+void* FixedPool::allocateFrom(Cache& cache)
+{
+    if (!cache.head) {
+        Node* batch = popBatch();
+        while (!batch) {
+            grow();
+            batch = popBatch();
+        }
+        cache.head = batch;
+        cache.count = batch->count;
+    }
+
+    Node* allocated = cache.head;
+    cache.head = allocated->next;
+    --cache.count;
+    return allocated;
+}
+
+void FixedPool::deallocateTo(Cache& cache, Node* freed)
+{
+    freed->next = cache.head;
+    cache.head = freed;
+
+    // Keep one batch to absorb alternating allocate/free at the boundary
+    // and hand the other to threads that need it.
+    if (++cache.count < 2 * kBatchSize)
+        return;
+
+    Node* last = cache.head;
+    for (uint32_t i = 1; i < kBatchSize; ++i)
+        last = last->next;
+
+    Node* batch = cache.head;
+    cache.head = last->next;
+    cache.count -= kBatchSize;
+    last->next = nullptr;
+    batch->count = kBatchSize;
+    pushBatch(batch);
+}
+
+FixedPool::Node* FixedPool::popBatch()
+{
+    uint64_t head = head_.load(std::memory_order_acquire);
+    while (untagged(head) != kEmpty) {
+        uint32_t next = link(untagged(head)).load(std::memory_order_relaxed);
+        if (head_.compare_exchange_weak(head, tagged(next, head), std::memory_order_acquire, std::memory_order_acquire))
+            return node(untagged(head));
+    }
+    return nullptr;
+}
+
+void FixedPool::pushBatch(Node* batch)
+{
+    uint32_t index = indexOf(batch);
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    do {
+        link(index).store(untagged(head), std::memory_order_relaxed);
+    } while (!head_.compare_exchange_weak(head, tagged(index, head), std::memory_order_release, std::memory_order_relaxed));
+}
+
+void FixedPool::grow()
+{
+    std::unique_lock lock(grow_mutex_);
+    // Another thread may have grown the pool meanwhile.
+    if (untagged(head_.load(std::memory_order_acquire)) != kEmpty)
+        return;
+
+    uint32_t index = chunk_count_.load(std::memory_order_relaxed);
+    if (index == max_chunks_)
+        throw std::bad_alloc();
+
+    std::atomic<std::atomic<char*>*>& segment = segments_[index / kChunksPerSegment];
+    if (!segment.load(std::memory_order_relaxed))
+        segment.store(new std::atomic<char*>[kChunksPerSegment] {}, std::memory_order_release);
+
+    char* chunk = static_cast<char*>(::operator new(kChunkSize, std::align_val_t(kChunkSize)));
+    reinterpret_cast<ChunkHeader*>(chunk)->index = index;
+    for (uint32_t i = 0; i < objects_per_chunk_; ++i)
+        new (chunk + sizeof(ChunkHeader) + i * sizeof(std::atomic<uint32_t>)) std::atomic<uint32_t>(kEmpty);
+    segment.load(std::memory_order_relaxed)[index % kChunksPerSegment].store(chunk, std::memory_order_release);
+    chunk_count_.store(index + 1, std::memory_order_relaxed);
+
+    for (uint32_t first = 0; first < objects_per_chunk_; first += kBatchSize) {
+        uint32_t count = std::min(kBatchSize, objects_per_chunk_ - first);
+        Node* batch = reinterpret_cast<Node*>(chunk + objects_offset_ + first * stride_);
+        Node* current = batch;
+        for (uint32_t i = 1; i < count; ++i) {
+            current->next = reinterpret_cast<Node*>(reinterpret_cast<char*>(current) + stride_);
+            current = current->next;
+        }
+        current->next = nullptr;
+        batch->count = count;
+        pushBatch(batch);
+    }
+}
+
+char* FixedPool::chunk(uint32_t chunkIndex) const
+{
+    std::atomic<char*>* segment = segments_[chunkIndex / kChunksPerSegment].load(std::memory_order_acquire);
+    return segment[chunkIndex % kChunksPerSegment].load(std::memory_order_acquire);
+}
+
+FixedPool::Node* FixedPool::node(uint32_t index) const
+{
+    return reinterpret_cast<Node*>(chunk(index / objects_per_chunk_) + objects_offset_ + (index % objects_per_chunk_) * stride_);
+}
+
+uint32_t FixedPool::indexOf(const void* object) const
+{
+    uintptr_t address = reinterpret_cast<uintptr_t>(object);
+    const char* chunk = reinterpret_cast<const char*>(address & ~uintptr_t(kChunkSize - 1));
+    uint32_t slot = uint32_t((static_cast<const char*>(object) - chunk - objects_offset_) / stride_);
+    return reinterpret_cast<const ChunkHeader*>(chunk)->index * objects_per_chunk_ + slot;
+}
+
+std::atomic<uint32_t>& FixedPool::link(uint32_t index) const
+{
+    return reinterpret_cast<std::atomic<uint32_t>*>(chunk(index / objects_per_chunk_) + sizeof(ChunkHeader))[index % objects_per_chunk_];
+}
+
+} // namespace se
@@ -0,0 +1,204 @@
+#include "rect_packer.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace se {
+
+namespace {
+
+    bool intersects(const PackedRect& a, const PackedRect& b)
+    {
+        return a.x < b.x + b.width && b.x < a.x + a.width
+            && a.y < b.y + b.height && b.y < a.y + a.height;
+    }
+
+    bool contains(const PackedRect& outer, const PackedRect& inner)
+    {
+        return inner.x >= outer.x && inner.y >= outer.y
+            && inner.x + inner.width <= outer.x + outer.width
+            && inner.y + inner.height <= outer.y + outer.height;
+    }
+
+    // Joins two rectangles that share a whole edge.
+    std::optional<PackedRect> join(const PackedRect& a, const PackedRect& b)
+    {
+        if (a.x == b.x && a.width == b.width) {
+            if (a.y + a.height == b.y)
+                return PackedRect { a.x, a.y, a.width, a.height + b.height };
+            if (b.y + b.height == a.y)
+                return PackedRect { a.x, b.y, a.width, a.height + b.height };
+        }
+        if (a.y == b.y && a.height == b.height) {
+            if (a.x + a.width == b.x)
+                return PackedRect { a.x, a.y, a.width + b.width, a.height };
+            if (b.x + b.width == a.x)
+                return PackedRect { b.x, a.y, a.width + b.width, a.height };
+        }
+        return std::nullopt;
+    }
+
+} // namespace
+
+RectPacker::RectPacker(uint32_t width, uint32_t height)
+    : width_(width)
+    , height_(height)
+{
+    reset();
+}
+
+std::optional<PackedRect> RectPacker::insert(uint32_t width, uint32_t height)
+{
+    if (width == 0 || height == 0)
+        return std::nullopt;
+
+    const PackedRect* best = nullptr;
+    uint32_t best_short = std::numeric_limits<uint32_t>::max();
+    uint32_t best_long = std::numeric_limits<uint32_t>::max();
+
+    for (const PackedRect& free : free_) {
+        if (free.width < width || free.height < height)
+            continue;
+
+        uint32_t leftover_x = free.width - width;
+        uint32_t leftover_y = free.height - height;
+        uint32_t short_side = std::min(leftover_x, leftover_y);
+        uint32_t long_side = std::max(leftover_x, leftover_y);
+
+        if (short_side < best_short || (short_side == best_short && long_side < best_long)) {
+            best = &free;
+            best_short = short_side;
+            best_long = long_side;
+        }
+    }
+
+    if (!best)
+        return std::nullopt;
+
+    PackedRect rect { best->x, best->y, width, height };
+    place(rect);
+    return rect;
+}
+
+void RectPacker::remove(const PackedRect& rect)
+{
+    used_area_ -= uint64_t(rect.width) * rect.height;
+    if (used_area_ == 0) {
+        reset();
+        return;
+    }
+
+    // Free rectangles are not re-grown around the hole beyond whole-edge
+    // joins, so heavy churn fragments the page until it empties again.
+    free_.push_back(rect);
+    prune(merge(free_.size() - 1));
+}
+
+void RectPacker::reset()
+{
+    used_area_ = 0;
+    free_.clear();
+    free_.push_back({ 0, 0, width_, height_ });
+}
+
+void RectPacker::place(const PackedRect& rect)
+{
+    scratch_.clear();
+    size_t kept = 0;
+    for (size_t i = 0; i < free_.size(); ++i) {
+        if (!split(free_[i], rect))
+            free_[kept++] = free_[i];
+    }
+    free_.resize(kept);
+
+    // Rectangles that survived were not contained in each other before and
+    // cannot be contained in a piece of another one, so only the new pieces
+    // need checking.
+    for (size_t i = 0; i < scratch_.size(); ++i) {
+        bool redundant = false;
+        for (const PackedRect& free : free_) {
+            if (contains(free, scratch_[i])) {
+                redundant = true;
+                break;
+            }
+        }
+        for (size_t j = 0; j < scratch_.size() && !redundant; ++j) {
+            // Of two identical pieces only the first is kept.
+            if (j != i && contains(scratch_[j], scratch_[i]) && (scratch_[j] != scratch_[i] || j < i))
+                redundant = true;
+        }
+        if (!redundant)
+            free_.push_back(scratch_[i]);
+    }
+
+    used_area_ += uint64_t(rect.width) * rect.height;
+}
+
+// Queues the up to four maximal rectangles left of `free` around `used`.
+bool RectPacker::split(const PackedRect& free, const PackedRect& used)
+{
+    if (!intersects(free, used))
+        return false;
+
+    if (used.x > free.x)
+        scratch_.push_back({ free.x, free.y, used.x - free.x, free.height });
+    if (used.x + used.width < free.x + free.width)
+        scratch_.push_back({ used.x + used.width, free.y, free.x + free.width - used.x - used.width, free.height });
+    if (used.y > free.y)
+        scratch_.push_back({ free.x, free.y, free.width, used.y - free.y });
+    if (used.y + used.height < free.y + free.height)
+        scratch_.push_back({ free.x, used.y + used.height, free.width, free.y + free.height - used.y - used.height });
+
+    return true;
+}
+
+// Grows free_[index] by joining it with the rectangles it shares a whole
+// edge with, and returns where the grown rectangle ended up. Pairs of other
+// rectangles are left alone, so a removal costs one scan per join instead of
+// one per pair.
+size_t RectPacker::merge(size_t index)
+{
+    for (size_t j = 0; j < free_.size();) {
+        std::optional<PackedRect> joined;
+        if (j != index)
+            joined = join(free_[index], free_[j]);
+        if (!joined) {
+            ++j;
+            continue;
+        }
+
+        free_[index] = *joined;
+        size_t last = free_.size() - 1;
+        free_[j] = free_[last];
+        if (index == last)
+            index = j;
+        free_.pop_back();
+        j = 0;
+    }
+    return index;
+}
+
+// Drops the free rectangles inside free_[index], or free_[index] itself if
+// it lies inside another one. No two of the others contain each other.
+void RectPacker::prune(size_t index)
+{
+    for (size_t j = 0; j < free_.size();) {
+        if (j == index) {
+            ++j;
+        } else if (contains(free_[j], free_[index])) {
+            free_[index] = free_.back();
+            free_.pop_back();
+            return;
+        } else if (contains(free_[index], free_[j])) {
+            size_t last = free_.size() - 1;
+            free_[j] = free_[last];
+            if (index == last)
+                index = j;
+            free_.pop_back();
+        } else {
+            ++j;
+        }
+    }
+}
+
+} // namespace se
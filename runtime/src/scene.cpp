@@ -0,0 +1,137 @@
+#include "scene.hpp"
+
+#include <cmath>
+
+namespace se {
+
+namespace {
+
+    AAPLSpriteVertex spriteVertex(vector_float2 position, float u, float v, vector_float4 color)
+    {
+        AAPLSpriteVertex vertex;
+        vertex.position = position;
+        vertex.uv = vector_float2 { u, v };
+        vertex.color = color;
+        return vertex;
+    }
+
+    // The vertex shader has no camera input, so positions are written
+    // relative to the center of `view`, as Tilemap::draw does.
+    vector_float2 viewCenter(const CullRect& view)
+    {
+        return vector_float2 { (view.minX + view.maxX) * 0.5f, (view.minY + view.maxY) * 0.5f };
+    }
+
+    void appendSprite(const Transform& transform, const Sprite& sprite, const CullRect& view, vector_float2 origin, SpriteBatches& batches)
+    {
+        vector_float2 half = sprite.size * transform.scale * 0.5f;
+
+        // Corner offsets from the center; x and y are the half extents of
+        // the rotated quad's bounds.
+        vector_float2 x_axis = vector_float2 { half[0], 0 };
+        vector_float2 y_axis = vector_float2 { 0, half[1] };
+        float extent_x = std::abs(half[0]);
+        float extent_y = std::abs(half[1]);
+        if (transform.rotation != 0) {
+            float c = std::cos(transform.rotation);
+            float s = std::sin(transform.rotation);
+            x_axis = vector_float2 { c * half[0], s * half[0] };
+            y_axis = vector_float2 { -s * half[1], c * half[1] };
+            extent_x = std::abs(x_axis[0]) + std::abs(y_axis[0]);
+            extent_y = std::abs(x_axis[1]) + std::abs(y_axis[1]);
+        }
+
+        vector_float2 center = transform.position;
+        if (center[0] + extent_x < view.minX || center[0] - extent_x > view.maxX
+            || center[1] + extent_y < view.minY || center[1] - extent_y > view.maxY)
+            return;
+
+        center -= origin;
+        std::vector<AAPLSpriteVertex>& vertices = batches.vertices(sprite.texture);
+        vector_float4 uv = sprite.uv;
+        vertices.push_back(spriteVertex(center - x_axis + y_axis, uv[0], uv[1], sprite.color));
+        vertices.push_back(spriteVertex(center + x_axis + y_axis, uv[2], uv[1], sprite.color));
+        vertices.push_back(spriteVertex(center - x_axis - y_axis, uv[0], uv[3], sprite.color));
+        vertices.push_back(spriteVertex(center + x_axis - y_axis, uv[2], uv[3], sprite.color));
+    }
+
+} // namespace
+
+void SpriteBatches::clear()
+{
+    for (size_t i = 0; i < active_; ++i)
+        batches_[i].vertices.clear();
+    active_ = 0;
+    last_ = 0;
+}
+
+std::vector<AAPLSpriteVertex>& SpriteBatches::vertices(TextureId texture)
+{
+    // Consecutive sprites mostly share a texture.
+    if (last_ < active_ && batches_[last_].texture == texture)
+        return batches_[last_].vertices;
+
+    for (size_t i = 0; i < active_; ++i) {
+        if (batches_[i].texture == texture) {
+            last_ = i;
+            return batches_[i].vertices;
+        }
+    }
+
+    if (active_ == batches_.size())
+        batches_.emplace_back();
+    last_ = active_++;
+    batches_[last_].texture = texture;
+    return batches_[last_].vertices;
+}
+
+void SpriteBatches::draw(CommandList& list, PipelineId pipeline, BufferId quadIndices) const
+{
+    for (const Batch& batch : *this) {
+        if (!batch.vertices.empty())
+            list.drawSpriteQuads(batch.vertices.data(), batch.vertices.size() / 4, pipeline, batch.texture, quadIndices);
+    }
+}
+
+size_t SpriteBatches::quadCount() const
+{
+    size_t count = 0;
+    for (const Batch& batch : *this)
+        count += batch.vertices.size() / 4;
+    return count;
+}
+
+void movementSystem(entt::registry& registry, float dt)
+{
+    registry.view<Transform, const Velocity>().each([dt](Entity, Transform& transform, const Velocity& velocity) {
+        transform.position += velocity.linear * dt;
+        transform.rotation += velocity.angular * dt;
+    });
+}
+
+void spriteSystem(entt::registry& registry, const CullRect& view, SpriteBatches& batches)
+{
+    batches.clear();
+    vector_float2 origin = viewCenter(view);
+    registry.view<const Transform, const Sprite>().each([&](Entity, const Transform& transform, const Sprite& sprite) {
+        appendSprite(transform, sprite, view, origin, batches);
+    });
+}
+
+void spriteSystem(std::span<const SpriteInstance> sprites, const CullRect& view, SpriteBatches& batches)
+{
+    batches.clear();
+    vector_float2 origin = viewCenter(view);
+    for (const SpriteInstance& instance : sprites)
+        appendSprite(instance.transform, instance.sprite, view, origin, batches);
+}
+
+void extractSprites(entt::registry& registry, std::vector<SpriteInstance>& sprites)
+{
+    sprites.clear();
+    registry.view<const Transform, const Sprite>().each([&](Entity, const Transform& transform, const Sprite& sprite) {
+        sprites.push_back({ transform, sprite });
+    });
+}
+
+} // namespace se
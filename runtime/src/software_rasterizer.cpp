@@ -0,0 +1,475 @@
+#include "software_rasterizer.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+#if defined(SE_SOFTWARE_RASTERIZER_SCALAR)
+#define SE_RASTER_SCALAR
+#elif defined(__AVX2__)
+#define SE_RASTER_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#define SE_RASTER_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#define SE_RASTER_NEON
+#include <arm_neon.h>
+#else
+#define SE_RASTER_SCALAR
+#endif
+
+namespace se {
+
+namespace {
+
+    // Per-row constants of one triangle, shared by every span implementation.
+    struct SpanSetup {
+        float a[3];
+        float baseX[3];
+        float rowE[3];
+        bool topLeft[3];
+        float dx[4];
+        float rowColor[4];
+        float originX;
+    };
+
+    inline uint32_t packColor(const int32_t (&c)[4])
+    {
+        return uint32_t(c[0]) | (uint32_t(c[1]) << 8) | (uint32_t(c[2]) << 16) | (uint32_t(c[3]) << 24);
+    }
+
+#if defined(SE_RASTER_SCALAR)
+    constexpr int kLanes = 1;
+    constexpr const char* kSimdName = "scalar";
+
+    uint64_t shadeSpan(uint32_t* row, int x0, int x1, const SpanSetup& s)
+    {
+        uint64_t shaded = 0;
+
+        for (int x = x0; x < x1; ++x) {
+            float px = float(x) + 0.5f;
+
+            bool inside = true;
+            for (int i = 0; i < 3; ++i) {
+                float e = s.a[i] * (px - s.baseX[i]) + s.rowE[i];
+                inside = inside && (e > 0.0f || (e == 0.0f && s.topLeft[i]));
+            }
+            if (!inside)
+                continue;
+
+            int32_t c[4];
+            for (int i = 0; i < 4; ++i) {
+                float value = s.dx[i] * (px - s.originX) + s.rowColor[i];
+                value = std::min(std::max(value, 0.0f), 1.0f) * 255.0f;
+                c[i] = int32_t(std::nearbyint(value));
+            }
+
+            row[x] = packColor(c);
+            ++shaded;
+        }
+
+        return shaded;
+    }
+#elif defined(SE_RASTER_SSE2)
+    constexpr int kLanes = 4;
+    constexpr const char* kSimdName = "SSE2";
+
+    uint64_t shadeSpan(uint32_t* row, int x0, int x1, const SpanSetup& s)
+    {
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 scale = _mm_set1_ps(255.0f);
+        const __m128 ramp = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+
+        __m128 a[3], base[3], rowE[3], topLeft[3];
+        for (int i = 0; i < 3; ++i) {
+            a[i] = _mm_set1_ps(s.a[i]);
+            base[i] = _mm_set1_ps(s.baseX[i]);
+            rowE[i] = _mm_set1_ps(s.rowE[i]);
+            topLeft[i] = _mm_castsi128_ps(_mm_set1_epi32(s.topLeft[i] ? -1 : 0));
+        }
+
+        __m128 dx[4], rowColor[4];
+        for (int i = 0; i < 4; ++i) {
+            dx[i] = _mm_set1_ps(s.dx[i]);
+            rowColor[i] = _mm_set1_ps(s.rowColor[i]);
+        }
+        const __m128 origin = _mm_set1_ps(s.originX);
+
+        uint64_t shaded = 0;
+
+        for (int x = x0; x < x1; x += kLanes) {
+            __m128 px = _mm_add_ps(_mm_set1_ps(float(x)), ramp);
+
+            __m128 mask = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for (int i = 0; i < 3; ++i) {
+                __m128 e = _mm_add_ps(_mm_mul_ps(a[i], _mm_sub_ps(px, base[i])), rowE[i]);
+                __m128 inside = _mm_or_ps(_mm_cmpgt_ps(e, zero), _mm_and_ps(_mm_cmpeq_ps(e, zero), topLeft[i]));
+                mask = _mm_and_ps(mask, inside);
+            }
+
+            int bits = _mm_movemask_ps(mask);
+            if (bits == 0)
+                continue;
+
+            __m128 offset = _mm_sub_ps(px, origin);
+            __m128i packed = _mm_setzero_si128();
+            for (int i = 0; i < 4; ++i) {
+                __m128 value = _mm_add_ps(_mm_mul_ps(dx[i], offset), rowColor[i]);
+                value = _mm_mul_ps(_mm_min_ps(_mm_max_ps(value, zero), one), scale);
+                packed = _mm_or_si128(packed, _mm_slli_epi32(_mm_cvtps_epi32(value), 8 * i));
+            }
+
+            __m128i* target = reinterpret_cast<__m128i*>(row + x);
+            __m128i keep = _mm_castps_si128(mask);
+            __m128i old = _mm_loadu_si128(target);
+            _mm_storeu_si128(target, _mm_or_si128(_mm_and_si128(keep, packed), _mm_andnot_si128(keep, old)));
+
+            shaded += std::popcount(unsigned(bits));
+        }
+
+        return shaded;
+    }
+#elif defined(SE_RASTER_AVX2)
+    constexpr int kLanes = 8;
+    constexpr const char* kSimdName = "AVX2";
+
+    uint64_t shadeSpan(uint32_t* row, int x0, int x1, const SpanSetup& s)
+    {
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 one = _mm256_set1_ps(1.0f);
+        const __m256 scale = _mm256_set1_ps(255.0f);
+        const __m256 ramp = _mm256_setr_ps(0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f);
+
+        __m256 a[3], base[3], rowE[3], topLeft[3];
+        for (int i = 0; i < 3; ++i) {
+            a[i] = _mm256_set1_ps(s.a[i]);
+            base[i] = _mm256_set1_ps(s.baseX[i]);
+            rowE[i] = _mm256_set1_ps(s.rowE[i]);
+            topLeft[i] = _mm256_castsi256_ps(_mm256_set1_epi32(s.topLeft[i] ? -1 : 0));
+        }
+
+        __m256 dx[4], rowColor[4];
+        for (int i = 0; i < 4; ++i) {
+            dx[i] = _mm256_set1_ps(s.dx[i]);
+            rowColor[i] = _mm256_set1_ps(s.rowColor[i]);
+        }
+        const __m256 origin = _mm256_set1_ps(s.originX);
+
+        uint64_t shaded = 0;
+
+        for (int x = x0; x < x1; x += kLanes) {
+            __m256 px = _mm256_add_ps(_mm256_set1_ps(float(x)), ramp);
+
+            __m256 mask = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+            for (int i = 0; i < 3; ++i) {
+                __m256 e = _mm256_add_ps(_mm256_mul_ps(a[i], _mm256_sub_ps(px, base[i])), rowE[i]);
+                __m256 inside = _mm256_or_ps(_mm256_cmp_ps(e, zero, _CMP_GT_OQ),
+                    _mm256_and_ps(_mm256_cmp_ps(e, zero, _CMP_EQ_OQ), topLeft[i]));
+                mask = _mm256_and_ps(mask, inside);
+            }
+
+            int bits = _mm256_movemask_ps(mask);
+            if (bits == 0)
+                continue;
+
+            __m256 offset = _mm256_sub_ps(px, origin);
+            __m256i packed = _mm256_setzero_si256();
+            for (int i = 0; i < 4; ++i) {
+                __m256 value = _mm256_add_ps(_mm256_mul_ps(dx[i], offset), rowColor[i]);
+                value = _mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(value, zero), one), scale);
+                packed = _mm256_or_si256(packed, _mm256_slli_epi32(_mm256_cvtps_epi32(value), 8 * i));
+            }
+
+            __m256i* target = reinterpret_cast<__m256i*>(row + x);
+            __m256i old = _mm256_loadu_si256(target);
+            _mm256_storeu_si256(target, _mm256_blendv_epi8(old, packed, _mm256_castps_si256(mask)));
+
+            shaded += std::popcount(unsigned(bits));
+        }
+
+        return shaded;
+    }
+#elif defined(SE_RASTER_NEON)
+    constexpr int kLanes = 4;
+    constexpr const char* kSimdName = "NEON";
+
+    uint64_t shadeSpan(uint32_t* row, int x0, int x1, const SpanSetup& s)
+    {
+        const float32x4_t zero = vdupq_n_f32(0.0f);
+        const float32x4_t one = vdupq_n_f32(1.0f);
+        const float32x4_t scale = vdupq_n_f32(255.0f);
+        const float ramp_values[4] = { 0.5f, 1.5f, 2.5f, 3.5f };
+        const float32x4_t ramp = vld1q_f32(ramp_values);
+
+        float32x4_t a[3], base[3], rowE[3];
+        uint32x4_t topLeft[3];
+        for (int i = 0; i < 3; ++i) {
+            a[i] = vdupq_n_f32(s.a[i]);
+            base[i] = vdupq_n_f32(s.baseX[i]);
+            rowE[i] = vdupq_n_f32(s.rowE[i]);
+            topLeft[i] = vdupq_n_u32(s.topLeft[i] ? ~0u : 0u);
+        }
+
+        float32x4_t dx[4], rowColor[4];
+        for (int i = 0; i < 4; ++i) {
+            dx[i] = vdupq_n_f32(s.dx[i]);
+            rowColor[i] = vdupq_n_f32(s.rowColor[i]);
+        }
+        const float32x4_t origin = vdupq_n_f32(s.originX);
+
+        uint64_t shaded = 0;
+
+        for (int x = x0; x < x1; x += kLanes) {
+            float32x4_t px = vaddq_f32(vdupq_n_f32(float(x)), ramp);
+
+            uint32x4_t mask = vdupq_n_u32(~0u);
+            for (int i = 0; i < 3; ++i) {
+                // Multiply and add separately so rounding matches the scalar path.
+                float32x4_t e = vaddq_f32(vmulq_f32(a[i], vsubq_f32(px, base[i])), rowE[i]);
+                uint32x4_t inside = vorrq_u32(vcgtq_f32(e, zero), vandq_u32(vceqq_f32(e, zero), topLeft[i]));
+                mask = vandq_u32(mask, inside);
+            }
+
+            if (vmaxvq_u32(mask) == 0)
+                continue;
+
+            float32x4_t offset = vsubq_f32(px, origin);
+            uint32x4_t packed = vdupq_n_u32(0);
+            for (int i = 0; i < 4; ++i) {
+                float32x4_t value = vaddq_f32(vmulq_f32(dx[i], offset), rowColor[i]);
+                value = vmulq_f32(vminq_f32(vmaxq_f32(value, zero), one), scale);
+                packed = vorrq_u32(packed, vshlq_u32(vreinterpretq_u32_s32(vcvtnq_s32_f32(value)), vdupq_n_s32(8 * i)));
+            }
+
+            uint32_t* target = row + x;
+            vst1q_u32(target, vbslq_u32(mask, packed, vld1q_u32(target)));
+
+            shaded += vaddvq_u32(vshrq_n_u32(mask, 31));
+        }
+
+        return shaded;
+    }
+#endif
+
+} // namespace
+
+const char* SoftwareRasterizer::simdName()
+{
+    return kSimdName;
+}
+
+void SoftwareRasterizer::resize(uint32_t width, uint32_t height)
+{
+    tiles_x_ = (width + kTileSize - 1) / kTileSize;
+    tiles_y_ = (height + kTileSize - 1) / kTileSize;
+
+    framebuffer_.width = width;
+    framebuffer_.height = height;
+    framebuffer_.stride = tiles_x_ * kTileSize;
+    framebuffer_.pixels.assign(size_t(framebuffer_.stride) * tiles_y_ * kTileSize, 0);
+}
+
+void SoftwareRasterizer::clear(uint32_t color)
+{
+    std::fill(framebuffer_.pixels.begin(), framebuffer_.pixels.end(), color);
+}
+
+void SoftwareRasterizer::addTriangles(const AAPLVertex* vertices, uint32_t count, vector_uint2 viewport)
+{
+    float half_width = float(viewport[0]) / 2.0f;
+    float half_height = float(viewport[1]) / 2.0f;
+    float width = float(framebuffer_.width);
+    float height = float(framebuffer_.height);
+
+    for (uint32_t first = 0; first + 3 <= count; first += 3) {
+        Triangle& triangle = triangles_.emplace_back();
+
+        for (int i = 0; i < 3; ++i) {
+            const AAPLVertex& vertex = vertices[first + i];
+
+            // vertexShader: clip = pixel / (viewport / 2); then the viewport
+            // transform with y pointing down.
+            float clip_x = vertex.position[0] / half_width;
+            float clip_y = vertex.position[1] / half_height;
+            triangle.x[i] = (clip_x * 0.5f + 0.5f) * width;
+            triangle.y[i] = (0.5f - clip_y * 0.5f) * height;
+
+            for (int c = 0; c < 4; ++c)
+                triangle.color[i][c] = vertex.color[c];
+        }
+    }
+}
+
+bool SoftwareRasterizer::setup(const Triangle& triangle, Setup& result) const
+{
+    float x[3] = { triangle.x[0], triangle.x[1], triangle.x[2] };
+    float y[3] = { triangle.y[0], triangle.y[1], triangle.y[2] };
+    const float* color[3] = { triangle.color[0], triangle.color[1], triangle.color[2] };
+
+    float area = (x[1] - x[0]) * (y[2] - y[0]) - (y[1] - y[0]) * (x[2] - x[0]);
+    if (!(area != 0.0f) || !std::isfinite(area))
+        return false;
+
+    // Metal does not cull by default, so both windings are drawn.
+    if (area < 0.0f) {
+        std::swap(x[1], x[2]);
+        std::swap(y[1], y[2]);
+        std::swap(color[1], color[2]);
+        area = -area;
+    }
+
+    float min_x = std::min({ x[0], x[1], x[2] });
+    float max_x = std::max({ x[0], x[1], x[2] });
+    float min_y = std::min({ y[0], y[1], y[2] });
+    float max_y = std::max({ y[0], y[1], y[2] });
+
+    float width = float(framebuffer_.width);
+    float height = float(framebuffer_.height);
+    if (max_x < 0.0f || max_y < 0.0f || min_x >= width || min_y >= height)
+        return false;
+
+    result.minX = int32_t(std::max(std::floor(min_x), 0.0f));
+    result.minY = int32_t(std::max(std::floor(min_y), 0.0f));
+    result.maxX = int32_t(std::min(std::ceil(max_x), width - 1.0f));
+    result.maxY = int32_t(std::min(std::ceil(max_y), height - 1.0f));
+
+    // Edge i lies opposite vertex i, so its value is vertex i's barycentric
+    // weight scaled by the area.
+    for (int i = 0; i < 3; ++i) {
+        int from = (i + 1) % 3;
+        int to = (i + 2) % 3;
+
+        float dx = x[to] - x[from];
+        float dy = y[to] - y[from];
+
+        Edge& edge = result.edges[i];
+        edge.a = -dy;
+        edge.b = dx;
+        // Top edges are horizontal with the interior below; left edges go up.
+        edge.topLeft = (dy == 0.0f && dx > 0.0f) || dy < 0.0f;
+
+        bool from_is_base = x[from] < x[to] || (x[from] == x[to] && y[from] < y[to]);
+        edge.baseX = from_is_base ? x[from] : x[to];
+        edge.baseY = from_is_base ? y[from] : y[to];
+    }
+
+    result.originX = x[0];
+    result.originY = y[0];
+
+    for (int c = 0; c < 4; ++c) {
+        Gradient& gradient = result.color[c];
+        gradient.value = color[0][c];
+        gradient.dx = 0.0f;
+        gradient.dy = 0.0f;
+
+        for (int i = 0; i < 3; ++i) {
+            gradient.dx += result.edges[i].a * color[i][c];
+            gradient.dy += result.edges[i].b * color[i][c];
+        }
+
+        gradient.dx /= area;
+        gradient.dy /= area;
+    }
+
+    return true;
+}
+
+void SoftwareRasterizer::bin(size_t chunk, size_t chunks)
+{
+    size_t tiles = size_t(tiles_x_) * tiles_y_;
+    size_t first = triangles_.size() * chunk / chunks;
+    size_t last = triangles_.size() * (chunk + 1) / chunks;
+
+    for (size_t t = 0; t < tiles; ++t)
+        bins_[chunk * tiles + t].clear();
+
+    for (size_t index = first; index < last; ++index) {
+        Setup& setup_result = setups_[index];
+        if (!setup(triangles_[index], setup_result))
+            continue;
+
+        uint32_t tile_x0 = setup_result.minX / kTileSize;
+        uint32_t tile_x1 = setup_result.maxX / kTileSize;
+        uint32_t tile_y0 = setup_result.minY / kTileSize;
+        uint32_t tile_y1 = setup_result.maxY / kTileSize;
+
+        for (uint32_t ty = tile_y0; ty <= tile_y1; ++ty)
+            for (uint32_t tx = tile_x0; tx <= tile_x1; ++tx)
+                bins_[chunk * tiles + ty * tiles_x_ + tx].push_back(uint32_t(index));
+    }
+}
+
+void SoftwareRasterizer::rasterizeTile(size_t tile)
+{
+    size_t tiles = size_t(tiles_x_) * tiles_y_;
+    int32_t tile_x = int32_t(tile % tiles_x_) * kTileSize;
+    int32_t tile_y = int32_t(tile / tiles_x_) * kTileSize;
+
+    uint64_t shaded = 0;
+
+    for (size_t chunk = 0; chunk < chunks_; ++chunk) {
+        for (uint32_t index : bins_[chunk * tiles + tile]) {
+            const Setup& s = setups_[index];
+
+            // Spans start on a lane boundary; lanes outside the triangle are
+            // rejected by the edge test and the tile keeps them in bounds.
+            int32_t x0 = std::max(s.minX, tile_x) & ~(kLanes - 1);
+            int32_t x1 = std::min(s.maxX + 1, tile_x + int32_t(kTileSize));
+            int32_t y0 = std::max(s.minY, tile_y);
+            int32_t y1 = std::min(s.maxY + 1, tile_y + int32_t(kTileSize));
+
+            SpanSetup span;
+            for (int i = 0; i < 3; ++i) {
+                span.a[i] = s.edges[i].a;
+                span.baseX[i] = s.edges[i].baseX;
+                span.topLeft[i] = s.edges[i].topLeft;
+            }
+            for (int c = 0; c < 4; ++c)
+                span.dx[c] = s.color[c].dx;
+            span.originX = s.originX;
+
+            for (int32_t y = y0; y < y1; ++y) {
+                float py = float(y) + 0.5f;
+
+                for (int i = 0; i < 3; ++i)
+                    span.rowE[i] = s.edges[i].b * (py - s.edges[i].baseY);
+                for (int c = 0; c < 4; ++c)
+                    span.rowColor[c] = s.color[c].value + s.color[c].dy * (py - s.originY);
+
+                uint32_t* row = framebuffer_.pixels.data() + size_t(y) * framebuffer_.stride;
+                shaded += shadeSpan(row, x0, x1, span);
+            }
+        }
+    }
+
+    tile_pixels_[tile] = shaded;
+}
+
+void SoftwareRasterizer::flush()
+{
+    if (triangles_.empty() || tiles_x_ == 0 || tiles_y_ == 0) {
+        triangles_.clear();
+        return;
+    }
+
+    size_t tiles = size_t(tiles_x_) * tiles_y_;
+
+    chunks_ = std::min(pool_.threadCount(), triangles_.size());
+    setups_.resize(triangles_.size());
+    if (bins_.size() < chunks_ * tiles)
+        bins_.resize(chunks_ * tiles);
+    tile_pixels_.assign(tiles, 0);
+
+    pool_.parallelFor(chunks_, [this](size_t chunk) { bin(chunk, chunks_); });
+    pool_.parallelFor(tiles, [this](size_t tile) { rasterizeTile(tile); });
+
+    triangles_rasterized_ += triangles_.size();
+    for (uint64_t pixels : tile_pixels_)
+        pixels_shaded_ += pixels;
+
+    triangles_.clear();
+}
+
+} // namespace se
@@ -0,0 +1,324 @@
+#include "sprite_vertices.hpp"
+
+#include <cmath>
+#include <cstdint>
+
+#if defined(SE_SPRITE_VERTICES_SCALAR)
+#define SE_SPRITE_SCALAR
+#elif (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define SE_SPRITE_AVX2
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define SE_SPRITE_NEON
+#include <arm_neon.h>
+#else
+#define SE_SPRITE_SCALAR
+#endif
+
+namespace se {
+
+namespace {
+
+    // Cephes sinf/cosf: reduction by pi/2 in three parts, then minimax
+    // polynomials on [-pi/4, pi/4]. Every kernel follows the same steps.
+    constexpr float kTwoOverPi = 0.636619772367581343f;
+    constexpr float kPiOver2Part1 = 1.5703125f;
+    constexpr float kPiOver2Part2 = 4.837512969970703125e-4f;
+    constexpr float kPiOver2Part3 = 7.54978995489188216e-8f;
+    constexpr float kSin1 = -1.6666654611e-1f;
+    constexpr float kSin2 = 8.3321608736e-3f;
+    constexpr float kSin3 = -1.9515295891e-4f;
+    constexpr float kCos1 = 4.166664568298827e-2f;
+    constexpr float kCos2 = -1.388731625493765e-3f;
+    constexpr float kCos3 = 2.443315711809948e-5f;
+    // Rotations up to 8192 pi keep the quadrant far inside int32_t and the
+    // reduction accurate; larger ones are first reduced to [-pi, pi].
+    constexpr float kMaxAngle = 25735.927f;
+    constexpr float kTwoPi = 6.28318530717958647692f;
+
+    // The SIMD kernels hand blocks with rotations outside +-kMaxAngle to
+    // the scalar kernel, so every kernel reduces them the same way.
+    void sinCos(float angle, float& sine, float& cosine)
+    {
+        // Also taken for NaNs.
+        if (!(std::abs(angle) <= kMaxAngle)) {
+            if (!std::isfinite(angle)) {
+                sine = cosine = angle - angle;
+                return;
+            }
+            angle = std::remainder(angle, kTwoPi);
+        }
+
+        float scaled = angle * kTwoOverPi;
+        int32_t quadrant = int32_t(scaled + (scaled < 0 ? -0.5f : 0.5f));
+        float j = float(quadrant);
+        float r = ((angle - j * kPiOver2Part1) - j * kPiOver2Part2) - j * kPiOver2Part3;
+        float z = r * r;
+
+        float s = r + r * z * (kSin1 + z * (kSin2 + z * kSin3));
+        float c = (1.0f - 0.5f * z) + z * z * (kCos1 + z * (kCos2 + z * kCos3));
+
+        if (quadrant & 1) {
+            float swap = s;
+            s = c;
+            c = swap;
+        }
+        sine = (quadrant & 2) ? -s : s;
+        cosine = ((quadrant + 1) & 2) ? -c : c;
+    }
+
+    AAPLSpriteVertex spriteVertex(float x, float y, float u, float v, vector_float4 color)
+    {
+        AAPLSpriteVertex vertex;
+        vertex.position = vector_float2 { x, y };
+        vertex.uv = vector_float2 { u, v };
+        vertex.color = color;
+        return vertex;
+    }
+
+    // Corners as in appendSprite in scene.cpp: top left, top right, bottom
+    // left, bottom right.
+    void generateScalar(const SpriteStreams& sprites, size_t begin, size_t end, AAPLSpriteVertex* out)
+    {
+        for (size_t i = begin; i < end; ++i) {
+            float s, c;
+            sinCos(sprites.rotation[i], s, c);
+
+            float half_width = sprites.width[i] * 0.5f;
+            float half_height = sprites.height[i] * 0.5f;
+            float ax = c * half_width, ay = s * half_width;
+            float bx = -s * half_height, by = c * half_height;
+            float x = sprites.x[i], y = sprites.y[i];
+
+            vector_float4 uv = sprites.uv[i];
+            vector_float4 color = sprites.color[i];
+            AAPLSpriteVertex* quad = out + 4 * i;
+            quad[0] = spriteVertex(x - ax + bx, y - ay + by, uv[0], uv[1], color);
+            quad[1] = spriteVertex(x + ax + bx, y + ay + by, uv[2], uv[1], color);
+            quad[2] = spriteVertex(x - ax - bx, y - ay - by, uv[0], uv[3], color);
+            quad[3] = spriteVertex(x + ax - bx, y + ay - by, uv[2], uv[3], color);
+        }
+    }
+
+#if defined(SE_SPRITE_AVX2)
+#define SE_AVX2 __attribute__((target("avx2")))
+
+    SE_AVX2 void sinCos8(__m256 angle, __m256& sine, __m256& cosine)
+    {
+        const __m256 sign_mask = _mm256_set1_ps(-0.0f);
+
+        __m256 scaled = _mm256_mul_ps(angle, _mm256_set1_ps(kTwoOverPi));
+        __m256 half = _mm256_or_ps(_mm256_and_ps(scaled, sign_mask), _mm256_set1_ps(0.5f));
+        __m256i quadrant = _mm256_cvttps_epi32(_mm256_add_ps(scaled, half));
+        __m256 j = _mm256_cvtepi32_ps(quadrant);
+
+        __m256 r = _mm256_sub_ps(angle, _mm256_mul_ps(j, _mm256_set1_ps(kPiOver2Part1)));
+        r = _mm256_sub_ps(r, _mm256_mul_ps(j, _mm256_set1_ps(kPiOver2Part2)));
+        r = _mm256_sub_ps(r, _mm256_mul_ps(j, _mm256_set1_ps(kPiOver2Part3)));
+        __m256 z = _mm256_mul_ps(r, r);
+
+        __m256 s = _mm256_add_ps(_mm256_set1_ps(kSin2), _mm256_mul_ps(z, _mm256_set1_ps(kSin3)));
+        s = _mm256_add_ps(_mm256_set1_ps(kSin1), _mm256_mul_ps(z, s));
+        s = _mm256_add_ps(r, _mm256_mul_ps(_mm256_mul_ps(r, z), s));
+
+        __m256 c = _mm256_add_ps(_mm256_set1_ps(kCos2), _mm256_mul_ps(z, _mm256_set1_ps(kCos3)));
+        c = _mm256_add_ps(_mm256_set1_ps(kCos1), _mm256_mul_ps(z, c));
+        c = _mm256_add_ps(_mm256_sub_ps(_mm256_set1_ps(1.0f), _mm256_mul_ps(_mm256_set1_ps(0.5f), z)), _mm256_mul_ps(_mm256_mul_ps(z, z), c));
+
+        __m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(quadrant, _mm256_set1_epi32(1)), _mm256_set1_epi32(1)));
+        __m256 sine_sign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(quadrant, _mm256_set1_epi32(2)), 30));
+        __m256 cosine_sign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(quadrant, _mm256_set1_epi32(1)), _mm256_set1_epi32(2)), 30));
+
+        sine = _mm256_xor_ps(_mm256_blendv_ps(s, c, swap), sine_sign);
+        cosine = _mm256_xor_ps(_mm256_blendv_ps(c, s, swap), cosine_sign);
+    }
+
+    // The two positions of sprites i and i + 1 of every 128-bit half,
+    // interleaved in sprite order: x0 y0 x1 y1 ... x7 y7.
+    SE_AVX2 void storePositions(__m256 x, __m256 y, float* positions)
+    {
+        __m256 low = _mm256_unpacklo_ps(x, y);
+        __m256 high = _mm256_unpackhi_ps(x, y);
+        _mm256_store_ps(positions, _mm256_permute2f128_ps(low, high, 0x20));
+        _mm256_store_ps(positions + 8, _mm256_permute2f128_ps(low, high, 0x31));
+    }
+
+    SE_AVX2 void generateAvx2(const SpriteStreams& sprites, size_t count, AAPLSpriteVertex* out)
+    {
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            // Not-less-or-equal is also true for NaNs.
+            __m256 rotation = _mm256_loadu_ps(sprites.rotation + i);
+            __m256 magnitude = _mm256_andnot_ps(_mm256_set1_ps(-0.0f), rotation);
+            if (_mm256_movemask_ps(_mm256_cmp_ps(magnitude, _mm256_set1_ps(kMaxAngle), _CMP_NLE_UQ))) {
+                generateScalar(sprites, i, i + 8, out);
+                continue;
+            }
+
+            __m256 sine, cosine;
+            sinCos8(rotation, sine, cosine);
+
+            __m256 half_width = _mm256_mul_ps(_mm256_loadu_ps(sprites.width + i), _mm256_set1_ps(0.5f));
+            __m256 half_height = _mm256_mul_ps(_mm256_loadu_ps(sprites.height + i), _mm256_set1_ps(0.5f));
+            __m256 ax = _mm256_mul_ps(cosine, half_width);
+            __m256 ay = _mm256_mul_ps(sine, half_width);
+            __m256 bx = _mm256_xor_ps(_mm256_mul_ps(sine, half_height), _mm256_set1_ps(-0.0f));
+            __m256 by = _mm256_mul_ps(cosine, half_height);
+            __m256 x = _mm256_loadu_ps(sprites.x + i);
+            __m256 y = _mm256_loadu_ps(sprites.y + i);
+
+            alignas(32) float corners[4][16];
+            storePositions(_mm256_add_ps(_mm256_sub_ps(x, ax), bx), _mm256_add_ps(_mm256_sub_ps(y, ay), by), corners[0]);
+            storePositions(_mm256_add_ps(_mm256_add_ps(x, ax), bx), _mm256_add_ps(_mm256_add_ps(y, ay), by), corners[1]);
+            storePositions(_mm256_sub_ps(_mm256_sub_ps(x, ax), bx), _mm256_sub_ps(_mm256_sub_ps(y, ay), by), corners[2]);
+            storePositions(_mm256_sub_ps(_mm256_add_ps(x, ax), bx), _mm256_sub_ps(_mm256_add_ps(y, ay), by), corners[3]);
+
+            // Every vertex is position and uv in one half, color in the
+            // other: one 32-byte store.
+            for (size_t k = 0; k < 8; ++k) {
+                __m128 uv = _mm_loadu_ps(reinterpret_cast<const float*>(sprites.uv + i + k));
+                __m128 color = _mm_loadu_ps(reinterpret_cast<const float*>(sprites.color + i + k));
+                __m128 uv_corners[4] = {
+                    _mm_shuffle_ps(uv, uv, _MM_SHUFFLE(1, 0, 1, 0)),
+                    _mm_shuffle_ps(uv, uv, _MM_SHUFFLE(1, 2, 1, 2)),
+                    _mm_shuffle_ps(uv, uv, _MM_SHUFFLE(3, 0, 3, 0)),
+                    _mm_shuffle_ps(uv, uv, _MM_SHUFFLE(3, 2, 3, 2)),
+                };
+
+                float* quad = reinterpret_cast<float*>(out + 4 * (i + k));
+                for (size_t corner = 0; corner < 4; ++corner) {
+                    __m128 position_uv = _mm_loadl_pi(uv_corners[corner], reinterpret_cast<const __m64*>(&corners[corner][2 * k]));
+                    _mm256_storeu_ps(quad + 8 * corner, _mm256_set_m128(color, position_uv));
+                }
+            }
+        }
+        generateScalar(sprites, i, count, out);
+    }
+
+#undef SE_AVX2
+#elif defined(SE_SPRITE_NEON)
+    void sinCos4(float32x4_t angle, float32x4_t& sine, float32x4_t& cosine)
+    {
+        float32x4_t scaled = vmulq_n_f32(angle, kTwoOverPi);
+        float32x4_t half = vbslq_f32(vcltq_f32(scaled, vdupq_n_f32(0)), vdupq_n_f32(-0.5f), vdupq_n_f32(0.5f));
+        int32x4_t quadrant = vcvtq_s32_f32(vaddq_f32(scaled, half));
+        float32x4_t j = vcvtq_f32_s32(quadrant);
+
+        float32x4_t r = vsubq_f32(angle, vmulq_n_f32(j, kPiOver2Part1));
+        r = vsubq_f32(r, vmulq_n_f32(j, kPiOver2Part2));
+        r = vsubq_f32(r, vmulq_n_f32(j, kPiOver2Part3));
+        float32x4_t z = vmulq_f32(r, r);
+
+        float32x4_t s = vaddq_f32(vdupq_n_f32(kSin2), vmulq_n_f32(z, kSin3));
+        s = vaddq_f32(vdupq_n_f32(kSin1), vmulq_f32(z, s));
+        s = vaddq_f32(r, vmulq_f32(vmulq_f32(r, z), s));
+
+        float32x4_t c = vaddq_f32(vdupq_n_f32(kCos2), vmulq_n_f32(z, kCos3));
+        c = vaddq_f32(vdupq_n_f32(kCos1), vmulq_f32(z, c));
+        c = vaddq_f32(vsubq_f32(vdupq_n_f32(1.0f), vmulq_n_f32(z, 0.5f)), vmulq_f32(vmulq_f32(z, z), c));
+
+        uint32x4_t swap = vtstq_s32(quadrant, vdupq_n_s32(1));
+        uint32x4_t sine_sign = vshlq_n_u32(vreinterpretq_u32_s32(vandq_s32(quadrant, vdupq_n_s32(2))), 30);
+        uint32x4_t cosine_sign = vshlq_n_u32(vreinterpretq_u32_s32(vandq_s32(vaddq_s32(quadrant, vdupq_n_s32(1)), vdupq_n_s32(2))), 30);
+
+        sine = vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(vbslq_f32(swap, c, s)), sine_sign));
+        cosine = vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(vbslq_f32(swap, s, c)), cosine_sign));
+    }
+
+    void generateNeon(const SpriteStreams& sprites, size_t count, AAPLSpriteVertex* out)
+    {
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            // The comparison is false for NaNs.
+            float32x4_t rotation = vld1q_f32(sprites.rotation + i);
+            if (vminvq_u32(vcaleq_f32(rotation, vdupq_n_f32(kMaxAngle))) == 0) {
+                generateScalar(sprites, i, i + 4, out);
+                continue;
+            }
+
+            float32x4_t sine, cosine;
+            sinCos4(rotation, sine, cosine);
+
+            float32x4_t half_width = vmulq_n_f32(vld1q_f32(sprites.width + i), 0.5f);
+            float32x4_t half_height = vmulq_n_f32(vld1q_f32(sprites.height + i), 0.5f);
+            float32x4_t ax = vmulq_f32(cosine, half_width);
+            float32x4_t ay = vmulq_f32(sine, half_width);
+            float32x4_t bx = vnegq_f32(vmulq_f32(sine, half_height));
+            float32x4_t by = vmulq_f32(cosine, half_height);
+            float32x4_t x = vld1q_f32(sprites.x + i);
+            float32x4_t y = vld1q_f32(sprites.y + i);
+
+            // x and y interleaved per corner: x0 y0 x1 y1 | x2 y2 x3 y3.
+            float32x4x2_t corners[4] = {
+                vzipq_f32(vaddq_f32(vsubq_f32(x, ax), bx), vaddq_f32(vsubq_f32(y, ay), by)),
+                vzipq_f32(vaddq_f32(vaddq_f32(x, ax), bx), vaddq_f32(vaddq_f32(y, ay), by)),
+                vzipq_f32(vsubq_f32(vsubq_f32(x, ax), bx), vsubq_f32(vsubq_f32(y, ay), by)),
+                vzipq_f32(vsubq_f32(vaddq_f32(x, ax), bx), vsubq_f32(vaddq_f32(y, ay), by)),
+            };
+
+            for (size_t k = 0; k < 4; ++k) {
+                float32x4_t uv = vld1q_f32(reinterpret_cast<const float*>(sprites.uv + i + k));
+                float32x4_t color = vld1q_f32(reinterpret_cast<const float*>(sprites.color + i + k));
+                float32x2_t u0_v0 = vget_low_f32(uv);
+                float32x2_t u1_v1 = vget_high_f32(uv);
+                float32x2_t uv_corners[4] = {
+                    u0_v0,
+                    vcopy_lane_f32(u1_v1, 1, u0_v0, 1),
+                    vcopy_lane_f32(u0_v0, 1, u1_v1, 1),
+                    u1_v1,
+                };
+
+                float* quad = reinterpret_cast<float*>(out + 4 * (i + k));
+                for (size_t corner = 0; corner < 4; ++corner) {
+                    float32x4_t pair = corners[corner].val[k / 2];
+                    float32x2_t position = (k % 2) ? vget_high_f32(pair) : vget_low_f32(pair);
+                    vst1q_f32(quad + 8 * corner, vcombine_f32(position, uv_corners[corner]));
+                    vst1q_f32(quad + 8 * corner + 4, color);
+                }
+            }
+        }
+        generateScalar(sprites, i, count, out);
+    }
+#endif
+
+    void generatePortable(const SpriteStreams& sprites, size_t count, AAPLSpriteVertex* out)
+    {
+        generateScalar(sprites, 0, count, out);
+    }
+
+    struct Kernel {
+        void (*generate)(const SpriteStreams&, size_t, AAPLSpriteVertex*);
+        const char* name;
+    };
+
+    Kernel selectKernel()
+    {
+#if defined(SE_SPRITE_AVX2)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+            return { generateAvx2, "avx2" };
+#elif defined(SE_SPRITE_NEON)
+        return { generateNeon, "neon" };
+#endif
+        return { generatePortable, "scalar" };
+    }
+
+    const Kernel& kernel()
+    {
+        static const Kernel selected = selectKernel();
+        return selected;
+    }
+
+} // namespace
+
+void generateSpriteVertices(const SpriteStreams& sprites, size_t count, AAPLSpriteVertex* out)
+{
+    kernel().generate(sprites, count, out);
+}
+
+const char* spriteVerticesKernelName()
+{
+    return kernel().name;
+}
+
+} // namespace se
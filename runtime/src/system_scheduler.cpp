@@ -0,0 +1,141 @@
+#include "system_scheduler.hpp"
+
+#include <algorithm>
+
+namespace se {
+
+bool SystemAccess::overlaps(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b)
+{
+    for (uint32_t id : a) {
+        if (std::find(b.begin(), b.end(), id) != b.end())
+            return true;
+    }
+    return false;
+}
+
+bool SystemAccess::conflicts(const SystemAccess& other) const
+{
+    if (exclusive_ || other.exclusive_)
+        return true;
+
+    return overlaps(writes_, other.writes_) || overlaps(writes_, other.reads_) || overlaps(reads_, other.writes_);
+}
+
+void SystemScheduler::add(std::string name, const SystemAccess& access, System system)
+{
+    systems_.push_back({ std::move(name), access, std::move(system), {}, 0 });
+    dirty_ = true;
+}
+
+void SystemScheduler::clear()
+{
+    systems_.clear();
+    dirty_ = false;
+}
+
+void SystemScheduler::run(entt::registry& registry, float dt)
+{
+    for (Node& node : systems_)
+        node.system(registry, dt);
+}
+
+void SystemScheduler::run(entt::registry& registry, float dt, ThreadPool& pool)
+{
+    if (pool.threadCount() <= 1 || systems_.size() <= 1) {
+        run(registry, dt);
+        return;
+    }
+
+    if (dirty_)
+        buildGraph();
+    prepare(registry);
+
+    pending_.resize(systems_.size());
+    ready_.clear();
+    for (size_t i = 0; i < systems_.size(); ++i) {
+        pending_[i] = systems_[i].dependencies;
+        if (pending_[i] == 0)
+            ready_.push_back(i);
+    }
+    remaining_ = systems_.size();
+
+    // Every pool thread takes ready systems until all have run. A thread
+    // that finds none waits for a running one to release its successors.
+    pool.parallelFor(pool.threadCount(), [&](size_t) {
+        drain(registry, dt);
+    });
+}
+
+std::vector<size_t> SystemScheduler::dependencies(size_t index)
+{
+    if (dirty_)
+        buildGraph();
+
+    std::vector<size_t> result;
+    for (size_t i = 0; i < index; ++i) {
+        const std::vector<size_t>& successors = systems_[i].successors;
+        if (std::find(successors.begin(), successors.end(), index) != successors.end())
+            result.push_back(i);
+    }
+    return result;
+}
+
+void SystemScheduler::buildGraph()
+{
+    for (Node& node : systems_) {
+        node.successors.clear();
+        node.dependencies = 0;
+    }
+
+    // An edge from every earlier conflicting system keeps the order the
+    // systems were added in wherever it matters.
+    for (size_t later = 0; later < systems_.size(); ++later) {
+        for (size_t earlier = 0; earlier < later; ++earlier) {
+            if (systems_[earlier].access.conflicts(systems_[later].access)) {
+                systems_[earlier].successors.push_back(later);
+                ++systems_[later].dependencies;
+            }
+        }
+    }
+    dirty_ = false;
+}
+
+void SystemScheduler::prepare(entt::registry& registry)
+{
+    for (const Node& node : systems_) {
+        for (SystemAccess::Prepare prepare : node.access.prepare_)
+            prepare(registry);
+    }
+}
+
+void SystemScheduler::drain(entt::registry& registry, float dt)
+{
+    std::unique_lock lock(mutex_);
+    for (;;) {
+        ready_changed_.wait(lock, [this]() { return !ready_.empty() || remaining_ == 0; });
+        if (remaining_ == 0)
+            return;
+
+        // Earliest added first.
+        auto next = std::min_element(ready_.begin(), ready_.end());
+        size_t index = *next;
+        ready_.erase(next);
+
+        lock.unlock();
+        systems_[index].system(registry, dt);
+        lock.lock();
+
+        --remaining_;
+        bool released = remaining_ == 0;
+        for (size_t successor : systems_[index].successors) {
+            if (--pending_[successor] == 0) {
+                ready_.push_back(successor);
+                released = true;
+            }
+        }
+        if (released)
+            ready_changed_.notify_all();
+    }
+}
+
+} // namespace se
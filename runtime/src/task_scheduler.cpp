@@ -0,0 +1,66 @@
+#include "task_scheduler.hpp"
+
+namespace se {
+
+TaskScheduler::TaskScheduler(size_t workerThreads)
+    : main_thread_(std::this_thread::get_id())
+    , workers_(workerThreads)
+{
+}
+
+TaskScheduler::~TaskScheduler() = default;
+
+void TaskScheduler::spawn(Task<> task)
+{
+    uint64_t id = next_task_++;
+    Task<> wrapper = run(std::move(task), id);
+    resumeNextFrame(wrapper.handle());
+    tasks_.emplace(id, std::move(wrapper));
+}
+
+void TaskScheduler::pump(double deltaTime)
+{
+    {
+        std::unique_lock lock(mutex_);
+        time_ += deltaTime;
+
+        // Tasks that wait again while being resumed land in the emptied
+        // next_frame_, for the next pump.
+        resuming_.swap(next_frame_);
+        while (!timers_.empty() && timers_.top().deadline <= time_) {
+            resuming_.push_back(timers_.top().handle);
+            timers_.pop();
+        }
+    }
+
+    for (std::coroutine_handle<> handle : resuming_)
+        handle.resume();
+    resuming_.clear();
+
+    for (uint64_t id : finished_)
+        tasks_.erase(id);
+    finished_.clear();
+}
+
+Task<> TaskScheduler::run(Task<> task, uint64_t id)
+{
+    co_await task;
+    // Finishing on the main thread keeps tasks_ and finished_ main-thread
+    // only, whichever thread the task ended on.
+    co_await onMainThread();
+    finished_.push_back(id);
+}
+
+void TaskScheduler::resumeNextFrame(std::coroutine_handle<> handle)
+{
+    std::unique_lock lock(mutex_);
+    next_frame_.push_back(handle);
+}
+
+void TaskScheduler::resumeAfter(std::coroutine_handle<> handle, double milliseconds)
+{
+    std::unique_lock lock(mutex_);
+    timers_.push({ time_ + milliseconds, timer_sequence_++, handle });
+}
+
+} // namespace se
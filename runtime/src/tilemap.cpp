@@ -0,0 +1,192 @@
+#include "tilemap.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "logging.hpp"
+
+namespace se {
+
+namespace {
+
+    uint16_t toUnorm16(float value)
+    {
+        return uint16_t(std::lround(std::clamp(value, 0.0f, 1.0f) * 65535.0f));
+    }
+
+    AAPLPackedSpriteVertex tileVertex(int32_t x, int32_t y, vector_ushort2 uv)
+    {
+        AAPLPackedSpriteVertex vertex;
+        vertex.position = vector_short2 { int16_t(x), int16_t(y) };
+        vertex.uv = uv;
+        vertex.color = vector_uchar4 { 255, 255, 255, 255 };
+        return vertex;
+    }
+
+} // namespace
+
+Tilemap::Tilemap(RenderBackend& backend, BufferId quadIndices, uint32_t width, uint32_t height, uint32_t tileSize,
+    size_t maxResidentChunks)
+    : backend_(backend)
+    , quad_indices_(quadIndices)
+    , width_(width)
+    , height_(height)
+    , tile_size_(tileSize)
+    , chunks_x_((width + kChunkTiles - 1) / kChunkTiles)
+    , chunks_y_((height + kChunkTiles - 1) / kChunkTiles)
+    , max_resident_(maxResidentChunks)
+    , tiles_(size_t(width) * height, kEmptyTile)
+    , chunks_(size_t(chunks_x_) * chunks_y_)
+{
+    // Chunk-local positions are stored as int16.
+    if (tileSize == 0 || tileSize * kChunkTiles > 32767)
+        FATAL("Tile size out of range");
+}
+
+Tilemap::~Tilemap()
+{
+    for (uint32_t index : resident_)
+        backend_.destroyBuffer(chunks_[index].buffer);
+}
+
+void Tilemap::setTileRegion(uint16_t tile, vector_float4 uv)
+{
+    if (tile >= regions_.size())
+        regions_.resize(size_t(tile) + 1, TileRegion { vector_ushort2 { 0, 0 }, vector_ushort2 { 0, 0 } });
+
+    regions_[tile].uv0 = vector_ushort2 { toUnorm16(uv[0]), toUnorm16(uv[1]) };
+    regions_[tile].uv1 = vector_ushort2 { toUnorm16(uv[2]), toUnorm16(uv[3]) };
+}
+
+void Tilemap::setTile(uint32_t x, uint32_t y, uint16_t tile)
+{
+    uint16_t& current = tiles_[size_t(y) * width_ + x];
+    if (current == tile)
+        return;
+
+    current = tile;
+    chunkAt(x / kChunkTiles, y / kChunkTiles).dirty = true;
+}
+
+void Tilemap::draw(CommandList& list, const CullRect& view, PipelineId pipeline, TextureId tileset)
+{
+    ++frame_;
+    stats_.drawnChunks = 0;
+    stats_.drawnTiles = 0;
+
+    // Rows extend towards negative y, so row ranges come from negated bounds.
+    float chunk_pixels = float(tile_size_ * kChunkTiles);
+    int64_t first_x = std::max<int64_t>(int64_t(std::floor(view.minX / chunk_pixels)), 0);
+    int64_t last_x = std::min<int64_t>(int64_t(std::floor(view.maxX / chunk_pixels)), int64_t(chunks_x_) - 1);
+    int64_t first_y = std::max<int64_t>(int64_t(std::floor(-view.maxY / chunk_pixels)), 0);
+    int64_t last_y = std::min<int64_t>(int64_t(std::floor(-view.minY / chunk_pixels)), int64_t(chunks_y_) - 1);
+    if (first_x > last_x || first_y > last_y)
+        return;
+
+    float center_x = (view.minX + view.maxX) * 0.5f;
+    float center_y = (view.minY + view.maxY) * 0.5f;
+
+    list.bindPipeline(pipeline);
+    list.bindTexture(AAPLTextureIndexAtlas, tileset);
+
+    for (int64_t chunk_y = first_y; chunk_y <= last_y; ++chunk_y) {
+        for (int64_t chunk_x = first_x; chunk_x <= last_x; ++chunk_x) {
+            Chunk& chunk = chunkAt(uint32_t(chunk_x), uint32_t(chunk_y));
+            if (chunk.dirty)
+                build(uint32_t(chunk_x), uint32_t(chunk_y));
+            if (chunk.quadCount == 0)
+                continue;
+
+            chunk.lastDrawn = frame_;
+
+            vector_float2 translation = vector_float2 {
+                float(chunk_x) * chunk_pixels - center_x,
+                -float(chunk_y) * chunk_pixels - center_y
+            };
+            list.setVertexBytes(AAPLVertexInputIndexTranslation, &translation, sizeof(translation));
+            list.bindVertexBuffer(AAPLVertexInputIndexVertices, chunk.buffer);
+            list.drawIndexed(quad_indices_, IndexType::UInt16, 0, chunk.quadCount * 6);
+
+            ++stats_.drawnChunks;
+            stats_.drawnTiles += chunk.quadCount;
+        }
+    }
+
+    if (resident_.size() > max_resident_)
+        evict();
+}
+
+void Tilemap::build(uint32_t chunk_x, uint32_t chunk_y)
+{
+    static_assert(kChunkTiles * kChunkTiles <= CommandList::kMaxQuadsPerDraw);
+
+    uint32_t index = chunk_y * chunks_x_ + chunk_x;
+    Chunk& chunk = chunks_[index];
+    bool was_resident = chunk.buffer.valid();
+    if (was_resident)
+        backend_.destroyBuffer(chunk.buffer);
+    chunk.buffer = {};
+
+    uint32_t first_x = chunk_x * kChunkTiles;
+    uint32_t first_y = chunk_y * kChunkTiles;
+    uint32_t end_x = std::min(first_x + kChunkTiles, width_);
+    uint32_t end_y = std::min(first_y + kChunkTiles, height_);
+    int32_t size = int32_t(tile_size_);
+
+    scratch_.clear();
+    for (uint32_t y = first_y; y < end_y; ++y) {
+        const uint16_t* row = &tiles_[size_t(y) * width_];
+        int32_t top = -int32_t(y - first_y) * size;
+
+        for (uint32_t x = first_x; x < end_x; ++x) {
+            uint16_t tile = row[x];
+            if (tile == kEmptyTile || tile >= regions_.size())
+                continue;
+
+            const TileRegion& region = regions_[tile];
+            int32_t left = int32_t(x - first_x) * size;
+            scratch_.push_back(tileVertex(left, top, region.uv0));
+            scratch_.push_back(tileVertex(left + size, top, vector_ushort2 { region.uv1[0], region.uv0[1] }));
+            scratch_.push_back(tileVertex(left, top - size, vector_ushort2 { region.uv0[0], region.uv1[1] }));
+            scratch_.push_back(tileVertex(left + size, top - size, region.uv1));
+        }
+    }
+
+    chunk.quadCount = uint32_t(scratch_.size() / 4);
+    chunk.dirty = false;
+    ++stats_.chunkBuilds;
+
+    if (chunk.quadCount > 0) {
+        chunk.buffer = backend_.createBuffer(scratch_.data(), scratch_.size() * sizeof(AAPLPackedSpriteVertex));
+        if (!was_resident)
+            resident_.push_back(index);
+    } else if (was_resident) {
+        std::erase(resident_, index);
+    }
+}
+
+// Releases the buffers of the chunks drawn least recently until the budget
+// is met. Chunks drawn this frame are kept even when that exceeds it.
+void Tilemap::evict()
+{
+    auto excess = resident_.begin() + (resident_.size() - max_resident_);
+    std::nth_element(resident_.begin(), excess, resident_.end(), [this](uint32_t a, uint32_t b) {
+        return chunks_[a].lastDrawn < chunks_[b].lastDrawn;
+    });
+
+    auto kept = std::remove_if(resident_.begin(), excess, [this](uint32_t index) {
+        Chunk& chunk = chunks_[index];
+        if (chunk.lastDrawn == frame_)
+            return false;
+
+        backend_.destroyBuffer(chunk.buffer);
+        chunk.buffer = {};
+        chunk.quadCount = 0;
+        chunk.dirty = true;
+        ++stats_.chunkEvictions;
+        return true;
+    });
+    resident_.erase(kept, excess);
+}
+
+} // namespace se
@@ -0,0 +1,213 @@
+#include "vector_math.hpp"
+
+#if defined(SE_MATH_SSE) && defined(__AVX__)
+#define SE_MATH_AVX
+#include <immintrin.h>
+#endif
+
+namespace se {
+
+Mat3 inverse(const Mat3& m)
+{
+    // Rows of the adjugate are cross products of the columns.
+    Vec3 r0 = cross(m.columns[1], m.columns[2]);
+    Vec3 r1 = cross(m.columns[2], m.columns[0]);
+    Vec3 r2 = cross(m.columns[0], m.columns[1]);
+    float inverse_determinant = 1.0f / dot(m.columns[0], r0);
+
+    Mat3 rows;
+    rows.columns[0] = r0 * inverse_determinant;
+    rows.columns[1] = r1 * inverse_determinant;
+    rows.columns[2] = r2 * inverse_determinant;
+    return transpose(rows);
+}
+
+Mat4 inverse(const Mat4& m)
+{
+    // Cofactor expansion over 2x2 sub-determinants of the upper and lower
+    // halves.
+    float a[16];
+    for (int c = 0; c < 4; ++c)
+        for (int r = 0; r < 4; ++r)
+            a[c * 4 + r] = m.columns[c][r];
+
+    float s0 = a[0] * a[5] - a[4] * a[1];
+    float s1 = a[0] * a[6] - a[4] * a[2];
+    float s2 = a[0] * a[7] - a[4] * a[3];
+    float s3 = a[1] * a[6] - a[5] * a[2];
+    float s4 = a[1] * a[7] - a[5] * a[3];
+    float s5 = a[2] * a[7] - a[6] * a[3];
+
+    float c5 = a[10] * a[15] - a[14] * a[11];
+    float c4 = a[9] * a[15] - a[13] * a[11];
+    float c3 = a[9] * a[14] - a[13] * a[10];
+    float c2 = a[8] * a[15] - a[12] * a[11];
+    float c1 = a[8] * a[14] - a[12] * a[10];
+    float c0 = a[8] * a[13] - a[12] * a[9];
+
+    float inverse_determinant = 1.0f / (s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0);
+
+    float b[16] = {
+        (a[5] * c5 - a[6] * c4 + a[7] * c3),
+        (-a[1] * c5 + a[2] * c4 - a[3] * c3),
+        (a[13] * s5 - a[14] * s4 + a[15] * s3),
+        (-a[9] * s5 + a[10] * s4 - a[11] * s3),
+
+        (-a[4] * c5 + a[6] * c2 - a[7] * c1),
+        (a[0] * c5 - a[2] * c2 + a[3] * c1),
+        (-a[12] * s5 + a[14] * s2 - a[15] * s1),
+        (a[8] * s5 - a[10] * s2 + a[11] * s1),
+
+        (a[4] * c4 - a[5] * c2 + a[7] * c0),
+        (-a[0] * c4 + a[1] * c2 - a[3] * c0),
+        (a[12] * s4 - a[13] * s2 + a[15] * s0),
+        (-a[8] * s4 + a[9] * s2 - a[11] * s0),
+
+        (-a[4] * c3 + a[5] * c1 - a[6] * c0),
+        (a[0] * c3 - a[1] * c1 + a[2] * c0),
+        (-a[12] * s3 + a[13] * s1 - a[14] * s0),
+        (a[8] * s3 - a[9] * s1 + a[10] * s0),
+    };
+
+    Mat4 result;
+    for (int c = 0; c < 4; ++c)
+        for (int r = 0; r < 4; ++r)
+            result.columns[c][r] = b[c * 4 + r] * inverse_determinant;
+    return result;
+}
+
+AABB transform(const Mat4& m, const AABB& box)
+{
+    if (box.empty())
+        return box;
+
+    // Arvo: the new extent along each axis is the extent projected onto the
+    // absolute values of the matrix.
+    Vec3 center = transformPoint(m, box.center());
+    Vec3 extent = box.extent();
+    Vec3 new_extent;
+    for (int r = 0; r < 3; ++r) {
+        new_extent[r] = std::abs(m.columns[0][r]) * extent.x
+            + std::abs(m.columns[1][r]) * extent.y
+            + std::abs(m.columns[2][r]) * extent.z;
+    }
+
+    AABB result;
+    result.min = center - new_extent;
+    result.max = center + new_extent;
+    return result;
+}
+
+void transformPoints(const Mat4& m, const Vec4* in, Vec4* out, size_t count)
+{
+    size_t i = 0;
+#if defined(SE_MATH_AVX)
+    // Two points per register, each half multiplied by the same columns.
+    __m256 c0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&m.columns[0]));
+    __m256 c1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&m.columns[1]));
+    __m256 c2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&m.columns[2]));
+    __m256 c3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&m.columns[3]));
+
+    for (; i + 2 <= count; i += 2) {
+        __m256 p = _mm256_loadu_ps(&in[i].x);
+        __m256 r = _mm256_mul_ps(c0, _mm256_permute_ps(p, 0x00));
+        r = _mm256_add_ps(r, _mm256_mul_ps(c1, _mm256_permute_ps(p, 0x55)));
+        r = _mm256_add_ps(r, _mm256_mul_ps(c2, _mm256_permute_ps(p, 0xaa)));
+        r = _mm256_add_ps(r, _mm256_mul_ps(c3, _mm256_permute_ps(p, 0xff)));
+        _mm256_storeu_ps(&out[i].x, r);
+    }
+#endif
+    for (; i < count; ++i)
+        out[i] = m * in[i];
+}
+
+void transformPoints(const Mat3& m, const Vec2* in, Vec2* out, size_t count)
+{
+    size_t i = 0;
+#if defined(SE_MATH_AVX)
+    // Four interleaved points per register.
+    __m256 a = _mm256_setr_ps(m[0].x, m[0].y, m[0].x, m[0].y, m[0].x, m[0].y, m[0].x, m[0].y);
+    __m256 b = _mm256_setr_ps(m[1].x, m[1].y, m[1].x, m[1].y, m[1].x, m[1].y, m[1].x, m[1].y);
+    __m256 t = _mm256_setr_ps(m[2].x, m[2].y, m[2].x, m[2].y, m[2].x, m[2].y, m[2].x, m[2].y);
+
+    for (; i + 4 <= count; i += 4) {
+        __m256 p = _mm256_loadu_ps(&in[i].x);
+        __m256 xs = _mm256_permute_ps(p, _MM_SHUFFLE(2, 2, 0, 0));
+        __m256 ys = _mm256_permute_ps(p, _MM_SHUFFLE(3, 3, 1, 1));
+        __m256 r = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(xs, a), _mm256_mul_ps(ys, b)), t);
+        _mm256_storeu_ps(&out[i].x, r);
+    }
+#elif defined(SE_MATH_SSE)
+    // Two interleaved points per register.
+    __m128 a = _mm_setr_ps(m[0].x, m[0].y, m[0].x, m[0].y);
+    __m128 b = _mm_setr_ps(m[1].x, m[1].y, m[1].x, m[1].y);
+    __m128 t = _mm_setr_ps(m[2].x, m[2].y, m[2].x, m[2].y);
+
+    for (; i + 2 <= count; i += 2) {
+        __m128 p = _mm_loadu_ps(&in[i].x);
+        __m128 xs = _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 0, 0));
+        __m128 ys = _mm_shuffle_ps(p, p, _MM_SHUFFLE(3, 3, 1, 1));
+        __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(xs, a), _mm_mul_ps(ys, b)), t);
+        _mm_storeu_ps(&out[i].x, r);
+    }
+#elif defined(SE_MATH_NEON)
+    // Four points per iteration, split into x and y registers on load.
+    for (; i + 4 <= count; i += 4) {
+        float32x4x2_t p = vld2q_f32(&in[i].x);
+        float32x4x2_t r;
+        r.val[0] = vfmaq_n_f32(vfmaq_n_f32(vdupq_n_f32(m[2].x), p.val[0], m[0].x), p.val[1], m[1].x);
+        r.val[1] = vfmaq_n_f32(vfmaq_n_f32(vdupq_n_f32(m[2].y), p.val[0], m[0].y), p.val[1], m[1].y);
+        vst2q_f32(&out[i].x, r);
+    }
+#endif
+    for (; i < count; ++i)
+        out[i] = transformPoint(m, in[i]);
+}
+
+void multiplyMatrices(const Mat4* a, const Mat4* b, Mat4* out, size_t count)
+{
+#if defined(SE_MATH_AVX)
+    // Two result columns per register: both halves combine the same columns
+    // of `a`, weighted by the elements of neighboring columns of `b`.
+    for (size_t i = 0; i < count; ++i) {
+        __m256 a0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&a[i].columns[0]));
+        __m256 a1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&a[i].columns[1]));
+        __m256 a2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&a[i].columns[2]));
+        __m256 a3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&a[i].columns[3]));
+
+        __m256 b01 = _mm256_loadu_ps(&b[i].columns[0].x);
+        __m256 b23 = _mm256_loadu_ps(&b[i].columns[2].x);
+
+        __m256 r01 = _mm256_mul_ps(a0, _mm256_permute_ps(b01, 0x00));
+        r01 = _mm256_add_ps(r01, _mm256_mul_ps(a1, _mm256_permute_ps(b01, 0x55)));
+        r01 = _mm256_add_ps(r01, _mm256_mul_ps(a2, _mm256_permute_ps(b01, 0xaa)));
+        r01 = _mm256_add_ps(r01, _mm256_mul_ps(a3, _mm256_permute_ps(b01, 0xff)));
+
+        __m256 r23 = _mm256_mul_ps(a0, _mm256_permute_ps(b23, 0x00));
+        r23 = _mm256_add_ps(r23, _mm256_mul_ps(a1, _mm256_permute_ps(b23, 0x55)));
+        r23 = _mm256_add_ps(r23, _mm256_mul_ps(a2, _mm256_permute_ps(b23, 0xaa)));
+        r23 = _mm256_add_ps(r23, _mm256_mul_ps(a3, _mm256_permute_ps(b23, 0xff)));
+
+        _mm256_storeu_ps(&out[i].columns[0].x, r01);
+        _mm256_storeu_ps(&out[i].columns[2].x, r23);
+    }
+#else
+    for (size_t i = 0; i < count; ++i)
+        out[i] = a[i] * b[i];
+#endif
+}
+
+const char* vectorMathSimdName()
+{
+#if defined(SE_MATH_AVX)
+    return "avx";
+#elif defined(SE_MATH_SSE)
+    return "sse2";
+#elif defined(SE_MATH_NEON)
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
+
+} // namespace se
@@ -0,0 +1,142 @@
+#include "vertex_packing.hpp"
+
+#include <cstring>
+
+namespace se {
+
+namespace {
+
+    // Portable four-lane vectors; both GCC and Clang lower these to SSE or
+    // NEON and convert between them lane by lane.
+    typedef float Float4 __attribute__((vector_size(16)));
+    typedef int32_t Int4 __attribute__((vector_size(16)));
+    typedef uint32_t UInt4 __attribute__((vector_size(16)));
+    typedef uint16_t UShort4 __attribute__((vector_size(8)));
+    typedef uint8_t UChar4 __attribute__((vector_size(4)));
+
+    Float4 load(const void* source)
+    {
+        Float4 value;
+        std::memcpy(&value, source, sizeof(value));
+        return value;
+    }
+
+    // NaN lanes become `low`.
+    Float4 clamp(Float4 value, Float4 low, Float4 high)
+    {
+        value = value > low ? value : low;
+        return value < high ? value : high;
+    }
+
+    // Rounds half up; lanes must be within [-bias, 2^23 - bias] after
+    // clamping, so the truncating conversion only sees non-negative values.
+    Int4 roundToInt(Float4 value, Float4 bias)
+    {
+        return __builtin_convertvector(value + bias + 0.5f, Int4) - __builtin_convertvector(bias, Int4);
+    }
+
+    UChar4 packColor(const vector_float4& color)
+    {
+        Float4 scaled = clamp(load(&color), Float4 { 0, 0, 0, 0 }, Float4 { 1, 1, 1, 1 }) * 255.0f;
+        return __builtin_convertvector(roundToInt(scaled, Float4 { 0, 0, 0, 0 }), UChar4);
+    }
+
+    // Round-to-nearest-even float to half conversion without branches, after
+    // Fabian Giesen's float_to_half_fast3_rtne. NaN stays NaN, values past
+    // the half range become infinity and tiny values become subnormals.
+    UShort4 floatToHalf4(Float4 value)
+    {
+        const UInt4 f32_infinity = UInt4 {} + (255u << 23);
+        const UInt4 f16_max = UInt4 {} + ((127u + 16) << 23);
+        const UInt4 denorm_magic_bits = UInt4 {} + (((127u - 15) + (23 - 10) + 1) << 23);
+        const UInt4 min_normal = UInt4 {} + (113u << 23);
+
+        UInt4 bits = (UInt4)value;
+        UInt4 sign = bits & 0x80000000u;
+        bits ^= sign;
+
+        UInt4 special = (bits > f32_infinity) ? UInt4 {} + 0x7e00u : UInt4 {} + 0x7c00u;
+
+        UInt4 subnormal = (UInt4)((Float4)bits + (Float4)denorm_magic_bits) - denorm_magic_bits;
+
+        UInt4 mantissa_odd = (bits >> 13) & 1u;
+        UInt4 normal = (bits + ((uint32_t(15 - 127) << 23) + 0xfffu) + mantissa_odd) >> 13;
+
+        UInt4 half = (bits < min_normal) ? subnormal : normal;
+        half = (bits >= f16_max) ? special : half;
+        return __builtin_convertvector(half | (sign >> 16), UShort4);
+    }
+
+} // namespace
+
+void packVertices(const AAPLVertex* vertices, size_t count, AAPLPackedVertex* out)
+{
+    const Float4 low { -32768, -32768, 0, 0 };
+    const Float4 high { 32767, 32767, 0, 0 };
+    const Float4 bias { 32768, 32768, 0, 0 };
+
+    for (size_t i = 0; i < count; ++i) {
+        // Position in the low two lanes; the rest of the load is padding.
+        Int4 position = roundToInt(clamp(load(&vertices[i]), low, high), bias);
+        out[i].position = vector_short2 { int16_t(position[0]), int16_t(position[1]) };
+        UChar4 color = packColor(vertices[i].color);
+        std::memcpy(&out[i].color, &color, sizeof(color));
+    }
+}
+
+void packVertices(const AAPLSpriteVertex* vertices, size_t count, AAPLPackedSpriteVertex* out)
+{
+    static_assert(offsetof(AAPLSpriteVertex, uv) == sizeof(vector_float2));
+    static_assert(offsetof(AAPLPackedSpriteVertex, uv) == sizeof(vector_short2));
+
+    // Position and uv share one vector: lanes 0-1 in pixels, 2-3 in unorm16.
+    const Float4 scale { 1, 1, 65535, 65535 };
+    const Float4 low { -32768, -32768, 0, 0 };
+    const Float4 high { 32767, 32767, 65535, 65535 };
+    const Float4 bias { 32768, 32768, 0, 0 };
+
+    for (size_t i = 0; i < count; ++i) {
+        Int4 packed = roundToInt(clamp(load(&vertices[i].position) * scale, low, high), bias);
+        UShort4 narrowed = __builtin_convertvector(packed, UShort4);
+        std::memcpy(&out[i].position, &narrowed, sizeof(narrowed));
+        UChar4 color = packColor(vertices[i].color);
+        std::memcpy(&out[i].color, &color, sizeof(color));
+    }
+}
+
+void packVertices(const AAPLSpriteVertex* vertices, size_t count, AAPLHalfSpriteVertex* out)
+{
+    static_assert(offsetof(AAPLHalfSpriteVertex, uv) == sizeof(vector_ushort2));
+
+    for (size_t i = 0; i < count; ++i) {
+        UShort4 halves = floatToHalf4(load(&vertices[i].position));
+        std::memcpy(&out[i].position, &halves, sizeof(halves));
+        UChar4 color = packColor(vertices[i].color);
+        std::memcpy(&out[i].color, &color, sizeof(color));
+    }
+}
+
+uint16_t floatToHalf(float value)
+{
+    return floatToHalf4(Float4 { value, value, value, value })[0];
+}
+
+float halfToFloat(uint16_t value)
+{
+    uint32_t sign = uint32_t(value & 0x8000) << 16;
+    uint32_t exponent = (value >> 10) & 0x1f;
+    uint32_t mantissa = value & 0x3ff;
+
+    // Zero or subnormal: mantissa * 2^-24.
+    if (exponent == 0)
+        return sign ? -float(mantissa) * 0x1p-24f : float(mantissa) * 0x1p-24f;
+
+    uint32_t bits = exponent == 0x1f
+        ? sign | 0x7f800000u | (mantissa << 13)
+        : sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+    float result;
+    std::memcpy(&result, &bits, sizeof(bits));
+    return result;
+}
+
+} // namespace se
@@ -0,0 +1,91 @@
+#include "test.hpp"
+
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+#include "game_renderer.hpp"
+#include "memory_tracker.hpp"
+#include "null_render_backend.hpp"
+#include "scene.hpp"
+#include "thread_pool.hpp"
+
+using namespace se;
+
+namespace {
+
+    // Frames before the renderer's lists and caches reach their final size.
+    constexpr int kWarmupFrames = 8;
+
+    AAPLVertex quad[4] = {
+        { { -10, 10 }, { 1, 1, 1, 1 } },
+        { { 10, 10 }, { 1, 1, 1, 1 } },
+        { { -10, -10 }, { 1, 1, 1, 1 } },
+        { { 10, -10 }, { 1, 1, 1, 1 } }
+    };
+
+    // Escapes, so the compiler cannot elide the allocation it holds.
+    std::unique_ptr<int> kept;
+
+} // namespace
+
+TEST(trackerCountsAllocations)
+{
+    CHECK(MemoryTracker::enabled());
+    MemoryTracker::endFrame();
+    kept = std::make_unique<int>(1);
+    CHECK(MemoryTracker::endFrame().allocations == 1);
+    kept.reset();
+}
+
+// The frame loop of tests/main.cpp, plus the scene, worker command lists and
+// frame arena users a game adds to it.
+TEST(steadyStateFramesDoNotAllocate)
+{
+    auto null_backend = std::make_unique<NullRenderBackend>(vector_uint2 { 640, 480 });
+    NullRenderBackend* backend = null_backend.get();
+    GameRenderer renderer(std::move(null_backend));
+    ThreadPool pool(2);
+
+    GameLibraryId library = renderer.addLibrary(nullptr, 0);
+    PipelineId pipeline = renderer.createPipeline(renderer.loadShaderFromLibrary(library, "vertexShader"),
+        renderer.loadShaderFromLibrary(library, "fragmentShader"));
+
+    PipelineDesc sprite_desc;
+    sprite_desc.vertexShader = renderer.loadShaderFromLibrary(library, "spriteVertexShader");
+    sprite_desc.fragmentShader = renderer.loadShaderFromLibrary(library, "spriteFragmentShader");
+    sprite_desc.blend = BlendMode::Alpha;
+    sprite_desc.vertexLayout = VertexLayout::AAPLSpriteVertex;
+    PipelineId sprites = renderer.createPipeline(sprite_desc);
+
+    Scene scene;
+    Sprite sprite;
+    sprite.texture = renderer.backend().createTexture(16, 16);
+    sprite.size = vector_float2 { 16, 16 };
+    for (int i = 0; i < 100; ++i) {
+        Transform transform;
+        transform.position = vector_float2 { float(i % 10) * 20 - 100, float(i / 10) * 20 - 100 };
+        scene.createSprite(transform, sprite);
+    }
+
+    for (int frame = 0; frame < kWarmupFrames + 32; ++frame) {
+        renderer.beginFrame();
+        renderer.drawQuads(quad, 1, pipeline);
+        renderer.drawScene(scene, vector_float2 { 0, 0 }, sprites);
+
+        std::span<CommandList> lists = renderer.commandLists(pool.threadCount());
+        pool.parallelFor(lists.size(), [&](size_t i) {
+            FrameResource resource(renderer.frameArena());
+            std::pmr::vector<AAPLVertex> vertices(&resource);
+            for (size_t copy = 0; copy < 16; ++copy)
+                vertices.insert(vertices.end(), std::begin(quad), std::end(quad));
+            lists[i].drawQuads(vertices.data(), vertices.size() / 4, pipeline, renderer.quadIndexBuffer());
+        });
+        renderer.endFrame();
+
+        FrameMemoryStats memory = MemoryTracker::endFrame();
+        if (frame >= kWarmupFrames)
+            CHECK(memory.allocations == 0);
+    }
+    CHECK(backend->frameStats().invalidCommands == 0);
+}
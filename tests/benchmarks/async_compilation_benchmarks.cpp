@@ -0,0 +1,69 @@
+#include "benchmark.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "game_renderer.hpp"
+#include "null_render_backend.hpp"
+
+using namespace se;
+using namespace std::chrono_literals;
+
+namespace {
+
+    constexpr auto kCompileDelay = 5ms;
+    constexpr int kFrames = 60;
+
+    // Longest frame, in milliseconds, of a loop that asks for a new pipeline
+    // every fourth frame while drawing one triangle a frame.
+    double worstFrame(bool async)
+    {
+        auto backend = std::make_unique<NullRenderBackend>(vector_uint2 { 1280, 720 });
+        backend->setCompileDelay(kCompileDelay);
+        GameRenderer renderer(std::move(backend));
+
+        GameLibraryId library = renderer.addLibrary(nullptr, 0);
+        PipelineDesc desc;
+        desc.vertexShader = renderer.loadShaderFromLibrary(library, "vertexShader");
+        desc.fragmentShader = renderer.loadShaderFromLibrary(library, "fragmentShader");
+        renderer.setFallbackPipeline(renderer.createPipeline(desc));
+
+        // Every request pairs the vertex shader with a different fragment
+        // shader, so each one misses the pipeline cache.
+        std::vector<ShaderId> variants;
+        for (int frame = 0; frame < kFrames; frame += 4)
+            variants.push_back(renderer.loadShaderFromLibrary(library, ("variant" + std::to_string(frame)).c_str()));
+
+        AAPLVertex vertices[3] = {};
+        AsyncPipeline pipeline = renderer.createPipelineAsync(desc);
+        double worst = 0;
+        for (int frame = 0; frame < kFrames; ++frame) {
+            auto start = std::chrono::steady_clock::now();
+            if (frame % 4 == 0) {
+                desc.fragmentShader = variants[frame / 4];
+                if (async)
+                    pipeline = renderer.createPipelineAsync(desc);
+                else
+                    pipeline = AsyncPipeline::resolved(renderer.createPipeline(desc));
+            }
+            renderer.beginFrame();
+            renderer.drawVertices(vertices, 3, pipeline);
+            renderer.endFrame();
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            worst = std::max(worst, elapsed.count());
+        }
+        return worst;
+    }
+
+} // namespace
+
+// Main-thread stall from pipeline creation with a 5 ms compiler: the
+// synchronous path pays the compile in the frame that asks for it.
+BENCHMARK(pipelineCreationStall)
+{
+    se::bench::report("sync worst frame", worstFrame(false), "ms");
+    se::bench::report("async worst frame", worstFrame(true), "ms");
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+
+namespace se::bench {
+
+using BenchmarkFunction = void (*)();
+
+// Adds a benchmark to the list main() runs; see BENCHMARK.
+struct Registration {
+    Registration(const char* name, BenchmarkFunction function);
+};
+
+// Prints one result line: the running benchmark's name, `label`, `value`
+// and `unit`.
+void report(const char* label, double value, const char* unit);
+
+// Keeps the compiler from dropping the computation of `value`.
+template <typename T>
+inline void keep(const T& value)
+{
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+// Seconds per call of `body`, from repeated runs of at least `minSeconds`
+// total after one warm-up call.
+template <typename Body>
+double secondsPerCall(Body&& body, double minSeconds = 0.25)
+{
+    using Clock = std::chrono::steady_clock;
+
+    body();
+
+    size_t calls = 0;
+    auto start = Clock::now();
+    double elapsed = 0;
+    do {
+        body();
+        ++calls;
+        elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    } while (elapsed < minSeconds);
+
+    return elapsed / calls;
+}
+
+} // namespace se::bench
+
+// Defines a benchmark. Benchmarks run one at a time, in registration order.
+#define BENCHMARK(name)                                                     \
+    static void name##_benchmark();                                         \
+    static se::bench::Registration name##_registration(#name, name##_benchmark); \
+    static void name##_benchmark()
@@ -0,0 +1,38 @@
+#include "benchmark.hpp"
+
+#include "command_list.hpp"
+#include "null_render_backend.hpp"
+
+using namespace se;
+
+// CPU cost of recording quads and of the null backend walking them, which
+// bounds what any backend can submit per frame.
+BENCHMARK(commandListSubmission)
+{
+    NullRenderBackend backend(vector_uint2 { 1920, 1080 });
+    GameLibraryId library = backend.addLibrary(nullptr, 0);
+    PipelineDesc desc;
+    desc.vertexShader = backend.loadShaderFromLibrary(library, "vertexShader");
+    desc.fragmentShader = backend.loadShaderFromLibrary(library, "fragmentShader");
+    PipelineId pipeline = backend.createPipeline(desc);
+
+    constexpr size_t kDraws = 10000;
+    AAPLVertex quad[6] = {};
+    CommandList list;
+
+    double record = se::bench::secondsPerCall([&]() {
+        list.reset();
+        for (size_t i = 0; i < kDraws; ++i)
+            list.drawVertices(quad, 6, pipeline);
+    });
+    se::bench::report("record draw", record / kDraws * 1e9, "ns");
+
+    const CommandList* lists[] = { &list };
+    double execute = se::bench::secondsPerCall([&]() {
+        backend.beginFrame();
+        backend.execute(lists);
+        backend.endFrame();
+    });
+    se::bench::report("null execute draw", execute / kDraws * 1e9, "ns");
+    se::bench::report("command bytes per draw", double(list.sizeInBytes()) / kDraws, "B");
+}
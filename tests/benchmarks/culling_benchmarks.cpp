@@ -0,0 +1,58 @@
+#include "benchmark.hpp"
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "culling.hpp"
+
+using namespace se;
+
+namespace {
+
+    constexpr size_t kObjects = 1000000;
+
+    // Sprites of 8 to 64 pixels scattered over a world ten 1080p screens
+    // wide and tall, so about one in a hundred is visible.
+    BoundsCuller scatteredObjects()
+    {
+        std::mt19937 random(11);
+        std::uniform_real_distribution<float> x(-9600, 9600);
+        std::uniform_real_distribution<float> y(-5400, 5400);
+        std::uniform_real_distribution<float> size(8, 64);
+
+        BoundsCuller culler;
+        for (size_t i = 0; i < kObjects; ++i) {
+            float min_x = x(random);
+            float min_y = y(random);
+            culler.add({ min_x, min_y, min_x + size(random), min_y + size(random) });
+        }
+        return culler;
+    }
+
+    void reportRate(const char* label, double seconds, size_t visible)
+    {
+        char line[64];
+        std::snprintf(line, sizeof(line), "%s, %zu visible", label, visible);
+        se::bench::report(line, double(kObjects) / (seconds * 1e3), "objects/ms");
+    }
+
+} // namespace
+
+BENCHMARK(cullMillionObjects)
+{
+    BoundsCuller culler = scatteredObjects();
+    CullRect view = viewportRect(vector_uint2 { 1920, 1080 });
+    std::vector<uint32_t> visible;
+
+    double seconds = se::bench::secondsPerCall([&]() { culler.cull(view, visible); });
+    reportRate("serial", seconds, visible.size());
+
+    for (size_t threads : { 1, 2, 4, 8 }) {
+        ThreadPool pool(threads);
+        seconds = se::bench::secondsPerCall([&]() { culler.cull(view, visible, pool); });
+        char label[32];
+        std::snprintf(label, sizeof(label), "threads=%zu", threads);
+        reportRate(label, seconds, visible.size());
+    }
+}
@@ -0,0 +1,68 @@
+#include "benchmark.hpp"
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "frame_arena.hpp"
+#include "thread_pool.hpp"
+
+using namespace se;
+
+namespace {
+
+    constexpr size_t kAllocationsPerFrame = 10000;
+
+    struct Particle {
+        float position[2];
+        float velocity[2];
+        uint32_t color;
+    };
+
+} // namespace
+
+// Small allocations of a frame, freed all at once, against the heap.
+BENCHMARK(frameArenaAllocationRate)
+{
+    FrameArena arena;
+    double seconds = se::bench::secondsPerCall([&]() {
+        for (size_t i = 0; i < kAllocationsPerFrame; ++i) {
+            Particle* particle = arena.allocate<Particle>(1);
+            particle->color = uint32_t(i);
+            se::bench::keep(particle);
+        }
+        arena.reset();
+    });
+    se::bench::report("arena", double(kAllocationsPerFrame) / seconds / 1e6, "M allocations/s");
+
+    std::vector<std::unique_ptr<Particle>> particles(kAllocationsPerFrame);
+    seconds = se::bench::secondsPerCall([&]() {
+        for (size_t i = 0; i < kAllocationsPerFrame; ++i) {
+            particles[i] = std::make_unique<Particle>();
+            particles[i]->color = uint32_t(i);
+        }
+        for (std::unique_ptr<Particle>& particle : particles)
+            particle.reset();
+    });
+    se::bench::report("new/delete", double(kAllocationsPerFrame) / seconds / 1e6, "M allocations/s");
+    se::bench::report("arena blocks allocated", double(arena.blockAllocations()), "blocks");
+}
+
+// Every pool thread allocates from its own block; totals over all threads.
+BENCHMARK(frameArenaThreadedAllocationRate)
+{
+    for (size_t threads : { 1, 2, 4, 8 }) {
+        FrameArena arena;
+        ThreadPool pool(threads);
+        double seconds = se::bench::secondsPerCall([&]() {
+            pool.parallelFor(threads, [&arena](size_t) {
+                for (size_t i = 0; i < kAllocationsPerFrame; ++i)
+                    se::bench::keep(arena.allocate(32, 16));
+            });
+            arena.reset();
+        });
+        char label[32];
+        std::snprintf(label, sizeof(label), "threads=%zu", threads);
+        se::bench::report(label, double(threads * kAllocationsPerFrame) / seconds / 1e6, "M allocations/s");
+    }
+}
@@ -0,0 +1,90 @@
+#include "benchmark.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "frame_pipeline.hpp"
+
+using namespace se;
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int kFrames = 20;
+    constexpr auto kSimulate = std::chrono::microseconds(2000);
+    constexpr auto kRender = std::chrono::microseconds(1500);
+
+    struct Snapshot {
+        std::vector<float> positions;
+    };
+
+    // Keeps the core busy, like simulation or command recording.
+    void spin(Clock::duration duration)
+    {
+        auto end = Clock::now() + duration;
+        while (Clock::now() < end) {
+        }
+    }
+
+    void simulate(std::vector<float>& world)
+    {
+        spin(kSimulate);
+        for (float& position : world)
+            position += 1.0f;
+    }
+
+    // Rendering either keeps its core busy or mostly waits, as it does on a
+    // GPU fence or a vsync'd present.
+    void render(const Snapshot& snapshot, bool waits)
+    {
+        if (waits)
+            std::this_thread::sleep_for(kRender);
+        else
+            spin(kRender);
+        se::bench::keep(snapshot.positions.front());
+    }
+
+    void reportFrames(const char* loop, const char* stage, double seconds)
+    {
+        char label[48];
+        std::snprintf(label, sizeof(label), "%s, render %s", loop, stage);
+        se::bench::report(label, seconds / kFrames * 1e3, "ms/frame");
+    }
+
+} // namespace
+
+// A 2 ms simulation and a 1.5 ms render stage run one after the other, then
+// overlapped through FramePipeline, which should bring a frame down to the
+// longer stage. Busy render stages only overlap with a core to spare.
+BENCHMARK(framePipelineOverlap)
+{
+    std::vector<float> world(1024, 0.0f);
+    for (bool waits : { false, true }) {
+        const char* stage = waits ? "waiting" : "busy";
+
+        Snapshot snapshot;
+        double seconds = se::bench::secondsPerCall([&]() {
+            for (int frame = 0; frame < kFrames; ++frame) {
+                simulate(world);
+                snapshot.positions = world;
+                render(snapshot, waits);
+            }
+        });
+        reportFrames("sequential", stage, seconds);
+
+        FramePipeline<Snapshot> pipeline([waits](const Snapshot& front) { render(front, waits); });
+        seconds = se::bench::secondsPerCall([&]() {
+            for (int frame = 0; frame < kFrames; ++frame) {
+                simulate(world);
+                pipeline.back().positions = world;
+                pipeline.present();
+            }
+            pipeline.finish();
+        });
+        reportFrames("pipelined", stage, seconds);
+    }
+    se::bench::report("hardware threads", double(std::thread::hardware_concurrency()), "threads");
+}
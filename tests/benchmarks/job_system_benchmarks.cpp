@@ -0,0 +1,95 @@
+#include "benchmark.hpp"
+
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "job_system.hpp"
+
+using namespace se;
+
+namespace {
+
+    constexpr size_t kThreadCounts[] = { 1, 2, 4, 8 };
+
+    void reportPerThreads(const char* what, size_t threads, double value, const char* unit)
+    {
+        char label[64];
+        std::snprintf(label, sizeof(label), "%s, threads=%zu", what, threads);
+        se::bench::report(label, value, unit);
+    }
+
+} // namespace
+
+// Creating, queuing and finishing empty children of one parent, which the
+// creating thread mostly runs itself. Past kJobsPerThread children the ring
+// wraps onto the unfinished parent and jobs come from the heap.
+BENCHMARK(jobSpawnOverhead)
+{
+    for (size_t jobs : { size_t(1000), 3 * JobSystem::kJobsPerThread }) {
+        for (size_t threads : kThreadCounts) {
+            JobSystem system(threads);
+            double seconds = se::bench::secondsPerCall([&]() {
+                Job* parent = system.create([]() {});
+                for (size_t i = 0; i < jobs; ++i)
+                    system.run(system.createChild(parent, []() {}));
+                system.run(parent);
+                system.wait(parent);
+            });
+            char what[32];
+            std::snprintf(what, sizeof(what), "%zu children", jobs);
+            reportPerThreads(what, threads, seconds / double(jobs) * 1e9, "ns/job");
+        }
+    }
+}
+
+// An unbalanced loop, whose late items cost far more than its early ones,
+// so threads that run out of work steal.
+BENCHMARK(jobStealRate)
+{
+    constexpr size_t kItems = 4096;
+    std::vector<float> out(kItems);
+    for (size_t threads : kThreadCounts) {
+        if (threads == 1)
+            continue;
+        JobSystem system(threads);
+        system.resetStats();
+        size_t loops = 0;
+        double seconds = se::bench::secondsPerCall([&]() {
+            system.parallelFor(0, kItems, [&out](size_t first, size_t last) {
+                for (size_t i = first; i < last; ++i) {
+                    float value = float(i);
+                    for (size_t k = 0; k < i / 64; ++k)
+                        value = std::sqrt(value + float(k));
+                    out[i] = value;
+                }
+            }, 16);
+            ++loops;
+        });
+        JobSystemStats stats = system.stats();
+        reportPerThreads("loop", threads, seconds * 1e3, "ms");
+        reportPerThreads("steals", threads, double(stats.steals) / double(loops), "steals/loop");
+        reportPerThreads("failed steals", threads, double(stats.failedSteals) / double(loops), "failed/loop");
+        reportPerThreads("jobs", threads, double(stats.executed) / double(loops), "jobs/loop");
+    }
+    se::bench::keep(out);
+}
+
+// A million trivial items with a grain of 64: scheduling cost dominates.
+BENCHMARK(jobFineGrainedScaling)
+{
+    constexpr size_t kItems = 1 << 20;
+    std::vector<uint32_t> values(kItems);
+    for (size_t threads : kThreadCounts) {
+        JobSystem system(threads);
+        double seconds = se::bench::secondsPerCall([&]() {
+            system.parallelFor(0, kItems, [&values](size_t first, size_t last) {
+                for (size_t i = first; i < last; ++i)
+                    values[i] = values[i] * 1664525u + 1013904223u;
+            }, 64);
+        });
+        reportPerThreads("items", threads, double(kItems) / seconds / 1e6, "M items/s");
+    }
+    se::bench::keep(values);
+}
@@ -0,0 +1,54 @@
+#include "benchmark.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace se::bench {
+
+namespace {
+
+    struct BenchmarkCase {
+        const char* name;
+        BenchmarkFunction function;
+    };
+
+    std::vector<BenchmarkCase>& benchmarks()
+    {
+        static std::vector<BenchmarkCase> benchmarks;
+        return benchmarks;
+    }
+
+    const char* running = "";
+
+} // namespace
+
+Registration::Registration(const char* name, BenchmarkFunction function)
+{
+    benchmarks().push_back({ name, function });
+}
+
+void report(const char* label, double value, const char* unit)
+{
+    std::printf("%-28s %-44s %14.3f %s\n", running, label, value, unit);
+    std::fflush(stdout);
+}
+
+} // namespace se::bench
+
+// Runs every benchmark, or those whose names contain one of the arguments.
+int main(int argc, char** argv)
+{
+    for (const se::bench::BenchmarkCase& benchmark : se::bench::benchmarks()) {
+        bool selected = argc < 2;
+        for (int i = 1; i < argc; ++i)
+            selected = selected || std::strstr(benchmark.name, argv[i]);
+        if (!selected)
+            continue;
+
+        se::bench::running = benchmark.name;
+        benchmark.function();
+    }
+
+    return 0;
+}
@@ -0,0 +1,96 @@
+#include "benchmark.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "object_pool.hpp"
+#include "thread_pool.hpp"
+
+using namespace se;
+
+namespace {
+
+    constexpr size_t kRounds = 20000;
+    // Objects each thread keeps alive, so frees cycle whole batches
+    // through the global list.
+    constexpr size_t kLive = 100;
+
+    struct Particle {
+        float position[2];
+        float velocity[2];
+        uint32_t color;
+    };
+
+    // Every pool thread replaces the oldest of its live objects kRounds
+    // times; millions of allocate/free pairs per second over all threads.
+    template <typename Handle, typename Make>
+    void churn(const char* name, Make make)
+    {
+        for (size_t threads : { 1, 2, 4, 8 }) {
+            ThreadPool pool(threads);
+            double seconds = se::bench::secondsPerCall([&]() {
+                pool.parallelFor(threads, [&](size_t) {
+                    std::vector<Handle> live(kLive);
+                    for (size_t i = 0; i < kRounds; ++i) {
+                        live[i % kLive] = make();
+                        live[i % kLive]->color = uint32_t(i);
+                    }
+                });
+            });
+            char label[48];
+            std::snprintf(label, sizeof(label), "%s threads=%zu", name, threads);
+            se::bench::report(label, double(threads * kRounds) / seconds / 1e6, "M allocations/s");
+        }
+    }
+
+    // Threads swap fresh objects into shared slots and free whatever they
+    // take out, mostly objects another thread allocated.
+    template <typename Create, typename Destroy>
+    void exchange(const char* name, Create create, Destroy destroy)
+    {
+        for (size_t threads : { 2, 4, 8 }) {
+            ThreadPool pool(threads);
+            std::vector<std::atomic<Particle*>> slots(256);
+            double seconds = se::bench::secondsPerCall([&]() {
+                pool.parallelFor(threads, [&](size_t thread) {
+                    for (size_t i = 0; i < kRounds; ++i) {
+                        Particle* particle = create();
+                        particle->color = uint32_t(i);
+                        if (Particle* old = slots[(i * 7 + thread * 31) % slots.size()].exchange(particle))
+                            destroy(old);
+                    }
+                });
+            });
+            for (std::atomic<Particle*>& slot : slots)
+                if (Particle* old = slot.exchange(nullptr))
+                    destroy(old);
+
+            char label[48];
+            std::snprintf(label, sizeof(label), "%s threads=%zu", name, threads);
+            se::bench::report(label, double(threads * kRounds) / seconds / 1e6, "M allocations/s");
+        }
+    }
+
+    ObjectPool<Particle> particles;
+
+} // namespace
+
+BENCHMARK(objectPoolContendedAllocation)
+{
+    churn<PoolPtr<Particle>>("ObjectPool", []() { return particles.make(); });
+    churn<std::unique_ptr<Particle>>("new/delete", []() { return std::make_unique<Particle>(); });
+}
+
+BENCHMARK(objectPoolContendedSharedAllocation)
+{
+    churn<std::shared_ptr<Particle>>("makePooled", []() { return makePooled<Particle>(); });
+    churn<std::shared_ptr<Particle>>("make_shared", []() { return std::make_shared<Particle>(); });
+}
+
+BENCHMARK(objectPoolCrossThreadFrees)
+{
+    exchange("ObjectPool", []() { return particles.create(); }, [](Particle* particle) { particles.destroy(particle); });
+    exchange("new/delete", []() { return new Particle(); }, [](Particle* particle) { delete particle; });
+}
@@ -0,0 +1,95 @@
+#include "benchmark.hpp"
+
+#include <cstdio>
+#include <optional>
+#include <random>
+#include <vector>
+
+#include "rect_packer.hpp"
+
+using namespace se;
+
+namespace {
+
+    constexpr uint32_t kPageSize = 2048;
+
+    // Glyph- and sprite-like sizes: mostly small, a few large.
+    std::vector<PackedRect> randomSizes(size_t count, uint32_t smallest, uint32_t largest)
+    {
+        std::mt19937 random(3);
+        std::uniform_int_distribution<uint32_t> size(smallest, largest);
+        std::vector<PackedRect> sizes(count);
+        for (PackedRect& rect : sizes) {
+            rect.width = size(random);
+            rect.height = size(random);
+        }
+        return sizes;
+    }
+
+} // namespace
+
+// Fills a page until inserts start failing; how much of it ends up used and
+// how fast inserts are while it fills.
+BENCHMARK(rectPackerFill)
+{
+    struct Range {
+        const char* name;
+        uint32_t smallest;
+        uint32_t largest;
+    };
+    for (Range range : { Range { "glyphs", 8, 32 }, Range { "sprites", 16, 128 } }) {
+        std::vector<PackedRect> sizes = randomSizes(100000, range.smallest, range.largest);
+        RectPacker packer(kPageSize, kPageSize);
+        size_t inserted = 0;
+        double seconds = se::bench::secondsPerCall([&]() {
+            packer.reset();
+            inserted = 0;
+            for (const PackedRect& size : sizes) {
+                if (packer.insert(size.width, size.height))
+                    ++inserted;
+            }
+        });
+
+        char label[48];
+        std::snprintf(label, sizeof(label), "%s occupancy", range.name);
+        se::bench::report(label, packer.occupancy() * 100, "%");
+        std::snprintf(label, sizeof(label), "%s inserts", range.name);
+        se::bench::report(label, double(sizes.size()) / seconds / 1e3, "k inserts/s");
+        std::snprintf(label, sizeof(label), "%s placed", range.name);
+        se::bench::report(label, double(inserted), "rects");
+    }
+}
+
+// A page kept about 80% full while entries are evicted and replaced, as a
+// glyph cache does; every round is one remove and one insert.
+BENCHMARK(rectPackerEvictionChurn)
+{
+    constexpr size_t kRounds = 10000;
+    std::vector<PackedRect> sizes = randomSizes(kRounds, 8, 48);
+    RectPacker packer(kPageSize, kPageSize);
+    std::vector<PackedRect> live;
+    std::mt19937 random(5);
+    for (size_t i = 0; packer.occupancy() < 0.8; ++i) {
+        if (std::optional<PackedRect> rect = packer.insert(sizes[i % kRounds].width, sizes[i % kRounds].height))
+            live.push_back(*rect);
+    }
+
+    size_t failed = 0;
+    double seconds = se::bench::secondsPerCall([&]() {
+        for (const PackedRect& size : sizes) {
+            size_t victim = random() % live.size();
+            packer.remove(live[victim]);
+            if (std::optional<PackedRect> rect = packer.insert(size.width, size.height)) {
+                live[victim] = *rect;
+            } else {
+                live[victim] = live.back();
+                live.pop_back();
+                ++failed;
+            }
+        }
+    });
+    se::bench::report("remove+insert", double(kRounds) / seconds / 1e3, "k rounds/s");
+    se::bench::report("occupancy", packer.occupancy() * 100, "%");
+    se::bench::report("free rectangles", double(packer.freeRectCount()), "rects");
+    se::bench::report("failed inserts", double(failed), "inserts");
+}
@@ -0,0 +1,181 @@
+#include "benchmark.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "scene.hpp"
+
+using namespace se;
+
+namespace {
+
+    constexpr size_t kEntityCounts[] = { 100000, 1000000 };
+    constexpr float kDt = 1.0f / 60;
+
+    // Sprites scattered over a world ten 1080p screens wide and tall, so
+    // about one in a hundred is visible; three in four of them move.
+    struct Spawn {
+        Transform transform;
+        Velocity velocity;
+        Sprite sprite;
+        bool moving;
+    };
+
+    std::vector<Spawn> spawns(size_t count)
+    {
+        std::mt19937 random(17);
+        std::uniform_real_distribution<float> x(-9600, 9600);
+        std::uniform_real_distribution<float> y(-5400, 5400);
+        std::uniform_real_distribution<float> speed(-100, 100);
+        std::uniform_real_distribution<float> size(8, 64);
+
+        std::vector<Spawn> result(count);
+        for (size_t i = 0; i < count; ++i) {
+            Spawn& spawn = result[i];
+            spawn.transform.position = vector_float2 { x(random), y(random) };
+            spawn.velocity.linear = vector_float2 { speed(random), speed(random) };
+            spawn.velocity.angular = speed(random) * 0.01f;
+            spawn.sprite.texture = TextureId { uint32_t(i % 4), 1 };
+            spawn.sprite.size = vector_float2 { size(random), size(random) };
+            spawn.moving = i % 4 != 0;
+        }
+        return result;
+    }
+
+    // The pattern the registry replaces: one heap object per entity, with
+    // virtual update and draw and its components as members.
+    class GameObject {
+    public:
+        virtual ~GameObject() = default;
+        virtual void update(float dt) = 0;
+        virtual void extract(std::vector<SpriteInstance>& sprites) const = 0;
+    };
+
+    class StaticSprite : public GameObject {
+    public:
+        explicit StaticSprite(const Spawn& spawn)
+            : transform_(spawn.transform)
+            , sprite_(spawn.sprite)
+        {
+        }
+
+        void update(float) override { }
+
+        void extract(std::vector<SpriteInstance>& sprites) const override
+        {
+            sprites.push_back({ transform_, sprite_ });
+        }
+
+    protected:
+        Transform transform_;
+        Sprite sprite_;
+    };
+
+    class MovingSprite : public StaticSprite {
+    public:
+        explicit MovingSprite(const Spawn& spawn)
+            : StaticSprite(spawn)
+            , velocity_(spawn.velocity)
+        {
+        }
+
+        void update(float dt) override
+        {
+            transform_.position += velocity_.linear * dt;
+            transform_.rotation += velocity_.angular * dt;
+        }
+
+    private:
+        Velocity velocity_;
+    };
+
+    // Objects come and go during a game, so by the time these run they sit
+    // all over the heap; the shuffle stands in for that.
+    std::vector<std::unique_ptr<GameObject>> objects(const std::vector<Spawn>& spawns)
+    {
+        std::vector<std::unique_ptr<GameObject>> result;
+        for (const Spawn& spawn : spawns) {
+            if (spawn.moving)
+                result.push_back(std::make_unique<MovingSprite>(spawn));
+            else
+                result.push_back(std::make_unique<StaticSprite>(spawn));
+        }
+        std::shuffle(result.begin(), result.end(), std::mt19937(23));
+        return result;
+    }
+
+    void registry(const std::vector<Spawn>& spawns, entt::registry& registry)
+    {
+        for (const Spawn& spawn : spawns) {
+            Entity entity = registry.create();
+            registry.emplace<Transform>(entity, spawn.transform);
+            registry.emplace<Sprite>(entity, spawn.sprite);
+            if (spawn.moving)
+                registry.emplace<Velocity>(entity, spawn.velocity);
+        }
+    }
+
+    void reportRate(const char* pattern, const char* stage, size_t count, double seconds)
+    {
+        char label[48];
+        std::snprintf(label, sizeof(label), "%s %s %zuk", pattern, stage, count / 1000);
+        se::bench::report(label, double(count) / seconds / 1e6, "M entities/s");
+    }
+
+} // namespace
+
+// One frame of simulation and sprite building, as systems over the
+// registry's packed component arrays and as virtual calls on one object
+// per entity. Both build the same batches with the same culling.
+BENCHMARK(sceneSystemsAgainstObjects)
+{
+    CullRect view = viewportRect(vector_uint2 { 1920, 1080 });
+    for (size_t count : kEntityCounts) {
+        std::vector<Spawn> spawned = spawns(count);
+        SpriteBatches batches;
+        std::vector<SpriteInstance> sprites;
+
+        entt::registry entities;
+        registry(spawned, entities);
+        reportRate("systems", "movement", count, se::bench::secondsPerCall([&]() {
+            movementSystem(entities, kDt);
+        }));
+        reportRate("systems", "sprites", count, se::bench::secondsPerCall([&]() {
+            spriteSystem(entities, view, batches);
+        }));
+        reportRate("systems", "extract", count, se::bench::secondsPerCall([&]() {
+            extractSprites(entities, sprites);
+        }));
+        reportRate("systems", "frame", count, se::bench::secondsPerCall([&]() {
+            movementSystem(entities, kDt);
+            spriteSystem(entities, view, batches);
+        }));
+        size_t visible = batches.quadCount();
+
+        std::vector<std::unique_ptr<GameObject>> scattered = objects(spawned);
+        reportRate("objects", "update", count, se::bench::secondsPerCall([&]() {
+            for (const std::unique_ptr<GameObject>& object : scattered)
+                object->update(kDt);
+        }));
+        reportRate("objects", "extract", count, se::bench::secondsPerCall([&]() {
+            sprites.clear();
+            for (const std::unique_ptr<GameObject>& object : scattered)
+                object->extract(sprites);
+        }));
+        reportRate("objects", "frame", count, se::bench::secondsPerCall([&]() {
+            sprites.clear();
+            for (const std::unique_ptr<GameObject>& object : scattered) {
+                object->update(kDt);
+                object->extract(sprites);
+            }
+            spriteSystem(sprites, view, batches);
+        }));
+
+        char label[48];
+        std::snprintf(label, sizeof(label), "visible sprites %zuk", count / 1000);
+        se::bench::report(label, double(visible), "sprites");
+    }
+}
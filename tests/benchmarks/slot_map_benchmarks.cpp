@@ -0,0 +1,128 @@
+#include "benchmark.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "slot_map.hpp"
+
+using namespace se;
+
+namespace {
+
+    constexpr size_t kElements = 100000;
+    constexpr size_t kLookups = 1000000;
+    // Elements replaced per churn round.
+    constexpr size_t kChurn = 10000;
+
+    struct Particle {
+        float position[2];
+        float velocity[2];
+        uint32_t color;
+    };
+
+    using Particles = SlotMap<Particle, struct ParticleTag>;
+
+    // Lookup positions in random order, so neither container gets a free
+    // ride from the prefetcher.
+    std::vector<uint32_t> shuffledPositions(size_t count, size_t range)
+    {
+        std::mt19937 random(42);
+        std::uniform_int_distribution<uint32_t> position(0, uint32_t(range - 1));
+        std::vector<uint32_t> positions(count);
+        for (uint32_t& value : positions)
+            value = position(random);
+        return positions;
+    }
+
+} // namespace
+
+// Random handle lookups through the slot table, against indexing a vector
+// directly with no stale-handle check.
+BENCHMARK(slotMapLookup)
+{
+    Particles particles;
+    std::vector<Particles::Key> keys;
+    std::vector<Particle> plain;
+    for (size_t i = 0; i < kElements; ++i) {
+        keys.push_back(particles.insert({ {}, {}, uint32_t(i) }));
+        plain.push_back({ {}, {}, uint32_t(i) });
+    }
+    // Erase and reinsert a third, so slots and dense positions disagree as
+    // they do after a while in a game.
+    for (size_t i = 0; i < kElements; i += 3) {
+        particles.erase(keys[i]);
+        keys[i] = particles.insert({ {}, {}, uint32_t(i) });
+    }
+    std::vector<uint32_t> positions = shuffledPositions(kLookups, kElements);
+
+    double seconds = se::bench::secondsPerCall([&]() {
+        uint32_t sum = 0;
+        for (uint32_t position : positions)
+            sum += particles.get(keys[position])->color;
+        se::bench::keep(sum);
+    });
+    se::bench::report("slot map", double(kLookups) / seconds / 1e6, "M lookups/s");
+
+    seconds = se::bench::secondsPerCall([&]() {
+        uint32_t sum = 0;
+        for (uint32_t position : positions)
+            sum += plain[position].color;
+        se::bench::keep(sum);
+    });
+    se::bench::report("vector", double(kLookups) / seconds / 1e6, "M lookups/s");
+}
+
+// Destroys and creates kChurn random elements of a full container. The
+// vector erases by swapping with the last element, which is what the slot
+// map does too, minus the slot table and generations.
+BENCHMARK(slotMapCreateDestroyChurn)
+{
+    std::vector<uint32_t> victims = shuffledPositions(kChurn, kElements);
+
+    Particles particles;
+    std::vector<Particles::Key> keys;
+    for (size_t i = 0; i < kElements; ++i)
+        keys.push_back(particles.insert({ {}, {}, uint32_t(i) }));
+    double seconds = se::bench::secondsPerCall([&]() {
+        for (uint32_t victim : victims) {
+            particles.erase(keys[victim]);
+            keys[victim] = particles.insert({ {}, {}, victim });
+        }
+    });
+    se::bench::report("slot map", double(kChurn) / seconds / 1e6, "M create+destroy/s");
+
+    std::vector<Particle> plain(kElements);
+    seconds = se::bench::secondsPerCall([&]() {
+        for (uint32_t victim : victims) {
+            plain[victim] = plain.back();
+            plain.pop_back();
+            plain.push_back({ {}, {}, victim });
+        }
+    });
+    se::bench::report("vector", double(kChurn) / seconds / 1e6, "M create+destroy/s");
+}
+
+// Iteration only touches the dense array, so it should match the vector.
+BENCHMARK(slotMapIteration)
+{
+    Particles particles;
+    std::vector<Particle> plain;
+    for (size_t i = 0; i < kElements; ++i) {
+        particles.insert({ { float(i), 0 }, { 1, 1 }, uint32_t(i) });
+        plain.push_back({ { float(i), 0 }, { 1, 1 }, uint32_t(i) });
+    }
+
+    auto step = [](auto& container) {
+        for (Particle& particle : container) {
+            particle.position[0] += particle.velocity[0];
+            particle.position[1] += particle.velocity[1];
+        }
+        se::bench::keep(container);
+    };
+    double seconds = se::bench::secondsPerCall([&]() { step(particles); });
+    se::bench::report("slot map", double(kElements) / seconds / 1e6, "M elements/s");
+    seconds = se::bench::secondsPerCall([&]() { step(plain); });
+    se::bench::report("vector", double(kElements) / seconds / 1e6, "M elements/s");
+}
@@ -0,0 +1,120 @@
+#include "benchmark.hpp"
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "software_render_backend.hpp"
+
+using namespace se;
+
+namespace {
+
+    constexpr vector_uint2 kViewport { 1920, 1080 };
+
+    // Seconds per frame of drawing `vertices` with `threads`, and what one
+    // frame rasterizes.
+    struct FrameResult {
+        double seconds;
+        uint64_t triangles;
+        uint64_t pixels;
+    };
+
+    FrameResult renderFrames(size_t threads, const std::vector<AAPLVertex>& vertices)
+    {
+        SoftwareRenderBackend backend(kViewport, threads);
+        GameLibraryId library = backend.addLibrary(nullptr, 0);
+        PipelineDesc desc;
+        desc.vertexShader = backend.loadShaderFromLibrary(library, "vertexShader");
+        desc.fragmentShader = backend.loadShaderFromLibrary(library, "fragmentShader");
+        PipelineId pipeline = backend.createPipeline(desc);
+
+        CommandList list;
+        list.bindPipeline(pipeline);
+        list.setVertexBytes(AAPLVertexInputIndexVertices, vertices.data(), vertices.size() * sizeof(AAPLVertex));
+        list.draw(0, uint32_t(vertices.size()));
+        const CommandList* lists[] = { &list };
+
+        uint64_t triangles = backend.rasterizer().trianglesRasterized();
+        uint64_t pixels = backend.rasterizer().pixelsShaded();
+        backend.beginFrame();
+        backend.execute(lists);
+        backend.endFrame();
+        FrameResult result { 0, backend.rasterizer().trianglesRasterized() - triangles,
+            backend.rasterizer().pixelsShaded() - pixels };
+
+        result.seconds = se::bench::secondsPerCall([&]() {
+            backend.beginFrame();
+            backend.execute(lists);
+            backend.endFrame();
+        });
+        return result;
+    }
+
+    std::vector<AAPLVertex> smallTriangles(size_t count, float size)
+    {
+        std::mt19937 random(7);
+        std::uniform_real_distribution<float> x(-float(kViewport[0]) / 2, float(kViewport[0]) / 2);
+        std::uniform_real_distribution<float> y(-float(kViewport[1]) / 2, float(kViewport[1]) / 2);
+        std::uniform_real_distribution<float> channel(0, 1);
+
+        std::vector<AAPLVertex> vertices;
+        for (size_t i = 0; i < count; ++i) {
+            vector_float2 origin { x(random), y(random) };
+            vector_float4 color { channel(random), channel(random), channel(random), 1 };
+            vertices.push_back({ origin, color });
+            vertices.push_back({ origin + vector_float2 { size, 0 }, color });
+            vertices.push_back({ origin + vector_float2 { 0, size }, color });
+        }
+        return vertices;
+    }
+
+    std::vector<AAPLVertex> fullScreenQuads(size_t count)
+    {
+        float x = float(kViewport[0]) / 2;
+        float y = float(kViewport[1]) / 2;
+
+        std::vector<AAPLVertex> vertices;
+        for (size_t i = 0; i < count; ++i) {
+            vector_float4 color { float(i % 2), float(i % 3) / 2, 1, 1 };
+            AAPLVertex quad[6] = {
+                { vector_float2 { -x, y }, color },
+                { vector_float2 { x, y }, color },
+                { vector_float2 { -x, -y }, color },
+                { vector_float2 { x, y }, color },
+                { vector_float2 { x, -y }, color },
+                { vector_float2 { -x, -y }, color },
+            };
+            vertices.insert(vertices.end(), quad, quad + 6);
+        }
+        return vertices;
+    }
+
+    constexpr size_t kThreadCounts[] = { 1, 2, 4, 8, 16 };
+
+} // namespace
+
+// Setup and binning bound: 100k triangles of 8 pixels, spread over a
+// 1080p frame.
+BENCHMARK(softwareTriangleRate)
+{
+    std::vector<AAPLVertex> vertices = smallTriangles(100000, 4);
+    for (size_t threads : kThreadCounts) {
+        FrameResult result = renderFrames(threads, vertices);
+        char label[64];
+        std::snprintf(label, sizeof(label), "threads=%zu", threads);
+        se::bench::report(label, double(result.triangles) / result.seconds / 1e6, "M triangles/s");
+    }
+}
+
+// Shading bound: ten full-screen quads per 1080p frame, clear included.
+BENCHMARK(softwareFillRate)
+{
+    std::vector<AAPLVertex> vertices = fullScreenQuads(10);
+    for (size_t threads : kThreadCounts) {
+        FrameResult result = renderFrames(threads, vertices);
+        char label[64];
+        std::snprintf(label, sizeof(label), "threads=%zu, %s", threads, SoftwareRasterizer::simdName());
+        se::bench::report(label, double(result.pixels) / result.seconds / 1e6, "M pixels/s");
+    }
+}
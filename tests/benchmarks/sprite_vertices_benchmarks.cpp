@@ -0,0 +1,93 @@
+#include "benchmark.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "sprite_vertices.hpp"
+
+using namespace se;
+
+namespace {
+
+    struct Sprites {
+        std::vector<float> x, y, rotation, width, height;
+        std::vector<vector_float4> uv, color;
+
+        explicit Sprites(size_t count)
+        {
+            std::mt19937 random(5);
+            std::uniform_real_distribution<float> position(-1000, 1000);
+            std::uniform_real_distribution<float> angle(-3.14159265f, 3.14159265f);
+            std::uniform_real_distribution<float> size(8, 64);
+            for (size_t i = 0; i < count; ++i) {
+                x.push_back(position(random));
+                y.push_back(position(random));
+                rotation.push_back(angle(random));
+                width.push_back(size(random));
+                height.push_back(size(random));
+                uv.push_back(vector_float4 { 0, 0, 1, 1 });
+                color.push_back(vector_float4 { 1, 1, 1, 1 });
+            }
+        }
+
+        SpriteStreams streams() const
+        {
+            return { x.data(), y.data(), rotation.data(), width.data(), height.data(), uv.data(), color.data() };
+        }
+    };
+
+    AAPLSpriteVertex spriteVertex(vector_float2 position, float u, float v, vector_float4 color)
+    {
+        AAPLSpriteVertex vertex;
+        vertex.position = position;
+        vertex.uv = vector_float2 { u, v };
+        vertex.color = color;
+        return vertex;
+    }
+
+    // One sprite at a time through libm, the way appendSprite in scene.cpp
+    // builds quads.
+    void generateWithLibm(const Sprites& sprites, size_t count, AAPLSpriteVertex* out)
+    {
+        for (size_t i = 0; i < count; ++i) {
+            float c = std::cos(sprites.rotation[i]);
+            float s = std::sin(sprites.rotation[i]);
+            vector_float2 center { sprites.x[i], sprites.y[i] };
+            vector_float2 x_axis = vector_float2 { c, s } * (sprites.width[i] * 0.5f);
+            vector_float2 y_axis = vector_float2 { -s, c } * (sprites.height[i] * 0.5f);
+            vector_float4 uv = sprites.uv[i];
+            AAPLSpriteVertex* quad = out + 4 * i;
+            quad[0] = spriteVertex(center - x_axis + y_axis, uv[0], uv[1], sprites.color[i]);
+            quad[1] = spriteVertex(center + x_axis + y_axis, uv[2], uv[1], sprites.color[i]);
+            quad[2] = spriteVertex(center - x_axis - y_axis, uv[0], uv[3], sprites.color[i]);
+            quad[3] = spriteVertex(center + x_axis - y_axis, uv[2], uv[3], sprites.color[i]);
+        }
+    }
+
+} // namespace
+
+// Target: more than 200 M vertices/s on one core.
+BENCHMARK(spriteVertexThroughput)
+{
+    for (size_t count : { 1000, 10000, 100000 }) {
+        Sprites sprites(count);
+        std::vector<AAPLSpriteVertex> vertices(4 * count);
+
+        double seconds = se::bench::secondsPerCall([&]() {
+            generateSpriteVertices(sprites.streams(), count, vertices.data());
+            se::bench::keep(vertices.data());
+        });
+        char label[48];
+        std::snprintf(label, sizeof(label), "%zu sprites, %s", count, spriteVerticesKernelName());
+        se::bench::report(label, double(4 * count) / seconds / 1e6, "M vertices/s");
+
+        seconds = se::bench::secondsPerCall([&]() {
+            generateWithLibm(sprites, count, vertices.data());
+            se::bench::keep(vertices.data());
+        });
+        std::snprintf(label, sizeof(label), "%zu sprites, libm per sprite", count);
+        se::bench::report(label, double(4 * count) / seconds / 1e6, "M vertices/s");
+    }
+}
@@ -0,0 +1,63 @@
+#include "benchmark.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+#include "system_scheduler.hpp"
+
+using namespace se;
+
+namespace {
+
+    constexpr size_t kEntities = 100000;
+
+    template <int Index>
+    struct Channel {
+        float value;
+    };
+
+    // One system per channel; channels are independent, so all systems may
+    // run at once.
+    template <int Index>
+    void addChannel(entt::registry& registry, SystemScheduler& scheduler, const std::vector<entt::entity>& entities)
+    {
+        for (entt::entity entity : entities)
+            registry.emplace<Channel<Index>>(entity, float(Index));
+        scheduler.add("channel", SystemAccess().writes<Channel<Index>>(), [](entt::registry& registry, float dt) {
+            registry.view<Channel<Index>>().each([dt](entt::entity, Channel<Index>& channel) {
+                channel.value = std::sin(channel.value + dt) * 0.5f + channel.value * 0.5f;
+            });
+        });
+    }
+
+    template <int... Indices>
+    void addChannels(entt::registry& registry, SystemScheduler& scheduler, std::integer_sequence<int, Indices...>)
+    {
+        std::vector<entt::entity> entities;
+        for (size_t i = 0; i < kEntities; ++i)
+            entities.push_back(registry.create());
+        (addChannel<Indices>(registry, scheduler, entities), ...);
+    }
+
+} // namespace
+
+// Eight independent systems over 100k entities each.
+BENCHMARK(systemSchedulerIndependentSystems)
+{
+    entt::registry registry;
+    SystemScheduler scheduler;
+    addChannels(registry, scheduler, std::make_integer_sequence<int, 8>());
+
+    double serial = se::bench::secondsPerCall([&]() { scheduler.run(registry, 0.016f); });
+    se::bench::report("serial", serial * 1e3, "ms/frame");
+
+    for (size_t threads : { 2, 4, 8 }) {
+        ThreadPool pool(threads);
+        double seconds = se::bench::secondsPerCall([&]() { scheduler.run(registry, 0.016f, pool); });
+        char label[32];
+        std::snprintf(label, sizeof(label), "threads=%zu", threads);
+        se::bench::report(label, seconds * 1e3, "ms/frame");
+    }
+}
@@ -0,0 +1,62 @@
+#include "benchmark.hpp"
+
+#include <cstdio>
+
+#include "task_scheduler.hpp"
+
+using namespace se;
+
+namespace {
+
+    Task<> everyFrame(TaskScheduler& scheduler, const bool& stop)
+    {
+        while (!stop)
+            co_await scheduler.nextFrame();
+    }
+
+    Task<> workerRoundTrips(TaskScheduler& scheduler, int trips, int& finished)
+    {
+        for (int i = 0; i < trips; ++i) {
+            co_await scheduler.onWorker();
+            co_await scheduler.onMainThread();
+        }
+        ++finished;
+    }
+
+} // namespace
+
+// Cost of one resume from pump(), with `tasks` tasks that each wait for
+// the next frame again every frame.
+BENCHMARK(taskResumeOverhead)
+{
+    for (int tasks : { 100, 1000, 10000 }) {
+        TaskScheduler scheduler;
+        bool stop = false;
+        for (int i = 0; i < tasks; ++i)
+            scheduler.spawn(everyFrame(scheduler, stop));
+
+        double seconds = se::bench::secondsPerCall([&]() { scheduler.pump(1.0); });
+        char label[32];
+        std::snprintf(label, sizeof(label), "tasks=%d", tasks);
+        se::bench::report(label, seconds / tasks * 1e9, "ns/resume");
+
+        stop = true;
+        scheduler.pump(1.0);
+    }
+}
+
+// One onWorker() and onMainThread() round trip, including the pump that
+// brings the task back.
+BENCHMARK(taskWorkerRoundTrip)
+{
+    constexpr int kTrips = 2000;
+    TaskScheduler scheduler;
+    int finished = 0;
+    double seconds = se::bench::secondsPerCall([&]() {
+        int target = finished + 1;
+        scheduler.spawn(workerRoundTrips(scheduler, kTrips, finished));
+        while (finished < target)
+            scheduler.pump(1.0);
+    });
+    se::bench::report("round trip", seconds / kTrips * 1e6, "us");
+}
@@ -0,0 +1,43 @@
+#include "benchmark.hpp"
+
+#include <string>
+
+#include "command_list.hpp"
+#include "mesh_builder.hpp"
+#include "null_render_backend.hpp"
+#include "text_renderer.hpp"
+
+using namespace se;
+
+// Layout of a screen of text into quads, including recording the draw,
+// with every glyph already cached.
+BENCHMARK(textRendererLayout)
+{
+    NullRenderBackend backend(vector_uint2 { 1920, 1080 });
+    BufferId quad_indices = createQuadIndexBuffer(backend);
+    TextRenderer text(backend, PipelineId {}, quad_indices, vector_uint2 { 1920, 1080 });
+
+    std::string line;
+    for (char character = '!'; character <= '~'; ++character)
+        line += character;
+    std::string page;
+    for (int i = 0; i < 100; ++i)
+        page += line + " the quick brown fox\n";
+    size_t glyphs = page.size() - 100 * 5;
+
+    CommandList list;
+    double seconds = se::bench::secondsPerCall([&]() {
+        list.reset();
+        text.drawText(page, 0, 0);
+        text.submit(list);
+    });
+    se::bench::report("scale 1", double(glyphs) / seconds / 1e6, "M glyphs/s");
+
+    seconds = se::bench::secondsPerCall([&]() {
+        list.reset();
+        text.drawText(page, 0, 0, vector_float4 { 1, 0.5f, 0, 1 }, 3);
+        text.submit(list);
+    });
+    se::bench::report("scale 3", double(glyphs) / seconds / 1e6, "M glyphs/s");
+    se::bench::report("glyph cache misses", double(text.glyphCache().stats().misses), "glyphs");
+}
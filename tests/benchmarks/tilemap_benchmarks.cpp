@@ -0,0 +1,116 @@
+#include "benchmark.hpp"
+
+#include <random>
+
+#include "mesh_builder.hpp"
+#include "null_render_backend.hpp"
+#include "tilemap.hpp"
+
+using namespace se;
+
+namespace {
+
+    constexpr uint32_t kMapTiles = 4096;
+    constexpr uint32_t kTileSize = 16;
+    constexpr uint16_t kTileKinds = 16;
+    constexpr vector_uint2 kViewport { 1920, 1080 };
+
+    // A 4096 x 4096 map of random non-empty tiles on the null backend.
+    struct TilemapFixture {
+        NullRenderBackend backend { kViewport };
+        PipelineId pipeline;
+        TextureId tileset;
+        Tilemap tilemap { backend, createQuadIndexBuffer(backend), kMapTiles, kMapTiles, kTileSize };
+
+        TilemapFixture()
+        {
+            GameLibraryId library = backend.addLibrary(nullptr, 0);
+            PipelineDesc desc;
+            desc.vertexShader = backend.loadShaderFromLibrary(library, "tileVertexShader");
+            desc.fragmentShader = backend.loadShaderFromLibrary(library, "spriteFragmentShader");
+            desc.blend = BlendMode::Alpha;
+            desc.vertexLayout = VertexLayout::AAPLPackedSpriteVertex;
+            pipeline = backend.createPipeline(desc);
+            tileset = backend.createTexture(256, 16);
+
+            for (uint16_t tile = 1; tile < kTileKinds; ++tile)
+                tilemap.setTileRegion(tile, vector_float4 { float(tile) / kTileKinds, 0, float(tile + 1) / kTileKinds, 1 });
+
+            std::mt19937 random(3);
+            std::uniform_int_distribution<int> kind(1, kTileKinds - 1);
+            for (uint32_t y = 0; y < kMapTiles; ++y)
+                for (uint32_t x = 0; x < kMapTiles; ++x)
+                    tilemap.setTile(x, y, uint16_t(kind(random)));
+        }
+
+        // Records and executes one frame with the view's top left corner at
+        // `corner`, in pixels into the map.
+        void frame(vector_float2 corner)
+        {
+            CullRect view { corner[0], -corner[1] - float(kViewport[1]), corner[0] + float(kViewport[0]), -corner[1] };
+            CommandList list;
+            tilemap.draw(list, view, pipeline, tileset);
+            const CommandList* lists[] = { &list };
+            backend.beginFrame();
+            backend.execute(lists);
+            backend.endFrame();
+        }
+    };
+
+} // namespace
+
+// Every visible chunk has one tile changed before each frame, so each frame
+// rebuilds all of them.
+BENCHMARK(tilemapChunkRebuild)
+{
+    TilemapFixture fixture;
+    vector_float2 corner { 30000, 30000 };
+    fixture.frame(corner);
+
+    uint32_t first_tile_x = uint32_t(corner[0]) / kTileSize;
+    uint32_t first_tile_y = uint32_t(corner[1]) / kTileSize;
+    uint32_t tiles_x = kViewport[0] / kTileSize + Tilemap::kChunkTiles;
+    uint32_t tiles_y = kViewport[1] / kTileSize + Tilemap::kChunkTiles;
+    uint16_t tile = 1;
+
+    uint64_t builds = fixture.tilemap.stats().chunkBuilds;
+    uint64_t frames = 0;
+    double seconds = se::bench::secondsPerCall([&]() {
+        tile = tile % (kTileKinds - 1) + 1;
+        for (uint32_t y = first_tile_y; y < first_tile_y + tiles_y; y += Tilemap::kChunkTiles)
+            for (uint32_t x = first_tile_x; x < first_tile_x + tiles_x; x += Tilemap::kChunkTiles)
+                fixture.tilemap.setTile(x, y, tile);
+        fixture.frame(corner);
+        ++frames;
+    });
+    double rebuilt_per_frame = double(fixture.tilemap.stats().chunkBuilds - builds) / double(frames);
+
+    se::bench::report("chunks rebuilt per frame", rebuilt_per_frame, "chunks");
+    se::bench::report("rebuild", seconds / rebuilt_per_frame * 1e6, "us/chunk");
+}
+
+// The camera pans diagonally at 8 pixels per frame; chunks scrolling into
+// view are built, all others are drawn from their cached buffers.
+BENCHMARK(tilemapPanningFrame)
+{
+    TilemapFixture fixture;
+    vector_float2 corner { 0, 0 };
+    fixture.frame(corner);
+
+    uint64_t builds = fixture.tilemap.stats().chunkBuilds;
+    uint64_t frames = 0;
+    double seconds = se::bench::secondsPerCall([&]() {
+        corner += vector_float2 { 8, 8 };
+        // Starts over before the view leaves the map.
+        if (corner[1] + float(kViewport[1]) > float(kMapTiles * kTileSize))
+            corner = vector_float2 { 0, 0 };
+        fixture.frame(corner);
+        ++frames;
+    });
+
+    se::bench::report("frame", seconds * 1e6, "us");
+    se::bench::report("draws per frame", double(fixture.backend.frameStats().draws), "draws");
+    se::bench::report("tiles per frame", double(fixture.tilemap.stats().drawnTiles), "tiles");
+    se::bench::report("chunk builds per frame", double(fixture.tilemap.stats().chunkBuilds - builds) / double(frames),
+        "chunks");
+}
@@ -0,0 +1,107 @@
+#include "benchmark.hpp"
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "vector_math.hpp"
+
+using namespace se;
+
+namespace {
+
+    constexpr size_t kPoints = 64 * 1024;
+    constexpr size_t kMatrices = 4096;
+
+    std::mt19937 random_engine(7);
+    std::uniform_real_distribution<float> values(-10, 10);
+
+    Vec4 randomVec4()
+    {
+        return { values(random_engine), values(random_engine), values(random_engine), values(random_engine) };
+    }
+
+    Mat4 randomMat4()
+    {
+        Mat4 m;
+        for (Vec4& column : m.columns)
+            column = randomVec4();
+        return m;
+    }
+
+    // Kernel and per-element loop over the same data, in ns per element.
+    template <typename Kernel, typename Loop>
+    void compare(size_t count, Kernel kernel, Loop loop)
+    {
+        char label[48];
+        std::snprintf(label, sizeof(label), "batched (%s)", vectorMathSimdName());
+        se::bench::report(label, se::bench::secondsPerCall(kernel) / double(count) * 1e9, "ns/element");
+        se::bench::report("per element", se::bench::secondsPerCall(loop) / double(count) * 1e9, "ns/element");
+    }
+
+} // namespace
+
+BENCHMARK(vectorMathTransformPoints)
+{
+    Mat4 m = randomMat4();
+    std::vector<Vec4> points(kPoints);
+    for (Vec4& point : points)
+        point = randomVec4();
+    std::vector<Vec4> out(kPoints);
+
+    compare(
+        kPoints,
+        [&]() {
+            transformPoints(m, points.data(), out.data(), kPoints);
+            se::bench::keep(out.data());
+        },
+        [&]() {
+            for (size_t i = 0; i < kPoints; ++i)
+                out[i] = m * points[i];
+            se::bench::keep(out.data());
+        });
+}
+
+BENCHMARK(vectorMathTransformAffinePoints)
+{
+    Mat3 m = Mat3::translation(Vec2(3, -4)) * Mat3::rotation(0.7f) * Mat3::scale(Vec2(2, 0.5f));
+    std::vector<Vec2> points(kPoints);
+    for (Vec2& point : points)
+        point = Vec2(values(random_engine), values(random_engine));
+    std::vector<Vec2> out(kPoints);
+
+    compare(
+        kPoints,
+        [&]() {
+            transformPoints(m, points.data(), out.data(), kPoints);
+            se::bench::keep(out.data());
+        },
+        [&]() {
+            for (size_t i = 0; i < kPoints; ++i)
+                out[i] = transformPoint(m, points[i]);
+            se::bench::keep(out.data());
+        });
+}
+
+BENCHMARK(vectorMathMultiplyMatrices)
+{
+    std::vector<Mat4> a(kMatrices);
+    std::vector<Mat4> b(kMatrices);
+    for (size_t i = 0; i < kMatrices; ++i) {
+        a[i] = randomMat4();
+        b[i] = randomMat4();
+    }
+    std::vector<Mat4> out(kMatrices);
+
+    compare(
+        kMatrices,
+        [&]() {
+            multiplyMatrices(a.data(), b.data(), out.data(), kMatrices);
+            se::bench::keep(out.data());
+        },
+        [&]() {
+            for (size_t i = 0; i < kMatrices; ++i)
+                out[i] = a[i] * b[i];
+            se::bench::keep(out.data());
+        });
+}
@@ -0,0 +1,89 @@
+#include "benchmark.hpp"
+
+#include <random>
+#include <vector>
+
+#include "vertex_packing.hpp"
+
+using namespace se;
+
+namespace {
+
+    constexpr size_t kVertices = 100000;
+
+    std::vector<AAPLSpriteVertex> randomSpriteVertices()
+    {
+        std::mt19937 random(9);
+        std::uniform_real_distribution<float> position(-2000, 2000);
+        std::uniform_real_distribution<float> unit(0, 1);
+        std::vector<AAPLSpriteVertex> vertices(kVertices);
+        for (AAPLSpriteVertex& vertex : vertices) {
+            vertex.position = vector_float2 { position(random), position(random) };
+            vertex.uv = vector_float2 { unit(random), unit(random) };
+            vertex.color = vector_float4 { unit(random), unit(random), unit(random), 1 };
+        }
+        return vertices;
+    }
+
+    template <typename Packed, typename Vertex>
+    void reportPacking(const char* label, const std::vector<Vertex>& vertices)
+    {
+        std::vector<Packed> packed(vertices.size());
+        double seconds = se::bench::secondsPerCall([&]() {
+            packVertices(vertices.data(), vertices.size(), packed.data());
+            se::bench::keep(packed);
+        });
+        se::bench::report(label, double(vertices.size()) / seconds / 1e6, "M vertices/s");
+    }
+
+} // namespace
+
+// Conversion cost of each compact layout, to weigh against the upload
+// bandwidth it saves.
+BENCHMARK(vertexPackingThroughput)
+{
+    std::vector<AAPLSpriteVertex> sprites = randomSpriteVertices();
+    std::vector<AAPLVertex> plain(kVertices);
+    for (size_t i = 0; i < kVertices; ++i) {
+        plain[i].position = sprites[i].position;
+        plain[i].color = sprites[i].color;
+    }
+
+    reportPacking<AAPLPackedVertex>("AAPLPackedVertex", plain);
+    reportPacking<AAPLPackedSpriteVertex>("AAPLPackedSpriteVertex", sprites);
+    reportPacking<AAPLHalfSpriteVertex>("AAPLHalfSpriteVertex", sprites);
+
+    // Copying the vertices unpacked, for scale.
+    std::vector<AAPLSpriteVertex> copy(kVertices);
+    double seconds = se::bench::secondsPerCall([&]() {
+        copy = sprites;
+        se::bench::keep(copy);
+    });
+    se::bench::report("AAPLSpriteVertex copy", double(kVertices) / seconds / 1e6, "M vertices/s");
+}
+
+// One value at a time, as callers building half vertices directly use it.
+BENCHMARK(floatToHalfThroughput)
+{
+    std::vector<float> values(kVertices);
+    std::mt19937 random(13);
+    std::uniform_real_distribution<float> value(-70000, 70000);
+    for (float& entry : values)
+        entry = value(random);
+
+    std::vector<uint16_t> halves(kVertices);
+    double seconds = se::bench::secondsPerCall([&]() {
+        for (size_t i = 0; i < kVertices; ++i)
+            halves[i] = floatToHalf(values[i]);
+        se::bench::keep(halves);
+    });
+    se::bench::report("floatToHalf", double(kVertices) / seconds / 1e6, "M values/s");
+
+    double sum = 0;
+    seconds = se::bench::secondsPerCall([&]() {
+        for (uint16_t half : halves)
+            sum += halfToFloat(half);
+        se::bench::keep(sum);
+    });
+    se::bench::report("halfToFloat", double(kVertices) / seconds / 1e6, "M values/s");
+}
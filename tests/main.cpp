@@ -5,11 +5,9 @@
 #include "game_renderer.hpp"
 #include "game_window.hpp"
 #include "keyboard.hpp"
-
-#include <Foundation/Foundation.hpp>
-#include <Metal/Metal.hpp>
-#include <Metal/shared_ptr.hpp>
-#include <QuartzCore/QuartzCore.hpp>
+#include "logging.hpp"
+#include "memory_tracker.hpp"
+#include "object_pool.hpp"
 
 #include <SDL3/SDL.h>
 
@@ -17,12 +15,8 @@ namespace {
 #include "triangle_metallib.h"
 }
 
-#define DEFINE_LIBRARY(name, renderer)                           \
-    dispatch_data_s* name##_library_data = dispatch_data_create( \
-        &name##_metallib[0], name##_metallib_len,                \
-        dispatch_get_main_queue(),                               \
-        ^ {});                                                   \
-    se::GameLibraryId name = renderer.addLibrary(name##_library_data)
+#define DEFINE_LIBRARY(name, renderer) \
+    se::GameLibraryId name = renderer.addLibrary(&name##_metallib[0], name##_metallib_len)
 
 class ExitLister : public se::EventListner {
 public:
@@ -68,21 +62,20 @@ public:
             move(distance, 0);
     }
 
-    AAPLVertex vertices[6]
+    // One quad: top left, top right, bottom left, bottom right.
+    AAPLVertex vertices[4]
         = {
               // 2D positions,    RGBA colors
-              { { 10, 10 }, { 1, 1, 1, 1 } },
-              { { 10, -10 }, { 1, 1, 1, 1 } },
-              { { -10, -10 }, { 1, 1, 1, 1 } },
               { { -10, 10 }, { 1, 1, 1, 1 } },
               { { 10, 10 }, { 1, 1, 1, 1 } },
-              { { -10, -10 }, { 1, 1, 1, 1 } }
+              { { -10, -10 }, { 1, 1, 1, 1 } },
+              { { 10, -10 }, { 1, 1, 1, 1 } }
           };
 
 private:
     void move(float x, float y)
     {
-        for (size_t i = 0; i < 6; i++) {
+        for (size_t i = 0; i < 4; i++) {
             vertices[i].position[0] += x;
             vertices[i].position[1] += y;
         }
@@ -109,7 +102,7 @@ int main(int argc, char** argv)
 
     Square player(keyboard, clock);
 
-    auto exit_listner = std::make_shared<ExitLister>();
+    auto exit_listner = se::makePooled<ExitLister>();
     eventSystem.addListner(exit_listner, se::Events::Quit);
     eventSystem.addListner(exit_listner, se::Events::KeyDown);
 
@@ -117,11 +110,16 @@ int main(int argc, char** argv)
         eventSystem.processEvents();
         clock.update();
 
-        player.update();
+        {
+            se::MemoryScope scope(se::MemoryTag::Game);
+            player.update();
+        }
 
         gameRenderer.beginFrame();
-        gameRenderer.drawVertices(player.vertices, 6, pipeline);
+        gameRenderer.drawQuads(player.vertices, 1, pipeline);
         gameRenderer.endFrame();
+
+        se::MemoryTracker::endFrame();
     }
 
     return 0;
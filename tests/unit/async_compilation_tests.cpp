@@ -0,0 +1,156 @@
+#include "test.hpp"
+
+#include <chrono>
+#include <memory>
+
+#include "async_compilation.hpp"
+#include "game_renderer.hpp"
+#include "null_render_backend.hpp"
+
+using namespace se;
+using namespace std::chrono_literals;
+
+namespace {
+
+    // A null backend whose compiles take `delay`, with the caches and the
+    // compilation front-end the renderer would own.
+    struct CompilationFixture {
+        NullRenderBackend backend { vector_uint2 { 640, 480 } };
+        ShaderCache shaders;
+        PipelineCache pipelines;
+        GameLibraryId library;
+        std::unique_ptr<AsyncCompilation> compilation;
+
+        explicit CompilationFixture(std::chrono::microseconds delay, size_t threads = 2)
+        {
+            backend.setCompileDelay(delay);
+            library = backend.addLibrary(nullptr, 0);
+            compilation = std::make_unique<AsyncCompilation>(backend, shaders, pipelines, threads);
+        }
+    };
+
+} // namespace
+
+TEST(asyncCompilationShadersBecomeReadyAfterPump)
+{
+    CompilationFixture fixture(5ms);
+
+    AsyncShader shader = fixture.compilation->loadShader(fixture.library, "vertexShader");
+    CHECK(shader.valid());
+    CHECK(!shader.ready());
+
+    fixture.compilation->finish();
+    CHECK(shader.ready());
+    CHECK(fixture.shaders.find(fixture.library, "vertexShader") == shader.get());
+    CHECK(fixture.compilation->inFlight() == 0);
+}
+
+TEST(asyncCompilationSharesRequestsInFlight)
+{
+    CompilationFixture fixture(5ms);
+
+    AsyncShader first = fixture.compilation->loadShader(fixture.library, "vertexShader");
+    AsyncShader second = fixture.compilation->loadShader(fixture.library, "vertexShader");
+    AsyncShader fragment = fixture.compilation->loadShader(fixture.library, "fragmentShader");
+
+    AsyncPipeline pipeline = fixture.compilation->createPipeline(first, fragment, {});
+    AsyncPipeline same = fixture.compilation->createPipeline(second, fragment, {});
+    fixture.compilation->finish();
+
+    CHECK(first.get() == second.get());
+    CHECK(pipeline.ready());
+    CHECK(pipeline.get() == same.get());
+    CHECK(fixture.compilation->stats().shadersCompiled == 2);
+    CHECK(fixture.compilation->stats().pipelinesCompiled == 1);
+    CHECK(fixture.pipelines.size() == 1);
+}
+
+TEST(asyncCompilationResolvesCachedRequestsImmediately)
+{
+    CompilationFixture fixture(0us);
+
+    ShaderId vertex = fixture.compilation->loadShaderNow(fixture.library, "vertexShader");
+    ShaderId fragment = fixture.compilation->loadShaderNow(fixture.library, "fragmentShader");
+    PipelineId pipeline = fixture.compilation->createPipelineNow(PipelineDesc { vertex, fragment });
+
+    AsyncShader shader = fixture.compilation->loadShader(fixture.library, "vertexShader");
+    AsyncPipeline cached = fixture.compilation->createPipeline(PipelineDesc { vertex, fragment });
+    CHECK(shader.ready());
+    CHECK(shader.get() == vertex);
+    CHECK(cached.ready());
+    CHECK(cached.get() == pipeline);
+    CHECK(fixture.compilation->inFlight() == 0);
+}
+
+TEST(asyncCompilationSynchronousRequestsReuseCompilesInFlight)
+{
+    CompilationFixture fixture(20ms);
+
+    AsyncShader vertex = fixture.compilation->loadShader(fixture.library, "vertexShader");
+    ShaderId vertex_now = fixture.compilation->loadShaderNow(fixture.library, "vertexShader");
+    CHECK(vertex.ready());
+    CHECK(vertex.get() == vertex_now);
+
+    ShaderId fragment = fixture.compilation->loadShaderNow(fixture.library, "fragmentShader");
+    PipelineDesc desc { vertex_now, fragment };
+    AsyncPipeline pipeline = fixture.compilation->createPipeline(desc);
+    PipelineId pipeline_now = fixture.compilation->createPipelineNow(desc);
+
+    CHECK(pipeline.ready());
+    CHECK(pipeline.get() == pipeline_now);
+    CHECK(fixture.compilation->stats().shadersCompiled == 1);
+    CHECK(fixture.compilation->stats().pipelinesCompiled == 1);
+    CHECK(fixture.pipelines.size() == 1);
+    CHECK(fixture.pipelines.stats().misses == 1);
+}
+
+TEST(asyncCompilationPumpDoesNotWaitForCompiles)
+{
+    CompilationFixture fixture(50ms, 1);
+
+    AsyncShader vertex = fixture.compilation->loadShader(fixture.library, "vertexShader");
+    AsyncShader fragment = fixture.compilation->loadShader(fixture.library, "fragmentShader");
+    AsyncPipeline pipeline = fixture.compilation->createPipeline(vertex, fragment, {});
+
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < 10; ++frame)
+        fixture.compilation->pump();
+    CHECK(std::chrono::steady_clock::now() - start < 40ms);
+    CHECK(!pipeline.ready());
+    CHECK(fixture.compilation->inFlight() == 3);
+
+    fixture.compilation->finish();
+    CHECK(pipeline.ready());
+}
+
+TEST(asyncCompilationRendererDrawsWithFallbackUntilReady)
+{
+    auto backend = std::make_unique<NullRenderBackend>(vector_uint2 { 640, 480 });
+    NullRenderBackend& null_backend = *backend;
+    null_backend.setCompileDelay(10ms);
+    GameRenderer renderer(std::move(backend));
+
+    GameLibraryId library = renderer.addLibrary(nullptr, 0);
+    ShaderId vertex = renderer.loadShaderFromLibrary(library, "vertexShader");
+    ShaderId fragment = renderer.loadShaderFromLibrary(library, "fragmentShader");
+    PipelineDesc opaque { vertex, fragment };
+    PipelineDesc blended = opaque;
+    blended.blend = BlendMode::Alpha;
+
+    renderer.setFallbackPipeline(renderer.createPipeline(opaque));
+    AsyncPipeline pipeline = renderer.createPipelineAsync(blended);
+
+    AAPLVertex vertices[3] = {};
+    renderer.beginFrame();
+    renderer.drawVertices(vertices, 3, pipeline);
+    renderer.endFrame();
+    CHECK(null_backend.frameStats().draws == 1);
+    CHECK(null_backend.frameStats().invalidCommands == 0);
+
+    // Requesting the same pipeline synchronously waits for the background
+    // compile and returns its pipeline.
+    PipelineId blended_now = renderer.createPipeline(blended);
+    CHECK(pipeline.ready());
+    CHECK(pipeline.get() == blended_now);
+    CHECK(renderer.compilationStats().pipelinesCompiled == 1);
+}
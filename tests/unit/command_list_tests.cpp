@@ -0,0 +1,68 @@
+#include "test.hpp"
+
+#include <vector>
+
+#include "command_list.hpp"
+
+using namespace se;
+
+TEST(commandListRecordsInOrder)
+{
+    CommandList list;
+    AAPLVertex vertices[3] = {};
+    list.drawVertices(vertices, 3, PipelineId {});
+
+    std::vector<RenderCommandType> types;
+    list.visit([&](const auto& command) {
+        types.push_back(command.type);
+    });
+
+    CHECK(types == std::vector { RenderCommandType::BindPipeline, RenderCommandType::SetVertexBytes, RenderCommandType::Draw });
+    CHECK(list.commandCount() == 3);
+    CHECK(list.sizeInBytes() % CommandList::kCommandAlignment == 0);
+}
+
+TEST(commandListCopiesVertexBytes)
+{
+    CommandList list;
+    float bytes[5] = { 1, 2, 3, 4, 5 };
+    CHECK(list.setVertexBytes(AAPLVertexInputIndexVertices, bytes, sizeof(bytes)));
+    bytes[0] = 0;
+
+    list.visit([&](const auto& command) {
+        if constexpr (std::is_same_v<std::decay_t<decltype(command)>, SetVertexBytesCommand>) {
+            CHECK(command.length == sizeof(bytes));
+            CHECK(reinterpret_cast<uintptr_t>(command.bytes()) % CommandList::kCommandAlignment == 0);
+            CHECK(static_cast<const float*>(command.bytes())[0] == 1);
+            CHECK(static_cast<const float*>(command.bytes())[4] == 5);
+        }
+    });
+}
+
+TEST(commandListRejectsOversizedVertexBytes)
+{
+    CommandList list;
+    // Rejected before anything is read, so the source can be tiny.
+    char byte = 0;
+    CHECK(!list.setVertexBytes(AAPLVertexInputIndexVertices, &byte, CommandList::kMaxVertexBytes + 1));
+    CHECK(!list.setVertexBytes(AAPLVertexInputIndexVertices, &byte, size_t(UINT32_MAX) + 16));
+    CHECK(list.empty());
+
+    // A draw whose vertices do not fit is dropped rather than drawn with
+    // whatever bytes were bound before.
+    list.drawVertices(reinterpret_cast<const AAPLVertex*>(&byte), CommandList::kMaxVertexBytes / sizeof(AAPLVertex) + 1, PipelineId {});
+    size_t draws = 0;
+    list.visit([&](const auto& command) {
+        draws += command.type == RenderCommandType::Draw;
+    });
+    CHECK(draws == 0);
+}
+
+TEST(commandListResetKeepsNothing)
+{
+    CommandList list;
+    list.draw(0, 3);
+    list.reset();
+    CHECK(list.empty());
+    CHECK(list.commandCount() == 0);
+}
@@ -0,0 +1,150 @@
+#include "test.hpp"
+
+#include <thread>
+#include <vector>
+
+#include "deferred_destruction.hpp"
+
+using namespace se;
+
+namespace {
+
+    // Records which frame's releases ran, in order.
+    struct ReleaseLog {
+        std::vector<uint64_t> released;
+
+        void enqueue(DeferredDestructionQueue& queue, uint64_t frame)
+        {
+            queue.enqueue(frame, [this, frame]() { released.push_back(frame); });
+        }
+
+        bool noneAfter(uint64_t frame) const
+        {
+            for (uint64_t released_frame : released)
+                if (released_frame > frame)
+                    return false;
+            return true;
+        }
+    };
+
+} // namespace
+
+TEST(deferredDestructionReleasesOnlyRetiredFrames)
+{
+    DeferredDestructionQueue queue;
+    ReleaseLog log;
+    for (uint64_t frame = 1; frame <= 4; ++frame) {
+        log.enqueue(queue, frame);
+        log.enqueue(queue, frame);
+    }
+
+    CHECK(queue.retire(0) == 0);
+    CHECK(queue.retire(2) == 4);
+    CHECK(log.noneAfter(2));
+    CHECK(queue.pending() == 4);
+
+    // A stale completed frame releases nothing again.
+    CHECK(queue.retire(1) == 0);
+    CHECK(queue.retire(4) == 4);
+    CHECK((log.released == std::vector<uint64_t> { 1, 1, 2, 2, 3, 3, 4, 4 }));
+    CHECK(queue.pending() == 0);
+}
+
+TEST(deferredDestructionReleasesMayEnqueueMore)
+{
+    DeferredDestructionQueue queue;
+    ReleaseLog log;
+    queue.enqueue(1, [&]() { log.enqueue(queue, 3); });
+
+    CHECK(queue.retire(2) == 1);
+    CHECK(log.released.empty());
+    CHECK(queue.pending() == 1);
+    CHECK(queue.retire(3) == 1);
+    CHECK((log.released == std::vector<uint64_t> { 3 }));
+}
+
+TEST(deferredDestructionDestructorReleasesEverything)
+{
+    ReleaseLog log;
+    {
+        DeferredDestructionQueue queue;
+        log.enqueue(queue, 5);
+        log.enqueue(queue, 9);
+    }
+    CHECK((log.released == std::vector<uint64_t> { 5, 9 }));
+}
+
+TEST(frameCompletionWaitsForEarlierFrames)
+{
+    FrameCompletion completion;
+    CHECK(completion.completedThrough() == 0);
+
+    completion.complete(3);
+    completion.complete(2);
+    CHECK(completion.completedThrough() == 0);
+
+    completion.complete(1);
+    CHECK(completion.completedThrough() == 3);
+
+    // Late and repeated completions change nothing.
+    completion.complete(2);
+    completion.complete(3);
+    CHECK(completion.completedThrough() == 3);
+    completion.complete(5);
+    CHECK(completion.completedThrough() == 3);
+    completion.complete(4);
+    CHECK(completion.completedThrough() == 5);
+}
+
+// Frames submitted in order complete in a scrambled order and a few frames
+// late, as completion handlers may; nothing may be released before every
+// frame up to its own has completed.
+TEST(deferredDestructionWithOutOfOrderCompletion)
+{
+    DeferredDestructionQueue queue;
+    FrameCompletion completion;
+    ReleaseLog log;
+
+    const uint64_t order[] = { 2, 1, 4, 5, 3, 8, 6, 7, 9, 10, 12, 11 };
+    std::vector<bool> completed(13);
+    size_t completions = 0;
+
+    for (uint64_t frame = 1; frame <= 12; ++frame) {
+        queue.retire(completion.completedThrough());
+        log.enqueue(queue, frame);
+
+        // The GPU lags two frames behind submission.
+        if (frame > 2) {
+            completed[order[completions]] = true;
+            completion.complete(order[completions++]);
+        }
+
+        uint64_t retired_through = 0;
+        while (retired_through + 1 < completed.size() && completed[retired_through + 1])
+            ++retired_through;
+        CHECK(log.noneAfter(retired_through));
+    }
+
+    while (completions < 12)
+        completion.complete(order[completions++]);
+    queue.retire(completion.completedThrough());
+    CHECK(queue.pending() == 0);
+    CHECK(log.released.size() == 12);
+    for (size_t i = 0; i < log.released.size(); ++i)
+        CHECK(log.released[i] == i + 1);
+}
+
+TEST(frameCompletionFromManyThreads)
+{
+    FrameCompletion completion;
+    std::vector<std::thread> threads;
+    for (uint64_t first = 1; first <= 4; ++first) {
+        threads.emplace_back([&completion, first]() {
+            for (uint64_t frame = first; frame <= 4000; frame += 4)
+                completion.complete(frame);
+        });
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+    CHECK(completion.completedThrough() == 4000);
+}
@@ -0,0 +1,148 @@
+#include "test.hpp"
+
+#include <cmath>
+#include <functional>
+#include <vector>
+
+#include "dynamic_resolution.hpp"
+
+using namespace se;
+
+namespace {
+
+    // Frame time in milliseconds of a frame that renders at `scale`, for a
+    // GPU whose cost is `fixed` plus `pixels` times the pixel fraction.
+    struct GpuModel {
+        double fixed;
+        double pixels;
+
+        double frameTime(float scale) const
+        {
+            return fixed + pixels * double(scale) * double(scale);
+        }
+    };
+
+    // Feeds the controller `frames` frames whose times follow `model`, which
+    // may change with the frame number, and returns the scale of each frame.
+    std::vector<float> runTrace(DynamicResolutionController& controller, size_t frames,
+        const std::function<GpuModel(size_t)>& model)
+    {
+        std::vector<float> scales;
+        float scale = controller.scale();
+        for (size_t frame = 0; frame < frames; ++frame) {
+            scales.push_back(scale);
+            scale = controller.update(model(frame).frameTime(scale));
+        }
+        return scales;
+    }
+
+    size_t changes(const std::vector<float>& scales)
+    {
+        size_t count = 0;
+        for (size_t i = 1; i < scales.size(); ++i)
+            count += scales[i] != scales[i - 1];
+        return count;
+    }
+
+    bool onStepGrid(float scale, const DynamicResolutionSettings& settings)
+    {
+        return scale == settings.maxScale || scale == settings.minScale
+            || scale == std::round(scale / settings.step) * settings.step;
+    }
+
+} // namespace
+
+TEST(dynamicResolutionKeepsFullScaleWithinBudget)
+{
+    DynamicResolutionController controller;
+    std::vector<float> scales = runTrace(controller, 600, [](size_t) { return GpuModel { 2, 12 }; });
+    CHECK(changes(scales) == 0);
+    CHECK(controller.scale() == 1.0f);
+}
+
+TEST(dynamicResolutionDropsToFitASpike)
+{
+    DynamicResolutionController controller;
+    // 30 ms at full scale against a 16.7 ms budget from frame 100 on.
+    std::vector<float> scales = runTrace(controller, 300, [](size_t frame) {
+        return frame < 100 ? GpuModel { 2, 10 } : GpuModel { 2, 28 };
+    });
+
+    // One history's worth of frames to notice, then one or two changes.
+    size_t settled = 100 + 2 * DynamicResolutionController::kHistory + 2;
+    for (size_t frame = settled; frame < scales.size(); ++frame) {
+        GpuModel model { 2, 28 };
+        CHECK(model.frameTime(scales[frame]) <= controller.settings().targetFrameTime);
+    }
+    CHECK(changes(scales) <= 2);
+    CHECK(controller.scale() >= 0.7f);
+}
+
+TEST(dynamicResolutionResolvesSmallOvershoots)
+{
+    DynamicResolutionController controller;
+    // Only 2% over the budget at full scale.
+    std::vector<float> scales = runTrace(controller, 100, [](size_t) { return GpuModel { 2, 15 }; });
+    CHECK(controller.scale() == 0.95f);
+    CHECK(changes(scales) == 1);
+}
+
+TEST(dynamicResolutionRaisesOneStepAtATime)
+{
+    DynamicResolutionSettings settings;
+    DynamicResolutionController controller(settings);
+    std::vector<float> scales = runTrace(controller, 2000, [](size_t frame) {
+        return frame < 50 ? GpuModel { 2, 40 } : GpuModel { 1, 4 };
+    });
+
+    CHECK(controller.scale() == settings.maxScale);
+    size_t last_change = 0;
+    for (size_t frame = 1; frame < scales.size(); ++frame) {
+        if (frame <= 50 || scales[frame] == scales[frame - 1])
+            continue;
+        CHECK(test::near(scales[frame] - scales[frame - 1], settings.step, 1e-5));
+        CHECK(last_change == 0 || frame - last_change >= settings.raiseDelay);
+        last_change = frame;
+    }
+}
+
+TEST(dynamicResolutionDoesNotOscillateAroundTheTarget)
+{
+    DynamicResolutionController controller;
+    // Cheap enough to raise from 0.8, too expensive to stay at 0.85, with
+    // +-10% noise on every frame.
+    std::vector<float> scales = runTrace(controller, 3000, [](size_t frame) {
+        double noise = 1.0 + 0.1 * std::sin(double(frame) * 1.7);
+        return GpuModel { 2 * noise, 20 * noise };
+    });
+    CHECK(changes(scales) <= 6);
+}
+
+TEST(dynamicResolutionClampsToMinimumScale)
+{
+    DynamicResolutionSettings settings;
+    settings.minScale = 0.5f;
+    DynamicResolutionController controller(settings);
+    runTrace(controller, 200, [](size_t) { return GpuModel { 20, 100 }; });
+    CHECK(controller.scale() == settings.minScale);
+}
+
+TEST(dynamicResolutionScalesStayOnTheStepGrid)
+{
+    // Neither the start scale nor the step is exact in binary, so repeated
+    // steps used to drift between grid values.
+    DynamicResolutionSettings settings;
+    settings.maxScale = 0.97f;
+    settings.minScale = 0.31f;
+    settings.step = 0.07f;
+    settings.raiseDelay = 20;
+    DynamicResolutionController controller(settings);
+
+    std::vector<float> scales = runTrace(controller, 4000, [](size_t frame) {
+        // Alternates between overloaded and idle stretches.
+        return (frame / 500) % 2 == 0 ? GpuModel { 2, 17 } : GpuModel { 1, 3 };
+    });
+    CHECK(changes(scales) > 4);
+    for (float scale : scales)
+        CHECK(onStepGrid(scale, settings));
+}
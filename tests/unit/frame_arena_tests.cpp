@@ -0,0 +1,109 @@
+#include "test.hpp"
+
+#include <cstdint>
+#include <memory_resource>
+#include <thread>
+#include <vector>
+
+#include "frame_arena.hpp"
+
+using namespace se;
+
+TEST(frameArenaAlignsAllocations)
+{
+    FrameArena arena(4096);
+    for (size_t alignment : { 1, 2, 8, 16, 64, 256 }) {
+        arena.allocate(3, 1);
+        void* pointer = arena.allocate(24, alignment);
+        CHECK(reinterpret_cast<uintptr_t>(pointer) % alignment == 0);
+    }
+}
+
+TEST(frameArenaReusesBlocksAfterReset)
+{
+    FrameArena arena(4096);
+    std::vector<char*> first;
+    for (int i = 0; i < 300; ++i)
+        first.push_back(static_cast<char*>(arena.allocate(40)));
+    uint64_t blocks = arena.blockAllocations();
+    CHECK(blocks >= 3);
+
+    // The same pattern in later frames takes no new blocks.
+    for (int frame = 0; frame < 50; ++frame) {
+        arena.reset();
+        for (int i = 0; i < 300; ++i)
+            arena.allocate(40);
+    }
+    CHECK(arena.blockAllocations() == blocks);
+    CHECK(arena.frame() == 50);
+}
+
+TEST(frameArenaAllocationsDoNotOverlap)
+{
+    FrameArena arena(1024);
+    std::vector<uint32_t*> values;
+    for (uint32_t i = 0; i < 1000; ++i) {
+        uint32_t* value = arena.allocate<uint32_t>(3);
+        value[0] = value[1] = value[2] = i;
+        values.push_back(value);
+    }
+    for (uint32_t i = 0; i < values.size(); ++i)
+        CHECK(values[i][0] == i && values[i][1] == i && values[i][2] == i);
+}
+
+TEST(frameArenaLargeAllocationsGoBackToTheHeap)
+{
+    FrameArena arena(4096);
+    arena.allocate(100);
+    size_t capacity = arena.capacity();
+    char* large = static_cast<char*>(arena.allocate(10000));
+    large[9999] = 1;
+    CHECK(arena.capacity() >= capacity + 10000);
+    arena.reset();
+    CHECK(arena.capacity() == capacity);
+}
+
+TEST(frameArenaSteadyStateAcrossThreads)
+{
+    FrameArena arena(16 * 1024);
+    constexpr int kThreads = 4;
+
+    auto frame = [&arena]() {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kThreads; ++t) {
+            threads.emplace_back([&arena, t]() {
+                for (int i = 0; i < 2000; ++i) {
+                    int* value = arena.allocate<int>(1 + i % 7);
+                    *value = t;
+                }
+            });
+        }
+        for (std::thread& thread : threads)
+            thread.join();
+        arena.reset();
+    };
+
+    for (int i = 0; i < 3; ++i)
+        frame();
+    uint64_t blocks = arena.blockAllocations();
+    for (int i = 0; i < 20; ++i)
+        frame();
+    CHECK(arena.blockAllocations() == blocks);
+}
+
+TEST(frameResourceBacksPmrContainers)
+{
+    FrameArena arena;
+    uint64_t blocks = 0;
+    for (int frame = 0; frame < 10; ++frame) {
+        FrameResource resource(arena);
+        std::pmr::vector<int> values(&resource);
+        for (int i = 0; i < 1000; ++i)
+            values.push_back(i);
+        CHECK(values[999] == 999);
+        if (frame == 1)
+            blocks = arena.blockAllocations();
+        arena.reset();
+    }
+    CHECK(arena.blockAllocations() == blocks);
+}
@@ -0,0 +1,67 @@
+#include "test.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <thread>
+
+#include "frame_capture.hpp"
+
+using namespace se;
+
+namespace {
+
+    // A fresh directory under the system's temporary one.
+    std::filesystem::path captureDirectory(const char* name)
+    {
+        std::filesystem::path directory = std::filesystem::temp_directory_path() / name;
+        std::filesystem::remove_all(directory);
+        std::filesystem::create_directories(directory);
+        return directory;
+    }
+
+} // namespace
+
+// The way a GPU completion handler finishes a read-back after the frame
+// loop dropped the capture.
+TEST(frameCaptureDestructionWaitsForAcquiredFrames)
+{
+    std::filesystem::path directory = captureDirectory("se_frame_capture_tests");
+    std::atomic<bool> submitted { false };
+    std::thread gpu;
+    {
+        FrameCapture capture(directory.string(), CaptureFormat::Raw, 2);
+        CapturedFrame* captured = capture.acquire();
+        CHECK(captured != nullptr);
+        CapturedFrame* failed = capture.acquire();
+
+        gpu = std::thread([&capture, &submitted, captured, failed]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            captured->width = 2;
+            captured->height = 1;
+            captured->pixels = { 0xff0000ff, 0xff00ff00 };
+            capture.release(failed);
+            capture.submit(captured);
+            submitted = true;
+        });
+    }
+    CHECK(submitted.load());
+    gpu.join();
+
+    CHECK(std::filesystem::exists(directory / "frame_000000_2x1.rgba"));
+    CHECK(std::filesystem::file_size(directory / "frame_000000_2x1.rgba") == 8);
+    std::filesystem::remove_all(directory);
+}
+
+TEST(frameCaptureDropsFramesWhenEveryBufferIsQueued)
+{
+    std::filesystem::path directory = captureDirectory("se_frame_capture_drop_tests");
+    FrameCapture capture(directory.string(), CaptureFormat::Raw, 1);
+    CapturedFrame* captured = capture.acquire();
+    CHECK(capture.acquire() == nullptr);
+    CHECK(capture.framesDropped() == 1);
+    capture.release(captured);
+    capture.flush();
+    CHECK(capture.framesWritten() == 0);
+    std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,112 @@
+#include "test.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "frame_pipeline.hpp"
+
+using namespace se;
+using namespace std::chrono_literals;
+
+namespace {
+
+    constexpr int kFrames = 50;
+
+    struct Snapshot {
+        int frame { -1 };
+        std::vector<int> payload;
+    };
+
+    // Fills the snapshot the way extraction would, so a snapshot shared with
+    // the render stage would show up as a torn payload.
+    void extract(Snapshot& snapshot, int frame)
+    {
+        snapshot.frame = frame;
+        snapshot.payload.assign(64, frame);
+    }
+
+    bool consistent(const Snapshot& snapshot)
+    {
+        for (int value : snapshot.payload) {
+            if (value != snapshot.frame)
+                return false;
+        }
+        return true;
+    }
+
+} // namespace
+
+TEST(framePipelineRendersEverySnapshotInOrder)
+{
+    std::vector<int> rendered;
+    int torn = 0;
+    {
+        FramePipeline<Snapshot> pipeline([&](const Snapshot& snapshot) {
+            // Long enough for the caller to fill the other snapshot meanwhile.
+            std::this_thread::sleep_for(100us);
+            if (!consistent(snapshot))
+                ++torn;
+            rendered.push_back(snapshot.frame);
+        });
+
+        for (int frame = 0; frame < kFrames; ++frame) {
+            extract(pipeline.back(), frame);
+            pipeline.present();
+        }
+    }
+
+    CHECK(torn == 0);
+    CHECK(rendered.size() == size_t(kFrames));
+    for (size_t i = 0; i < rendered.size(); ++i)
+        CHECK(rendered[i] == int(i));
+}
+
+// The caller runs at most one frame ahead: present() returns only once the
+// frame before is rendered, and back() is the snapshot of two frames ago.
+TEST(framePipelineLagsAtMostOneFrame)
+{
+    std::atomic<int> rendered { 0 };
+    FramePipeline<Snapshot> pipeline([&](const Snapshot& snapshot) {
+        std::this_thread::sleep_for(200us);
+        rendered.store(snapshot.frame + 1, std::memory_order_release);
+    });
+
+    int most_behind = 0;
+    for (int frame = 0; frame < kFrames; ++frame) {
+        if (frame >= 2)
+            CHECK(pipeline.back().frame == frame - 2);
+        extract(pipeline.back(), frame);
+        pipeline.present();
+        int behind = frame + 1 - rendered.load(std::memory_order_acquire);
+        most_behind = std::max(most_behind, behind);
+        CHECK(behind <= 1);
+    }
+
+    pipeline.finish();
+    CHECK(rendered.load() == kFrames);
+    // The render stage is slow enough that the caller does get ahead.
+    CHECK(most_behind == 1);
+}
+
+TEST(framePipelineFinishesTheFrameInFlightOnShutdown)
+{
+    std::atomic<int> rendered { 0 };
+    {
+        FramePipeline<Snapshot> pipeline([&](const Snapshot&) {
+            std::this_thread::sleep_for(5ms);
+            ++rendered;
+        });
+        extract(pipeline.back(), 0);
+        pipeline.present();
+    }
+    CHECK(rendered.load() == 1);
+
+    // A pipeline that never presented shuts down without rendering.
+    {
+        FramePipeline<Snapshot> pipeline([&](const Snapshot&) { ++rendered; });
+    }
+    CHECK(rendered.load() == 1);
+}
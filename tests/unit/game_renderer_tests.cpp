@@ -0,0 +1,158 @@
+#include "game_renderer.hpp"
+
+// Renderer users that draw neither scenes nor tilemaps must not depend on
+// EnTT.
+#ifdef ENTT_VERSION_MAJOR
+#error "game_renderer.hpp must not include EnTT"
+#endif
+
+#include "test.hpp"
+
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "null_render_backend.hpp"
+#include "scene.hpp"
+#include "tilemap.hpp"
+
+using namespace se;
+
+namespace {
+
+    struct RendererFixture {
+        NullRenderBackend* backend;
+        GameRenderer renderer;
+        PipelineId sprites;
+        TextureId texture;
+
+        RendererFixture()
+            : RendererFixture(std::make_unique<NullRenderBackend>(vector_uint2 { 640, 480 }))
+        {
+        }
+
+        explicit RendererFixture(std::unique_ptr<NullRenderBackend> null_backend)
+            : backend(null_backend.get())
+            , renderer(std::move(null_backend))
+        {
+            GameLibraryId library = renderer.addLibrary(nullptr, 0);
+            texture = renderer.backend().createTexture(16, 16);
+            sprites = pipeline(library, "spriteVertexShader", VertexLayout::AAPLSpriteVertex);
+        }
+
+        PipelineId pipeline(GameLibraryId library, const char* vertex, VertexLayout layout)
+        {
+            PipelineDesc desc;
+            desc.vertexShader = renderer.loadShaderFromLibrary(library, vertex);
+            desc.fragmentShader = renderer.loadShaderFromLibrary(library, "spriteFragmentShader");
+            desc.blend = BlendMode::Alpha;
+            desc.vertexLayout = layout;
+            return renderer.createPipeline(desc);
+        }
+    };
+
+    // Keeps the sprite vertices of every executed list.
+    class VertexRecordingBackend : public NullRenderBackend {
+    public:
+        VertexRecordingBackend()
+            : NullRenderBackend(vector_uint2 { 640, 480 })
+        {
+        }
+
+        void execute(std::span<const CommandList* const> lists) override
+        {
+            for (const CommandList* list : lists) {
+                list->visit([this](const auto& command) {
+                    if constexpr (std::is_same_v<std::decay_t<decltype(command)>, SetVertexBytesCommand>) {
+                        const auto* vertices = static_cast<const AAPLSpriteVertex*>(command.bytes());
+                        spriteVertices.insert(spriteVertices.end(), vertices, vertices + command.length / sizeof(AAPLSpriteVertex));
+                    }
+                });
+            }
+            NullRenderBackend::execute(lists);
+        }
+
+        std::vector<AAPLSpriteVertex> spriteVertices;
+    };
+
+} // namespace
+
+TEST(gameRendererDrawsScenesThroughTheQuadIndexBuffer)
+{
+    RendererFixture fixture;
+    Scene scene;
+    Sprite sprite;
+    sprite.texture = fixture.texture;
+    sprite.size = vector_float2 { 16, 16 };
+    for (int i = 0; i < 3; ++i) {
+        Transform transform;
+        transform.position = vector_float2 { float(i) * 20, 0 };
+        scene.createSprite(transform, sprite);
+    }
+    // Far outside the viewport.
+    Transform hidden;
+    hidden.position = vector_float2 { 5000, 0 };
+    scene.createSprite(hidden, sprite);
+
+    fixture.renderer.beginFrame();
+    fixture.renderer.drawScene(scene, vector_float2 { 0, 0 }, fixture.sprites);
+    fixture.renderer.endFrame();
+
+    CHECK(fixture.backend->frameStats().draws == 1);
+    CHECK(fixture.backend->frameStats().indices == 3 * 6);
+    CHECK(fixture.backend->frameStats().invalidCommands == 0);
+}
+
+// The sprite shader has no camera input, so the camera has to be taken out
+// of the vertex positions.
+TEST(gameRendererDrawsScenesRelativeToTheCamera)
+{
+    auto recording = std::make_unique<VertexRecordingBackend>();
+    VertexRecordingBackend* backend = recording.get();
+    RendererFixture fixture(std::move(recording));
+
+    Scene scene;
+    Sprite sprite;
+    sprite.texture = fixture.texture;
+    sprite.size = vector_float2 { 16, 8 };
+    Transform transform;
+    transform.position = vector_float2 { 1010, -300 };
+    scene.createSprite(transform, sprite);
+    // At the origin, so only visible if the camera were ignored.
+    scene.createSprite(Transform {}, sprite);
+
+    fixture.renderer.beginFrame();
+    fixture.renderer.drawScene(scene, vector_float2 { 1000, -300 }, fixture.sprites);
+    fixture.renderer.endFrame();
+
+    CHECK(backend->frameStats().draws == 1);
+    CHECK(backend->frameStats().invalidCommands == 0);
+    CHECK(backend->spriteVertices.size() == 4);
+    if (backend->spriteVertices.size() == 4) {
+        const AAPLSpriteVertex* quad = backend->spriteVertices.data();
+        CHECK(quad[0].position[0] == 2 && quad[0].position[1] == 4);
+        CHECK(quad[3].position[0] == 18 && quad[3].position[1] == -4);
+    }
+}
+
+TEST(gameRendererDrawsVisibleTilemapChunks)
+{
+    RendererFixture fixture;
+    GameLibraryId library = fixture.renderer.addLibrary(nullptr, 0);
+    PipelineId tiles = fixture.pipeline(library, "tileVertexShader", VertexLayout::AAPLPackedSpriteVertex);
+
+    Tilemap tilemap(fixture.renderer.backend(), fixture.renderer.quadIndexBuffer(), 256, 256, 16);
+    tilemap.setTileRegion(1, vector_float4 { 0, 0, 1, 1 });
+    for (uint32_t y = 0; y < 256; ++y)
+        for (uint32_t x = 0; x < 256; ++x)
+            tilemap.setTile(x, y, 1);
+
+    // Centered on the corner between four chunks of 512 pixels.
+    fixture.renderer.beginFrame();
+    fixture.renderer.drawTilemap(tilemap, vector_float2 { 512, -512 }, tiles, fixture.texture);
+    fixture.renderer.endFrame();
+
+    CHECK(tilemap.stats().drawnChunks == 4);
+    CHECK(fixture.backend->frameStats().draws == 4);
+    CHECK(fixture.backend->frameStats().invalidCommands == 0);
+}
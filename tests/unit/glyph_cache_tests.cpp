@@ -0,0 +1,91 @@
+#include "test.hpp"
+
+#include "glyph_cache.hpp"
+#include "null_render_backend.hpp"
+
+using namespace se;
+
+namespace {
+
+    // A 64 pixel page holds nine glyphs at scale 2: 16 pixels plus one
+    // pixel of padding on each side, three to a row.
+    constexpr uint32_t kPageSize = 64;
+    constexpr uint32_t kScale = 2;
+    constexpr size_t kCapacity = 9;
+
+    struct CacheFixture {
+        NullRenderBackend backend { vector_uint2 { 640, 480 } };
+        GlyphCache cache { backend, kPageSize };
+
+        // True when the glyph was already cached.
+        bool hit(char character)
+        {
+            uint64_t misses = cache.stats().misses;
+            cache.glyph(uint8_t(character), kScale);
+            return cache.stats().misses == misses;
+        }
+    };
+
+} // namespace
+
+TEST(glyphCacheReturnsTheSameGlyphUntilEvicted)
+{
+    CacheFixture fixture;
+    const Glyph* glyph = fixture.cache.glyph('A', kScale);
+    CHECK(glyph != nullptr);
+    CHECK(glyph->width == kBitmapFontSize * kScale && glyph->height == kBitmapFontSize * kScale);
+    CHECK(fixture.cache.glyph('A', kScale) == glyph);
+    CHECK(fixture.cache.glyph('A', 1) != glyph);
+    CHECK(fixture.cache.stats().hits == 1);
+    CHECK(fixture.cache.stats().misses == 2);
+
+    // Out-of-range scales are clamped; missing characters share '?'.
+    CHECK(fixture.cache.glyph('A', 0) == fixture.cache.glyph('A', 1));
+    CHECK(fixture.cache.glyph(0x2603, 1) == fixture.cache.glyph('?', 1));
+}
+
+TEST(glyphCacheEvictsTheLeastRecentlyUsedGlyph)
+{
+    CacheFixture fixture;
+    for (size_t i = 0; i < kCapacity; ++i) {
+        fixture.cache.glyph(uint8_t('A' + i), kScale);
+        fixture.cache.nextFrame();
+    }
+    CHECK(fixture.cache.size() == kCapacity);
+
+    // 'A' is the oldest but was used again, so 'B' goes first.
+    CHECK(fixture.hit('A'));
+    CHECK(!fixture.hit('J'));
+    CHECK(fixture.cache.stats().evictions == 1);
+    CHECK(fixture.cache.size() == kCapacity);
+
+    fixture.cache.nextFrame();
+    CHECK(fixture.hit('C'));
+    CHECK(fixture.hit('A'));
+    CHECK(!fixture.hit('B'));
+    CHECK(fixture.cache.stats().evictions == 2);
+    CHECK(!fixture.hit('D'));
+    CHECK(fixture.hit('C'));
+    CHECK(fixture.hit('J'));
+}
+
+TEST(glyphCacheNeverEvictsGlyphsUsedThisFrame)
+{
+    CacheFixture fixture;
+    for (size_t i = 0; i < kCapacity; ++i)
+        fixture.cache.glyph(uint8_t('A' + i), kScale);
+
+    CHECK(fixture.cache.glyph('Z', kScale) == nullptr);
+    CHECK(fixture.cache.stats().evictions == 0);
+    for (size_t i = 0; i < kCapacity; ++i)
+        CHECK(fixture.hit(char('A' + i)));
+
+    // Glyphs from earlier frames go once nothing of this frame is left.
+    fixture.cache.nextFrame();
+    for (size_t i = 1; i < kCapacity; ++i)
+        fixture.cache.glyph(uint8_t('A' + i), kScale);
+    CHECK(fixture.cache.glyph('Z', kScale) != nullptr);
+    CHECK(fixture.cache.glyph('Y', kScale) == nullptr);
+    CHECK(fixture.cache.stats().evictions == 1);
+    CHECK(!fixture.hit('A'));
+}
@@ -0,0 +1,46 @@
+#include "reference_image.hpp"
+#include "test.hpp"
+
+#include <vector>
+
+#include "image_writer.hpp"
+
+using namespace se;
+
+TEST(pngRoundTripsPixels)
+{
+    // Three by two pixels inside rows of four.
+    std::vector<uint32_t> pixels = { 0xff0000ff, 0xff00ff00, 0xffff0000, 0, 0x80808080, 0x00000000, 0x12345678, 0 };
+    std::vector<uint8_t> png = encodePng(3, 2, pixels.data(), 4);
+
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<uint32_t> decoded;
+    CHECK(se::test::decodePng(png, width, height, decoded));
+    CHECK(width == 3);
+    CHECK(height == 2);
+    CHECK(decoded == std::vector<uint32_t> { 0xff0000ff, 0xff00ff00, 0xffff0000, 0x80808080, 0x00000000, 0x12345678 });
+}
+
+TEST(pngSpansSeveralDeflateBlocks)
+{
+    // 200 rows of 801 bytes need three 65535-byte stored blocks.
+    std::vector<uint32_t> pixels(200 * 200);
+    for (size_t i = 0; i < pixels.size(); ++i)
+        pixels[i] = uint32_t(i * 2654435761u);
+    std::vector<uint8_t> png = encodePng(200, 200, pixels.data(), 200);
+
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<uint32_t> decoded;
+    CHECK(se::test::decodePng(png, width, height, decoded));
+    CHECK(decoded == pixels);
+}
+
+TEST(pngRejectsEmptyImages)
+{
+    uint32_t pixel = 0;
+    CHECK(encodePng(0, 0, &pixel, 0).empty());
+    CHECK(encodePng(4, 0, &pixel, 4).empty());
+    CHECK(encodePng(0, 4, &pixel, 0).empty());
+}
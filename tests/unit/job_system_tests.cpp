@@ -0,0 +1,122 @@
+#include "test.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <vector>
+
+#include "job_system.hpp"
+
+using namespace se;
+
+namespace {
+
+    constexpr size_t kThreadCounts[] = { 1, 2, 4 };
+
+    struct Fibonacci {
+        JobSystem* system;
+        uint32_t n;
+        uint64_t* result;
+
+        void operator()() const
+        {
+            if (n < 2) {
+                *result = n;
+                return;
+            }
+
+            uint64_t a = 0;
+            uint64_t b = 0;
+            Job* left = system->create(Fibonacci { system, n - 1, &a });
+            Job* right = system->create(Fibonacci { system, n - 2, &b });
+            system->run(left);
+            system->run(right);
+            system->wait(left);
+            system->wait(right);
+            *result = a + b;
+        }
+    };
+
+} // namespace
+
+TEST(jobSystemRunsChildrenBeforeParentFinishes)
+{
+    for (size_t threads : kThreadCounts) {
+        JobSystem system(threads);
+        std::atomic<uint32_t> ran { 0 };
+        Job* parent = system.create([]() {});
+        for (int i = 0; i < 100; ++i)
+            system.run(system.createChild(parent, [&ran]() { ran.fetch_add(1, std::memory_order_relaxed); }));
+        system.run(parent);
+        system.wait(parent);
+        CHECK(parent->finished());
+        CHECK(ran.load() == 100);
+    }
+}
+
+// More children than the ring holds, queued before the parent: the parent
+// takes the slot the ring wraps around to, and only its creator can run it.
+TEST(jobSystemSpawnsMoreChildrenThanTheRingHolds)
+{
+    for (size_t threads : kThreadCounts) {
+        JobSystem system(threads);
+        std::atomic<uint32_t> ran { 0 };
+        constexpr uint32_t kChildren = 3 * JobSystem::kJobsPerThread + 7;
+
+        Job* parent = system.create([]() {});
+        for (uint32_t i = 0; i < kChildren; ++i)
+            system.run(system.createChild(parent, [&ran]() { ran.fetch_add(1, std::memory_order_relaxed); }));
+        system.run(parent);
+        system.wait(parent);
+
+        CHECK(ran.load() == kChildren);
+        CHECK(system.stats().overflowJobs > 0);
+        CHECK(system.stats().executed == kChildren + 1);
+    }
+}
+
+TEST(jobSystemCreatesMoreJobsThanTheRingHoldsBeforeRunningAny)
+{
+    JobSystem system(2);
+    std::vector<uint32_t> values(2 * JobSystem::kJobsPerThread);
+    std::vector<Job*> jobs;
+    for (uint32_t i = 0; i < values.size(); ++i) {
+        uint32_t* value = &values[i];
+        jobs.push_back(system.create([value, i]() { *value = i; }));
+    }
+    for (Job* job : jobs)
+        system.run(job);
+    for (Job* job : jobs)
+        system.wait(job);
+
+    for (uint32_t i = 0; i < values.size(); ++i)
+        CHECK(values[i] == i);
+}
+
+TEST(jobSystemNestedWaits)
+{
+    for (size_t threads : kThreadCounts) {
+        JobSystem system(threads);
+        uint64_t result = 0;
+        Job* root = system.create(Fibonacci { &system, 20, &result });
+        system.run(root);
+        system.wait(root);
+        CHECK(result == 6765);
+    }
+}
+
+TEST(jobSystemParallelForCoversTheRangeOnce)
+{
+    for (size_t threads : kThreadCounts) {
+        JobSystem system(threads);
+        for (size_t grain : { 0, 1, 7, 1000 }) {
+            std::vector<uint32_t> hits(10007);
+            system.parallelFor(0, hits.size(), [&hits](size_t first, size_t last) {
+                for (size_t i = first; i < last; ++i)
+                    ++hits[i];
+            }, grain);
+            CHECK(std::accumulate(hits.begin(), hits.end(), size_t(0)) == hits.size());
+            CHECK(*std::min_element(hits.begin(), hits.end()) == 1);
+        }
+    }
+}
@@ -0,0 +1,71 @@
+#include "test.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace se::test {
+
+namespace {
+
+    struct TestCase {
+        const char* name;
+        TestFunction function;
+    };
+
+    std::vector<TestCase>& tests()
+    {
+        static std::vector<TestCase> tests;
+        return tests;
+    }
+
+    // CHECKs may fail on worker threads.
+    std::atomic<size_t> failed_checks { 0 };
+
+} // namespace
+
+Registration::Registration(const char* name, TestFunction function)
+{
+    tests().push_back({ name, function });
+}
+
+void fail(const char* expression, const char* file, int line)
+{
+    ++failed_checks;
+    std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", file, line, expression);
+}
+
+} // namespace se::test
+
+// Runs every test, or those whose names contain one of the arguments.
+int main(int argc, char** argv)
+{
+    size_t run = 0;
+    size_t failed = 0;
+
+    for (const se::test::TestCase& test : se::test::tests()) {
+        bool selected = argc < 2;
+        for (int i = 1; i < argc; ++i)
+            selected = selected || std::strstr(test.name, argv[i]);
+        if (!selected)
+            continue;
+
+        std::printf("[ RUN      ] %s\n", test.name);
+        std::fflush(stdout);
+
+        size_t failed_before = se::test::failed_checks;
+        auto start = std::chrono::steady_clock::now();
+        test.function();
+        double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        bool passed = se::test::failed_checks == failed_before;
+        std::printf("[ %s ] %s (%.1f ms)\n", passed ? "    OK  " : " FAILED ", test.name, milliseconds);
+        ++run;
+        failed += !passed;
+    }
+
+    std::printf("%zu tests, %zu failed\n", run, failed);
+    return failed == 0 && run > 0 ? 0 : 1;
+}
@@ -0,0 +1,141 @@
+#include "test.hpp"
+
+#include <cstring>
+
+#include "mesh_builder.hpp"
+#include "null_render_backend.hpp"
+
+using namespace se;
+
+namespace {
+
+    AAPLVertex vertex(float x, float y, vector_float4 color = vector_float4 { 1, 1, 1, 1 })
+    {
+        AAPLVertex result;
+        result.position = vector_float2 { x, y };
+        result.color = color;
+        return result;
+    }
+
+    // A row of `count` quads that share no corners.
+    void addSeparateQuads(MeshBuilder<AAPLVertex>& builder, uint32_t count)
+    {
+        for (uint32_t i = 0; i < count; ++i) {
+            float x = float(i) * 2;
+            builder.addQuad(vertex(x, 0), vertex(x + 1, 0), vertex(x, 1), vertex(x + 1, 1));
+        }
+    }
+
+    const RenderStats& drawMesh(NullRenderBackend& backend, const Mesh& mesh)
+    {
+        GameLibraryId library = backend.addLibrary(nullptr, 0);
+        PipelineDesc desc;
+        desc.vertexShader = backend.loadShaderFromLibrary(library, "vertexShader");
+        desc.fragmentShader = backend.loadShaderFromLibrary(library, "fragmentShader");
+
+        CommandList list;
+        list.drawMesh(mesh, backend.createPipeline(desc));
+        const CommandList* lists[] = { &list };
+        backend.beginFrame();
+        backend.execute(lists);
+        backend.endFrame();
+        return backend.frameStats();
+    }
+
+} // namespace
+
+TEST(meshBuilderWeldsSharedCorners)
+{
+    // A 2x2 grid of quads has nine distinct corners.
+    MeshBuilder<AAPLVertex> builder;
+    for (int y = 0; y < 2; ++y) {
+        for (int x = 0; x < 2; ++x)
+            builder.addQuad(vertex(x, y), vertex(x + 1, y), vertex(x, y + 1), vertex(x + 1, y + 1));
+    }
+
+    CHECK(builder.vertices().size() == 9);
+    CHECK(builder.indices().size() == 24);
+    CHECK(builder.weldedCount() == 24 - 9);
+    for (size_t i = 0; i < builder.indices().size(); i += 3) {
+        const AAPLVertex& a = builder.vertices()[builder.indices()[i]];
+        const AAPLVertex& b = builder.vertices()[builder.indices()[i + 1]];
+        CHECK(a.position[0] != b.position[0] || a.position[1] != b.position[1]);
+    }
+}
+
+TEST(meshBuilderWeldsOnFieldsOnly)
+{
+    MeshBuilder<AAPLVertex> builder;
+
+    // Equal fields weld even when the padding bytes differ.
+    AAPLVertex first;
+    AAPLVertex second;
+    std::memset(&first, 0xaa, sizeof(first));
+    std::memset(&second, 0x55, sizeof(second));
+    first.position = second.position = vector_float2 { 3, 4 };
+    first.color = second.color = vector_float4 { 0, 1, 0, 1 };
+    CHECK(builder.addVertex(first) == builder.addVertex(second));
+
+    // Any field that differs keeps vertices apart, including -0 against 0.
+    CHECK(builder.addVertex(vertex(3, 4, vector_float4 { 0, 1, 0, 0.5f })) != 0);
+    CHECK(builder.addVertex(vertex(-0.0f, 0)) != builder.addVertex(vertex(0.0f, 0)));
+    CHECK(builder.vertices().size() == 4);
+    CHECK(builder.weldedCount() == 1);
+
+    builder.clear();
+    CHECK(builder.vertices().empty() && builder.weldedCount() == 0);
+    CHECK(builder.addVertex(vertex(3, 4)) == 0);
+}
+
+// 16-bit indices reach vertex 65535, so 65536 vertices still fit.
+TEST(meshBuilderPicksTheNarrowestIndexType)
+{
+    MeshBuilder<AAPLVertex> builder;
+    addSeparateQuads(builder, 0x10000 / 4);
+    CHECK(builder.vertices().size() == 0x10000);
+    CHECK(builder.indexType() == IndexType::UInt16);
+
+    std::vector<uint8_t> bytes = builder.indexBytes();
+    CHECK(bytes.size() == builder.indices().size() * sizeof(uint16_t));
+    uint16_t last;
+    std::memcpy(&last, &bytes[bytes.size() - sizeof(last)], sizeof(last));
+    CHECK(last == 0xffff);
+    CHECK(last == builder.indices().back());
+
+    builder.addTriangle(vertex(-1, 0), vertex(-2, 0), vertex(-3, 0));
+    CHECK(builder.indexType() == IndexType::UInt32);
+}
+
+TEST(meshBuilderDrawsMeshesPast65535Vertices)
+{
+    MeshBuilder<AAPLVertex> builder;
+    addSeparateQuads(builder, 20000);
+    CHECK(builder.vertices().size() == 80000);
+    CHECK(builder.indexType() == IndexType::UInt32);
+
+    std::vector<uint8_t> bytes = builder.indexBytes();
+    CHECK(bytes.size() == builder.indices().size() * sizeof(uint32_t));
+    uint32_t last;
+    std::memcpy(&last, &bytes[bytes.size() - sizeof(last)], sizeof(last));
+    CHECK(last == 79999);
+
+    NullRenderBackend backend(vector_uint2 { 640, 480 });
+    Mesh mesh = builder.upload(backend);
+    CHECK(mesh.indexType == IndexType::UInt32);
+    CHECK(mesh.indexCount == 120000);
+    const RenderStats& stats = drawMesh(backend, mesh);
+    CHECK(stats.invalidCommands == 0);
+    CHECK(stats.draws == 1);
+    CHECK(stats.indices == 120000);
+}
+
+TEST(meshBuilderUploadsNoBuffersForAnEmptyMesh)
+{
+    NullRenderBackend backend(vector_uint2 { 640, 480 });
+    MeshBuilder<AAPLVertex> builder;
+    Mesh mesh = builder.upload(backend);
+    CHECK(!mesh.vertexBuffer.valid());
+    CHECK(!mesh.indexBuffer.valid());
+    CHECK(mesh.indexCount == 0);
+    backend.destroyBuffer(mesh.vertexBuffer);
+}
@@ -0,0 +1,106 @@
+#include "test.hpp"
+
+#include "null_render_backend.hpp"
+
+using namespace se;
+
+namespace {
+
+    struct NullFixture {
+        NullRenderBackend backend { vector_uint2 { 640, 480 } };
+        PipelineDesc desc;
+        PipelineId pipeline;
+
+        NullFixture()
+        {
+            GameLibraryId library = backend.addLibrary(nullptr, 0);
+            desc.vertexShader = backend.loadShaderFromLibrary(library, "vertexShader");
+            desc.fragmentShader = backend.loadShaderFromLibrary(library, "fragmentShader");
+            pipeline = backend.createPipeline(desc);
+        }
+
+        const RenderStats& run(const CommandList& list)
+        {
+            const CommandList* lists[] = { &list };
+            backend.beginFrame();
+            backend.execute(lists);
+            backend.endFrame();
+            return backend.frameStats();
+        }
+    };
+
+} // namespace
+
+TEST(nullBackendCountsDraws)
+{
+    NullFixture fixture;
+    AAPLVertex vertices[6] = {};
+
+    CommandList list;
+    list.drawVertices(vertices, 6, fixture.pipeline);
+    list.drawVertices(vertices, 3, fixture.pipeline);
+
+    const RenderStats& stats = fixture.run(list);
+    CHECK(stats.invalidCommands == 0);
+    CHECK(stats.draws == 2);
+    CHECK(stats.vertices == 9);
+    CHECK(stats.pipelineBinds == 2);
+    CHECK(stats.redundantPipelineBinds == 1);
+    CHECK(stats.vertexBytes == sizeof(vertices) + 3 * sizeof(AAPLVertex));
+}
+
+TEST(nullBackendRejectsDrawsAfterInvalidBind)
+{
+    NullFixture fixture;
+    AAPLVertex vertices[3] = {};
+
+    PipelineId destroyed = fixture.backend.createPipeline(fixture.desc);
+    fixture.backend.destroyPipeline(destroyed);
+
+    // The valid pipeline bound first must not be used by the draw after the
+    // failed bind.
+    CommandList list;
+    list.drawVertices(vertices, 3, fixture.pipeline);
+    list.drawVertices(vertices, 3, destroyed);
+
+    const RenderStats& stats = fixture.run(list);
+    CHECK(stats.draws == 1);
+    CHECK(stats.invalidCommands == 2);
+}
+
+TEST(nullBackendRejectsDrawsPastVertexBytes)
+{
+    NullFixture fixture;
+    AAPLVertex vertices[3] = {};
+
+    CommandList list;
+    list.bindPipeline(fixture.pipeline);
+    list.setVertexBytes(AAPLVertexInputIndexVertices, vertices, sizeof(vertices));
+    list.draw(1, 3);
+
+    const RenderStats& stats = fixture.run(list);
+    CHECK(stats.draws == 0);
+    CHECK(stats.invalidCommands == 1);
+}
+
+TEST(nullBackendStateDoesNotCarryAcrossLists)
+{
+    NullFixture fixture;
+    AAPLVertex vertices[3] = {};
+
+    CommandList first;
+    first.drawVertices(vertices, 3, fixture.pipeline);
+    CommandList second;
+    second.setVertexBytes(AAPLVertexInputIndexVertices, vertices, sizeof(vertices));
+    second.draw(0, 3);
+
+    const CommandList* lists[] = { &first, &second };
+    fixture.backend.beginFrame();
+    fixture.backend.execute(lists);
+    fixture.backend.endFrame();
+
+    CHECK(fixture.backend.frameStats().draws == 1);
+    CHECK(fixture.backend.frameStats().invalidCommands == 1);
+    CHECK(fixture.backend.totalStats().draws == 1);
+    CHECK(fixture.backend.frames() == 1);
+}
@@ -0,0 +1,90 @@
+#include "test.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "object_pool.hpp"
+
+using namespace se;
+
+namespace {
+
+    struct Payload {
+        uint32_t owner;
+        uint32_t sequence;
+        uint64_t padding[6];
+    };
+
+} // namespace
+
+// The chunk table used to end at 1024 chunks.
+TEST(fixedPoolGrowsPastTheFirstTableSegment)
+{
+    FixedPool pool(1900);
+    std::vector<void*> objects;
+    while (pool.chunkAllocations() <= FixedPool::kChunksPerSegment) {
+        void* object = pool.allocate();
+        std::memset(object, int(objects.size() & 0xff), 1900);
+        objects.push_back(object);
+    }
+
+    std::vector<void*> sorted = objects;
+    std::sort(sorted.begin(), sorted.end());
+    CHECK(std::adjacent_find(sorted.begin(), sorted.end()) == sorted.end());
+    for (size_t i = 0; i < objects.size(); i += 997)
+        CHECK(static_cast<unsigned char*>(objects[i])[1899] == (i & 0xff));
+
+    for (void* object : objects)
+        pool.deallocate(object);
+    CHECK(pool.capacity() >= objects.size());
+}
+
+TEST(objectPoolHandsEachSlotToOneThreadAtATime)
+{
+    ObjectPool<Payload> pool;
+    std::atomic<uint32_t> corrupted { 0 };
+    std::vector<std::thread> threads;
+    for (uint32_t owner = 0; owner < 4; ++owner) {
+        threads.emplace_back([&pool, &corrupted, owner]() {
+            std::vector<Payload*> live;
+            for (uint32_t round = 0; round < 2000; ++round) {
+                for (uint32_t i = 0; i < 48; ++i)
+                    live.push_back(pool.create(Payload { owner, round * 48 + i, {} }));
+                for (uint32_t i = 0; i < live.size(); ++i)
+                    if (live[i]->owner != owner || live[i]->sequence != round * 48 + i)
+                        corrupted.fetch_add(1, std::memory_order_relaxed);
+                for (Payload* payload : live)
+                    pool.destroy(payload);
+                live.clear();
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+    CHECK(corrupted.load() == 0);
+}
+
+// Objects freed on another thread than the one that allocated them.
+TEST(objectPoolFreesAcrossThreads)
+{
+    ObjectPool<Payload> pool;
+    std::vector<Payload*> objects;
+    for (uint32_t i = 0; i < 10000; ++i)
+        objects.push_back(pool.create(Payload { 0, i, {} }));
+    size_t capacity = pool.capacity();
+
+    std::thread([&]() {
+        for (Payload* payload : objects)
+            pool.destroy(payload);
+    }).join();
+
+    // The freed slots come back instead of new chunks.
+    for (uint32_t i = 0; i < 10000; ++i)
+        objects[i] = pool.create(Payload { 1, i, {} });
+    CHECK(pool.capacity() == capacity);
+    for (Payload* payload : objects)
+        pool.destroy(payload);
+}
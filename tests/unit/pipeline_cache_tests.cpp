@@ -0,0 +1,130 @@
+#include "test.hpp"
+
+#include <chrono>
+#include <memory>
+
+#include "game_renderer.hpp"
+#include "null_render_backend.hpp"
+
+using namespace se;
+using namespace std::chrono_literals;
+
+namespace {
+
+    struct CacheFixture {
+        NullRenderBackend* backend;
+        GameRenderer renderer;
+        GameLibraryId library;
+
+        CacheFixture()
+            : CacheFixture(std::make_unique<NullRenderBackend>(vector_uint2 { 640, 480 }))
+        {
+        }
+
+        explicit CacheFixture(std::unique_ptr<NullRenderBackend> null_backend)
+            : backend(null_backend.get())
+            , renderer(std::move(null_backend))
+        {
+            library = renderer.addLibrary(nullptr, 0);
+        }
+
+        PipelineDesc spriteDesc()
+        {
+            PipelineDesc desc;
+            desc.vertexShader = renderer.loadShaderFromLibrary(library, "spriteVertexShader");
+            desc.fragmentShader = renderer.loadShaderFromLibrary(library, "spriteFragmentShader");
+            desc.blend = BlendMode::Alpha;
+            desc.vertexLayout = VertexLayout::AAPLSpriteVertex;
+            return desc;
+        }
+    };
+
+} // namespace
+
+TEST(pipelineCacheReturnsTheSamePipelineForIdenticalDescriptions)
+{
+    CacheFixture fixture;
+    PipelineId first = fixture.renderer.createPipeline(fixture.spriteDesc());
+    PipelineId second = fixture.renderer.createPipeline(fixture.spriteDesc());
+
+    CHECK(first == second);
+    CHECK(fixture.renderer.pipelineCacheStats().misses == 1);
+    CHECK(fixture.renderer.pipelineCacheStats().hits == 1);
+}
+
+TEST(pipelineCacheMissesOnAnyDifferentField)
+{
+    CacheFixture fixture;
+    PipelineDesc desc = fixture.spriteDesc();
+    PipelineId alpha = fixture.renderer.createPipeline(desc);
+
+    PipelineDesc opaque = desc;
+    opaque.blend = BlendMode::Opaque;
+    PipelineDesc packed = desc;
+    packed.vertexLayout = VertexLayout::AAPLPackedSpriteVertex;
+    PipelineDesc other_shader = desc;
+    other_shader.fragmentShader = fixture.renderer.loadShaderFromLibrary(fixture.library, "fragmentShader");
+
+    PipelineId pipelines[] = {
+        fixture.renderer.createPipeline(opaque),
+        fixture.renderer.createPipeline(packed),
+        fixture.renderer.createPipeline(other_shader),
+    };
+    for (PipelineId pipeline : pipelines)
+        CHECK(pipeline != alpha);
+    CHECK(pipelines[0] != pipelines[1] && pipelines[1] != pipelines[2] && pipelines[0] != pipelines[2]);
+    CHECK(fixture.renderer.pipelineCacheStats().misses == 4);
+    CHECK(fixture.renderer.pipelineCacheStats().hits == 0);
+
+    // A destroyed pipeline is created again instead of being returned.
+    fixture.renderer.destroyPipeline(alpha);
+    CHECK(fixture.renderer.createPipeline(desc) != alpha);
+}
+
+TEST(shaderCacheReturnsTheSameShaderPerLibraryAndName)
+{
+    CacheFixture fixture;
+    GameLibraryId other = fixture.renderer.addLibrary(nullptr, 0);
+
+    ShaderId vertex = fixture.renderer.loadShaderFromLibrary(fixture.library, "vertexShader");
+    CHECK(fixture.renderer.loadShaderFromLibrary(fixture.library, "vertexShader") == vertex);
+    CHECK(fixture.renderer.loadShaderFromLibrary(other, "vertexShader") != vertex);
+    CHECK(fixture.renderer.cachedShaders() == 2);
+}
+
+TEST(shaderCacheForgetsDestroyedLibraries)
+{
+    CacheFixture fixture;
+    GameLibraryId other = fixture.renderer.addLibrary(nullptr, 0);
+    PipelineDesc desc = fixture.spriteDesc();
+    ShaderId kept = fixture.renderer.loadShaderFromLibrary(other, "vertexShader");
+    CHECK(fixture.renderer.cachedShaders() == 3);
+
+    fixture.renderer.destroyLibrary(fixture.library);
+    CHECK(fixture.renderer.cachedShaders() == 1);
+    CHECK(fixture.renderer.loadShaderFromLibrary(other, "vertexShader") == kept);
+
+    // Shaders from the destroyed library still make pipelines, and the
+    // reloaded library gets shaders of its own.
+    CHECK(fixture.renderer.createPipeline(desc).valid());
+    GameLibraryId reloaded = fixture.renderer.addLibrary(nullptr, 0);
+    CHECK(fixture.renderer.loadShaderFromLibrary(reloaded, "spriteVertexShader") != desc.vertexShader);
+}
+
+// Shaders of the library still compiling in the background finish before
+// the library goes away.
+TEST(shaderCacheDestroyLibraryWaitsForCompilesInFlight)
+{
+    auto null_backend = std::make_unique<NullRenderBackend>(vector_uint2 { 640, 480 });
+    null_backend->setCompileDelay(5ms);
+    CacheFixture fixture(std::move(null_backend));
+
+    AsyncShader vertex = fixture.renderer.loadShaderFromLibraryAsync(fixture.library, "vertexShader");
+    AsyncShader fragment = fixture.renderer.loadShaderFromLibraryAsync(fixture.library, "fragmentShader");
+    CHECK(!vertex.ready());
+
+    fixture.renderer.destroyLibrary(fixture.library);
+    CHECK(vertex.ready());
+    CHECK(fragment.ready());
+    CHECK(fixture.renderer.cachedShaders() == 0);
+}
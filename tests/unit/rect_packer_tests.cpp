@@ -0,0 +1,133 @@
+#include "test.hpp"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "rect_packer.hpp"
+
+using namespace se;
+
+namespace {
+
+    bool overlaps(const PackedRect& a, const PackedRect& b)
+    {
+        return a.x < b.x + b.width && b.x < a.x + a.width
+            && a.y < b.y + b.height && b.y < a.y + a.height;
+    }
+
+    bool disjointAndInside(const RectPacker& packer, const std::vector<PackedRect>& rects)
+    {
+        for (size_t i = 0; i < rects.size(); ++i) {
+            if (rects[i].x + rects[i].width > packer.width() || rects[i].y + rects[i].height > packer.height())
+                return false;
+            for (size_t j = i + 1; j < rects.size(); ++j) {
+                if (overlaps(rects[i], rects[j]))
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    uint64_t area(const std::vector<PackedRect>& rects)
+    {
+        uint64_t total = 0;
+        for (const PackedRect& rect : rects)
+            total += uint64_t(rect.width) * rect.height;
+        return total;
+    }
+
+} // namespace
+
+TEST(rectPackerPlacesRectanglesWithoutOverlap)
+{
+    RectPacker packer(256, 256);
+    std::mt19937 random(7);
+    std::uniform_int_distribution<uint32_t> size(4, 40);
+
+    std::vector<PackedRect> placed;
+    for (int failures = 0; failures < 20;) {
+        if (std::optional<PackedRect> rect = packer.insert(size(random), size(random)))
+            placed.push_back(*rect);
+        else
+            ++failures;
+    }
+
+    CHECK(disjointAndInside(packer, placed));
+    CHECK(packer.usedArea() == area(placed));
+    CHECK(packer.occupancy() > 0.75);
+}
+
+TEST(rectPackerRejectsEmptyAndOversizedRectangles)
+{
+    RectPacker packer(64, 64);
+    CHECK(!packer.insert(0, 8));
+    CHECK(!packer.insert(8, 0));
+    CHECK(!packer.insert(65, 8));
+    CHECK(packer.insert(64, 64) == PackedRect { 0, 0, 64, 64 });
+    CHECK(!packer.insert(1, 1));
+}
+
+TEST(rectPackerReusesTheSpaceOfRemovedRectangles)
+{
+    RectPacker packer(64, 64);
+    std::vector<PackedRect> tiles;
+    while (std::optional<PackedRect> rect = packer.insert(16, 16))
+        tiles.push_back(*rect);
+    CHECK(tiles.size() == 16);
+
+    packer.remove(tiles[5]);
+    CHECK(packer.insert(16, 16) == tiles[5]);
+
+    // Two tiles side by side merge back into a rectangle a wider one fits.
+    PackedRect left = tiles[0];
+    auto right = std::find_if(tiles.begin(), tiles.end(), [&](const PackedRect& tile) {
+        return tile.y == left.y && tile.x == left.x + 16;
+    });
+    auto below = std::find_if(tiles.begin(), tiles.end(), [&](const PackedRect& tile) {
+        return tile.x == left.x && tile.y == left.y + 16;
+    });
+    CHECK(right != tiles.end() && below != tiles.end());
+    packer.remove(left);
+    packer.remove(*right);
+    CHECK(!packer.insert(16, 32));
+    CHECK(packer.insert(32, 16) == PackedRect { left.x, left.y, 32, 16 });
+
+    packer.remove({ left.x, left.y, 32, 16 });
+    for (const PackedRect& tile : tiles) {
+        if (tile != left && tile != *right)
+            packer.remove(tile);
+    }
+    CHECK(packer.usedArea() == 0);
+    CHECK(packer.freeRectCount() == 1);
+}
+
+// Random inserts and removals keep every live rectangle apart and the free
+// list from growing without bound.
+TEST(rectPackerStaysConsistentUnderChurn)
+{
+    RectPacker packer(512, 512);
+    std::mt19937 random(11);
+    std::uniform_int_distribution<uint32_t> size(2, 48);
+
+    std::vector<PackedRect> live;
+    size_t most_free = 0;
+    for (int round = 0; round < 4000; ++round) {
+        std::optional<PackedRect> rect;
+        if (random() % 3 != 0)
+            rect = packer.insert(size(random), size(random));
+        if (rect) {
+            live.push_back(*rect);
+        } else if (!live.empty()) {
+            size_t victim = random() % live.size();
+            packer.remove(live[victim]);
+            live[victim] = live.back();
+            live.pop_back();
+        }
+        most_free = std::max(most_free, packer.freeRectCount());
+    }
+
+    CHECK(disjointAndInside(packer, live));
+    CHECK(packer.usedArea() == area(live));
+    CHECK(most_free < 2000);
+}
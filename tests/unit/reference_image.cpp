@@ -0,0 +1,161 @@
+#include "reference_image.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "image_writer.hpp"
+
+namespace se::test {
+
+namespace {
+
+    uint32_t readBigEndian(const uint8_t* data)
+    {
+        return uint32_t(data[0]) << 24 | uint32_t(data[1]) << 16 | uint32_t(data[2]) << 8 | data[3];
+    }
+
+    bool readFile(const std::string& path, std::vector<uint8_t>& data)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+            return false;
+        data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        return true;
+    }
+
+    uint32_t channelDistance(uint32_t a, uint32_t b)
+    {
+        uint32_t distance = 0;
+        for (int shift = 0; shift < 32; shift += 8) {
+            int32_t difference = int32_t((a >> shift) & 0xff) - int32_t((b >> shift) & 0xff);
+            distance = std::max<uint32_t>(distance, uint32_t(std::abs(difference)));
+        }
+        return distance;
+    }
+
+} // namespace
+
+bool decodePng(const std::vector<uint8_t>& png, uint32_t& width, uint32_t& height, std::vector<uint32_t>& pixels)
+{
+    static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+    if (png.size() < 8 || std::memcmp(png.data(), signature, 8) != 0)
+        return false;
+
+    std::vector<uint8_t> zlib;
+    bool has_header = false;
+    for (size_t offset = 8; offset + 12 <= png.size();) {
+        uint32_t length = readBigEndian(&png[offset]);
+        const uint8_t* type = &png[offset + 4];
+        const uint8_t* data = &png[offset + 8];
+        if (offset + 12 + length > png.size())
+            return false;
+
+        if (std::memcmp(type, "IHDR", 4) == 0) {
+            width = readBigEndian(data);
+            height = readBigEndian(data + 4);
+            // 8-bit RGBA, no interlacing.
+            if (data[8] != 8 || data[9] != 6 || data[12] != 0)
+                return false;
+            has_header = true;
+        } else if (std::memcmp(type, "IDAT", 4) == 0) {
+            zlib.insert(zlib.end(), data, data + length);
+        }
+        offset += 12 + length;
+    }
+    if (!has_header || zlib.size() < 2)
+        return false;
+
+    std::vector<uint8_t> raw;
+    size_t position = 2;
+    for (bool last = false; !last;) {
+        if (position + 5 > zlib.size() || (zlib[position] & 0x06) != 0) {
+            std::fprintf(stderr, "Reference images must use stored deflate blocks, as encodePng writes them\n");
+            return false;
+        }
+        last = zlib[position] & 1;
+        size_t length = zlib[position + 1] | size_t(zlib[position + 2]) << 8;
+        position += 5;
+        if (position + length > zlib.size())
+            return false;
+        raw.insert(raw.end(), zlib.begin() + position, zlib.begin() + position + length);
+        position += length;
+    }
+
+    uint32_t a = 1, b = 0;
+    for (uint8_t byte : raw) {
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+    if (position + 4 > zlib.size() || readBigEndian(&zlib[position]) != (b << 16 | a))
+        return false;
+
+    size_t row_bytes = size_t(width) * 4 + 1;
+    if (raw.size() != row_bytes * height)
+        return false;
+
+    pixels.resize(size_t(width) * height);
+    for (uint32_t y = 0; y < height; ++y) {
+        if (raw[y * row_bytes] != 0)
+            return false;
+        std::memcpy(&pixels[size_t(y) * width], &raw[y * row_bytes + 1], size_t(width) * 4);
+    }
+    return true;
+}
+
+bool matchesReference(const char* name, uint32_t width, uint32_t height, const uint32_t* pixels, uint32_t stride,
+    uint32_t tolerance, uint32_t maxMismatches)
+{
+    std::string reference_path = std::string(SE_TEST_REFERENCE_DIR) + "/" + name + ".png";
+    std::vector<uint8_t> encoded = encodePng(width, height, pixels, stride);
+
+    const char* update = std::getenv("SE_UPDATE_REFERENCES");
+    if (update && std::strcmp(update, "1") == 0) {
+        std::printf("Updated %s\n", reference_path.c_str());
+        return writeFile(reference_path, encoded.data(), encoded.size());
+    }
+
+    std::vector<uint8_t> png;
+    uint32_t reference_width = 0;
+    uint32_t reference_height = 0;
+    std::vector<uint32_t> reference;
+    bool matches = false;
+
+    if (!readFile(reference_path, png)) {
+        std::fprintf(stderr, "Missing reference %s\n", reference_path.c_str());
+    } else if (!decodePng(png, reference_width, reference_height, reference)) {
+        std::fprintf(stderr, "Unreadable reference %s\n", reference_path.c_str());
+    } else if (reference_width != width || reference_height != height) {
+        std::fprintf(stderr, "%s: reference is %ux%u, image is %ux%u\n", name, reference_width, reference_height,
+            width, height);
+    } else {
+        uint32_t mismatches = 0;
+        uint32_t worst = 0;
+        for (uint32_t y = 0; y < height; ++y) {
+            for (uint32_t x = 0; x < width; ++x) {
+                uint32_t distance = channelDistance(pixels[size_t(y) * stride + x], reference[size_t(y) * width + x]);
+                worst = std::max(worst, distance);
+                mismatches += distance > tolerance;
+            }
+        }
+
+        matches = mismatches <= maxMismatches;
+        if (!matches)
+            std::fprintf(stderr, "%s: %u pixels differ from the reference by more than %u, up to %u\n", name,
+                mismatches, tolerance, worst);
+    }
+
+    if (!matches) {
+        std::string actual_path = std::string(name) + ".actual.png";
+        writeFile(actual_path, encoded.data(), encoded.size());
+        std::fprintf(stderr, "Wrote %s\n", actual_path.c_str());
+    }
+    return matches;
+}
+
+} // namespace se::test
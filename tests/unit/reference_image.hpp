@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace se::test {
+
+// Compares RGBA8 `pixels` with tests/unit/references/<name>.png. Pixels
+// match when no channel is more than `tolerance` apart; up to
+// `maxMismatches` pixels may differ, which absorbs edge pixels that
+// another compiler's rounding moves across a triangle edge.
+//
+// On failure the image is written to <name>.actual.png in the working
+// directory. Running with SE_UPDATE_REFERENCES=1 in the environment
+// rewrites the reference instead; review the new image before checking it
+// in.
+bool matchesReference(const char* name, uint32_t width, uint32_t height, const uint32_t* pixels, uint32_t stride,
+    uint32_t tolerance = 2, uint32_t maxMismatches = 0);
+
+// Reads PNGs as encodePng writes them: 8-bit RGBA, unfiltered rows in
+// stored deflate blocks. Returns false for anything else.
+bool decodePng(const std::vector<uint8_t>& png, uint32_t& width, uint32_t& height, std::vector<uint32_t>& pixels);
+
+} // namespace se::test
@@ -0,0 +1,159 @@
+#include "test.hpp"
+
+#include <numbers>
+#include <type_traits>
+#include <vector>
+
+#include "scene.hpp"
+
+using namespace se;
+
+namespace {
+
+    constexpr CullRect kView { -100, -50, 100, 50 };
+
+    Entity addSprite(entt::registry& registry, vector_float2 position, TextureId texture, vector_float2 size = vector_float2 { 10, 10 }, float rotation = 0)
+    {
+        Entity entity = registry.create();
+        Transform transform;
+        transform.position = position;
+        transform.rotation = rotation;
+        registry.emplace<Transform>(entity, transform);
+        Sprite sprite;
+        sprite.texture = texture;
+        sprite.size = size;
+        registry.emplace<Sprite>(entity, sprite);
+        return entity;
+    }
+
+    // Center of each quad of `batch`, in order.
+    std::vector<float> quadCentersX(const SpriteBatches::Batch& batch)
+    {
+        std::vector<float> centers;
+        for (size_t i = 0; i < batch.vertices.size(); i += 4)
+            centers.push_back((batch.vertices[i].position[0] + batch.vertices[i + 3].position[0]) * 0.5f);
+        return centers;
+    }
+
+} // namespace
+
+TEST(spriteBatchesGroupByTextureInFirstUseOrder)
+{
+    TextureId a { 0, 1 };
+    TextureId b { 1, 1 };
+    TextureId c { 2, 1 };
+    entt::registry registry;
+    addSprite(registry, vector_float2 { 0, 0 }, a);
+    addSprite(registry, vector_float2 { 10, 0 }, b);
+    addSprite(registry, vector_float2 { 20, 0 }, a);
+    addSprite(registry, vector_float2 { 30, 0 }, c);
+    addSprite(registry, vector_float2 { 40, 0 }, b);
+
+    SpriteBatches batches;
+    spriteSystem(registry, kView, batches);
+    CHECK(batches.end() - batches.begin() == 3);
+    CHECK(batches.quadCount() == 5);
+    CHECK(batches.begin()[0].texture == a);
+    CHECK(batches.begin()[1].texture == b);
+    CHECK(batches.begin()[2].texture == c);
+    CHECK((quadCentersX(batches.begin()[0]) == std::vector<float> { 0, 20 }));
+    CHECK((quadCentersX(batches.begin()[1]) == std::vector<float> { 10, 40 }));
+
+    // One draw per batch.
+    CommandList list;
+    batches.draw(list, PipelineId { 0, 1 }, BufferId { 0, 1 });
+    size_t draws = 0;
+    list.visit([&](const auto& command) {
+        if constexpr (std::is_same_v<std::decay_t<decltype(command)>, DrawIndexedCommand>)
+            ++draws;
+    });
+    CHECK(draws == 3);
+
+    // The next frame starts over, keeping only what it uses.
+    entt::registry next;
+    addSprite(next, vector_float2 { 0, 0 }, c);
+    spriteSystem(next, kView, batches);
+    CHECK(batches.end() - batches.begin() == 1);
+    CHECK(batches.begin()[0].texture == c);
+    CHECK(batches.quadCount() == 1);
+}
+
+TEST(spriteSystemCullsSpritesOutsideTheView)
+{
+    TextureId texture { 0, 1 };
+    entt::registry registry;
+    // Just past each edge, counting the half size.
+    addSprite(registry, vector_float2 { -106, 0 }, texture);
+    addSprite(registry, vector_float2 { 106, 0 }, texture);
+    addSprite(registry, vector_float2 { 0, -56 }, texture);
+    addSprite(registry, vector_float2 { 0, 56 }, texture);
+    // A long sprite that only reaches past the edge while unrotated.
+    addSprite(registry, vector_float2 { 140, 0 }, texture, vector_float2 { 100, 2 }, std::numbers::pi_v<float> / 2);
+
+    SpriteBatches batches;
+    spriteSystem(registry, kView, batches);
+    CHECK(batches.quadCount() == 0);
+
+    // Partly inside, straddling a corner, or rotated into the view.
+    addSprite(registry, vector_float2 { 104, 0 }, texture);
+    addSprite(registry, vector_float2 { -104, 54 }, texture);
+    addSprite(registry, vector_float2 { 0, 90 }, texture, vector_float2 { 100, 2 }, std::numbers::pi_v<float> / 2);
+    spriteSystem(registry, kView, batches);
+    CHECK(batches.quadCount() == 3);
+}
+
+TEST(spriteSystemPositionsQuadsRelativeToTheViewCenter)
+{
+    TextureId texture { 0, 1 };
+    entt::registry registry;
+    addSprite(registry, vector_float2 { 510, 205 }, texture);
+
+    SpriteBatches batches;
+    spriteSystem(registry, CullRect { 400, 150, 600, 250 }, batches);
+    CHECK(batches.quadCount() == 1);
+    if (batches.quadCount() == 1) {
+        const std::vector<AAPLSpriteVertex>& quad = batches.begin()->vertices;
+        CHECK(quad[0].position[0] == 5 && quad[0].position[1] == 10);
+        CHECK(quad[3].position[0] == 15 && quad[3].position[1] == 0);
+    }
+}
+
+TEST(extractedSpritesBuildTheSameQuads)
+{
+    entt::registry registry;
+    for (int i = 0; i < 20; ++i)
+        addSprite(registry, vector_float2 { float(i * 13 - 120), float(i * 7 - 60) }, TextureId { uint32_t(i % 3), 1 }, vector_float2 { 10, 6 }, float(i) * 0.3f);
+
+    std::vector<SpriteInstance> sprites;
+    extractSprites(registry, sprites);
+    CHECK(sprites.size() == 20);
+
+    SpriteBatches direct;
+    SpriteBatches extracted;
+    spriteSystem(registry, kView, direct);
+    spriteSystem(sprites, kView, extracted);
+    CHECK(direct.quadCount() == extracted.quadCount());
+    CHECK(direct.end() - direct.begin() == extracted.end() - extracted.begin());
+    for (const SpriteBatches::Batch* batch = direct.begin(), *other = extracted.begin(); batch != direct.end(); ++batch, ++other) {
+        CHECK(batch->texture == other->texture);
+        CHECK(batch->vertices.size() == other->vertices.size());
+        for (size_t i = 0; i < batch->vertices.size() && i < other->vertices.size(); ++i)
+            CHECK(batch->vertices[i].position[0] == other->vertices[i].position[0] && batch->vertices[i].position[1] == other->vertices[i].position[1]);
+    }
+}
+
+TEST(movementSystemMovesOnlyEntitiesWithVelocity)
+{
+    entt::registry registry;
+    Entity still = addSprite(registry, vector_float2 { 1, 2 }, TextureId {});
+    Entity moving = addSprite(registry, vector_float2 { 1, 2 }, TextureId {});
+    Velocity velocity;
+    velocity.linear = vector_float2 { 10, -4 };
+    velocity.angular = 2;
+    registry.emplace<Velocity>(moving, velocity);
+
+    movementSystem(registry, 0.5f);
+    CHECK(registry.get<Transform>(still).position[0] == 1 && registry.get<Transform>(still).position[1] == 2);
+    CHECK(registry.get<Transform>(moving).position[0] == 6 && registry.get<Transform>(moving).position[1] == 0);
+    CHECK(registry.get<Transform>(moving).rotation == 1);
+}
@@ -0,0 +1,107 @@
+#include "test.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "slot_map.hpp"
+
+using namespace se;
+
+namespace {
+
+    using Names = SlotMap<std::string, struct NameTag>;
+
+} // namespace
+
+TEST(slotMapStaleHandlesStopResolvingAfterErase)
+{
+    Names names;
+    Names::Key first = names.insert("first");
+    Names::Key second = names.insert("second");
+
+    CHECK(names.erase(first));
+    CHECK(!names.contains(first));
+    CHECK(names.get(first) == nullptr);
+    CHECK(!names.erase(first));
+
+    // The slot is reused, but the old handle does not alias the new element.
+    Names::Key third = names.insert("third");
+    CHECK(third.index == first.index);
+    CHECK(third.generation != first.generation);
+    CHECK(names.get(first) == nullptr);
+    CHECK(*names.get(third) == "third");
+    CHECK(*names.get(second) == "second");
+    CHECK(names.size() == 2);
+}
+
+TEST(slotMapRejectsHandlesItNeverIssued)
+{
+    Names names;
+    Names::Key key = names.insert("only");
+
+    CHECK(!names.contains(Names::Key {}));
+    CHECK(!names.contains(Names::Key { key.index, 0 }));
+    CHECK(!names.contains(Names::Key { key.index + 1, key.generation }));
+    CHECK(!names.erase(Names::Key {}));
+}
+
+TEST(slotMapGenerationsSkipZeroOnWrapAround)
+{
+    constexpr uint32_t kLast = std::numeric_limits<uint32_t>::max();
+    CHECK(Names::nextGeneration(1) == 2);
+    CHECK(Names::nextGeneration(kLast - 1) == kLast);
+    CHECK(Names::nextGeneration(kLast) == 1);
+
+    // Every generation a slot goes through differs from the previous one.
+    Names names;
+    Names::Key key = names.insert("slot");
+    for (int i = 0; i < 1000; ++i) {
+        names.erase(key);
+        Names::Key next = names.insert("slot");
+        CHECK(next.index == key.index);
+        CHECK(next.generation == Names::nextGeneration(key.generation));
+        key = next;
+    }
+}
+
+TEST(slotMapReusesFreedSlotsMostRecentFirst)
+{
+    Names names;
+    std::vector<Names::Key> keys;
+    for (int i = 0; i < 8; ++i)
+        keys.push_back(names.insert(std::to_string(i)));
+
+    names.erase(keys[2]);
+    names.erase(keys[5]);
+    names.erase(keys[6]);
+
+    CHECK(names.insert("a").index == keys[6].index);
+    CHECK(names.insert("b").index == keys[5].index);
+    CHECK(names.insert("c").index == keys[2].index);
+    // The free list is empty again, so the table grows.
+    CHECK(names.insert("d").index == 8);
+    CHECK(names.size() == 9);
+}
+
+TEST(slotMapKeepsElementsDenseAcrossErase)
+{
+    Names names;
+    std::vector<Names::Key> keys;
+    for (int i = 0; i < 6; ++i)
+        keys.push_back(names.insert(std::to_string(i)));
+    names.erase(keys[0]);
+    names.erase(keys[3]);
+
+    std::vector<std::string> live(names.begin(), names.end());
+    std::sort(live.begin(), live.end());
+    CHECK((live == std::vector<std::string> { "1", "2", "4", "5" }));
+    for (size_t position = 0; position < names.size(); ++position)
+        CHECK(*names.get(names.keyAt(position)) == *(names.begin() + position));
+
+    names.clear();
+    CHECK(names.empty());
+    for (Names::Key key : keys)
+        CHECK(!names.contains(key));
+}
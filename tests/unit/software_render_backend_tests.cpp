@@ -0,0 +1,259 @@
+#include "reference_image.hpp"
+#include "test.hpp"
+
+#include <cmath>
+#include <vector>
+
+#include "software_render_backend.hpp"
+
+using namespace se;
+
+namespace {
+
+    constexpr uint32_t kOpaqueBlack = 0xff000000;
+
+    struct SoftwareFixture {
+        SoftwareRenderBackend backend;
+        GameLibraryId library;
+        PipelineId pipeline;
+
+        explicit SoftwareFixture(vector_uint2 viewport, size_t threads = 2)
+            : backend(viewport, threads)
+        {
+            library = backend.addLibrary(nullptr, 0);
+            pipeline = createPipeline("vertexShader", "fragmentShader");
+        }
+
+        PipelineId createPipeline(const char* vertex, const char* fragment, PipelineDesc desc = {})
+        {
+            desc.vertexShader = backend.loadShaderFromLibrary(library, vertex);
+            desc.fragmentShader = backend.loadShaderFromLibrary(library, fragment);
+            return backend.createPipeline(desc);
+        }
+
+        void render(std::initializer_list<const CommandList*> lists)
+        {
+            backend.beginFrame();
+            backend.execute(std::span<const CommandList* const>(lists.begin(), lists.size()));
+            backend.endFrame();
+        }
+
+        bool matches(const char* reference) const
+        {
+            const Framebuffer& framebuffer = backend.framebuffer();
+            return se::test::matchesReference(reference, framebuffer.width, framebuffer.height,
+                framebuffer.pixels.data(), framebuffer.stride);
+        }
+
+        bool untouched() const
+        {
+            const Framebuffer& framebuffer = backend.framebuffer();
+            for (uint32_t y = 0; y < framebuffer.height; ++y)
+                for (uint32_t x = 0; x < framebuffer.width; ++x)
+                    if (framebuffer.pixel(x, y) != kOpaqueBlack)
+                        return false;
+            return true;
+        }
+    };
+
+    // Covers the whole viewport of `size`, centered on the origin.
+    void fullScreenQuad(CommandList& list, PipelineId pipeline, vector_uint2 size, vector_float4 color)
+    {
+        float x = float(size[0]) / 2;
+        float y = float(size[1]) / 2;
+        AAPLVertex vertices[6] = {
+            { { -x, y }, color },
+            { { x, y }, color },
+            { { -x, -y }, color },
+            { { x, y }, color },
+            { { x, -y }, color },
+            { { -x, -y }, color },
+        };
+        list.drawVertices(vertices, 6, pipeline);
+    }
+
+    // Thin triangles around the center that share every edge with their
+    // neighbors and cross all tiles; the last ones leave the viewport.
+    std::vector<AAPLVertex> fan(vector_uint2 size, uint32_t segments)
+    {
+        std::vector<AAPLVertex> vertices;
+        float radius = float(std::max(size[0], size[1])) * 0.6f;
+        for (uint32_t i = 0; i < segments; ++i) {
+            float a0 = 2 * float(M_PI) * float(i) / float(segments);
+            float a1 = 2 * float(M_PI) * float(i + 1) / float(segments);
+            float shade = float(i) / float(segments - 1);
+            vector_float4 color { shade, 1 - shade, float(i % 3) / 2, 1 };
+            vertices.push_back({ vector_float2 { 3, -2 }, color });
+            vertices.push_back({ vector_float2 { radius * std::cos(a0), radius * std::sin(a0) }, color });
+            vertices.push_back({ vector_float2 { radius * std::cos(a1), radius * std::sin(a1) }, color });
+        }
+        return vertices;
+    }
+
+    constexpr vector_uint2 kReferenceSize { 96, 80 };
+
+} // namespace
+
+TEST(softwareBackendMatchesTriangleReference)
+{
+    SoftwareFixture fixture(kReferenceSize);
+
+    AAPLVertex vertices[3] = {
+        { { 40, -32 }, { 1, 0, 0, 1 } },
+        { { -40, -32 }, { 0, 1, 0, 1 } },
+        { { 0, 36 }, { 0, 0, 1, 1 } },
+    };
+    CommandList list;
+    list.drawVertices(vertices, 3, fixture.pipeline);
+    fixture.render({ &list });
+
+    CHECK(fixture.matches("software_triangle"));
+}
+
+TEST(softwareBackendMatchesDrawOrderReference)
+{
+    SoftwareFixture fixture(kReferenceSize);
+
+    // Later draws cover earlier ones, and later lists cover earlier lists.
+    auto quad = [](CommandList& list, PipelineId pipeline, float x, float y, float half, vector_float4 color) {
+        AAPLVertex vertices[6] = {
+            { { x - half, y + half }, color },
+            { { x + half, y + half }, color },
+            { { x - half, y - half }, color },
+            { { x + half, y + half }, color },
+            { { x + half, y - half }, color },
+            { { x - half, y - half }, color },
+        };
+        list.drawVertices(vertices, 6, pipeline);
+    };
+
+    CommandList first;
+    quad(first, fixture.pipeline, -12, 8, 24, vector_float4 { 1, 0, 0, 1 });
+    quad(first, fixture.pipeline, 0, 0, 20, vector_float4 { 0, 1, 0, 1 });
+    CommandList second;
+    quad(second, fixture.pipeline, 14, -8, 22, vector_float4 { 0, 0, 1, 1 });
+    fixture.render({ &first, &second });
+
+    CHECK(fixture.matches("software_draw_order"));
+}
+
+TEST(softwareBackendMatchesIndexedReference)
+{
+    SoftwareFixture fixture(kReferenceSize);
+
+    // Two by two cells with a shared vertex grid, drawn from buffers.
+    std::vector<AAPLVertex> vertices;
+    for (int y = 0; y < 3; ++y)
+        for (int x = 0; x < 3; ++x)
+            vertices.push_back({ vector_float2 { float(x - 1) * 36, float(y - 1) * 30 },
+                vector_float4 { float(x) / 2, float(y) / 2, 0.5f, 1 } });
+
+    std::vector<uint16_t> indices;
+    for (uint16_t y = 0; y < 2; ++y) {
+        for (uint16_t x = 0; x < 2; ++x) {
+            uint16_t corner = y * 3 + x;
+            uint16_t cell[6] = { corner, uint16_t(corner + 1), uint16_t(corner + 3), uint16_t(corner + 1),
+                uint16_t(corner + 4), uint16_t(corner + 3) };
+            indices.insert(indices.end(), cell, cell + 6);
+        }
+    }
+
+    Mesh mesh;
+    mesh.vertexBuffer = fixture.backend.createBuffer(vertices.data(), vertices.size() * sizeof(AAPLVertex));
+    mesh.indexBuffer = fixture.backend.createBuffer(indices.data(), indices.size() * sizeof(uint16_t));
+    mesh.indexCount = uint32_t(indices.size());
+
+    CommandList list;
+    list.drawMesh(mesh, fixture.pipeline);
+    fixture.render({ &list });
+
+    CHECK(fixture.matches("software_indexed"));
+}
+
+TEST(softwareBackendMatchesFanReference)
+{
+    SoftwareFixture fixture(kReferenceSize);
+
+    std::vector<AAPLVertex> vertices = fan(kReferenceSize, 40);
+    CommandList list;
+    list.drawVertices(vertices.data(), vertices.size(), fixture.pipeline);
+    fixture.render({ &list });
+
+    CHECK(fixture.matches("software_fan"));
+}
+
+TEST(softwareBackendOutputIndependentOfThreads)
+{
+    vector_uint2 size { 300, 200 };
+    std::vector<AAPLVertex> vertices = fan(size, 500);
+
+    std::vector<uint32_t> single;
+    for (size_t threads : { 1, 3, 8 }) {
+        SoftwareFixture fixture(size, threads);
+        CommandList list;
+        list.drawVertices(vertices.data(), vertices.size(), fixture.pipeline);
+        fixture.render({ &list });
+
+        const std::vector<uint32_t>& pixels = fixture.backend.framebuffer().pixels;
+        if (single.empty())
+            single = pixels;
+        CHECK(pixels == single);
+    }
+}
+
+TEST(softwareBackendUnsupportedPipelinesDrawNothing)
+{
+    vector_uint2 size { 64, 64 };
+    SoftwareFixture fixture(size);
+
+    PipelineDesc blended;
+    blended.blend = BlendMode::Alpha;
+    PipelineDesc sprites;
+    sprites.vertexLayout = VertexLayout::AAPLSpriteVertex;
+
+    PipelineId unsupported[] = {
+        fixture.createPipeline("spriteVertexShader", "spriteFragmentShader"),
+        fixture.createPipeline("vertexShader", "fragmentShader", blended),
+        fixture.createPipeline("vertexShader", "fragmentShader", sprites),
+    };
+
+    for (PipelineId pipeline : unsupported) {
+        CommandList list;
+        fullScreenQuad(list, pipeline, size, vector_float4 { 1, 1, 1, 1 });
+        fixture.render({ &list });
+        CHECK(fixture.untouched());
+    }
+
+    // The backend keeps working with supported pipelines afterwards.
+    CommandList list;
+    fullScreenQuad(list, fixture.pipeline, size, vector_float4 { 1, 1, 1, 1 });
+    fixture.render({ &list });
+    CHECK(fixture.backend.framebuffer().pixel(10, 10) == 0xffffffff);
+}
+
+// vertexStart + vertexCount wraps around in 32 bits to a small count that
+// fits the bound vertices.
+TEST(softwareBackendSkipsDrawsPastTheVertexRange)
+{
+    vector_uint2 size { 64, 64 };
+    SoftwareFixture fixture(size);
+
+    float x = float(size[0]) / 2;
+    float y = float(size[1]) / 2;
+    vector_float4 white { 1, 1, 1, 1 };
+    AAPLVertex vertices[6] = {
+        { { -x, y }, white },
+        { { x, y }, white },
+        { { -x, -y }, white },
+        { { x, y }, white },
+        { { x, -y }, white },
+        { { -x, -y }, white },
+    };
+
+    CommandList list;
+    list.bindPipeline(fixture.pipeline);
+    list.setVertexBytes(AAPLVertexInputIndexVertices, vertices, sizeof(vertices));
+    list.draw(UINT32_MAX - 2, 6);
+    fixture.render({ &list });
+    CHECK(fixture.untouched());
+}
@@ -0,0 +1,152 @@
+#include "test.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "sprite_vertices.hpp"
+
+using namespace se;
+
+namespace {
+
+    struct Sprites {
+        std::vector<float> x, y, rotation, width, height;
+        std::vector<vector_float4> uv, color;
+
+        Sprites(size_t count, float maxRotation, uint32_t seed)
+        {
+            std::mt19937 random(seed);
+            std::uniform_real_distribution<float> position(-1000, 1000);
+            std::uniform_real_distribution<float> angle(-maxRotation, maxRotation);
+            std::uniform_real_distribution<float> size(1, 128);
+            std::uniform_real_distribution<float> unit(0, 1);
+            for (size_t i = 0; i < count; ++i) {
+                x.push_back(position(random));
+                y.push_back(position(random));
+                rotation.push_back(angle(random));
+                width.push_back(size(random));
+                height.push_back(size(random));
+                uv.push_back(vector_float4 { unit(random), unit(random), unit(random), unit(random) });
+                color.push_back(vector_float4 { unit(random), unit(random), unit(random), 1 });
+            }
+        }
+
+        // The streams of the sprites from `first` on.
+        SpriteStreams streams(size_t first = 0) const
+        {
+            return { x.data() + first, y.data() + first, rotation.data() + first, width.data() + first,
+                height.data() + first, uv.data() + first, color.data() + first };
+        }
+    };
+
+    std::vector<AAPLSpriteVertex> generate(const Sprites& sprites, size_t count)
+    {
+        std::vector<AAPLSpriteVertex> vertices(4 * count);
+        generateSpriteVertices(sprites.streams(), count, vertices.data());
+        return vertices;
+    }
+
+    // Each sprite alone: always the scalar kernel, which also does tails.
+    bool matchesScalar(const Sprites& sprites, const std::vector<AAPLSpriteVertex>& vertices)
+    {
+        for (size_t i = 0; i < vertices.size() / 4; ++i) {
+            AAPLSpriteVertex quad[4];
+            generateSpriteVertices(sprites.streams(i), 1, quad);
+            if (std::memcmp(quad, &vertices[4 * i], sizeof(quad)) != 0)
+                return false;
+        }
+        return true;
+    }
+
+    double distance(vector_float2 a, vector_float2 b)
+    {
+        return std::hypot(double(a[0]) - double(b[0]), double(a[1]) - double(b[1]));
+    }
+
+} // namespace
+
+TEST(spriteVerticesMatchDoublePrecisionRotation)
+{
+    constexpr float kRange = 8192 * 3.14159265f;
+    Sprites sprites(1003, kRange, 1);
+    std::vector<AAPLSpriteVertex> vertices = generate(sprites, 1003);
+
+    for (size_t i = 0; i < 1003; ++i) {
+        double c = std::cos(double(sprites.rotation[i]));
+        double s = std::sin(double(sprites.rotation[i]));
+        double ax = c * sprites.width[i] * 0.5, ay = s * sprites.width[i] * 0.5;
+        double bx = -s * sprites.height[i] * 0.5, by = c * sprites.height[i] * 0.5;
+        double expected[4][2] = {
+            { sprites.x[i] - ax + bx, sprites.y[i] - ay + by },
+            { sprites.x[i] + ax + bx, sprites.y[i] + ay + by },
+            { sprites.x[i] - ax - bx, sprites.y[i] - ay - by },
+            { sprites.x[i] + ax - bx, sprites.y[i] + ay - by },
+        };
+        vector_float4 uv = sprites.uv[i];
+        float corner_uv[4][2] = { { uv[0], uv[1] }, { uv[2], uv[1] }, { uv[0], uv[3] }, { uv[2], uv[3] } };
+
+        for (size_t corner = 0; corner < 4; ++corner) {
+            const AAPLSpriteVertex& vertex = vertices[4 * i + corner];
+            CHECK(test::near(vertex.position[0], expected[corner][0], 1e-3));
+            CHECK(test::near(vertex.position[1], expected[corner][1], 1e-3));
+            CHECK(vertex.uv[0] == corner_uv[corner][0] && vertex.uv[1] == corner_uv[corner][1]);
+            CHECK(std::memcmp(&vertex.color, &sprites.color[i], sizeof(vector_float4)) == 0);
+        }
+    }
+}
+
+TEST(spriteVerticesKernelsAreBitIdentical)
+{
+    Sprites sprites(1003, 100, 2);
+    CHECK(matchesScalar(sprites, generate(sprites, 1003)));
+}
+
+// Rotations beyond the polynomial's range used to overflow the quadrant.
+TEST(spriteVerticesReduceHugeRotations)
+{
+    Sprites sprites(64, 10, 3);
+    const float huge[] = { 3.5e9f, -3.5e9f, 1e12f, -1e30f, 3e38f, 25736.0f, -1e5f };
+    for (size_t i = 0; i < std::size(huge); ++i)
+        sprites.rotation[9 * i] = huge[i];
+
+    std::vector<AAPLSpriteVertex> vertices = generate(sprites, 64);
+    CHECK(matchesScalar(sprites, vertices));
+    for (size_t i = 0; i < 64; ++i) {
+        const AAPLSpriteVertex* quad = &vertices[4 * i];
+        // Still a rectangle of the sprite's size.
+        CHECK(test::near(distance(quad[0].position, quad[1].position), sprites.width[i], 1e-3));
+        CHECK(test::near(distance(quad[0].position, quad[2].position), sprites.height[i], 1e-3));
+    }
+}
+
+TEST(spriteVerticesPassNonFiniteRotationsThrough)
+{
+    Sprites sprites(16, 10, 4);
+    sprites.rotation[3] = std::numeric_limits<float>::infinity();
+    sprites.rotation[12] = std::numeric_limits<float>::quiet_NaN();
+
+    std::vector<AAPLSpriteVertex> vertices = generate(sprites, 16);
+    for (size_t i = 0; i < 16; ++i) {
+        bool finite = std::isfinite(vertices[4 * i].position[0]) && std::isfinite(vertices[4 * i + 3].position[1]);
+        CHECK(finite == (i != 3 && i != 12));
+    }
+}
+
+TEST(spriteVerticesLeaveMemoryPastTheEndAlone)
+{
+    Sprites sprites(20, 10, 5);
+    for (size_t count = 0; count <= 17; ++count) {
+        std::vector<AAPLSpriteVertex> vertices(4 * count + 4);
+        std::memset(vertices.data(), 0x7b, vertices.size() * sizeof(AAPLSpriteVertex));
+        generateSpriteVertices(sprites.streams(), count, vertices.data());
+
+        unsigned char guard[4 * sizeof(AAPLSpriteVertex)];
+        std::memset(guard, 0x7b, sizeof(guard));
+        CHECK(std::memcmp(&vertices[4 * count], guard, sizeof(guard)) == 0);
+        vertices.resize(4 * count);
+        CHECK(matchesScalar(sprites, vertices));
+    }
+}
@@ -0,0 +1,204 @@
+#include "test.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <vector>
+
+#include "culling.hpp"
+#include "system_scheduler.hpp"
+
+using namespace se;
+
+namespace {
+
+    struct Position {
+        float x;
+        float y;
+    };
+
+    struct Motion {
+        float dx;
+        float dy;
+    };
+
+    struct Health {
+        int32_t points;
+    };
+
+    struct Score {
+        uint64_t value;
+    };
+
+    struct Age {
+        uint32_t frames;
+    };
+
+    struct Visibility {
+        uint32_t visibleNeighbors;
+    };
+
+    constexpr size_t kEntities = 2000;
+
+    struct World {
+        entt::registry registry;
+        std::vector<entt::entity> entities;
+        BoundsCuller culler;
+        std::vector<uint32_t> visible;
+
+        World()
+        {
+            for (size_t i = 0; i < kEntities; ++i)
+                spawn(uint32_t(i));
+        }
+
+        void spawn(uint32_t seed)
+        {
+            entt::entity entity = registry.create();
+            registry.emplace<Position>(entity, float(seed % 97) * 3.0f - 150, float(seed % 89) * 2.0f - 90);
+            registry.emplace<Motion>(entity, float(seed % 7) - 3, float(seed % 5) - 2);
+            registry.emplace<Health>(entity, int32_t(50 + seed % 50));
+            registry.emplace<Score>(entity, uint64_t(0));
+            registry.emplace<Age>(entity, 0u);
+            registry.emplace<Visibility>(entity, 0u);
+            entities.push_back(entity);
+        }
+
+        // FNV-1a over every component of every entity, in creation order.
+        uint64_t hash()
+        {
+            uint64_t hash = 14695981039346656037ull;
+            auto mix = [&hash](const auto& component) {
+                unsigned char bytes[sizeof(component)];
+                std::memcpy(bytes, &component, sizeof(component));
+                for (unsigned char byte : bytes)
+                    hash = (hash ^ byte) * 1099511628211ull;
+            };
+            for (entt::entity entity : entities) {
+                mix(registry.get<Position>(entity));
+                mix(registry.get<Motion>(entity));
+                mix(registry.get<Health>(entity));
+                mix(registry.get<Score>(entity));
+                mix(registry.get<Age>(entity));
+                mix(registry.get<Visibility>(entity));
+            }
+            return hash;
+        }
+    };
+
+    // Systems whose results depend on the order of conflicting ones. The
+    // culling system runs its own loop on `pool`, which must not deadlock
+    // with the scheduler running on the same pool.
+    void addSystems(SystemScheduler& scheduler, World& world, ThreadPool* pool)
+    {
+        scheduler.add("movement", SystemAccess().writes<Position>().reads<Motion>(), [](entt::registry& registry, float dt) {
+            registry.view<Position, const Motion>().each([dt](entt::entity, Position& position, const Motion& motion) {
+                position.x += motion.dx * dt;
+                position.y += motion.dy * dt;
+            });
+        });
+        scheduler.add("bounce", SystemAccess().writes<Motion>().reads<Position>(), [](entt::registry& registry, float) {
+            registry.view<Motion, const Position>().each([](entt::entity, Motion& motion, const Position& position) {
+                if (position.x < -200 || position.x > 200)
+                    motion.dx = -motion.dx;
+                if (position.y < -120 || position.y > 120)
+                    motion.dy = -motion.dy;
+            });
+        });
+        scheduler.add("damage", SystemAccess().writes<Health>().reads<Position>(), [](entt::registry& registry, float) {
+            registry.view<Health, const Position>().each([](entt::entity, Health& health, const Position& position) {
+                if (position.x > 0)
+                    health.points -= 3;
+            });
+        });
+        scheduler.add("regeneration", SystemAccess().writes<Health>(), [](entt::registry& registry, float) {
+            registry.view<Health>().each([](entt::entity, Health& health) {
+                health.points = health.points < 0 ? 100 : health.points + 1;
+            });
+        });
+        scheduler.add("scoring", SystemAccess().writes<Score>().reads<Health, Age>(), [](entt::registry& registry, float) {
+            registry.view<Score, const Health, const Age>().each(
+                [](entt::entity, Score& score, const Health& health, const Age& age) {
+                    score.value = score.value * 31 + uint64_t(health.points) + age.frames;
+                });
+        });
+        scheduler.add("aging", SystemAccess().writes<Age>(), [](entt::registry& registry, float) {
+            registry.view<Age>().each([](entt::entity, Age& age) { ++age.frames; });
+        });
+        scheduler.add("visibility", SystemAccess().writes<Visibility>().reads<Position>(),
+            [&world, pool](entt::registry& registry, float) {
+                world.culler.clear();
+                for (entt::entity entity : world.entities) {
+                    const Position& position = registry.get<Position>(entity);
+                    world.culler.add({ position.x, position.y, position.x + 4, position.y + 4 });
+                }
+                CullRect view { -50, -50, 50, 50 };
+                if (pool)
+                    world.culler.cull(view, world.visible, *pool);
+                else
+                    world.culler.cull(view, world.visible);
+                uint32_t visible = uint32_t(world.visible.size());
+                registry.view<Visibility>().each([visible](entt::entity, Visibility& visibility) {
+                    visibility.visibleNeighbors = visible;
+                });
+            });
+        scheduler.add("spawn", SystemAccess().exclusive(), [&world](entt::registry& registry, float) {
+            if (registry.get<Age>(world.entities.front()).frames % 4 == 0)
+                world.spawn(uint32_t(world.entities.size()));
+        });
+    }
+
+} // namespace
+
+TEST(systemSchedulerPooledRunsMatchSerialRuns)
+{
+    World serial_world;
+    SystemScheduler serial;
+    addSystems(serial, serial_world, nullptr);
+
+    std::vector<uint64_t> hashes;
+    for (int frame = 0; frame < 30; ++frame) {
+        serial.run(serial_world.registry, 0.5f);
+        hashes.push_back(serial_world.hash());
+    }
+
+    for (size_t threads : { 2, 3, 8 }) {
+        ThreadPool pool(threads);
+        World world;
+        SystemScheduler scheduler;
+        addSystems(scheduler, world, &pool);
+
+        for (int frame = 0; frame < 30; ++frame) {
+            scheduler.run(world.registry, 0.5f, pool);
+            CHECK(world.hash() == hashes[size_t(frame)]);
+        }
+        CHECK(world.entities.size() == serial_world.entities.size());
+    }
+}
+
+TEST(systemSchedulerOrdersConflictingSystems)
+{
+    World world;
+    SystemScheduler scheduler;
+    addSystems(scheduler, world, nullptr);
+
+    // Each system waits for the earlier ones touching its components, and
+    // the exclusive spawn waits for everything.
+    CHECK((scheduler.dependencies(1) == std::vector<size_t> { 0 }));
+    CHECK((scheduler.dependencies(2) == std::vector<size_t> { 0 }));
+    CHECK((scheduler.dependencies(3) == std::vector<size_t> { 2 }));
+    CHECK((scheduler.dependencies(4) == std::vector<size_t> { 2, 3 }));
+    CHECK((scheduler.dependencies(5) == std::vector<size_t> { 4 }));
+    CHECK((scheduler.dependencies(6) == std::vector<size_t> { 0 }));
+    CHECK(scheduler.dependencies(7).size() == 7);
+}
+
+TEST(threadPoolNestedLoopsRunInline)
+{
+    ThreadPool pool(4);
+    std::vector<std::atomic<uint32_t>> counts(64);
+    pool.parallelFor(8, [&](size_t outer) {
+        pool.parallelFor(8, [&](size_t inner) { counts[outer * 8 + inner].fetch_add(1); });
+    });
+    for (const std::atomic<uint32_t>& count : counts)
+        CHECK(count.load() == 1);
+}
@@ -0,0 +1,173 @@
+#include "test.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "task_scheduler.hpp"
+
+using namespace se;
+
+namespace {
+
+    struct Checks {
+        std::thread::id main_thread { std::this_thread::get_id() };
+        uint64_t frame { 0 };
+        std::atomic<uint32_t> wrong_thread { 0 };
+        std::atomic<uint32_t> early { 0 };
+        std::atomic<uint32_t> late { 0 };
+
+        void onMain()
+        {
+            if (std::this_thread::get_id() != main_thread)
+                wrong_thread.fetch_add(1, std::memory_order_relaxed);
+        }
+    };
+
+    Task<int> square(TaskScheduler& scheduler, int value)
+    {
+        co_await scheduler.nextFrame();
+        co_return value * value;
+    }
+
+    // Awaits nested tasks twice over, once on a worker.
+    Task<int> sumOfSquares(TaskScheduler& scheduler, int a, int b)
+    {
+        int first = co_await square(scheduler, a);
+        co_await scheduler.onWorker();
+        int second = co_await square(scheduler, b);
+        co_return first + second;
+    }
+
+    Task<> roundTrip(TaskScheduler& scheduler, Checks& checks, int index, std::vector<int>& results)
+    {
+        // nextFrame resumes at exactly the next pump, on the main thread.
+        uint64_t frame = checks.frame;
+        co_await scheduler.nextFrame();
+        checks.onMain();
+        if (checks.frame != frame + 1)
+            checks.early.fetch_add(1, std::memory_order_relaxed);
+
+        // delay resumes at the first pump that reaches the deadline.
+        double delay = double(index % 13) * 2.5;
+        double start = scheduler.time();
+        co_await scheduler.delay(delay);
+        checks.onMain();
+        if (scheduler.time() < start + delay)
+            checks.early.fetch_add(1, std::memory_order_relaxed);
+        else if (delay > 0 && scheduler.time() >= start + delay + 1.0)
+            checks.late.fetch_add(1, std::memory_order_relaxed);
+
+        co_await scheduler.onWorker();
+        if (std::this_thread::get_id() == checks.main_thread)
+            checks.wrong_thread.fetch_add(1, std::memory_order_relaxed);
+        co_await scheduler.onMainThread();
+        checks.onMain();
+
+        int squares = co_await sumOfSquares(scheduler, index % 100, 3);
+        co_await scheduler.onMainThread();
+        checks.onMain();
+        results[size_t(index)] = squares;
+
+        // Already on the main thread: continues without waiting for a pump.
+        frame = checks.frame;
+        co_await scheduler.onMainThread();
+        if (checks.frame != frame)
+            checks.late.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    Task<> nested(TaskScheduler& scheduler, int depth, int& result)
+    {
+        if (depth == 0) {
+            co_await scheduler.nextFrame();
+            result = 1;
+            co_return;
+        }
+        int inner = 0;
+        co_await nested(scheduler, depth - 1, inner);
+        result = inner + 1;
+    }
+
+} // namespace
+
+TEST(taskSchedulerRunsThousandsOfTasksToCompletion)
+{
+    constexpr int kTasks = 4000;
+    TaskScheduler scheduler(4);
+    Checks checks;
+    std::vector<int> results(kTasks, -1);
+
+    for (int i = 0; i < kTasks; ++i)
+        scheduler.spawn(roundTrip(scheduler, checks, i, results));
+    CHECK(scheduler.activeTasks() == size_t(kTasks));
+
+    // Pumps until every task finished, waiting a little for workers between
+    // frames; a stuck task fails instead of hanging.
+    for (int frame = 0; frame < 20000 && scheduler.activeTasks() > 0; ++frame) {
+        ++checks.frame;
+        scheduler.pump(1.0);
+        if (frame > 40)
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+
+    CHECK(scheduler.activeTasks() == 0);
+    CHECK(checks.wrong_thread.load() == 0);
+    CHECK(checks.early.load() == 0);
+    CHECK(checks.late.load() == 0);
+    for (int i = 0; i < kTasks; ++i)
+        CHECK(results[size_t(i)] == (i % 100) * (i % 100) + 9);
+}
+
+TEST(taskSchedulerResumesDelaysInDeadlineOrder)
+{
+    TaskScheduler scheduler;
+    std::vector<int> order;
+    auto waiter = [](TaskScheduler& scheduler, std::vector<int>& order, double delay, int id) -> Task<> {
+        co_await scheduler.delay(delay);
+        order.push_back(id);
+    };
+    scheduler.spawn(waiter(scheduler, order, 30, 3));
+    scheduler.spawn(waiter(scheduler, order, 10, 1));
+    scheduler.spawn(waiter(scheduler, order, 10, 2));
+    scheduler.spawn(waiter(scheduler, order, 0, 0));
+
+    scheduler.pump(0);
+    CHECK((order == std::vector<int> { 0 }));
+    scheduler.pump(9.5);
+    CHECK((order == std::vector<int> { 0 }));
+    scheduler.pump(0.5);
+    CHECK((order == std::vector<int> { 0, 1, 2 }));
+    scheduler.pump(100);
+    CHECK((order == std::vector<int> { 0, 1, 2, 3 }));
+    CHECK(scheduler.activeTasks() == 0);
+}
+
+TEST(taskSchedulerDeeplyNestedTasks)
+{
+    TaskScheduler scheduler;
+    int result = 0;
+    scheduler.spawn(nested(scheduler, 500, result));
+    scheduler.pump(1);
+    CHECK(result == 0);
+    scheduler.pump(1);
+    CHECK(result == 501);
+    CHECK(scheduler.activeTasks() == 0);
+}
+
+TEST(taskSchedulerDestroysUnfinishedTasks)
+{
+    int finished = 0;
+    {
+        TaskScheduler scheduler(2);
+        auto forever = [](TaskScheduler& scheduler, int& finished) -> Task<> {
+            co_await scheduler.delay(1e9);
+            ++finished;
+        };
+        for (int i = 0; i < 100; ++i)
+            scheduler.spawn(forever(scheduler, finished));
+        scheduler.pump(1);
+        CHECK(scheduler.activeTasks() == 100);
+    }
+    CHECK(finished == 0);
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cmath>
+
+namespace se::test {
+
+using TestFunction = void (*)();
+
+// Adds a test to the list main() runs; see TEST.
+struct Registration {
+    Registration(const char* name, TestFunction function);
+};
+
+// Records a failed CHECK against the running test; the test keeps going.
+void fail(const char* expression, const char* file, int line);
+
+inline bool near(double a, double b, double tolerance)
+{
+    return std::abs(a - b) <= tolerance;
+}
+
+} // namespace se::test
+
+// Defines a test. Tests run in registration order, each file's in the order
+// they appear, and must not depend on each other.
+#define TEST(name)                                                        \
+    static void name##_test();                                            \
+    static se::test::Registration name##_registration(#name, name##_test); \
+    static void name##_test()
+
+#define CHECK(...)                                        \
+    do {                                                  \
+        if (!(__VA_ARGS__))                               \
+            se::test::fail(#__VA_ARGS__, __FILE__, __LINE__); \
+    } while (false)
@@ -0,0 +1,135 @@
+#include "test.hpp"
+
+#include <unordered_map>
+#include <vector>
+
+#include "null_render_backend.hpp"
+#include "texture_atlas.hpp"
+
+using namespace se;
+
+namespace {
+
+    // Keeps what the atlas uploads, so tests can look at page contents.
+    class RecordingBackend : public NullRenderBackend {
+    public:
+        RecordingBackend()
+            : NullRenderBackend(vector_uint2 { 640, 480 })
+        {
+        }
+
+        TextureId createTexture(uint32_t width, uint32_t height) override
+        {
+            TextureId texture = NullRenderBackend::createTexture(width, height);
+            pages[texture] = { width, std::vector<uint32_t>(size_t(width) * height, 0xdeadbeef) };
+            return texture;
+        }
+
+        void updateTexture(TextureId texture, uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+            const uint32_t* pixels, uint32_t stride) override
+        {
+            NullRenderBackend::updateTexture(texture, x, y, width, height, pixels, stride);
+            Page& page = pages.at(texture);
+            for (uint32_t row = 0; row < height; ++row) {
+                for (uint32_t column = 0; column < width; ++column)
+                    page.pixels[size_t(y + row) * page.width + x + column] = pixels[size_t(row) * stride + column];
+            }
+        }
+
+        uint32_t pixel(TextureId texture, uint32_t x, uint32_t y) const
+        {
+            const Page& page = pages.at(texture);
+            return page.pixels[size_t(y) * page.width + x];
+        }
+
+        struct Page {
+            uint32_t width;
+            std::vector<uint32_t> pixels;
+        };
+        std::unordered_map<TextureId, Page> pages;
+    };
+
+    std::vector<uint32_t> image(uint32_t width, uint32_t height, uint32_t color)
+    {
+        return std::vector<uint32_t>(size_t(width) * height, color);
+    }
+
+    bool overlaps(const AtlasRegion& a, const AtlasRegion& b, uint32_t padding)
+    {
+        return a.page == b.page
+            && a.x < b.x + b.width + 2 * padding && b.x < a.x + a.width + 2 * padding
+            && a.y < b.y + b.height + 2 * padding && b.y < a.y + a.height + 2 * padding;
+    }
+
+} // namespace
+
+TEST(textureAtlasSurroundsEntriesWithTransparentPadding)
+{
+    RecordingBackend backend;
+    TextureAtlas atlas(backend, 64, 1, 2);
+    std::vector<uint32_t> red = image(5, 3, 0xff0000ff);
+    AtlasEntryId entry = atlas.insert(5, 3, red.data(), 5);
+    atlas.upload();
+
+    const AtlasRegion* region = atlas.region(entry);
+    CHECK(region->width == 5 && region->height == 3);
+    CHECK(region->x >= 2 && region->y >= 2);
+    CHECK(test::near(region->uv[0], region->x / 64.0f, 1e-6f));
+    CHECK(test::near(region->uv[3], (region->y + 3) / 64.0f, 1e-6f));
+
+    for (uint32_t y = region->y - 2; y < region->y + 5; ++y) {
+        for (uint32_t x = region->x - 2; x < region->x + 7; ++x) {
+            bool inside = x >= region->x && x < region->x + 5 && y >= region->y && y < region->y + 3;
+            CHECK(backend.pixel(region->texture, x, y) == (inside ? 0xff0000ff : 0u));
+        }
+    }
+}
+
+TEST(textureAtlasEntriesKeepTheirPaddingApart)
+{
+    RecordingBackend backend;
+    TextureAtlas atlas(backend, 128, 2, 1);
+    std::vector<uint32_t> pixels = image(32, 32, 0xffffffff);
+
+    std::vector<AtlasEntryId> entries;
+    for (uint32_t size = 3; size < 32; size += 2) {
+        for (int copy = 0; copy < 4; ++copy)
+            entries.push_back(atlas.insert(size, 32 - size, pixels.data(), 32));
+    }
+
+    for (size_t i = 0; i < entries.size(); ++i) {
+        CHECK(entries[i].valid());
+        for (size_t j = i + 1; j < entries.size(); ++j)
+            CHECK(!overlaps(*atlas.region(entries[i]), *atlas.region(entries[j]), 1));
+    }
+    CHECK(atlas.pageCount() == 2);
+}
+
+TEST(textureAtlasEvictionFreesSpaceForNewEntries)
+{
+    RecordingBackend backend;
+    TextureAtlas atlas(backend, 32, 1, 1);
+    std::vector<uint32_t> blue = image(14, 14, 0xffff0000);
+    std::vector<AtlasEntryId> entries;
+    for (AtlasEntryId entry = atlas.insert(14, 14, blue.data(), 14); entry.valid(); entry = atlas.insert(14, 14, blue.data(), 14))
+        entries.push_back(entry);
+    CHECK(entries.size() == 4);
+    CHECK(atlas.stats().failedInserts == 1);
+
+    AtlasRegion evicted = *atlas.region(entries[2]);
+    atlas.remove(entries[2]);
+    CHECK(atlas.region(entries[2]) == nullptr);
+    CHECK(atlas.entryCount() == 3);
+
+    // The new, smaller entry lands in the evicted space; the old pixels
+    // around it are cleared.
+    std::vector<uint32_t> green = image(10, 10, 0xff00ff00);
+    AtlasEntryId reused = atlas.insert(10, 10, green.data(), 10);
+    CHECK(reused.valid());
+    atlas.upload();
+    const AtlasRegion* region = atlas.region(reused);
+    CHECK(region->x == evicted.x && region->y == evicted.y);
+    CHECK(backend.pixel(region->texture, region->x + 9, region->y + 9) == 0xff00ff00);
+    CHECK(backend.pixel(region->texture, region->x + 10, region->y + 10) == 0u);
+    CHECK(backend.pixel(region->texture, evicted.x + 13, evicted.y + 13) == 0xffff0000);
+}
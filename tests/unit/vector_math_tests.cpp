@@ -0,0 +1,330 @@
+#include "test.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "vector_math.hpp"
+
+using namespace se;
+
+// Every test here also runs in the scalar and, where the CPU has it, AVX
+// builds of the vector math (see CMakeLists.txt), against the same
+// double-precision references.
+
+namespace {
+
+    struct Random {
+        uint32_t state;
+
+        float next(float low = -10, float high = 10)
+        {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return low + (high - low) * float(state >> 8) / float(1 << 24);
+        }
+
+        Vec4 vec4()
+        {
+            return { next(), next(), next(), next() };
+        }
+
+        Mat4 mat4()
+        {
+            Mat4 m;
+            for (Vec4& column : m.columns)
+                column = vec4();
+            return m;
+        }
+
+        Mat3 affine()
+        {
+            Mat3 m;
+            m.columns[0] = { next(), next(), 0 };
+            m.columns[1] = { next(), next(), 0 };
+            m.columns[2] = { next(), next(), 1 };
+            return m;
+        }
+
+        Quat rotation()
+        {
+            Vec3 axis = normalize(Vec3(next(), next(), next()));
+            return Quat::axisAngle(axis, next(-3.14f, 3.14f));
+        }
+    };
+
+    // A sum of products computed in double, with the sum of their
+    // magnitudes, which bounds the float rounding error of any order of
+    // evaluation.
+    struct Exact {
+        double value { 0 };
+        double magnitude { 0 };
+
+        void add(double a, double b)
+        {
+            value += a * b;
+            magnitude += std::abs(a * b);
+        }
+
+        bool matches(float result) const
+        {
+            return std::abs(double(result) - value) <= 4e-6 * magnitude + 1e-6;
+        }
+    };
+
+    Exact exactRow(const Mat4& m, int row, Vec4 v)
+    {
+        Exact e;
+        for (int c = 0; c < 4; ++c)
+            e.add(m.columns[c][size_t(row)], v[size_t(c)]);
+        return e;
+    }
+
+    bool matchesProduct(const Mat4& m, Vec4 v, Vec4 result)
+    {
+        for (int row = 0; row < 4; ++row)
+            if (!exactRow(m, row, v).matches(result[size_t(row)]))
+                return false;
+        return true;
+    }
+
+    bool matchesAffine(const Mat3& m, Vec2 p, Vec2 result)
+    {
+        for (size_t row = 0; row < 2; ++row) {
+            Exact e;
+            e.add(m.columns[0][row], p.x);
+            e.add(m.columns[1][row], p.y);
+            e.add(m.columns[2][row], 1);
+            if (!e.matches(result[row]))
+                return false;
+        }
+        return true;
+    }
+
+    bool near(Vec3 a, Vec3 b, double tolerance)
+    {
+        return test::near(a.x, b.x, tolerance) && test::near(a.y, b.y, tolerance) && test::near(a.z, b.z, tolerance);
+    }
+
+    // Batch sizes covering every tail length of the widest kernel, then
+    // one with many full iterations.
+    constexpr size_t kBatchSizes[] = { 0, 1, 2, 3, 4, 5, 6, 7, 1001 };
+
+    // Written past the end of each output batch; the kernels must leave
+    // it alone.
+    constexpr float kGuard = 12345.0f;
+
+} // namespace
+
+TEST(vectorMathReportsTheCompiledPath)
+{
+    const char* name = vectorMathSimdName();
+#if defined(SE_VECTOR_MATH_SCALAR)
+    CHECK(std::strcmp(name, "scalar") == 0);
+#elif defined(__AVX__)
+    CHECK(std::strcmp(name, "avx") == 0);
+#elif defined(__SSE2__)
+    CHECK(std::strcmp(name, "sse2") == 0);
+#else
+    CHECK(name != nullptr);
+#endif
+}
+
+TEST(vectorMathVec3AndVec4Operations)
+{
+    Random random { 1 };
+    for (int i = 0; i < 10000; ++i) {
+        Vec4 a = random.vec4();
+        Vec4 b = random.vec4();
+        float s = random.next();
+
+        Vec4 sum = a + b;
+        Vec4 product = a * b;
+        Vec4 scaled = a * s;
+        Vec4 low = min(a, b);
+        Vec4 high = max(a, b);
+        Exact dot4;
+        for (size_t c = 0; c < 4; ++c) {
+            CHECK(sum[c] == a[c] + b[c]);
+            CHECK(product[c] == a[c] * b[c]);
+            CHECK(scaled[c] == a[c] * s);
+            CHECK(low[c] == std::fmin(a[c], b[c]));
+            CHECK(high[c] == std::fmax(a[c], b[c]));
+            dot4.add(a[c], b[c]);
+        }
+        CHECK(dot4.matches(dot(a, b)));
+
+        Vec3 a3 = a.xyz();
+        Vec3 b3 = b.xyz();
+        Vec3 difference = a3 - b3;
+        CHECK(difference.unused == 0);
+        CHECK((difference == Vec3(a.x - b.x, a.y - b.y, a.z - b.z)));
+
+        Exact dot3;
+        for (size_t c = 0; c < 3; ++c)
+            dot3.add(a3[c], b3[c]);
+        CHECK(dot3.matches(dot(a3, b3)));
+
+        Vec3 crossed = cross(a3, b3);
+        CHECK(test::near(dot(crossed, a3), 0, 1e-4 * length(crossed) * length(a3) + 1e-4));
+        CHECK(test::near(length(normalize(a3)), 1, 1e-5));
+    }
+}
+
+TEST(vectorMathMatrixProducts)
+{
+    Random random { 2 };
+    for (int i = 0; i < 10000; ++i) {
+        Mat4 a = random.mat4();
+        Mat4 b = random.mat4();
+        Vec4 v = random.vec4();
+        CHECK(matchesProduct(a, v, a * v));
+
+        Mat4 ab = a * b;
+        for (int c = 0; c < 4; ++c)
+            CHECK(matchesProduct(a, b.columns[c], ab.columns[c]));
+
+        Mat3 m = random.affine();
+        Vec2 p(random.next(), random.next());
+        CHECK(matchesAffine(m, p, transformPoint(m, p)));
+        Vec3 p3 = m * Vec3(p, 1);
+        CHECK(p3.unused == 0);
+        CHECK(matchesAffine(m, p, p3.xy()));
+    }
+}
+
+TEST(vectorMathInverses)
+{
+    Random random { 3 };
+    for (int i = 0; i < 1000; ++i) {
+        Mat4 m = Mat4::translation(Vec3(random.next(), random.next(), random.next()))
+            * Mat4::rotation(random.rotation()) * Mat4::scale(Vec3(random.next(0.5f, 2), random.next(0.5f, 2), random.next(0.5f, 2)));
+        Mat4 identity = m * inverse(m);
+        for (size_t c = 0; c < 4; ++c)
+            for (size_t r = 0; r < 4; ++r)
+                CHECK(test::near(identity.columns[c][r], c == r ? 1 : 0, 1e-4));
+
+        Mat3 affine = Mat3::translation(Vec2(random.next(), random.next())) * Mat3::rotation(random.next())
+            * Mat3::scale(Vec2(random.next(0.5f, 2), random.next(0.5f, 2)));
+        Mat3 identity3 = inverse(affine) * affine;
+        for (size_t c = 0; c < 3; ++c)
+            for (size_t r = 0; r < 3; ++r)
+                CHECK(test::near(identity3.columns[c][r], c == r ? 1 : 0, 1e-4));
+    }
+}
+
+TEST(vectorMathQuaternionsMatchRotationMatrices)
+{
+    Random random { 4 };
+    for (int i = 0; i < 10000; ++i) {
+        Quat a = random.rotation();
+        Quat b = random.rotation();
+        Vec3 v(random.next(), random.next(), random.next());
+
+        Vec3 by_matrix = transformPoint(Mat4::rotation(a), v);
+        CHECK(near(rotate(a, v), by_matrix, 1e-4 * length(v)));
+        CHECK(near(rotate(a * b, v), rotate(a, rotate(b, v)), 1e-4 * length(v)));
+
+        Quat half = slerp(a, b, 0.5f);
+        CHECK(test::near(dot(half, half), 1, 1e-4));
+        Quat start = slerp(a, b, 0);
+        CHECK(test::near(std::abs(dot(start, a)), 1, 1e-4));
+    }
+}
+
+TEST(vectorMathBoxTransformContainsCorners)
+{
+    Random random { 5 };
+    for (int i = 0; i < 1000; ++i) {
+        AABB box;
+        box.merge(Vec3(random.next(), random.next(), random.next()));
+        box.merge(Vec3(random.next(), random.next(), random.next()));
+        Mat4 m = Mat4::translation(Vec3(random.next(), random.next(), random.next())) * Mat4::rotation(random.rotation());
+
+        AABB transformed = transform(m, box);
+        AABB corners;
+        for (int corner = 0; corner < 8; ++corner) {
+            Vec3 point(corner & 1 ? box.max.x : box.min.x, corner & 2 ? box.max.y : box.min.y, corner & 4 ? box.max.z : box.min.z);
+            corners.merge(transformPoint(m, point));
+        }
+        CHECK(near(transformed.min, corners.min, 1e-3));
+        CHECK(near(transformed.max, corners.max, 1e-3));
+    }
+    CHECK(transform(Mat4::identity(), AABB()).empty());
+}
+
+TEST(vectorMathBatchedPointTransforms)
+{
+    Random random { 6 };
+    for (size_t count : kBatchSizes) {
+        Mat4 m = random.mat4();
+        std::vector<Vec4> points(count + 1);
+        for (Vec4& point : points)
+            point = random.vec4();
+
+        std::vector<Vec4> out(count + 1, Vec4(kGuard));
+        transformPoints(m, points.data(), out.data(), count);
+        for (size_t i = 0; i < count; ++i)
+            CHECK(matchesProduct(m, points[i], out[i]));
+        CHECK((out[count] == Vec4(kGuard)));
+
+        // In place.
+        std::vector<Vec4> in_place = points;
+        transformPoints(m, in_place.data(), in_place.data(), count);
+        for (size_t i = 0; i < count; ++i)
+            CHECK(matchesProduct(m, points[i], in_place[i]));
+        CHECK((in_place[count] == points[count]));
+    }
+}
+
+TEST(vectorMathBatchedAffineTransforms)
+{
+    Random random { 7 };
+    for (size_t count : kBatchSizes) {
+        Mat3 m = random.affine();
+        std::vector<Vec2> points(count + 1);
+        for (Vec2& point : points)
+            point = Vec2(random.next(), random.next());
+
+        std::vector<Vec2> out(count + 1, Vec2(kGuard));
+        transformPoints(m, points.data(), out.data(), count);
+        for (size_t i = 0; i < count; ++i)
+            CHECK(matchesAffine(m, points[i], out[i]));
+        CHECK((out[count] == Vec2(kGuard)));
+
+        std::vector<Vec2> in_place = points;
+        transformPoints(m, in_place.data(), in_place.data(), count);
+        for (size_t i = 0; i < count; ++i)
+            CHECK(matchesAffine(m, points[i], in_place[i]));
+        CHECK((in_place[count] == points[count]));
+    }
+}
+
+TEST(vectorMathBatchedMatrixProducts)
+{
+    Random random { 8 };
+    for (size_t count : kBatchSizes) {
+        std::vector<Mat4> a(count);
+        std::vector<Mat4> b(count);
+        for (size_t i = 0; i < count; ++i) {
+            a[i] = random.mat4();
+            b[i] = random.mat4();
+        }
+
+        std::vector<Mat4> out(count + 1);
+        out[count].columns[0] = Vec4(kGuard);
+        multiplyMatrices(a.data(), b.data(), out.data(), count);
+        for (size_t i = 0; i < count; ++i)
+            for (int c = 0; c < 4; ++c)
+                CHECK(matchesProduct(a[i], b[i].columns[c], out[i].columns[c]));
+        CHECK((out[count].columns[0] == Vec4(kGuard)));
+
+        std::vector<Mat4> in_place = a;
+        multiplyMatrices(in_place.data(), b.data(), in_place.data(), count);
+        for (size_t i = 0; i < count; ++i)
+            for (int c = 0; c < 4; ++c)
+                CHECK(matchesProduct(a[i], b[i].columns[c], in_place[i].columns[c]));
+    }
+}
@@ -0,0 +1,143 @@
+#include "test.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <initializer_list>
+#include <limits>
+
+#include "vertex_packing.hpp"
+
+using namespace se;
+
+namespace {
+
+    float fromBits(uint32_t bits)
+    {
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    bool isHalfNaN(uint16_t half)
+    {
+        return (half & 0x7c00) == 0x7c00 && (half & 0x3ff) != 0;
+    }
+
+    AAPLSpriteVertex spriteVertex(vector_float2 position, vector_float2 uv, vector_float4 color)
+    {
+        AAPLSpriteVertex vertex;
+        vertex.position = position;
+        vertex.uv = uv;
+        vertex.color = color;
+        return vertex;
+    }
+
+} // namespace
+
+TEST(floatToHalfConvertsOrdinaryValues)
+{
+    CHECK(floatToHalf(0.0f) == 0x0000);
+    CHECK(floatToHalf(-0.0f) == 0x8000);
+    CHECK(floatToHalf(1.0f) == 0x3c00);
+    CHECK(floatToHalf(-2.0f) == 0xc000);
+    CHECK(floatToHalf(0.5f) == 0x3800);
+    CHECK(floatToHalf(65504.0f) == 0x7bff);
+    CHECK(floatToHalf(0x1p-14f) == 0x0400);
+
+    // Halfway cases round to the even mantissa.
+    CHECK(floatToHalf(1.0f + 0x1p-11f) == 0x3c00);
+    CHECK(floatToHalf(1.0f + 3 * 0x1p-11f) == 0x3c02);
+
+    for (float value : { 1.0f / 3, 3.14159f, -1234.5678f, 0.001f, 40000.0f }) {
+        float back = halfToFloat(floatToHalf(value));
+        CHECK(std::fabs(back - value) <= std::fabs(value) * 0x1p-11f);
+    }
+}
+
+TEST(floatToHalfKeepsDenormals)
+{
+    CHECK(floatToHalf(0x1p-24f) == 0x0001);
+    CHECK(floatToHalf(-0x1p-24f) == 0x8001);
+    CHECK(floatToHalf(0x3ffp-24f) == 0x03ff);
+    CHECK(floatToHalf(0x1.8p-24f) == 0x0002);
+    // Below half the smallest denormal, and exactly half of it (even: 0).
+    CHECK(floatToHalf(0x1p-26f) == 0x0000);
+    CHECK(floatToHalf(0x1p-25f) == 0x0000);
+    CHECK(floatToHalf(-0x1p-26f) == 0x8000);
+
+    CHECK(halfToFloat(0x0001) == 0x1p-24f);
+    CHECK(halfToFloat(0x83ff) == -0x3ffp-24f);
+}
+
+TEST(floatToHalfOverflowsToInfinity)
+{
+    constexpr float kInfinity = std::numeric_limits<float>::infinity();
+    CHECK(floatToHalf(65520.0f) == 0x7c00);
+    CHECK(floatToHalf(1e6f) == 0x7c00);
+    CHECK(floatToHalf(-1e30f) == 0xfc00);
+    CHECK(floatToHalf(std::numeric_limits<float>::max()) == 0x7c00);
+    CHECK(floatToHalf(kInfinity) == 0x7c00);
+    CHECK(floatToHalf(-kInfinity) == 0xfc00);
+    CHECK(halfToFloat(0x7c00) == kInfinity);
+    CHECK(halfToFloat(0xfc00) == -kInfinity);
+}
+
+TEST(floatToHalfKeepsNaN)
+{
+    CHECK(isHalfNaN(floatToHalf(std::numeric_limits<float>::quiet_NaN())));
+    CHECK(isHalfNaN(floatToHalf(-std::numeric_limits<float>::quiet_NaN())));
+    // A NaN whose payload lives only in bits the half drops.
+    CHECK(isHalfNaN(floatToHalf(fromBits(0x7f800001))));
+    CHECK(std::isnan(halfToFloat(0x7e00)));
+    CHECK(std::isnan(halfToFloat(0xfc01)));
+}
+
+// Every half survives the trip through float; NaNs stay NaN.
+TEST(halfRoundTripsThroughFloat)
+{
+    int mismatches = 0;
+    for (uint32_t half = 0; half <= 0xffff; ++half) {
+        uint16_t back = floatToHalf(halfToFloat(uint16_t(half)));
+        bool same = isHalfNaN(uint16_t(half)) ? isHalfNaN(back) && (back & 0x8000) == (half & 0x8000) : back == half;
+        if (!same)
+            ++mismatches;
+    }
+    CHECK(mismatches == 0);
+}
+
+TEST(packVerticesClampsSpriteUvsAndColors)
+{
+    constexpr float kNaN = std::numeric_limits<float>::quiet_NaN();
+    AAPLSpriteVertex vertices[] = {
+        spriteVertex(vector_float2 { 1.4f, -1.6f }, vector_float2 { 0.5f, 1.0f }, vector_float4 { 0.5f, 1.0f, 0.0f, 1.0f }),
+        spriteVertex(vector_float2 { 40000.0f, -40000.0f }, vector_float2 { -0.5f, 1.5f }, vector_float4 { 2.0f, -1.0f, kNaN, 0.25f }),
+    };
+    AAPLPackedSpriteVertex packed[2];
+    packVertices(vertices, 2, packed);
+
+    CHECK(packed[0].position[0] == 1 && packed[0].position[1] == -2);
+    CHECK(packed[0].uv[0] == 32768 && packed[0].uv[1] == 65535);
+    CHECK(packed[0].color[0] == 128 && packed[0].color[1] == 255 && packed[0].color[2] == 0 && packed[0].color[3] == 255);
+
+    CHECK(packed[1].position[0] == 32767 && packed[1].position[1] == -32768);
+    CHECK(packed[1].uv[0] == 0 && packed[1].uv[1] == 65535);
+    CHECK(packed[1].color[0] == 255 && packed[1].color[1] == 0 && packed[1].color[2] == 0 && packed[1].color[3] == 64);
+}
+
+TEST(packVerticesConvertsPlainAndHalfVertices)
+{
+    AAPLVertex vertex;
+    vertex.position = vector_float2 { -0.5f, 100000.0f };
+    vertex.color = vector_float4 { 0.0f, 0.2f, 1.0f, 1.5f };
+    AAPLPackedVertex packed;
+    packVertices(&vertex, 1, &packed);
+    CHECK(packed.position[0] == 0 && packed.position[1] == 32767);
+    CHECK(packed.color[0] == 0 && packed.color[1] == 51 && packed.color[2] == 255 && packed.color[3] == 255);
+
+    AAPLSpriteVertex sprite = spriteVertex(vector_float2 { 1.0f, -70000.0f }, vector_float2 { 0x1p-24f, 0.25f }, vector_float4 { 1, 1, 1, 1 });
+    AAPLHalfSpriteVertex half;
+    packVertices(&sprite, 1, &half);
+    CHECK(half.position[0] == 0x3c00 && half.position[1] == 0xfc00);
+    CHECK(half.uv[0] == 0x0001 && half.uv[1] == 0x3400);
+    CHECK(half.color[0] == 255 && half.color[3] == 255);
+}